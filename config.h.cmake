@@ -39,18 +39,30 @@
 /* Define to 1 if you have the <signal.h> header file. */
 #cmakedefine HAVE_SIGNAL_H
 
+/* we can include <sys/mman.h>, needed for memory mapped swap files */
+#cmakedefine HAVE_SYS_MMAN_H
+
 /* we can include <sys/times.h> */
 #cmakedefine HAVE_SYS_TIMES_H
 
 /* used for unlinking swap files */
 #cmakedefine HAVE_UNLINK
 
+/* compiler supports x86 SSE2/AVX2 kernels with runtime dispatching */
+#cmakedefine HAVE_X86_SIMD
+
 /* support FLAC */
 #cmakedefine HAVE_FLAC
 
+/* does libFLAC support multithreaded encoding ? (>= v1.5.0) */
+#cmakedefine HAVE_FLAC_NUM_THREADS
+
 /* support MP3 */
 #cmakedefine HAVE_MP3
 
+/* encode MP3 in-process with libmp3lame */
+#cmakedefine HAVE_LIBMP3LAME
+
 /* does libogg have the function ogg_stream_flush_fill ? (>= v1.3.0) */
 #cmakedefine HAVE_OGG_STREAM_FLUSH_FILL
 
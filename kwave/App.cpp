@@ -21,6 +21,7 @@
 
 #include <QCommandLineParser>
 #include <QFile>
+#include <QFileInfo>
 #include <QMetaType>
 #include <QMutableListIterator>
 #include <QString>
@@ -34,6 +35,7 @@
 #include "libkwave/ClipBoard.h"
 #include "libkwave/LabelList.h"
 #include "libkwave/Logger.h"
+#include "libkwave/MemoryManager.h"
 #include "libkwave/Parser.h"
 #include "libkwave/PluginManager.h"
 #include "libkwave/Sample.h"
@@ -65,6 +67,12 @@ Kwave::App::App(int &argc, char **argv)
     qRegisterMetaType<sample_index_t>("sample_index_t");
     qRegisterMetaType<Kwave::MetaDataList>("Kwave::MetaDataList");
 
+    // set up the storage of samples: physical memory limit and swap files
+    const KConfigGroup cfg = KSharedConfig::openConfig()->group(u"Memory"_s);
+    Kwave::MemoryManager &mem = Kwave::MemoryManager::instance();
+    mem.setPhysicalLimit(cfg.readEntry("Physical Limit", quint64(0)));
+    mem.setSwapDirectory(cfg.readEntry("Swap Directory", QString()));
+
     // connect the clipboard
     connect(QApplication::clipboard(),
             SIGNAL(changed(QClipboard::Mode)),
@@ -169,6 +177,62 @@ int Kwave::App::newInstance(const QStringList &args, const QString &dir)
     return retval;
 }
 
+//***************************************************************************
+int Kwave::App::runBatch(const QString &filename)
+{
+    Q_ASSERT(Kwave::isHeadless());
+    Q_ASSERT(m_cmdline);
+    if (!m_cmdline) return BATCH_INIT_FAILED;
+
+    // open the log file if given on the command line
+    if (m_cmdline->isSet(_("logfile"))) {
+        if (!Kwave::Logger::open(m_cmdline->value(_("logfile"))))
+            return BATCH_INIT_FAILED;
+    }
+
+    // the script has to open the files on its own
+    if (!m_cmdline->positionalArguments().isEmpty()) {
+        qWarning("files cannot be passed to a script, use 'open' instead");
+        return BATCH_INIT_FAILED;
+    }
+
+    const QUrl url = Kwave::URLfromUserInput(filename);
+    if (!url.isLocalFile() || !QFileInfo(url.toLocalFile()).isReadable()) {
+        qWarning("unable to read the script '%s'", DBG(filename));
+        return BATCH_NO_SCRIPT;
+    }
+
+    // a file context without toplevel and main widget
+    Kwave::FileContext *context = new(std::nothrow) Kwave::FileContext(*this);
+    Q_ASSERT(context);
+    if (!context) return BATCH_INIT_FAILED;
+
+    int retval = BATCH_OK;
+    if (context->init(nullptr)) {
+        // errors within plugins only show up as error messages
+        Kwave::setFailed(false);
+        int result = context->loadBatch(url);
+        if (result && (result != ECANCELED)) {
+            qWarning("script '%s' failed: %d", DBG(filename), result);
+            retval = BATCH_FAILED;
+        } else if (Kwave::hasFailed()) {
+            qWarning("script '%s' reported an error", DBG(filename));
+            retval = BATCH_FAILED;
+        }
+
+        // discard the signal, the script has to save it on its own
+        context->closeFile();
+    } else {
+        retval = BATCH_INIT_FAILED;
+    }
+    context->release();
+
+    // let the deferred delete of the context happen
+    sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    return retval;
+}
+
 //***************************************************************************
 bool Kwave::App::isOK() const
 {
@@ -397,6 +461,9 @@ void Kwave::App::switchGuiType(Kwave::TopWidget *top, GuiType new_type)
 //***************************************************************************
 void Kwave::App::saveRecentFiles()
 {
+    // the batch mode does not know and must not touch the recent files
+    if (Kwave::isHeadless()) return;
+
     KConfigGroup cfg = KSharedConfig::openConfig()->group(u"Recent Files"_s);
 
     QString num;
@@ -52,6 +52,14 @@ namespace Kwave
         /*  GUI_IDE       integrated development environment (IDE) */
         } GuiType;
 
+        /** exit codes of the batch mode, see runBatch() */
+        typedef enum {
+            BATCH_OK          = 0, /**< all commands succeeded          */
+            BATCH_FAILED      = 1, /**< a command of the script failed  */
+            BATCH_NO_SCRIPT   = 2, /**< the script could not be read    */
+            BATCH_INIT_FAILED = 3  /**< initialization or usage failed  */
+        } BatchExitCode;
+
         /**
          * pair of file name and instance
          * @see #openFiles()
@@ -125,6 +133,15 @@ namespace Kwave
          */
         void switchGuiType(Kwave::TopWidget *top, GuiType new_type);
 
+        /**
+         * Runs a Kwave script without GUI and returns when it is done,
+         * for the batch mode. The signal is closed at the end, without
+         * saving it.
+         * @param filename path of the script file
+         * @return exit code of the application, see BatchExitCode
+         */
+        int runBatch(const QString &filename);
+
         /** Returns the command line parameters passed to the application */
         inline const QCommandLineParser *cmdline() const { return m_cmdline; }
 
@@ -32,6 +32,7 @@
 
 #include "libkwave/CodecManager.h"
 #include "libkwave/Encoder.h"
+#include "libkwave/LabelList.h"
 #include "libkwave/Logger.h"
 #include "libkwave/MessageBox.h"
 #include "libkwave/Parser.h"
@@ -162,9 +163,10 @@ bool Kwave::FileContext::init(Kwave::TopWidget *top_widget)
 {
     Kwave::FileContext::UsageGuard _keep(this);
 
+    // without GUI there is no toplevel widget
     m_top_widget = top_widget;
-    Q_ASSERT(m_top_widget);
-    if (!m_top_widget) return false;
+    Q_ASSERT(m_top_widget || Kwave::isHeadless());
+    if (!m_top_widget && !Kwave::isHeadless()) return false;
 
     m_signal_manager = new(std::nothrow)
         Kwave::SignalManager(m_top_widget);
@@ -203,34 +205,36 @@ bool Kwave::FileContext::init(Kwave::TopWidget *top_widget)
     Kwave::Splash::showMessage(i18n("Scanning plugins..."));
     m_plugin_manager->searchPluginModules();
 
-    // load the menu from file
-    QFile menufile(QStandardPaths::locate(
-        QStandardPaths::GenericDataLocation,
-        _("kwave/menus.config")
-    ));
-    if (!menufile.open(QIODevice::ReadOnly)) {
-        qWarning("menu file not found in:");
-        const QStringList locations = QStandardPaths::standardLocations(
-            QStandardPaths::GenericDataLocation);
-        for (const QString &location : locations)
-        {
-            qWarning("    '%s'", DBG(location));
+    // load the menu from file, not needed without GUI
+    if (!Kwave::isHeadless()) {
+        QFile menufile(QStandardPaths::locate(
+            QStandardPaths::GenericDataLocation,
+            _("kwave/menus.config")
+        ));
+        if (!menufile.open(QIODevice::ReadOnly)) {
+            qWarning("menu file not found in:");
+            const QStringList locations = QStandardPaths::standardLocations(
+                QStandardPaths::GenericDataLocation);
+            for (const QString &location : locations)
+            {
+                qWarning("    '%s'", DBG(location));
+            }
+            return false;
         }
-        return false;
-    }
-    QTextStream stream(&menufile);
-    if (stream.atEnd()) {
-        qWarning("menu file not found in:");
-        QStringList locations = QStandardPaths::standardLocations(
-            QStandardPaths::GenericDataLocation);
-        for (const QString &location : locations)
-        {
-            qWarning("    '%s'", DBG(location));
+        QTextStream stream(&menufile);
+        if (stream.atEnd()) {
+            qWarning("menu file not found in:");
+            QStringList locations = QStandardPaths::standardLocations(
+                QStandardPaths::GenericDataLocation);
+            for (const QString &location : locations)
+            {
+                qWarning("    '%s'", DBG(location));
+            }
         }
+        Q_ASSERT(!stream.atEnd());
+        if (!stream.atEnd()) parseCommands(stream);
+        menufile.close();
     }
-    Q_ASSERT(!stream.atEnd());
-    if (!stream.atEnd()) parseCommands(stream);
-    menufile.close();
 
     // now we are initialized, load all plugins
     Kwave::Splash::showMessage(i18n("Loading plugins..."));
@@ -341,8 +345,9 @@ int Kwave::FileContext::executeCommand(const QString &line)
 //     qDebug("Kwave::FileContext[%p]::executeCommand(%s)", this, DBG(command));
 
     Q_ASSERT(m_plugin_manager);
-    Q_ASSERT(m_top_widget);
-    if (!m_plugin_manager || !m_top_widget) return -ENOMEM;
+    Q_ASSERT(m_top_widget || Kwave::isHeadless());
+    if (!m_plugin_manager) return -ENOMEM;
+    if (!m_top_widget && !Kwave::isHeadless()) return -ENOMEM;
 
     if (!command.length()) return 0; // empty line -> nothing to do
     if (command.trimmed().startsWith(_("#")))
@@ -425,7 +430,8 @@ int Kwave::FileContext::executeCommand(const QString &line)
         qDebug("# %s ", DBG(command));
     }
 
-    if ((result = m_top_widget->executeCommand(command)) != ENOSYS)
+    if (m_top_widget &&
+        ((result = m_top_widget->executeCommand(command)) != ENOSYS))
         return result;
 
     if (false) {
@@ -440,6 +446,22 @@ int Kwave::FileContext::executeCommand(const QString &line)
         result = 0;
     CASE_COMMAND("loadbatch")
         result = loadBatch(QUrl(parser.nextParam()));
+    CASE_COMMAND("newsignal")
+        // only reached without GUI, otherwise done by the toplevel widget
+        sample_index_t samples = parser.toSampleIndex();
+        double         rate    = parser.toDouble();
+        unsigned int   bits    = parser.toUInt();
+        unsigned int   tracks  = parser.toUInt();
+        if (!closeFile()) return -EBUSY;
+        m_signal_manager->newSignal(samples, rate, bits, tracks);
+        result = 0;
+    CASE_COMMAND("open")
+        // only reached without GUI, otherwise done by the toplevel widget
+        QString filename = parser.nextParam();
+        if (filename.isEmpty()) return -EINVAL;
+        if (!closeFile()) return -EBUSY;
+        result = m_signal_manager->loadFile(
+            Kwave::URLfromUserInput(filename));
     CASE_COMMAND("plugin")
         QString name(parser.firstParam());
         QStringList params(parser.remainingParams());
@@ -457,6 +479,9 @@ int Kwave::FileContext::executeCommand(const QString &line)
         QStringList params(parser.remainingParams());
         result = m_plugin_manager->setupPlugin(name, params);
         if (result > 0) result = 0;
+    CASE_COMMAND("quit")
+        // only reached without GUI, the script ends after this command
+        result = 0;
     CASE_COMMAND("revert")
         result = revert();
     CASE_COMMAND("save")
@@ -482,6 +507,27 @@ int Kwave::FileContext::executeCommand(const QString &line)
         result = delegateCommand("debug", parser, 2);
     CASE_COMMAND("window:screenshot")
         result = delegateCommand("debug", parser, 2);
+    } else if (!m_main_widget && Kwave::isHeadless()) {
+        // without GUI there is no main widget, handle the label files
+        // here and leave everything else to the signal manager
+        if ((parser.command() == _("label:load")) ||
+            (parser.command() == _("label:save")))
+        {
+            const QString filename = parser.nextParam();
+            if (filename.isEmpty()) return -EINVAL;
+            const QUrl url = Kwave::URLfromUserInput(filename);
+            if (parser.command() == _("label:save"))
+                return saveLabels(url);
+
+            Kwave::UndoTransactionGuard undo(*m_signal_manager,
+                                             i18n("Load Labels"));
+            result = loadBatch(url);
+        } else if (parser.command().startsWith(_("view:"))) {
+            // zooming and scrolling have nothing to show
+            result = 0;
+        } else {
+            result = m_signal_manager->executeCommand(command);
+        }
     } else {
         // pass the command to the layer below (main widget)
         Kwave::CommandHandler *layer_below = m_main_widget;
@@ -900,6 +946,31 @@ int Kwave::FileContext::loadBatch(const QUrl &url)
     return result;
 }
 
+//***************************************************************************
+int Kwave::FileContext::saveLabels(const QUrl &url)
+{
+    if (!m_signal_manager) return -EINVAL;
+
+    Kwave::Logger::log(this, Kwave::Logger::Info,
+        _("saving labels to '") + url.toDisplayString() + _("'"));
+
+    QFile file(url.path());
+    if (!file.open(QIODevice::WriteOnly)) return -1;
+    QTextStream out(&file);
+
+    Kwave::LabelList labels(m_signal_manager->metaData());
+    for (const Kwave::Label &label : labels) {
+        sample_index_t pos = label.pos();
+        const QString name = Kwave::Parser::escape(label.name());
+        out << _("label:add(") << pos;
+        if (name.length()) out << _(", ") << name;
+        out << _(")") << Qt::endl;
+    }
+
+    file.close();
+    return 0;
+}
+
 //***************************************************************************
 int Kwave::FileContext::revert()
 {
@@ -950,6 +1021,10 @@ int Kwave::FileContext::saveFileAs(const QString &filename, bool selection)
     if (name.length()) {
         /* name given -> take it */
         url = QUrl(name);
+    } else if (Kwave::isHeadless()) {
+        /* no name given and no GUI -> we cannot ask for one */
+        qWarning("FileContext::saveFileAs(): no file name given");
+        return -EINVAL;
     } else {
         /*
          * no name given -> show the File/SaveAs dialog...
@@ -1067,8 +1142,10 @@ int Kwave::FileContext::saveFileAs(const QString &filename, bool selection)
             m_signal_manager->setFileInfo(info, true);
 
             // now call the fileinfo plugin with the new file name and
-            // mime type
-            res = m_plugin_manager->setupPlugin(_("fileinfo"), QStringList());
+            // mime type, not possible without GUI
+            if (!Kwave::isHeadless())
+                res = m_plugin_manager->setupPlugin(_("fileinfo"),
+                                                    QStringList());
         }
 
     }
@@ -1077,7 +1154,8 @@ int Kwave::FileContext::saveFileAs(const QString &filename, bool selection)
     if (!res) res = m_signal_manager->save(url, selection);
 
     // if saving was successful, add the file to the list of recent files
-    if (!res) m_application.addRecentFile(signalName());
+    if (!res && !Kwave::isHeadless())
+        m_application.addRecentFile(signalName());
 
     // undo the temporary metadata changes in case of errors or cancel
     if (res)  m_signal_manager->undo();
@@ -145,6 +145,14 @@ namespace Kwave
          */
         int loadBatch(const QUrl &url);
 
+        /**
+         * Saves all labels of the current signal as a Kwave script,
+         * which can be loaded again with loadBatch()
+         * @param url URL of the file to be written
+         * @return zero if succeeded, non-zero if failed
+         */
+        int saveLabels(const QUrl &url);
+
         /**
          * Saves the current file.
          * @return zero if succeeded, non-zero if failed
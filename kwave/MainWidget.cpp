@@ -25,7 +25,6 @@
 #include <new>
 
 #include <QApplication>
-#include <QFile>
 #include <QFileInfo>
 #include <QFrame>
 #include <QGridLayout>
@@ -34,7 +33,6 @@
 #include <QPointer>
 #include <QResizeEvent>
 #include <QScrollBar>
-#include <QTextStream>
 #include <QWheelEvent>
 #include <QtGlobal>
 
@@ -46,7 +44,6 @@
 #include "libkwave/FileInfo.h"
 #include "libkwave/Label.h"
 #include "libkwave/LabelList.h"
-#include "libkwave/Logger.h"
 #include "libkwave/MessageBox.h"
 #include "libkwave/Parser.h"
 #include "libkwave/SignalManager.h"
@@ -1004,24 +1001,7 @@ int Kwave::MainWidget::saveLabels(const QString &filename)
     }
 
     // now we have a file name -> save all labels...
-    Kwave::Logger::log(this, Kwave::Logger::Info,
-        _("saving labels to '") + url.toDisplayString() + _("'"));
-
-    QFile file(url.path());
-    if (!file.open(QIODevice::WriteOnly)) return -1;
-    QTextStream out(&file);
-
-    Kwave::LabelList labels(signal_manager->metaData());
-    for (const Kwave::Label &label : labels) {
-        sample_index_t pos = label.pos();
-        const QString name = Kwave::Parser::escape(label.name());
-        out << _("label:add(") << pos;
-        if (name.length()) out << _(", ") << name;
-        out << _(")") << Qt::endl;
-    }
-
-    file.close();
-    return 0;
+    return m_context.saveLabels(url);
 }
 
 //***************************************************************************
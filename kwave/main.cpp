@@ -20,6 +20,7 @@
 #include <errno.h>
 
 #include <QApplication>
+#include <QByteArray>
 #include <QCommandLineParser>
 #include <QString>
 
@@ -30,6 +31,7 @@
 #include <kxmlgui_version.h>
 
 #include "libkwave/String.h"
+#include "libkwave/Utils.h"
 
 #include "App.h"
 #include "Splash.h"
@@ -148,11 +150,35 @@ static void addDataStrings(KAboutData &aboutdata)
         QString());
 }
 
+//***************************************************************************
+/**
+ * Checks whether the batch mode is requested on the command line, this
+ * has to be known before the application instance is created
+ */
+static bool batchModeRequested(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        const QByteArray arg(argv[i]);
+        if ((arg == "--batch") || arg.startsWith("--batch=") ||
+            (arg == "-batch")  || arg.startsWith("-batch="))
+            return true;
+    }
+    return false;
+}
+
 //***************************************************************************
 int main(int argc, char **argv)
 {
     int retval = 0;
 
+    // the batch mode runs without GUI, on the offscreen platform
+    // unless a different one has been chosen explicitly
+    if (batchModeRequested(argc, argv)) {
+        Kwave::setHeadless(true);
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     // create the application instance first
     Kwave::App app(argc, argv);
 
@@ -174,6 +200,12 @@ int main(int argc, char **argv)
               "Log all commands into a file <file>."),
         i18nc("placeholder of command line parameter", "file")
     ));
+    cmdline.addOption(QCommandLineOption(
+        _("batch"),
+        i18nc("description of command line parameter",
+              "Run the Kwave script <file> without GUI and exit."),
+        i18nc("placeholder of command line parameter", "file")
+    ));
     cmdline.addOption(QCommandLineOption(
         _("gui"),
         i18nc("description of command line parameter",
@@ -225,6 +257,11 @@ int main(int argc, char **argv)
     about.setupCommandLine(&cmdline);
     about.processCommandLine(&cmdline);
 
+    // batch mode: no unique instance, no splash screen and no window,
+    // several scripts may run in parallel
+    if (Kwave::isHeadless())
+        return app.runBatch(cmdline.value(_("batch")));
+
     /* let Kwave be a "unique" application, only one instance */
     KDBusService service(KDBusService::Unique);
 
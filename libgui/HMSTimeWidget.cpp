@@ -47,7 +47,8 @@ int Kwave::HMSTimeWidget::value()
 void Kwave::HMSTimeWidget::setValue(int value)
 {
     if (value < 0) value = 0;
-    if (Kwave::toUint(value) > m_limit) value = m_limit;
+    if (static_cast<sample_index_t>(value) > m_limit)
+        value = Kwave::toInt(m_limit);
     m_time = value;
 
     const int seconds = (m_time % 60);
@@ -60,14 +61,16 @@ void Kwave::HMSTimeWidget::setValue(int value)
 }
 
 //***************************************************************************
-void Kwave::HMSTimeWidget::setLimit(unsigned int limit)
+void Kwave::HMSTimeWidget::setLimit(sample_index_t limit)
 {
     Q_ASSERT(limit <= SAMPLE_INDEX_MAX);
     if (limit > SAMPLE_INDEX_MAX)
         limit = SAMPLE_INDEX_MAX;
     if (limit < m_limit) {
+        // the time itself is an int, beyond that there is no limit
         m_limit = limit;
-        setValue(m_limit);
+        setValue(Kwave::toInt(qMin<sample_index_t>(m_limit,
+            std::numeric_limits<int>::max())));
     } else {
         m_limit = limit;
     }
@@ -25,6 +25,8 @@
 #include <QObject>
 #include <QWidget>
 
+#include "libkwave/Sample.h"
+
 #include "libgui/ui_HMSTimeWidgetBase.h"
 
 namespace Kwave
@@ -55,7 +57,7 @@ namespace Kwave
         virtual void setValue(int value);
 
         /** sets the maximum time in seconds */
-        virtual void setLimit(unsigned int limit);
+        virtual void setLimit(sample_index_t limit);
 
     protected slots:
 
@@ -76,7 +78,7 @@ namespace Kwave
         unsigned int m_time;
 
         /** the maximum time in seconds, for limiting m_time */
-        unsigned int m_limit;
+        sample_index_t m_limit;
 
     };
 }
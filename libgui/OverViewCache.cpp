@@ -22,8 +22,6 @@
 #include <QtConcurrentRun>
 #include <QFutureSynchronizer>
 
-#include "libkwave/MultiTrackReader.h"
-#include "libkwave/SampleReader.h"
 #include "libkwave/SignalManager.h"
 #include "libkwave/Track.h"
 #include "libkwave/Utils.h"
@@ -272,12 +270,7 @@ int Kwave::OverViewCache::getMinMax(int width, MinMaxArray &minmax)
     if (track_list.isEmpty())
         return 0;
 
-    Kwave::MultiTrackReader src(
-        Kwave::SinglePassForward,
-        m_signal, track_list, first, last
-    );
-
-    if ((length / m_scale < 2) || src.isEmpty() || !m_track_state.count())
+    if ((length / m_scale < 2) || !m_track_state.count())
         return 0; // empty ?
 
     // loop over all min/max buffers and make their content valid
@@ -300,24 +293,23 @@ int Kwave::OverViewCache::getMinMax(int width, MinMaxArray &minmax)
         sample_t   *min   = (*it).m_min.data();
         sample_t   *max   = (*it).m_max.data();
         Q_ASSERT(min && max && state);
-        Kwave::SampleReader *reader = src[index];
-        Q_ASSERT(reader);
-
-        if (!reader || !min || !max || !state) continue;
+        if (!min || !max || !state) continue;
 
-        sample_index_t selection_ofs = m_selection.offset();
-        quint64        scale         = m_scale;
+        // get min/max from the peak cache of the track
+        Kwave::SignalManager *signal = &m_signal;
+        unsigned int          track  = track_list[index];
+        quint64               scale  = m_scale;
         synchronizer.addFuture(QtConcurrent::run(
-            [&reader, selection_ofs, scale, &min, &max, count, &state]
+            [signal, track, first, last, scale, min, max, count, state]
             () {
             for (unsigned int ofs = 0; ofs < count; ++ofs) {
                 if (state[ofs] == Valid)  continue;
                 if (state[ofs] == Unused) continue;
 
-                // get min/max
-                sample_index_t first_idx = selection_ofs + (ofs * scale);
-                sample_index_t last_idx  = first_idx + scale - 1;
-                reader->minMax(first_idx, last_idx, min[ofs], max[ofs]);
+                sample_index_t first_idx = first + (ofs * scale);
+                sample_index_t last_idx  = qMin(first_idx + scale - 1, last);
+                signal->minMax(track, first_idx, last_idx,
+                               min[ofs], max[ofs]);
                 state[ofs] = Valid;
             }
         }));
@@ -30,6 +30,17 @@
 
 #include "libgui/SelectTimeWidget.h"
 
+//***************************************************************************
+/**
+ * Limits a number of samples to the range of the sample spin box,
+ * which is based on int
+ */
+static inline int samples2spin(sample_index_t samples)
+{
+    return Kwave::toInt(qMin<sample_index_t>(samples,
+        static_cast<sample_index_t>(std::numeric_limits<int>::max())));
+}
+
 //***************************************************************************
 Kwave::SelectTimeWidget::SelectTimeWidget(QWidget *widget)
     :QGroupBox(widget), Ui::SelectTimeWidgetBase(),
@@ -65,7 +76,7 @@ void Kwave::SelectTimeWidget::init(Mode mode, quint64 range,
         m_length = m_offset + SAMPLE_INDEX_MAX;
 
     // set range of selection by sample
-    edSamples->setRange(0, Kwave::toInt(m_length - m_offset));
+    edSamples->setRange(0, samples2spin(m_length - m_offset));
     edSamples->setSingleStep(1);
 
     // set range of time controls
@@ -99,9 +110,7 @@ void Kwave::SelectTimeWidget::init(Mode mode, quint64 range,
             break;
         }
         case bySamples: {
-            quint64 samples = qMin<quint64>(m_range,
-                                            std::numeric_limits<int>::max());
-            edSamples->setValue(Kwave::toInt(samples));
+            edSamples->setValue(samples2spin(m_range));
             break;
         }
         case byPercents: {
@@ -316,7 +325,7 @@ void Kwave::SelectTimeWidget::timeChanged(int)
 
     // update the other widgets
     sample_index_t samples = timeToSamples(byTime, ms, m_rate, m_length);
-    edSamples->setValue(Kwave::toInt(samples));
+    edSamples->setValue(samples2spin(samples));
     quint64 percents = samplesToTime(byPercents, samples, m_rate, m_length);
     sbPercents->setValue(Kwave::toInt(percents));
 
@@ -396,7 +405,7 @@ void Kwave::SelectTimeWidget::percentsChanged(int p)
 
     // update the other widgets
     sample_index_t samples = timeToSamples(byPercents, p, m_rate, m_length);
-    edSamples->setValue(Kwave::toInt(samples));
+    edSamples->setValue(samples2spin(samples));
 
     quint64 t = samplesToTime(byTime, samples, m_rate, m_length);
     sbMilliseconds->setValue(Kwave::toInt(t % 1000));
@@ -427,7 +436,7 @@ void Kwave::SelectTimeWidget::setOffset(sample_index_t offset)
     // the range of the sample edit should always get updated
     if (max_samples > SAMPLE_INDEX_MAX)
         max_samples = SAMPLE_INDEX_MAX;
-    edSamples->setRange(0, Kwave::toInt(max_samples));
+    edSamples->setRange(0, samples2spin(max_samples));
     edSamples->setSingleStep(1);
 
     // no range conflict -> nothing to do
@@ -451,7 +460,7 @@ void Kwave::SelectTimeWidget::setOffset(sample_index_t offset)
     Q_ASSERT(samples <= SAMPLE_INDEX_MAX);
     if (samples > SAMPLE_INDEX_MAX)
         samples = SAMPLE_INDEX_MAX;
-    edSamples->setValue(Kwave::toInt(samples));
+    edSamples->setValue(samples2spin(samples));
 
     double percents = 100.0 * static_cast<double>(samples) /
         static_cast<double>(m_length);
@@ -463,7 +472,12 @@ void Kwave::SelectTimeWidget::setOffset(sample_index_t offset)
 //***************************************************************************
 sample_index_t Kwave::SelectTimeWidget::samples() const
 {
-    return (edSamples) ? edSamples->value() : 0;
+    if (!edSamples) return 0;
+
+    // the sample spin box is limited to the range of int, in the other
+    // modes the number of samples can be calculated with full precision
+    if (m_mode == bySamples) return edSamples->value();
+    return timeToSamples(m_mode, m_range, m_rate, m_length);
 }
 
 //***************************************************************************
@@ -484,7 +498,7 @@ sample_index_t Kwave::SelectTimeWidget::timeToSamples(
             break;
         case Kwave::SelectTimeWidget::byPercents:
             // by percentage of whole signal
-            pos = static_cast<unsigned int>(rint(
+            pos = static_cast<sample_index_t>(rint(
                 static_cast<double>(length) *
                 (static_cast<double>(time) / 100.0)));
             break;
@@ -17,10 +17,14 @@
 
 #include <new>
 
+#include <QCache>
+#include <QMutableListIterator>
+#include <QMutex>
 #include <QMutexLocker>
 #include <QPainter>
 #include <QPolygon>
 #include <QTime>
+#include <QtConcurrentRun>
 
 #include "libkwave/SampleReader.h"
 #include "libkwave/Track.h"
@@ -42,14 +46,34 @@
  */
 #define INTERPOLATION_ZOOM 0.10
 
+/** width of a tile of the overview [pixels] */
+#define TILE_WIDTH 256
+
+/** maximum size of the tile cache, shared by all tracks [kilobytes] */
+#define TILE_CACHE_SIZE (128 * 1024)
+
+/** maximum number of tiles of one track that are rendered at a time */
+#define MAX_RENDER_JOBS 16
+
+/** key of a tile in the shared cache: owner, zoom factor and tile index */
+typedef QPair<const void *, QPair<double, qint64> > SharedTileKey;
+
+/** rendered tiles of all tracks, cost is in kilobytes */
+static QCache<SharedTileKey, QImage> g_tile_cache(TILE_CACHE_SIZE);
+
+/** protects g_tile_cache against concurrent access */
+static QMutex g_tile_cache_lock;
+
 //***************************************************************************
 Kwave::TrackPixmap::TrackPixmap(Kwave::Track &track)
     :QObject(), m_pixmap(), m_track(track), m_offset(0), m_zoom(0.0),
     m_vertical_zoom(1.0), m_minmax_mode(false),
-    m_sample_buffer(), m_min_buffer(), m_max_buffer(),
+    m_sample_buffer(),
     m_modified(false), m_valid(0), m_lock_buffer(),
     m_interpolation_order(0), m_interpolation_alpha(),
-    m_colors(Kwave::Colors::Normal)
+    m_colors(Kwave::Colors::Normal),
+    m_tiles_pending(), m_tiles_deferred(false), m_render_jobs(),
+    m_tile_generation(0)
 {
     // connect all the notification signals of the track
     connect(&track,
@@ -65,11 +89,24 @@ Kwave::TrackPixmap::TrackPixmap(Kwave::Track &track)
         sample_index_t, sample_index_t)));
     connect(&track, SIGNAL(sigSelectionChanged(bool)),
             this, SLOT(selectionChanged()));
+
+    // take over tiles that have been rendered in the background
+    connect(this, SIGNAL(sigTileRendered(quint64,double,qint64,QImage)),
+            this, SLOT(tileRendered(quint64,double,qint64,QImage)),
+            Qt::QueuedConnection);
 }
 
 //***************************************************************************
 Kwave::TrackPixmap::~TrackPixmap()
 {
+    // let the jobs stop at their next pixel and release our tiles
+    clearTiles();
+
+    // the jobs use the track, wait until they are done
+    for (QFuture<void> &job : m_render_jobs)
+        job.waitForFinished();
+    m_render_jobs.clear();
+
     QMutexLocker lock(&m_lock_buffer);
     m_interpolation_alpha.clear();
 }
@@ -81,72 +118,9 @@ void Kwave::TrackPixmap::setOffset(sample_index_t offset)
     if (offset == m_offset) return; // no change
     const unsigned int buflen = static_cast<unsigned int>(m_valid.size());
 
-    if (m_minmax_mode) {
-        // move content of min and max buffer
-        // one buffer element = one screen pixel
-        Q_ASSERT(buflen == m_min_buffer.size());
-        Q_ASSERT(buflen == m_max_buffer.size());
-        if ((buflen != m_min_buffer.size()) ||
-            (buflen != m_max_buffer.size()))
-        {
-            qDebug("TrackPixmap::setOffset(): buflen = %u", buflen);
-            qDebug("TrackPixmap::setOffset(): min_buffer : %u",
-                   m_min_buffer.size());
-            qDebug("TrackPixmap::setOffset(): max_buffer : %u",
-                   m_max_buffer.size());
-        }
-
-        // check for misaligned offset changes
-        if ((  offset % static_cast<sample_index_t>(ceil(m_zoom))) !=
-            (m_offset % static_cast<sample_index_t>(ceil(m_zoom)))) {
-
-#ifdef CURRENTLY_UNUSED
-// this will become interesting later, with the offset/zoom optimizations
-            qWarning("TrackPixmap::setOffset(): oh nooo, "\
-                "offset %u is misaligned by %u sample(s), please fix this!",
-                offset, offset % pixels2samples(1));
-            qWarning("TrackPixmap::setOffset(): "\
-                "now I have to throw away the whole buffer :-((");
-
-            qDebug("TrackPixmap::setOffset(%u): "\
-                "misaligned->invalidating buffer", offset);
-#endif
-            invalidateBuffer();
-        } else if (offset > m_offset) {
-            // move left
-            int diff = samples2pixels(offset - m_offset);
-//          qDebug("TrackPixmap::setOffset(): moving left (min/max): %u",diff);
-            Q_ASSERT(diff);
-            Q_ASSERT(buflen);
-            if (diff && buflen) {
-                unsigned int src = Kwave::toUint(diff);
-                unsigned int dst = 0;
-                while (src < buflen) {
-                    m_min_buffer[dst] = m_min_buffer[src];
-                    m_max_buffer[dst] = m_max_buffer[src];
-                    m_valid[dst++]    = m_valid[src++];
-                }
-                while (dst < buflen) m_valid.clearBit(dst++);
-            }
-        } else {
-            // move right
-            int diff = Kwave::toInt(samples2pixels(m_offset - offset));
-//          qDebug("TrackPixmap::setOffset(): moving right (min/max): %u",diff);
-            Q_ASSERT(diff);
-            Q_ASSERT(buflen);
-            if (diff && buflen) {
-                int dst = buflen - 1;
-                while (dst >= diff) {
-                    int src = dst - diff;
-                    m_min_buffer[dst] = m_min_buffer[src];
-                    m_max_buffer[dst] = m_max_buffer[src];
-                    m_valid[dst--]    = m_valid[src--];
-                }
-                diff = dst + 1;
-                while (diff--) m_valid.clearBit(dst--);
-            }
-        }
-    } else {
+    // in min/max mode the tiles are aligned to the start of the signal,
+    // only the position where they are drawn changes
+    if (!m_minmax_mode) {
         // move content of sample buffer
         // one buffer element = one sample
         Q_ASSERT(buflen == m_sample_buffer.size());
@@ -194,12 +168,8 @@ void Kwave::TrackPixmap::resizeBuffer()
     Q_ASSERT(w >= 0);
 
     if (m_minmax_mode) {
-        // one buffer index == one screen pixel
-        buflen = w;
-        ok &= m_min_buffer.resize(buflen);
-        Q_ASSERT(ok);
-        ok &= m_max_buffer.resize(buflen);
-        Q_ASSERT(ok);
+        // no buffer, the tile cache is used instead
+        buflen = 0;
     } else {
         // one buffer index == one sample
         buflen = Kwave::toInt(pixels2samples(w));
@@ -231,15 +201,10 @@ void Kwave::TrackPixmap::setZoom(double zoom)
         m_minmax_mode = false;
     }
 
-    // take the new zoom and resize the buffer
+    // take the new zoom and resize the buffer,
+    // the tile cache still has the tiles of the previous zoom factors
     m_zoom = zoom;
-    if (m_minmax_mode) {
-        // TODO: some clever caching instead of throwing away everything
-        resizeBuffer();
-        invalidateBuffer();
-    } else {
-        resizeBuffer();
-    }
+    resizeBuffer();
 
     m_modified = true;
 }
@@ -255,6 +220,7 @@ void Kwave::TrackPixmap::resize(int width, int height)
 
     m_pixmap = QPixmap(width, height);
     if (width != old_width) resizeBuffer();
+    if (height != old_height) clearTiles();
 
     m_modified = true;
 }
@@ -273,19 +239,18 @@ bool Kwave::TrackPixmap::validateBuffer()
     int last = 0;
     int buflen = static_cast<int>(m_valid.size());
 
+    // in min/max mode the tile cache is used instead
+    Q_ASSERT(!m_minmax_mode);
+    if (m_minmax_mode) return false;
+
     sample_index_t left  = m_offset;
     sample_index_t right = (m_track.length()) ? (m_track.length() - 1) : 0;
-    Kwave::SampleReader *reader = m_track.openReader(
-        Kwave::SinglePassForward, left, right);
+    Kwave::SampleReader *reader =
+        m_track.openReader(Kwave::SinglePassForward, left, right);
     Q_ASSERT(reader);
     if (!reader) return false;
 
-    if (m_minmax_mode) {
-        Q_ASSERT(Kwave::toInt(m_min_buffer.size()) == buflen);
-        Q_ASSERT(Kwave::toInt(m_max_buffer.size()) == buflen);
-    } else {
-        Q_ASSERT(Kwave::toInt(m_sample_buffer.size()) == buflen);
-    }
+    Q_ASSERT(Kwave::toInt(m_sample_buffer.size()) == buflen);
 
     // work-around for missing extra buffer, delete the whole buffer
     // instead. this should not do any harm, in this mode we only
@@ -311,51 +276,20 @@ bool Kwave::TrackPixmap::validateBuffer()
         if (last >= buflen) last = buflen - 1;
         if ((last > first) && (m_valid[last])) --last;
 
-        // fill our array(s) with fresh sample data
-        if (m_minmax_mode) {
-            // indices are in pixels, convert to samples
-
-            // first sample in first pixel
-            sample_index_t s1 = m_offset +
-                static_cast<sample_index_t>(floor(first * m_zoom));
-            // last sample of last pixel
-            sample_index_t s2 = m_offset +
-                static_cast<sample_index_t>(floor((last+1) * m_zoom)) - 1;
-
-            while (first <= last) {
-                s2 = m_offset + static_cast<sample_index_t>(
-                    floor((first + 1) * m_zoom));
-
-                // get min/max for interval [s1...s2]
-                sample_t min;
-                sample_t max;
-                reader->minMax(s1, s2, min, max);
-
-                m_min_buffer[first] = min;
-                m_max_buffer[first] = max;
-                m_valid.setBit(first);
-
-                // advance to the next position
-                ++first;
-                s1 = s2 + 1;
-            }
-        } else {
-            // each index is one sample
-            // -> read directly into the buffer
-            reader->seek(m_offset + first);
-            unsigned int count = reader->read(m_sample_buffer,
-                first, last - first + 1);
-            while (count) {
-                m_valid.setBit(first++);
-                count--;
-            }
-
-            // fill the rest with zeroes
-            while (first <= last) {
-                m_valid.setBit(first);
-                m_sample_buffer[first++] = 0;
-            }
+        // each index is one sample
+        // -> read directly into the buffer
+        reader->seek(m_offset + first);
+        unsigned int count = reader->read(m_sample_buffer,
+            first, last - first + 1);
+        while (count) {
+            m_valid.setBit(first++);
+            count--;
+        }
 
+        // fill the rest with zeroes
+        while (first <= last) {
+            m_valid.setBit(first);
+            m_sample_buffer[first++] = 0;
         }
 
         Q_ASSERT(first >= last);
@@ -394,13 +328,13 @@ void Kwave::TrackPixmap::repaint()
     p.fillRect(0, 0, w, h, m_colors.background);
 
     if (m_zoom > 0) {
-        // first make the buffer valid
-        validateBuffer();
-
-        // then draw the samples
+        // draw the samples
         if (m_minmax_mode) {
-            drawOverview(p, h >> 1, h, 0, w - 1);
+            drawTiles(p, w, h);
         } else {
+            // first make the buffer valid
+            validateBuffer();
+
             if (m_zoom < INTERPOLATION_ZOOM) {
                 drawInterpolatedSignal(p, w, h >> 1, h);
             } else {
@@ -432,6 +366,7 @@ void Kwave::TrackPixmap::setVerticalZoom(double zoom)
 
     if (qFuzzyCompare(zoom, m_vertical_zoom)) return;
     m_vertical_zoom = zoom;
+    clearTiles();
     m_modified = true;
 }
 
@@ -446,41 +381,230 @@ bool Kwave::TrackPixmap::isModified()
 void Kwave::TrackPixmap::selectionChanged()
 {
     QMutexLocker lock(&m_lock_buffer);
+
+    // the tiles have been rendered with the colors of the old state
+    clearTiles();
     m_modified = true;
 }
 
 //***************************************************************************
-void Kwave::TrackPixmap::drawOverview(QPainter &p, int middle, int height,
-                                      int first, int last)
+void Kwave::TrackPixmap::drawTiles(QPainter &p, int width, int height)
 {
-    const Kwave::SampleArray &min_buffer = m_min_buffer;
-    const Kwave::SampleArray &max_buffer = m_max_buffer;
-
     Q_ASSERT(m_minmax_mode);
-    Q_ASSERT(width() <= Kwave::toInt(min_buffer.size()));
-    Q_ASSERT(width() <= Kwave::toInt(max_buffer.size()));
+    Q_ASSERT(m_zoom > 0);
+
+    // position of the view on the pixel grid of the tiles
+    const qint64 origin = static_cast<qint64>(
+        rint(static_cast<double>(m_offset) / m_zoom));
+    const qint64 first  = origin / TILE_WIDTH;
+    const qint64 last   = (origin + width - 1) / TILE_WIDTH;
+
+    for (qint64 index = first; index <= last; ++index) {
+        const TileKey key(m_zoom, index);
+        const int x = Kwave::toInt((index * TILE_WIDTH) - origin);
+        QImage tile;
+        {
+            QMutexLocker cache_lock(&g_tile_cache_lock);
+            const QImage *cached = g_tile_cache.object(
+                SharedTileKey(this, key));
+            if (cached) tile = *cached;
+        }
+        if (!tile.isNull() && (tile.height() == height)) {
+            p.drawImage(x, 0, tile);
+        } else {
+            // placeholder, until the tile is available
+            p.fillRect(x, 0, TILE_WIDTH, height,
+                       QBrush(m_colors.zero_unused, Qt::Dense6Pattern));
+            requestTile(key, height);
+        }
+    }
+
+    // prepare the neighbours of the view, for scrolling
+    if (first > 0) requestTile(TileKey(m_zoom, first - 1), height);
+    requestTile(TileKey(m_zoom, last + 1), height);
+}
+
+//***************************************************************************
+void Kwave::TrackPixmap::requestTile(const TileKey &key, int height)
+{
+    if (m_tiles_pending.contains(key)) return;
+    {
+        QMutexLocker cache_lock(&g_tile_cache_lock);
+        if (g_tile_cache.contains(SharedTileKey(this, key))) return;
+    }
+
+    // limit the number of jobs, the rest follows when they are done
+    if (m_tiles_pending.count() >= MAX_RENDER_JOBS) {
+        m_tiles_deferred = true;
+        return;
+    }
+    m_tiles_pending.insert(key);
+
+    // forget about jobs that are already done
+    QMutableListIterator<QFuture<void> > it(m_render_jobs);
+    while (it.hasNext()) {
+        if (it.next().isFinished()) it.remove();
+    }
+
+    Kwave::Track                 *track         = &m_track;
+    const quint64                 generation    = m_tile_generation;
+    const double                  vertical_zoom = m_vertical_zoom;
+    const Kwave::Colors::ColorSet colors        = m_colors;
+    m_render_jobs.append(QtConcurrent::run(
+        [this, track, key, height, vertical_zoom, colors, generation]() {
+            const QImage tile = renderTile(track, key.first, key.second,
+                                           height, vertical_zoom, colors,
+                                           m_tile_generation, generation);
+            if (generation != m_tile_generation) return; // outdated
+            emit sigTileRendered(generation, key.first, key.second, tile);
+        }
+    ));
+}
+
+//***************************************************************************
+QImage Kwave::TrackPixmap::renderTile(Kwave::Track *track, double zoom,
+                                      qint64 index, int height,
+                                      double vertical_zoom,
+                                      const Kwave::Colors::ColorSet &colors,
+                                      const std::atomic<quint64> &current,
+                                      quint64 generation)
+{
+    QImage tile(TILE_WIDTH, height, QImage::Format_ARGB32_Premultiplied);
+    if (tile.isNull()) return tile;
+
+    QPainter p(&tile);
+    p.fillRect(0, 0, TILE_WIDTH, height, colors.background);
+    p.setPen(colors.sample);
 
     // scale_y: pixels per unit
-    double scale_y = (m_vertical_zoom * height) / (1 << SAMPLE_BITS);
+    const double scale_y = (vertical_zoom * height) / (1 << SAMPLE_BITS);
+    const int    middle  = height >> 1;
+
+    // start with the last pixel of the left neighbour, for avoiding
+    // a gap at the border of the tiles
+    const qint64 first = index * TILE_WIDTH;
+    int  last_min = 0;
+    int  last_max = 0;
+    bool has_last = false;
+    for (qint64 x = qMax<qint64>(first - 1, 0); x < first + TILE_WIDTH; ++x)
+    {
+        // give up if the tile has become outdated in the meantime
+        if (current != generation) {
+            p.end();
+            return QImage();
+        }
 
-    p.setPen(m_colors.sample);
-    int last_min = Kwave::toInt(min_buffer[first] * scale_y);
-    int last_max = Kwave::toInt(max_buffer[first] * scale_y);
-    for (int i = first; i <= last; i++) {
-        Q_ASSERT(m_valid[i]);
-        int max = Kwave::toInt(max_buffer[i] * scale_y);
-        int min = Kwave::toInt(min_buffer[i] * scale_y);
+        // get min/max of the samples under the pixel
+        const sample_index_t s1 = static_cast<sample_index_t>(
+            floor(static_cast<double>(x) * zoom));
+        const sample_index_t s2 = qMax(s1, static_cast<sample_index_t>(
+            floor(static_cast<double>(x + 1) * zoom)) - 1);
+        sample_t min_value;
+        sample_t max_value;
+        track->minMax(s1, s2, min_value, max_value);
+
+        int max = Kwave::toInt(max_value * scale_y);
+        int min = Kwave::toInt(min_value * scale_y);
 
         // make sure there is a connection between this
         // section and the one before, avoid gaps
-        if (min > last_max + 1) min = last_max + 1;
-        if (max + 1 < last_min) max = last_min - 1;
+        if (has_last) {
+            if (min > last_max + 1) min = last_max + 1;
+            if (max + 1 < last_min) max = last_min - 1;
+        }
 
-        p.drawLine(i, middle - max, i, middle - min);
+        if (x >= first) {
+            const int i = Kwave::toInt(x - first);
+            p.drawLine(i, middle - max, i, middle - min);
+        }
 
         last_min = min;
         last_max = max;
+        has_last = true;
     }
+    p.end();
+
+    return tile;
+}
+
+//***************************************************************************
+void Kwave::TrackPixmap::tileRendered(quint64 generation, double zoom,
+                                      qint64 index, QImage tile)
+{
+    {
+        QMutexLocker lock(&m_lock_buffer);
+
+        if (generation != m_tile_generation) return; // outdated
+        const TileKey key(zoom, index);
+        m_tiles_pending.remove(key);
+
+        // tiles that did not fit into the job limit can follow now
+        const bool deferred = m_tiles_deferred;
+        m_tiles_deferred = false;
+
+        if (!tile.isNull()) {
+            QImage *image = new(std::nothrow) QImage(tile);
+            Q_ASSERT(image);
+            if (image) {
+                QMutexLocker cache_lock(&g_tile_cache_lock);
+                g_tile_cache.insert(SharedTileKey(this, key), image,
+                    Kwave::toInt(tile.sizeInBytes() / 1024) + 1);
+            }
+        }
+
+        // tiles for scrolling or other zoom factors are not shown yet
+        if (!m_minmax_mode) return;
+        if (!deferred && (tile.isNull() || !qFuzzyCompare(zoom, m_zoom)))
+            return;
+        m_modified = true;
+    }
+
+    // notify our owner about changed data -> screen refresh
+    emit sigModified();
+}
+
+//***************************************************************************
+bool Kwave::TrackPixmap::invalidateTiles(sample_index_t first,
+                                         sample_index_t last)
+{
+    // the results of running jobs might already be outdated
+    bool affected = !m_tiles_pending.isEmpty();
+    m_tiles_pending.clear();
+    m_tile_generation++;
+
+    QMutexLocker cache_lock(&g_tile_cache_lock);
+    const QList<SharedTileKey> keys = g_tile_cache.keys();
+    for (const SharedTileKey &shared_key : keys) {
+        if (shared_key.first != this) continue; // other track
+        const TileKey &key = shared_key.second;
+        const double zoom = key.first;
+
+        // a tile also shows the last pixel of its left neighbour
+        const qint64 left = static_cast<qint64>(
+            floor(static_cast<double>(first) / zoom)) / TILE_WIDTH;
+        const qint64 right = (last == SAMPLE_INDEX_MAX) ? key.second :
+            (static_cast<qint64>(floor(static_cast<double>(last) / zoom))
+            + 1) / TILE_WIDTH;
+        if ((key.second < left) || (key.second > right)) continue;
+
+        g_tile_cache.remove(shared_key);
+        if (qFuzzyCompare(zoom, m_zoom)) affected = true;
+    }
+
+    return affected;
+}
+
+//***************************************************************************
+void Kwave::TrackPixmap::clearTiles()
+{
+    m_tiles_pending.clear();
+    m_tiles_deferred = false;
+    m_tile_generation++;
+
+    QMutexLocker cache_lock(&g_tile_cache_lock);
+    const QList<SharedTileKey> keys = g_tile_cache.keys();
+    for (const SharedTileKey &key : keys)
+        if (key.first == this) g_tile_cache.remove(key);
 }
 
 //***************************************************************************
@@ -712,15 +836,21 @@ void Kwave::TrackPixmap::slotSamplesInserted(Kwave::Track *,
     {
         QMutexLocker lock(&m_lock_buffer);
 
+        // all tiles from here to the end are affected
+        const bool tiles = (length) &&
+            invalidateTiles(offset, SAMPLE_INDEX_MAX);
+
         convertOverlap(offset, length);
-        if (!length) return; // false alarm
+        if (!length && !tiles) return; // false alarm
 
         // mark all positions from here to right end as "invalid"
-        const qsizetype first = offset;
-        const qsizetype last  = m_valid.size();
-        Q_ASSERT(first < m_valid.size());
-        Q_ASSERT(last  > first);
-        m_valid.fill(false, first, last);
+        if (length) {
+            const qsizetype first = offset;
+            const qsizetype last  = m_valid.size();
+            Q_ASSERT(first < m_valid.size());
+            Q_ASSERT(last  > first);
+            m_valid.fill(false, first, last);
+        }
 
         // repaint of the signal is needed
         m_modified = true;
@@ -738,15 +868,21 @@ void Kwave::TrackPixmap::slotSamplesDeleted(Kwave::Track *,
     {
         QMutexLocker lock(&m_lock_buffer);
 
+        // all tiles from here to the end are affected
+        const bool tiles = (length) &&
+            invalidateTiles(offset, SAMPLE_INDEX_MAX);
+
         convertOverlap(offset, length);
-        if (!length) return; // false alarm
+        if (!length && !tiles) return; // false alarm
 
         // mark all positions from here to right end as "invalid"
-        const qsizetype first = offset;
-        const qsizetype last  = m_valid.size();
-        Q_ASSERT(first < m_valid.size());
-        Q_ASSERT(last  > first);
-        m_valid.fill(false, first, last);
+        if (length) {
+            const qsizetype first = offset;
+            const qsizetype last  = m_valid.size();
+            Q_ASSERT(first < m_valid.size());
+            Q_ASSERT(last  > first);
+            m_valid.fill(false, first, last);
+        }
 
         // repaint of the signal is needed
         m_modified = true;
@@ -764,15 +900,20 @@ void Kwave::TrackPixmap::slotSamplesModified(Kwave::Track *,
     {
         QMutexLocker lock(&m_lock_buffer);
 
+        const bool tiles = (length) &&
+            invalidateTiles(offset, offset + length - 1);
+
         convertOverlap(offset, length);
-        if (!length) return; // false alarm
+        if (!length && !tiles) return; // false alarm
 
         // mark all overlapping positions as "invalid"
-        const int first = Kwave::toInt(offset);
-        const int last  = Kwave::toInt(offset + length);
-        Q_ASSERT(first < m_valid.size());
-        Q_ASSERT(last  > first);
-        m_valid.fill(false, first, last);
+        if (length) {
+            const int first = Kwave::toInt(offset);
+            const int last  = Kwave::toInt(offset + length);
+            Q_ASSERT(first < m_valid.size());
+            Q_ASSERT(last  > first);
+            m_valid.fill(false, first, last);
+        }
 
         // repaint of the signal is needed
         m_modified = true;
@@ -800,37 +941,14 @@ void Kwave::TrackPixmap::convertOverlap(sample_index_t &offset,
         return;
     }
 
-    // calculate the length
-    if (m_minmax_mode) {
-        // attention: round up the length int this mode!
-        if (offset >= m_offset + static_cast<sample_index_t>(
-            ceil(buflen * m_zoom)))
-        {
-            length = 0; // out of view
-            return;
-        } else {
-            length = static_cast<sample_index_t>(
-                ceil(static_cast<double>(length) / m_zoom));
-        }
-    } else {
-        if (offset >= m_offset + buflen) {
-            length = 0; // out of view
-            return;
-        }
+    // calculate the length, in min/max mode there is no buffer
+    if (offset >= m_offset + buflen) {
+        length = 0; // out of view
+        return;
     }
 
     // convert the offset
     offset = (offset > m_offset) ? offset - m_offset : 0;
-    if (m_minmax_mode) {
-        // attention: round down in this mode!
-        double         ofs_d = static_cast<double>(offset);
-        sample_index_t ofs = static_cast<sample_index_t>(floor(ofs_d / m_zoom));
-
-        // if offset was rounded down, increment length
-        if (ofs != static_cast<sample_index_t>(ceil(ofs_d / m_zoom)))
-            length++;
-        offset = ofs;
-    }
 
     // limit the offset (maybe something happened when rounding)
     if (offset >= buflen) offset = buflen - 1;
@@ -23,12 +23,19 @@
 
 #include <math.h>
 
+#include <atomic>
+
 #include <QtGlobal>
 #include <QBitArray>
 #include <QColor>
+#include <QFuture>
+#include <QImage>
+#include <QList>
 #include <QMutex>
 #include <QObject>
+#include <QPair>
 #include <QPixmap>
+#include <QSet>
 #include <QVector>
 
 #include "libkwave/Sample.h"
@@ -44,6 +51,11 @@
  * caching mechanisms for reducing (slow) accesses to the track; this
  * is especially needed for speeding up the handling large wav files.
  *
+ * In overview mode (more than one sample per pixel) the signal is
+ * rendered in tiles of fixed width, in background threads. The tiles are
+ * cached per zoom factor, the GUI thread only copies finished tiles into
+ * the pixmap and shows a placeholder for tiles that are not ready yet.
+ *
  * @note The sample ranges in this class are a kind of "virtual", it is
  *       possible that the length of this pixmap in samples is larger
  *       than the track. However, this should not do any harm and might
@@ -129,6 +141,17 @@ namespace Kwave
         /** Emitted if the content of the pixmap was modified. */
         void sigModified();
 
+        /**
+         * Emitted from a background thread when a tile has been rendered
+         * @param generation value of m_tile_generation when requested
+         * @param zoom the zoom factor of the tile
+         * @param index index of the tile
+         * @param tile the rendered image
+         * @internal
+         */
+        void sigTileRendered(quint64 generation, double zoom, qint64 index,
+                             QImage tile);
+
     public slots:
 
         /**
@@ -187,8 +210,20 @@ namespace Kwave
          */
         void selectionChanged();
 
+        /**
+         * Takes over a tile that has been rendered in the background
+         * and requests a repaint if it belongs to the current zoom.
+         * @see sigTileRendered
+         * @internal
+         */
+        void tileRendered(quint64 generation, double zoom, qint64 index,
+                          QImage tile);
+
     private:
 
+        /** key of a tile in the cache: zoom factor and tile index */
+        typedef QPair<double, qint64> TileKey;
+
         /**
          * Resizes the current buffer and sets all new entries to
          * invalid (if any).
@@ -212,15 +247,54 @@ namespace Kwave
 
         /**
          * Draws the signal as an overview with multiple samples per
-         * pixel.
+         * pixel, out of the tile cache. Tiles that are missing are shown
+         * as placeholder and requested from a background thread.
          * @param p reference to a QPainter
-         * @param middle the y position of the zero line [pixels]
+         * @param width the width of the pixmap [pixels]
          * @param height the height of the pixmap [pixels]
-         * @param first the offset of the first pixel
-         * @param last the offset of the last pixel
          */
-        void drawOverview(QPainter &p, int middle, int height,
-            int first, int last);
+        void drawTiles(QPainter &p, int width, int height);
+
+        /**
+         * Starts rendering a tile in a background thread, unless it is
+         * already cached or pending
+         * @param key zoom factor and index of the tile
+         * @param height the height of the tile [pixels]
+         */
+        void requestTile(const TileKey &key, int height);
+
+        /**
+         * Renders one tile of the overview, with the min/max values of
+         * the samples under each pixel. Runs in a background thread.
+         * @param track the track with the samples
+         * @param zoom the zoom factor [samples/pixel]
+         * @param index index of the tile
+         * @param height the height of the tile [pixels]
+         * @param vertical_zoom the vertical zoom factor
+         * @param colors set of colors for drawing
+         * @param current the current generation of the tiles
+         * @param generation generation of the tiles when requested
+         * @return the rendered tile, or a null image if out of memory
+         *         or outdated before it was complete
+         */
+        static QImage renderTile(Kwave::Track *track, double zoom,
+                                 qint64 index, int height,
+                                 double vertical_zoom,
+                                 const Kwave::Colors::ColorSet &colors,
+                                 const std::atomic<quint64> &current,
+                                 quint64 generation);
+
+        /**
+         * Removes all tiles that show a range of samples from the cache,
+         * for all zoom factors
+         * @param first index of the first modified sample
+         * @param last index of the last modified sample
+         * @return true if the current view might be affected
+         */
+        bool invalidateTiles(sample_index_t first, sample_index_t last);
+
+        /** Removes all tiles from the cache and drops pending ones */
+        void clearTiles();
 
         /**
          * Calculates the parameters for interpolation of the graphical
@@ -317,7 +391,7 @@ namespace Kwave
 
         /**
          * If true, we are in min/max mode. This means that m_sample_buffer
-         * is not used and m_minmax_buffer contains is used instead.
+         * is not used and the signal is drawn out of the tile cache.
          */
         bool m_minmax_mode;
 
@@ -328,16 +402,6 @@ namespace Kwave
          */
         Kwave::SampleArray m_sample_buffer;
 
-        /**
-         * Array with minimum sample values, if in min/max mode.
-         */
-        Kwave::SampleArray m_min_buffer;
-
-        /**
-         * Array with maximum sample values, if in min/max mode.
-         */
-        Kwave::SampleArray m_max_buffer;
-
         /** Indicates that the buffer content was modified */
         bool m_modified;
 
@@ -367,6 +431,22 @@ namespace Kwave
         /** set of colors for drawing */
         Kwave::Colors::ColorSet m_colors;
 
+        /** tiles that are currently rendered in the background */
+        QSet<TileKey> m_tiles_pending;
+
+        /** true if tiles were not requested due to the job limit */
+        bool m_tiles_deferred;
+
+        /** background jobs that render tiles */
+        QList<QFuture<void> > m_render_jobs;
+
+        /**
+         * incremented whenever the cached tiles become invalid, results
+         * of jobs that have been started before are discarded and
+         * running jobs stop early
+         */
+        std::atomic<quint64> m_tile_generation;
+
     };
 }
 
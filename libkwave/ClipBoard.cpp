@@ -28,8 +28,8 @@
 
 #include "libkwave/ClipBoard.h"
 #include "libkwave/CodecManager.h"
+#include "libkwave/MemoryManager.h"
 #include "libkwave/MimeData.h"
-#include "libkwave/MultiTrackReader.h"
 #include "libkwave/SignalManager.h"
 
 /** static instance of Kwave's clipboard */
@@ -45,6 +45,9 @@ Kwave::ClipBoard &Kwave::ClipBoard::instance()
 Kwave::ClipBoard::ClipBoard()
     :m_tracks(0)
 {
+    // the clipboard might still hold samples at exit, so make sure that
+    // the memory manager is constructed first and destroyed last
+    Kwave::MemoryManager::instance();
 }
 
 //***************************************************************************
@@ -66,7 +69,7 @@ void Kwave::ClipBoard::slotChanged(QClipboard::Mode mode)
 }
 
 //***************************************************************************
-void Kwave::ClipBoard::copy(QWidget *widget,
+void Kwave::ClipBoard::copy(QWidget * /* widget */,
                             Kwave::SignalManager &signal_manager,
                             const QVector<unsigned int> &track_list,
                             sample_index_t offset, sample_index_t length)
@@ -79,12 +82,10 @@ void Kwave::ClipBoard::copy(QWidget *widget,
     Q_ASSERT(buffer);
     if (!buffer) return;
 
-    // encode into the mime data container
-    Kwave::MultiTrackReader src(Kwave::SinglePassForward, signal_manager,
-        track_list, offset, offset + length - 1);
-
-    if (!buffer->encode(widget, src, signal_manager.metaData())) {
-        // encoding failed, reset to empty
+    // take references to the samples, they are encoded only if another
+    // application requests them
+    if (!buffer->store(signal_manager, track_list, offset, length)) {
+        // storing failed, reset to empty
         buffer->clear();
         delete buffer;
         return;
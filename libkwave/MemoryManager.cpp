@@ -0,0 +1,433 @@
+/***************************************************************************
+      MemoryManager.cpp  -  Kwave memory management
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <fcntl.h>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QTemporaryFile>
+
+#include "libkwave/MemoryManager.h"
+#include "libkwave/String.h"
+#include "libkwave/memcpy.h"
+
+/**
+ * minimum size of a block that is put into a swap file [bytes], smaller
+ * blocks like the buffers of readers and writers always stay on the heap
+ */
+#define SWAP_MIN_SIZE (1024 * 1024)
+
+namespace Kwave
+{
+    /**
+     * A swap file that holds exactly one block of storage, mapped
+     * into the address space of the process.
+     */
+    class SwapFile
+    {
+    public:
+        /** Constructor */
+        SwapFile()
+            :m_path(), m_data(nullptr), m_size(0), m_resident(false),
+             m_releasing(false)
+        {
+        }
+
+        /** Destructor, unmaps and removes the file */
+        virtual ~SwapFile()
+        {
+#ifdef HAVE_SYS_MMAN_H
+            if (m_data) munmap(m_data, m_size);
+#endif
+            m_data = nullptr;
+            m_size = 0;
+#ifdef HAVE_UNLINK
+            if (!m_path.isEmpty())
+                unlink(m_path.toLocal8Bit().constData());
+#else
+            if (!m_path.isEmpty()) QFile::remove(m_path);
+#endif
+        }
+
+        /**
+         * Creates the file in a given directory
+         * @param dir directory for the swap file
+         * @return true if succeeded
+         */
+        bool create(const QString &dir)
+        {
+            QTemporaryFile file(dir + _("/kwave-swap-XXXXXX"));
+            file.setAutoRemove(false);
+            if (!file.open()) return false;
+            m_path = file.fileName();
+            file.close();
+            return true;
+        }
+
+        /**
+         * Resizes the file and (re-)maps it into memory. The file
+         * descriptor is closed afterwards, so that the number of
+         * swap files is not limited by the number of open files.
+         * @param size new size in bytes, not zero
+         * @return true if succeeded, false if failed (old mapping stays)
+         */
+        bool resize(size_t size)
+        {
+#ifdef HAVE_SYS_MMAN_H
+            const QByteArray path = m_path.toLocal8Bit();
+            int fd = ::open(path.constData(), O_RDWR);
+            if (fd < 0) return false;
+
+            if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                ::close(fd);
+                return false;
+            }
+
+            void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED) return false;
+
+            // the content is held by the file, no need to copy it
+            if (m_data) munmap(m_data, m_size);
+            m_data = p;
+            m_size = size;
+            return true;
+#else
+            Q_UNUSED(size)
+            return false;
+#endif
+        }
+
+        /**
+         * Writes back all modified pages and releases them from
+         * physical memory. The content stays valid and will be
+         * paged in again on the next access.
+         */
+        void release()
+        {
+#ifdef HAVE_SYS_MMAN_H
+            if (!m_data) return;
+            msync(m_data, m_size, MS_SYNC);
+            madvise(m_data, m_size, MADV_DONTNEED);
+#endif
+        }
+
+        /** returns a pointer to the mapped storage */
+        inline void *data() const { return m_data; }
+
+        /** returns the size of the mapped storage in bytes */
+        inline size_t size() const { return m_size; }
+
+    private:
+
+        /** path of the file */
+        QString m_path;
+
+        /** pointer to the mapped storage */
+        void *m_data;
+
+        /** size of the file in bytes */
+        size_t m_size;
+
+    public:
+
+        /** true if the file is assumed to be in physical memory */
+        bool m_resident;
+
+        /** true while release() is running, without the lock */
+        bool m_releasing;
+    };
+}
+
+//***************************************************************************
+Kwave::MemoryManager &Kwave::MemoryManager::instance()
+{
+    // constructed on first use, so that it is destroyed after all static
+    // objects that have been constructed after it and still hold samples
+    static Kwave::MemoryManager memory_manager;
+    return memory_manager;
+}
+
+//***************************************************************************
+Kwave::MemoryManager::MemoryManager()
+    :m_lock(), m_physical_limit(0), m_swap_dir(QDir::tempPath()),
+     m_physical_used(0), m_mapped_resident(0), m_swap_files(), m_lru(),
+     m_swap_count(0), m_released()
+{
+}
+
+//***************************************************************************
+Kwave::MemoryManager::~MemoryManager()
+{
+    QMutexLocker lock(&m_lock);
+    if (!m_swap_files.isEmpty())
+        qWarning("MemoryManager: %lld swap files still in use",
+                 static_cast<qint64>(m_swap_files.count()));
+    for (Kwave::SwapFile *swap : m_swap_files)
+        waitForRelease(swap);
+    qDeleteAll(m_swap_files);
+    m_swap_files.clear();
+    m_swap_count = 0;
+    m_lru.clear();
+}
+
+//***************************************************************************
+void Kwave::MemoryManager::setPhysicalLimit(quint64 mb)
+{
+    QList<Kwave::SwapFile *> evicted;
+    {
+        QMutexLocker lock(&m_lock);
+        m_physical_limit = mb;
+        if (m_physical_limit) evict(evicted);
+    }
+    release(evicted);
+}
+
+//***************************************************************************
+quint64 Kwave::MemoryManager::physicalLimit() const
+{
+    return m_physical_limit;
+}
+
+//***************************************************************************
+void Kwave::MemoryManager::setSwapDirectory(const QString &dir)
+{
+    QMutexLocker lock(&m_lock);
+    m_swap_dir = (dir.length()) ? dir : QDir::tempPath();
+}
+
+//***************************************************************************
+QString Kwave::MemoryManager::swapDirectory() const
+{
+    QMutexLocker lock(&m_lock);
+    return m_swap_dir;
+}
+
+//***************************************************************************
+bool Kwave::MemoryManager::needsSwap(size_t size, size_t freed) const
+{
+    const quint64 limit = limitBytes();
+    return (limit && (size >= SWAP_MIN_SIZE) &&
+            (m_physical_used - freed + size > limit));
+}
+
+//***************************************************************************
+void *Kwave::MemoryManager::allocateSwap(size_t size,
+                                         QList<Kwave::SwapFile *> &evicted)
+{
+    Kwave::SwapFile *swap = new(std::nothrow) Kwave::SwapFile();
+    if (!swap) return nullptr;
+
+    if (!swap->create(m_swap_dir) || !swap->resize(size)) {
+        qWarning("MemoryManager: creating swap file in '%s' failed",
+                 DBG(m_swap_dir));
+        delete swap;
+        return nullptr;
+    }
+
+    m_swap_files.insert(swap->data(), swap);
+    ++m_swap_count;
+    swap->m_resident = true;
+    m_mapped_resident += size;
+    m_lru.prepend(swap);
+    evict(evicted);
+
+    return swap->data();
+}
+
+//***************************************************************************
+void *Kwave::MemoryManager::allocate(size_t size)
+{
+    if (!size) return nullptr;
+
+    if (needsSwap(size, 0)) {
+        QList<Kwave::SwapFile *> evicted;
+        void *block = nullptr;
+        {
+            QMutexLocker lock(&m_lock);
+            block = allocateSwap(size, evicted);
+        }
+        release(evicted);
+        if (block) return block;
+        // fall back to physical memory if no swap is available
+    }
+
+    void *block = ::malloc(size);
+    if (block) m_physical_used += size;
+    return block;
+}
+
+//***************************************************************************
+void *Kwave::MemoryManager::resize(void *block, size_t old_size,
+                                   size_t new_size)
+{
+    if (!block) return allocate(new_size);
+    Q_ASSERT(new_size);
+    if (!new_size) return nullptr;
+
+    // block in a swap file -> resize the file
+    if (m_swap_count) {
+        QMutexLocker lock(&m_lock);
+        Kwave::SwapFile *swap = m_swap_files.value(block, nullptr);
+        if (swap) {
+            waitForRelease(swap);
+            if (!swap->resize(new_size)) return nullptr;
+            m_swap_files.remove(block);
+            m_swap_files.insert(swap->data(), swap);
+            if (swap->m_resident) {
+                m_mapped_resident -= old_size;
+                m_mapped_resident += new_size;
+            }
+            return swap->data();
+        }
+    }
+
+    // block in physical memory, move it into a swap file if it does
+    // no longer fit into the limit
+    if (needsSwap(new_size, old_size)) {
+        QList<Kwave::SwapFile *> evicted;
+        void *new_block = nullptr;
+        {
+            QMutexLocker lock(&m_lock);
+            new_block = allocateSwap(new_size, evicted);
+        }
+        if (new_block) {
+            MEMCPY(new_block, block, qMin(old_size, new_size));
+            ::free(block);
+            m_physical_used -= old_size;
+        }
+        release(evicted);
+        if (new_block) return new_block;
+    }
+
+    void *new_block = ::realloc(block, new_size);
+    if (!new_block) return nullptr;
+    m_physical_used -= old_size;
+    m_physical_used += new_size;
+    return new_block;
+}
+
+//***************************************************************************
+void Kwave::MemoryManager::free(void *block, size_t size)
+{
+    if (!block) return;
+
+    if (m_swap_count) {
+        QMutexLocker lock(&m_lock);
+        Kwave::SwapFile *swap = m_swap_files.value(block, nullptr);
+        if (swap) {
+            waitForRelease(swap);
+            m_swap_files.remove(block);
+            --m_swap_count;
+            if (swap->m_resident) {
+                m_lru.removeAll(swap);
+                m_mapped_resident -= swap->size();
+            }
+            delete swap;
+            return;
+        }
+    }
+
+    ::free(block);
+    Q_ASSERT(m_physical_used >= size);
+    m_physical_used -= size;
+}
+
+//***************************************************************************
+void Kwave::MemoryManager::touch(const void *block)
+{
+    // shortcut without locking, as long as no swap file is in use
+    if (!block || !m_swap_count) return;
+
+    QList<Kwave::SwapFile *> evicted;
+    {
+        QMutexLocker lock(&m_lock);
+
+        Kwave::SwapFile *swap = m_swap_files.value(block, nullptr);
+        if (!swap) return;
+
+        if (swap->m_resident) {
+            if (!m_lru.isEmpty() && (m_lru.first() == swap)) return;
+            m_lru.removeOne(swap);
+        } else {
+            swap->m_resident = true;
+            m_mapped_resident += swap->size();
+        }
+        m_lru.prepend(swap);
+
+        evict(evicted);
+    }
+    release(evicted);
+}
+
+//***************************************************************************
+void Kwave::MemoryManager::evict(QList<Kwave::SwapFile *> &evicted)
+{
+    const quint64 limit = limitBytes();
+    if (!limit) return;
+
+    // always keep the most recently used file
+    while ((m_lru.count() > 1) &&
+           (m_physical_used + m_mapped_resident > limit))
+    {
+        Kwave::SwapFile *swap = m_lru.takeLast();
+        swap->m_resident   = false;
+        m_mapped_resident -= swap->size();
+        if (swap->m_releasing) continue; // already in progress
+        swap->m_releasing  = true;
+        evicted.append(swap);
+    }
+}
+
+//***************************************************************************
+void Kwave::MemoryManager::release(QList<Kwave::SwapFile *> &evicted)
+{
+    if (evicted.isEmpty()) return;
+
+    // the files can not be unmapped or resized meanwhile, as long as
+    // their m_releasing flag is set
+    for (Kwave::SwapFile *swap : evicted)
+        swap->release();
+
+    QMutexLocker lock(&m_lock);
+    for (Kwave::SwapFile *swap : evicted)
+        swap->m_releasing = false;
+    evicted.clear();
+    m_released.wakeAll();
+}
+
+//***************************************************************************
+void Kwave::MemoryManager::waitForRelease(Kwave::SwapFile *swap)
+{
+    while (swap && swap->m_releasing)
+        m_released.wait(&m_lock);
+}
+
+//***************************************************************************
+//***************************************************************************
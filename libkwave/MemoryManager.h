@@ -0,0 +1,198 @@
+/***************************************************************************
+        MemoryManager.h  -  Kwave memory management
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef MEMORY_MANAGER_H
+#define MEMORY_MANAGER_H
+
+#include "config.h"
+#include "libkwave_export.h"
+
+#include <atomic>
+
+#include <QtGlobal>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+namespace Kwave
+{
+
+    class SwapFile;
+
+    /**
+     * Manages the storage of sample data. Small amounts of samples are
+     * kept in physical memory (heap), as soon as the configured limit of
+     * physical memory is reached, new storage is allocated in memory
+     * mapped swap files. Swap files that have not been accessed for
+     * a while are written back to disk and their pages are released,
+     * so that the working set stays within the configured limit.
+     *
+     * All storage is accessed through plain pointers, so that users
+     * like Kwave::SampleArray do not need to know where the data lives.
+     * Only large blocks, like the storage of stripes, are put into swap
+     * files. Without a limit and without swap files, allocating,
+     * resizing and freeing does not lock.
+     */
+    class LIBKWAVE_EXPORT MemoryManager
+    {
+    public:
+
+        /** Constructor */
+        MemoryManager();
+
+        /** Destructor */
+        virtual ~MemoryManager();
+
+        /** returns the static instance of the memory manager */
+        static MemoryManager &instance();
+
+        /**
+         * Sets the limit of physical memory that can be used for samples.
+         * @param mb number of whole megabytes, zero means unlimited
+         *           (swap files disabled)
+         */
+        void setPhysicalLimit(quint64 mb);
+
+        /** returns the limit of physical memory in megabytes */
+        quint64 physicalLimit() const;
+
+        /**
+         * Sets the directory where swap files are created
+         * @param dir a directory with write access
+         */
+        void setSwapDirectory(const QString &dir);
+
+        /** returns the directory where swap files are created */
+        QString swapDirectory() const;
+
+        /**
+         * Allocates storage for samples, either in physical memory or
+         * in a swap file.
+         * @param size number of bytes to allocate
+         * @return pointer to the storage or null if out of memory
+         */
+        void *allocate(size_t size);
+
+        /**
+         * Resizes a block of storage, keeps the existing content.
+         * @param block pointer to the storage, allocated with allocate()
+         * @param old_size the current size of the block in bytes
+         * @param new_size the new size of the block in bytes, not zero
+         * @return pointer to the (maybe moved) block, or null if failed.
+         *         In the latter case the old block stays valid.
+         */
+        void *resize(void *block, size_t old_size, size_t new_size);
+
+        /**
+         * Frees a block of storage
+         * @param block pointer to the storage, allocated with allocate()
+         * @param size the current size of the block in bytes
+         */
+        void free(void *block, size_t size);
+
+        /**
+         * Marks a block as recently used. Blocks in swap files that have
+         * not been used for a long time will be evicted from physical
+         * memory if the limit is exceeded.
+         * @param block pointer to the storage, allocated with allocate()
+         */
+        void touch(const void *block);
+
+    private:
+
+        /**
+         * Allocates a new swap file, must be called with m_lock held
+         * @param size number of bytes
+         * @param evicted receives the swap files that have to be
+         *        released, @see evict()
+         * @return pointer to the mapped storage or null if failed
+         */
+        void *allocateSwap(size_t size, QList<Kwave::SwapFile *> &evicted);
+
+        /**
+         * Selects least recently used swap files for eviction from
+         * physical memory, until the working set fits into the limit.
+         * Must be called with m_lock held, the selected files have to
+         * be passed to release() after unlocking.
+         * @param evicted receives the swap files that have to be released
+         */
+        void evict(QList<Kwave::SwapFile *> &evicted);
+
+        /**
+         * Writes back and releases the pages of evicted swap files. Must
+         * be called without holding m_lock, as this might take a while.
+         * @param evicted list of swap files from evict(), will be cleared
+         */
+        void release(QList<Kwave::SwapFile *> &evicted);
+
+        /**
+         * Waits until a swap file is no longer being released by another
+         * thread. Must be called with m_lock held.
+         * @param swap the swap file
+         */
+        void waitForRelease(Kwave::SwapFile *swap);
+
+        /** returns the physical limit in bytes, zero if unlimited */
+        inline quint64 limitBytes() const { return m_physical_limit.load() << 20; }
+
+        /**
+         * Returns true if a block of a given size has to be put into a
+         * swap file, because it does not fit into the limit
+         * @param size number of bytes of the block
+         * @param freed number of bytes on the heap that are freed when
+         *        the block is stored
+         */
+        bool needsSwap(size_t size, size_t freed) const;
+
+    private:
+
+        /** mutex for serializing access to the internal lists */
+        mutable QMutex m_lock;
+
+        /** limit of physical memory [MB], zero means unlimited */
+        std::atomic<quint64> m_physical_limit;
+
+        /** directory for swap files */
+        QString m_swap_dir;
+
+        /** number of bytes allocated on the heap */
+        std::atomic<quint64> m_physical_used;
+
+        /** number of bytes in swap files assumed to be in physical memory */
+        quint64 m_mapped_resident;
+
+        /** map of all swap files, indexed by address of their storage */
+        QHash<const void *, Kwave::SwapFile *> m_swap_files;
+
+        /** swap files in physical memory, most recently used first */
+        QList<Kwave::SwapFile *> m_lru;
+
+        /** number of swap files, for checking without locking */
+        std::atomic<int> m_swap_count;
+
+        /** signalled when releasing of swap files has finished */
+        QWaitCondition m_released;
+
+    };
+}
+
+#endif /* MEMORY_MANAGER_H */
+
+//***************************************************************************
+//***************************************************************************
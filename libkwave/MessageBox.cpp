@@ -26,6 +26,8 @@
 #include <KMessageBox>
 
 #include "libkwave/MessageBox.h"
+#include "libkwave/String.h"
+#include "libkwave/Utils.h"
 
 //***************************************************************************
 Kwave::MessageBox::MessageBox(KMessageBox::DialogType mode, QWidget *parent,
@@ -140,6 +142,25 @@ int Kwave::MessageBox::exec(KMessageBox::DialogType mode, QWidget *parent,
     const QString &button1, const QString &button2,
     const QString &dontAskAgainName)
 {
+    if (Kwave::isHeadless()) {
+        // nobody can answer: only log the message and take the answer
+        // that lets a script go on, without saving anything on our own
+        qWarning("%s", DBG(message));
+        if (mode == KMessageBox::Error) Kwave::setFailed(true);
+        switch (mode) {
+            case KMessageBox::QuestionTwoActions: /* FALLTHROUGH */
+            case KMessageBox::WarningTwoActions:
+                return KMessageBox::PrimaryAction;
+            case KMessageBox::QuestionTwoActionsCancel: /* FALLTHROUGH */
+            case KMessageBox::WarningTwoActionsCancel:
+                return KMessageBox::SecondaryAction;
+            case KMessageBox::WarningContinueCancel:
+                return KMessageBox::Continue;
+            default:
+                return -1;
+        }
+    }
+
     Kwave::MessageBox box(
         mode, parent, message, caption,
         button1, button2,
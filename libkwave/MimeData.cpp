@@ -167,23 +167,20 @@ Kwave::MimeData::~MimeData()
 }
 
 //***************************************************************************
-bool Kwave::MimeData::encode(QWidget *widget,
-                             Kwave::MultiTrackReader &src,
-                             const Kwave::MetaDataList &meta_data)
+/**
+ * Prepares the meta data of a range of samples for the mime data, moved
+ * to start at zero, uncompressed and with the length of the range
+ * @param meta_data meta data of the whole signal
+ * @param first index of the first sample of the range
+ * @param last index of the last sample of the range
+ * @param tracks number of tracks
+ * @return the meta data for the range
+ */
+static Kwave::MetaDataList rangeMetaData(const Kwave::MetaDataList &meta_data,
+                                         sample_index_t first,
+                                         sample_index_t last,
+                                         unsigned int tracks)
 {
-    // use our default encoder
-    Kwave::Encoder *encoder = Kwave::CodecManager::encoder(_(WAVE_FORMAT_PCM));
-    Q_ASSERT(encoder);
-    if (!encoder) return false;
-
-    Q_ASSERT(src.tracks());
-    if (!src.tracks()) return false;
-
-    // set hourglass cursor
-    QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-
-    sample_index_t first = src.first();
-    sample_index_t last  = src.last();
     Kwave::MetaDataList new_meta_data = meta_data.selectByRange(first, last);
 
     // move all meta data left, to start at the beginning of the selection
@@ -194,21 +191,54 @@ bool Kwave::MimeData::encode(QWidget *widget,
     Kwave::FileInfo info(meta_data);
     info.set(Kwave::INF_COMPRESSION, QVariant(Kwave::Compression::NONE));
     info.setLength(last - first + 1);
-    info.setTracks(src.tracks());
+    info.setTracks(tracks);
     new_meta_data.replace(Kwave::MetaDataList(info));
 
+    return new_meta_data;
+}
+
+//***************************************************************************
+bool Kwave::MimeData::encode(QWidget *widget,
+                             Kwave::MultiTrackReader &src,
+                             const Kwave::MetaDataList &meta_data)
+{
+    Q_ASSERT(src.tracks());
+    if (!src.tracks()) return false;
+
+    m_stripes.clear();
+    m_meta_data.clear();
+
+    // encode into the buffer
+    bool succeeded = encodeBuffer(widget, src, rangeMetaData(
+        meta_data, src.first(), src.last(), src.tracks()));
+
+    // set the mime data into this mime data container
+    if (succeeded) setData(_(WAVE_FORMAT_PCM), m_buffer.byteArray());
+
+    return succeeded;
+}
+
+//***************************************************************************
+bool Kwave::MimeData::encodeBuffer(QWidget *widget,
+                                   Kwave::MultiTrackReader &src,
+                                   const Kwave::MetaDataList &meta_data)
+{
+    // use our default encoder
+    Kwave::Encoder *encoder = Kwave::CodecManager::encoder(_(WAVE_FORMAT_PCM));
+    Q_ASSERT(encoder);
+    if (!encoder) return false;
+
+    // set hourglass cursor
+    QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
     // encode into the buffer
     m_buffer.close(); // discard old stuff
-    encoder->encode(widget, src, m_buffer, new_meta_data);
+    encoder->encode(widget, src, m_buffer, meta_data);
 
     delete encoder;
 
-    // set the mime data into this mime data container
     bool succeeded = m_buffer.mapToByteArray();
-    if (succeeded) {
-        // mmap succeeded
-        setData(_(WAVE_FORMAT_PCM), m_buffer.byteArray());
-    } else {
+    if (!succeeded) {
         // failed to map memory
         m_buffer.close();
     }
@@ -219,11 +249,117 @@ bool Kwave::MimeData::encode(QWidget *widget,
     return succeeded;
 }
 
+//***************************************************************************
+bool Kwave::MimeData::store(Kwave::SignalManager &signal_manager,
+                            const QVector<unsigned int> &track_list,
+                            sample_index_t offset, sample_index_t length)
+{
+    clear();
+    if (!length || track_list.isEmpty()) return false;
+
+    // fork off a multi track stripe list, like the undo system does
+    const sample_index_t first = offset;
+    const sample_index_t last  = offset + length - 1;
+    m_stripes = signal_manager.stripes(track_list, first, last);
+    if (m_stripes.isEmpty())
+        return false; // retrieving the stripes failed
+
+    m_meta_data = rangeMetaData(signal_manager.metaData(), first, last,
+                                Kwave::toUint(track_list.count()));
+    return true;
+}
+
+//***************************************************************************
+QStringList Kwave::MimeData::formats() const
+{
+    if (m_stripes.isEmpty()) return QMimeData::formats();
+    return QStringList(_(WAVE_FORMAT_PCM));
+}
+
+//***************************************************************************
+bool Kwave::MimeData::hasFormat(const QString &mimetype) const
+{
+    return formats().contains(mimetype);
+}
+
+//***************************************************************************
+QVariant Kwave::MimeData::retrieveData(const QString &mimetype,
+                                       QMetaType type) const
+{
+    if (m_stripes.isEmpty() || (mimetype != _(WAVE_FORMAT_PCM)))
+        return QMimeData::retrieveData(mimetype, type);
+
+    // encode the stripes on the first request, e.g. from another application
+    if (!m_buffer.size()) {
+        Kwave::MimeData *self = const_cast<Kwave::MimeData *>(this);
+        Kwave::MultiTrackReader src(Kwave::SinglePassForward, m_stripes);
+        if (!self->encodeBuffer(nullptr, src, m_meta_data))
+            return QVariant();
+    }
+
+    return QVariant(m_buffer.byteArray());
+}
+
+//***************************************************************************
+bool Kwave::MimeData::canPasteStripes(Kwave::SignalManager &sig) const
+{
+    if (m_stripes.isEmpty() || !sig.tracks()) return false;
+
+    const Kwave::FileInfo info(m_meta_data);
+    return (sig.selectedTracks().count() == m_stripes.count()) &&
+           qFuzzyCompare(info.rate(), sig.rate());
+}
+
+//***************************************************************************
+sample_index_t Kwave::MimeData::pasteStripes(Kwave::SignalManager &sig,
+                                             sample_index_t pos) const
+{
+    const QVector<unsigned int> tracks = sig.selectedTracks();
+    const Kwave::Stripe::List &first = m_stripes.first();
+    const sample_index_t length = first.right() - first.left() + 1;
+
+    // move the stripes to the destination, they share their samples
+    QList<Kwave::Stripe::List> stripes;
+    for (const Kwave::Stripe::List &list : m_stripes) {
+        Kwave::Stripe::List moved(pos, pos + length - 1);
+        for (const Kwave::Stripe &stripe : list) {
+            Kwave::Stripe s(stripe);
+            s.setStart(stripe.start() - list.left() + pos);
+            moved.append(s);
+        }
+        stripes.append(moved);
+    }
+
+    // make room and merge the stripes into it, the undo data is the
+    // same as for inserting space
+    if (!sig.insertSpace(pos, length, tracks)) return 0;
+    if (!sig.mergeStripes(stripes, tracks)) {
+        qWarning("Kwave::MimeData::pasteStripes() FAILED [mergeStripes]");
+        return 0;
+    }
+
+    // add the meta data (e.g. labels etc), but not the file info
+    Kwave::MetaDataList meta_data(m_meta_data);
+    meta_data.shiftRight(0, pos);
+    meta_data.remove(meta_data.selectByType(
+        Kwave::FileInfo::metaDataType()));
+    sig.metaData().add(meta_data);
+
+    return length;
+}
+
 //***************************************************************************
 sample_index_t Kwave::MimeData::decode(QWidget *widget, const QMimeData *e,
                                         Kwave::SignalManager &sig,
                                         sample_index_t pos)
 {
+    // data from Kwave itself, with matching tracks and sample rate:
+    // merge the stripes directly, without encoding and decoding
+    const Kwave::MimeData *kwave_data =
+        qobject_cast<const Kwave::MimeData *>(e);
+    if (kwave_data && kwave_data->canPasteStripes(sig))
+        return kwave_data->pasteStripes(sig, pos);
+
     // decode, use the first format that matches
     sample_index_t decoded_length = 0;
     unsigned int   decoded_tracks = 0;
@@ -412,6 +548,8 @@ sample_index_t Kwave::MimeData::decode(QWidget *widget, const QMimeData *e,
 void Kwave::MimeData::clear()
 {
     m_buffer.close();
+    m_stripes.clear();
+    m_meta_data.clear();
 }
 
 //***************************************************************************
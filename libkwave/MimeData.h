@@ -24,10 +24,16 @@
 #include <QtGlobal>
 #include <QByteArray>
 #include <QIODevice>
+#include <QList>
 #include <QMimeData>
 #include <QObject>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
 
+#include "libkwave/MetaDataList.h"
 #include "libkwave/Sample.h"
+#include "libkwave/Stripe.h"
 #include "libkwave/Utils.h"
 
 class QWidget;
@@ -35,7 +41,6 @@ class QWidget;
 namespace Kwave
 {
 
-    class MetaDataList;
     class MultiTrackReader;
     class SignalManager;
 
@@ -63,6 +68,21 @@ namespace Kwave
                                 Kwave::MultiTrackReader &src,
                                 const Kwave::MetaDataList &meta_data);
 
+            /**
+             * Takes references to a range of samples of a signal, without
+             * copying or encoding them. The data is encoded only when
+             * requested through QMimeData::data(), a paste into a Kwave
+             * signal merges the stripes directly.
+             * @param signal_manager the SignalManager with the tracks
+             * @param track_list a list of indices of tracks
+             * @param offset first sample
+             * @param length number of samples
+             * @return true if successful
+             */
+            virtual bool store(Kwave::SignalManager &signal_manager,
+                               const QVector<unsigned int> &track_list,
+                               sample_index_t offset, sample_index_t length);
+
             /**
              * Decodes the encoded byte data of the given mime source and
              * initializes a MultiTrackReader.
@@ -81,6 +101,54 @@ namespace Kwave
              */
             virtual void clear();
 
+            /** @see QMimeData::formats() */
+            QStringList formats() const override;
+
+            /** @see QMimeData::hasFormat() */
+            bool hasFormat(const QString &mimetype) const override;
+
+        protected:
+
+            /**
+             * Encodes the stored stripes on the first request of the
+             * data, otherwise the same as QMimeData::retrieveData()
+             * @param mimetype the requested mime type
+             * @param type the requested type of the variant
+             * @return the data, or an invalid variant
+             */
+            QVariant retrieveData(const QString &mimetype,
+                                  QMetaType type) const override;
+
+        private:
+
+            /**
+             * Encodes wave data received from a MultiTrackReader into
+             * the internal buffer
+             * @see encode()
+             */
+            bool encodeBuffer(QWidget *widget,
+                              Kwave::MultiTrackReader &src,
+                              const Kwave::MetaDataList &meta_data);
+
+            /**
+             * Checks whether the stored stripes can be inserted into a
+             * signal, which needs the same number of tracks and the same
+             * sample rate
+             * @param sig signal that should receive the data
+             * @return true if pasteStripes() can be used
+             */
+            bool canPasteStripes(Kwave::SignalManager &sig) const;
+
+            /**
+             * Inserts the stored stripes into a signal, sharing their
+             * samples
+             * @param sig signal that receives the data
+             * @param pos position within the signal where to insert
+             * @return number of inserted samples, zero if failed
+             */
+            sample_index_t pasteStripes(Kwave::SignalManager &sig,
+                                        sample_index_t pos) const;
+
         private:
             /**
              * internal class for buffering huge amounts of mime data.
@@ -153,6 +221,12 @@ namespace Kwave
             /** buffer for the mime data (with swap file support) */
             Kwave::MimeData::Buffer m_buffer;
 
+            /** stripes of all tracks, if stored with store() */
+            QList<Kwave::Stripe::List> m_stripes;
+
+            /** meta data of the stored stripes, starting at zero */
+            Kwave::MetaDataList m_meta_data;
+
     };
 }
 
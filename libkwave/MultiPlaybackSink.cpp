@@ -17,11 +17,11 @@
 
 #include "config.h"
 
+#include <errno.h>
 #include <new>
 
 #include <QMutexLocker>
 #include <QtGlobal>
-#include <QThread>
 
 #include "libkwave/Connect.h"
 #include "libkwave/MultiPlaybackSink.h"
@@ -32,8 +32,7 @@ Kwave::MultiPlaybackSink::MultiPlaybackSink(unsigned int tracks,
                                             Kwave::PlayBackDevice *device)
     :Kwave::SampleSink(),
      m_tracks(tracks), m_device(device), m_in_buffer(tracks),
-     m_in_buffer_filled(tracks),
-     m_out_buffer(tracks), m_lock()
+     m_in_buffer_filled(tracks), m_lock()
 {
     m_in_buffer.fill(Kwave::SampleArray(0));
     m_in_buffer_filled.fill(false);
@@ -75,33 +74,23 @@ void Kwave::MultiPlaybackSink::input(unsigned int track,
     m_in_buffer_filled[track] = true;
 
     // copy the input data to the buffer
-    unsigned int samples = data.size();
     m_in_buffer[track] = data;
 
     // check if all buffers are filled
-    for (unsigned int t = 0; t < m_tracks; t++)
+    unsigned int samples = data.size();
+    for (unsigned int t = 0; t < m_tracks; t++) {
         if (!m_in_buffer_filled[t]) return;
+        samples = qMin(samples, m_in_buffer[t].size());
+    }
 
     // all tracks have left their data, now we are ready
-    // to convert the buffers into a big combined one
-    Q_ASSERT(m_out_buffer.size() >= m_tracks);
-    for (unsigned int sample = 0; sample < samples; sample++) {
-        for (unsigned int t = 0; t < m_tracks; t++) {
-            const Kwave::SampleArray &in = m_in_buffer[t];
-            m_out_buffer[t] = in[sample];
-        }
-
-        // play the output buffer
-        unsigned int retry = 5;
-        while (retry-- && !isCanceled()) {
-            int res = m_device->write(m_out_buffer);
-            if (res != 0) {
-                QThread::yieldCurrentThread();
-            } else break;
-        }
-        if (retry == 0)
-            break; // give up
-    }
+    // to play them as one block, the device continues with the rest
+    // of the block if it accepted only a part of it
+    int res = -EAGAIN;
+    while ((res == -EAGAIN) && !isCanceled())
+        res = m_device->writeBlock(m_in_buffer, samples);
+    if (res && (res != -EAGAIN))
+        qWarning("MultiPlaybackSink: writing to the device failed");
 
     m_in_buffer_filled.fill(false);
 }
@@ -83,9 +83,6 @@ namespace Kwave
         /** "filled"-flags for input buffers */
         QBitArray m_in_buffer_filled;
 
-        /** output buffer for all samples */
-        Kwave::SampleArray m_out_buffer;
-
         /** mutex for locking against reentrance */
         QMutex m_lock;
 
@@ -18,6 +18,8 @@
 
 #include "config.h"
 
+#include <new>
+
 #include "libkwave/MultiTrackReader.h"
 #include "libkwave/SampleReader.h"
 #include "libkwave/SignalManager.h"
@@ -50,6 +52,26 @@ Kwave::MultiTrackReader::MultiTrackReader(
     }
 }
 
+//***************************************************************************
+Kwave::MultiTrackReader::MultiTrackReader(
+    Kwave::ReaderMode mode,
+    const QList<Kwave::Stripe::List> &stripes)
+    :Kwave::MultiTrackSource<Kwave::SampleReader, false>(0, nullptr),
+     m_first(stripes.isEmpty() ? 0 : stripes.first().left()),
+     m_last(stripes.isEmpty()  ? 0 : stripes.first().right())
+{
+    unsigned int index = 0;
+
+    for (const Kwave::Stripe::List &list : stripes) {
+        Kwave::SampleReader *s =
+            new(std::nothrow) Kwave::SampleReader(mode, list);
+        Q_ASSERT(s);
+        if (!s) break;
+        insert(index++, s);
+        Q_ASSERT(index == tracks());
+    }
+}
+
 //***************************************************************************
 Kwave::MultiTrackReader::~MultiTrackReader()
 {
@@ -29,6 +29,7 @@
 
 #include "libkwave/MultiTrackSource.h"
 #include "libkwave/SampleReader.h"
+#include "libkwave/Stripe.h"
 
 namespace Kwave
 {
@@ -63,6 +64,15 @@ namespace Kwave
                          const QVector<unsigned int> &track_list,
                          sample_index_t first, sample_index_t last);
 
+        /**
+         * Constructor, for reading from stripes that have been forked
+         * off a signal before, e.g. by SignalManager::stripes()
+         * @param mode a reader mode, see Kwave::ReaderMode
+         * @param stripes list of stripe lists, one for each track
+         */
+        MultiTrackReader(Kwave::ReaderMode mode,
+                         const QList<Kwave::Stripe::List> &stripes);
+
         /** Destructor */
         ~MultiTrackReader() override;
 
@@ -23,12 +23,11 @@
 
 #include <new>
 
-#include <QFutureSynchronizer>
 #include <QList>
 #include <QObject>
-#include <QtConcurrentRun>
 
 #include "libkwave/SampleSource.h"
+#include "libkwave/WorkerPool.h"
 #include "modules/StreamObject.h"
 
 namespace Kwave
@@ -68,23 +67,22 @@ namespace Kwave
         }
 
         /**
-         * Calls goOn() for each track.
+         * Calls goOn() for each track, in parallel through the
+         * threads of the Kwave::WorkerPool.
          * @see Kwave::SampleSource::goOn()
          */
         void goOn() override
         {
             if (isCanceled()) return;
 
-            QFutureSynchronizer<void> synchronizer;
-            for (SOURCE *src : static_cast< QList<SOURCE *> >(*this)) {
-                if (!src) continue;
-                synchronizer.addFuture(QtConcurrent::run(
-                    &Kwave::MultiTrackSource<SOURCE, INITIALIZE>::runSource,
-                    this,
-                    src)
-                );
-            }
-            synchronizer.waitForFinished();
+            const QList<SOURCE *> &sources = *this;
+            Kwave::WorkerPool::instance().run(
+                static_cast<unsigned int>(sources.size()),
+                [&sources](unsigned int track) {
+                    SOURCE *src = sources.at(track);
+                    if (src) src->goOn();
+                }
+            );
         }
 
         /** Returns true when all sources are done */
@@ -163,13 +161,6 @@ namespace Kwave
                 delete QList<SOURCE *>::takeLast();
         }
 
-    private:
-
-        /** little wrapper for calling goOn() of a source in a worker thread */
-        void runSource(SOURCE *src) {
-            src->goOn();
-        }
-
     };
 
     /**
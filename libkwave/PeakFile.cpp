@@ -0,0 +1,235 @@
+/***************************************************************************
+           PeakFile.cpp  -  persistent cache of peak values of a file
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <vector>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include "libkwave/PeakFile.h"
+#include "libkwave/PeakPyramid.h"
+#include "libkwave/String.h"
+#include "libkwave/Track.h"
+#include "libkwave/Utils.h"
+
+/** magic number at the start of a peak file: "KWPK" */
+#define PEAK_FILE_MAGIC 0x4B57504BU
+
+/** version of the file format */
+#define PEAK_FILE_VERSION 1
+
+/** first level of the peak pyramid that is stored in the file */
+#define PEAK_FILE_FIRST_LEVEL 1
+
+/** minimum number of samples per track for using a peak file */
+#define PEAK_FILE_MIN_LENGTH (4UL * 1024UL * 1024UL)
+
+/** number of bytes at start and end of the audio file used for the hash */
+#define PEAK_FILE_HASH_BYTES (64 * 1024)
+
+//***************************************************************************
+Kwave::PeakFile::PeakFile(const QString &filename)
+    :m_filename(QFileInfo(filename).absoluteFilePath()), m_path()
+{
+    const QByteArray id = QCryptographicHash::hash(
+        m_filename.toUtf8(), QCryptographicHash::Sha1).toHex();
+    m_path = QStandardPaths::writableLocation(
+        QStandardPaths::CacheLocation) + _("/peaks/") +
+        QString::fromLatin1(id) + _(".peaks");
+}
+
+//***************************************************************************
+Kwave::PeakFile::~PeakFile()
+{
+}
+
+//***************************************************************************
+QString Kwave::PeakFile::path() const
+{
+    return m_path;
+}
+
+//***************************************************************************
+bool Kwave::PeakFile::isUseful(sample_index_t length)
+{
+    return (length >= PEAK_FILE_MIN_LENGTH);
+}
+
+//***************************************************************************
+QByteArray Kwave::PeakFile::key() const
+{
+    QFile file(m_filename);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+
+    const QFileInfo info(file);
+    const qint64 size = file.size();
+
+    // hash over the start and the end of the content
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(file.read(PEAK_FILE_HASH_BYTES));
+    if (size > 2 * PEAK_FILE_HASH_BYTES) {
+        file.seek(size - PEAK_FILE_HASH_BYTES);
+        hash.addData(file.read(PEAK_FILE_HASH_BYTES));
+    }
+    file.close();
+
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << size;
+    stream << info.lastModified().toMSecsSinceEpoch();
+    stream << hash.result();
+    return key;
+}
+
+//***************************************************************************
+bool Kwave::PeakFile::load(const QList<Kwave::Track *> &tracks,
+                           sample_index_t length)
+{
+    if (tracks.isEmpty() || !isUseful(length)) return false;
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32    magic   = 0;
+    quint32    version = 0;
+    QByteArray file_key;
+    stream >> magic >> version >> file_key;
+    if ((magic != PEAK_FILE_MAGIC) || (version != PEAK_FILE_VERSION))
+        return false;
+    if (file_key != key()) return false; // outdated
+
+    quint32 file_tracks = 0;
+    quint64 file_length = 0;
+    quint32 first_level = 0;
+    quint32 levels      = 0;
+    stream >> file_tracks >> file_length >> first_level >> levels;
+    if ((file_tracks != static_cast<quint32>(tracks.count())) ||
+        (file_length != length) || (first_level != PEAK_FILE_FIRST_LEVEL))
+        return false;
+
+    for (Kwave::Track *track : tracks) {
+        if (!track || (track->peakLevels() != levels)) return false;
+    }
+
+    // read the whole content before touching any track
+    typedef std::vector<std::vector<Kwave::PeakPyramid::Peak> > Levels;
+    std::vector<Levels> content(tracks.count());
+    for (Levels &track_levels : content) {
+        for (unsigned int level = first_level; level < levels; ++level) {
+            quint64 count = 0;
+            stream >> count;
+            if ((stream.status() != QDataStream::Ok) || (count > length))
+                break;
+
+            std::vector<Kwave::PeakPyramid::Peak> peaks(count);
+            for (Kwave::PeakPyramid::Peak &peak : peaks)
+                stream >> peak.min >> peak.max >> peak.power;
+            if (stream.status() != QDataStream::Ok) break;
+            track_levels.push_back(peaks);
+        }
+        if (track_levels.size() != levels - first_level) {
+            qWarning("PeakFile: '%s' is corrupt", DBG(m_path));
+            return false;
+        }
+    }
+
+    // all tracks have the same length and the same structure, so
+    // either all of them accept the content or none
+    for (int index = 0; index < tracks.count(); ++index) {
+        if (!tracks[index]->presetPeaks(first_level, content[index]))
+            return false;
+    }
+
+    for (Kwave::Track *track : tracks)
+        track->freezePeaks(true);
+    return true;
+}
+
+//***************************************************************************
+bool Kwave::PeakFile::save(const QList<Kwave::Stripe::List> &stripes,
+                           sample_index_t length)
+{
+    if (stripes.isEmpty() || !isUseful(length)) return false;
+
+    const QByteArray file_key = key();
+    if (file_key.isEmpty()) return false;
+
+    // the number of levels only depends on the length
+    Kwave::PeakPyramid shape([](sample_index_t, sample_index_t,
+                                Kwave::PeakPyramid::Peak &) { });
+    shape.resize(length);
+    const quint32 levels = shape.levels();
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning("PeakFile: unable to create '%s'", DBG(m_path));
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    stream << static_cast<quint32>(PEAK_FILE_MAGIC);
+    stream << static_cast<quint32>(PEAK_FILE_VERSION);
+    stream << file_key;
+    stream << static_cast<quint32>(stripes.count());
+    stream << static_cast<quint64>(length);
+    stream << static_cast<quint32>(PEAK_FILE_FIRST_LEVEL);
+    stream << levels;
+
+    for (const Kwave::Stripe::List &track_stripes : stripes) {
+        // the snapshot shares the samples, only the list is copied
+        Kwave::Stripe::List list(track_stripes);
+        Kwave::PeakPyramid pyramid([&list](sample_index_t first,
+            sample_index_t last, Kwave::PeakPyramid::Peak &peak) {
+            Kwave::Stripe::peaks(list.data(), list.count(), first, last,
+                                 peak.min, peak.max, peak.power);
+        });
+        pyramid.resize(length);
+
+        for (unsigned int level = PEAK_FILE_FIRST_LEVEL;
+             level < levels; ++level)
+        {
+            const std::vector<Kwave::PeakPyramid::Peak> peaks =
+                pyramid.level(level);
+            stream << static_cast<quint64>(peaks.size());
+            for (const Kwave::PeakPyramid::Peak &peak : peaks)
+                stream << peak.min << peak.max << peak.power;
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+//***************************************************************************
+//***************************************************************************
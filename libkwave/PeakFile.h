@@ -0,0 +1,119 @@
+/***************************************************************************
+             PeakFile.h  -  persistent cache of peak values of a file
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PEAK_FILE_H
+#define PEAK_FILE_H
+
+#include "config.h"
+#include "libkwave_export.h"
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "libkwave/PeakPyramid.h"
+#include "libkwave/Sample.h"
+#include "libkwave/Stripe.h"
+
+namespace Kwave
+{
+
+    class Track;
+
+    /**
+     * Sidecar file with the peak values (min/max/power) of all tracks
+     * of an audio file, at all decimation levels of Kwave::PeakPyramid
+     * except the finest one. The file is identified by size, time of
+     * last modification and a hash over the start and the end of its
+     * content. If everything matches when the file is opened again,
+     * the peak values are taken over into the tracks, so that overview
+     * and zoomed-out display are available before the decoder is done.
+     *
+     * Peak files are kept in the cache directory of the application,
+     * so the directory of the audio file does not need to be writable.
+     */
+    class LIBKWAVE_EXPORT PeakFile
+    {
+    public:
+        /**
+         * Constructor
+         * @param filename path of the audio file
+         */
+        explicit PeakFile(const QString &filename);
+
+        /** Destructor */
+        virtual ~PeakFile();
+
+        /** returns the path of the peak file */
+        QString path() const;
+
+        /**
+         * Checks whether a signal is long enough to be worth a peak file
+         * @param length number of samples per track
+         * @return true if a peak file should be used
+         */
+        static bool isUseful(sample_index_t length);
+
+        /**
+         * Loads the peak file into the peak caches of a list of tracks
+         * and freezes them, so that they survive the decoding. Unfreeze
+         * them with Kwave::Track::freezePeaks() when decoding is done.
+         * @param tracks list of tracks, already with their final length
+         * @param length number of samples per track
+         * @return true if succeeded, false if the file is missing,
+         *         outdated or does not match
+         */
+        bool load(const QList<Kwave::Track *> &tracks,
+                  sample_index_t length);
+
+        /**
+         * Computes the peak values of a snapshot of the tracks and writes
+         * them into the peak file. This scans all samples, but does not
+         * touch the tracks themselves, so it can run in a worker thread.
+         * @param stripes list of stripe lists, one per track, each from
+         *                the first to the last sample
+         * @param length number of samples per track
+         * @return true if succeeded
+         */
+        bool save(const QList<Kwave::Stripe::List> &stripes,
+                  sample_index_t length);
+
+    private:
+
+        /**
+         * Computes the identification of the current state of the
+         * audio file, consisting of size, modification time and a hash
+         * @return a key, empty if the file is not readable
+         */
+        QByteArray key() const;
+
+    private:
+
+        /** absolute path of the audio file */
+        QString m_filename;
+
+        /** path of the peak file */
+        QString m_path;
+
+    };
+}
+
+#endif /* PEAK_FILE_H */
+
+//***************************************************************************
+//***************************************************************************
@@ -0,0 +1,426 @@
+/***************************************************************************
+        PeakPyramid.cpp  -  multi-resolution min/max/power cache
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <QMutexLocker>
+
+#include "libkwave/PeakPyramid.h"
+
+/** number of samples per entry in the lowest level, as power of two */
+#define PEAK_BASE_SHIFT 8
+
+/** number of entries combined into one entry of the next level (2^n) */
+#define PEAK_LEVEL_SHIFT 4
+
+/** maximum number of levels */
+#define PEAK_MAX_LEVELS 14
+
+//***************************************************************************
+Kwave::PeakPyramid::PeakPyramid(Scanner scanner)
+    :m_lock(), m_scanner(scanner), m_length(0), m_levels(), m_frozen(false),
+     m_generation(0)
+{
+    resizeLevels();
+}
+
+//***************************************************************************
+Kwave::PeakPyramid::~PeakPyramid()
+{
+    QMutexLocker lock(&m_lock);
+    m_levels.clear();
+}
+
+//***************************************************************************
+sample_index_t Kwave::PeakPyramid::blockSize(unsigned int level)
+{
+    return sample_index_t(1) << (PEAK_BASE_SHIFT + level * PEAK_LEVEL_SHIFT);
+}
+
+//***************************************************************************
+sample_index_t Kwave::PeakPyramid::length()
+{
+    QMutexLocker lock(&m_lock);
+    return m_length;
+}
+
+//***************************************************************************
+void Kwave::PeakPyramid::resizeLevels()
+{
+    unsigned int levels = 1;
+    while ((levels < PEAK_MAX_LEVELS) && (blockSize(levels - 1) < m_length))
+        ++levels;
+    m_levels.resize(levels);
+
+    for (unsigned int level = 0; level < levels; ++level) {
+        const sample_index_t bs = blockSize(level);
+        const size_t count = static_cast<size_t>((m_length + bs - 1) / bs);
+        Level &l = m_levels[level];
+        l.peaks.resize(count);
+        l.valid.resize(count, false);
+    }
+}
+
+//***************************************************************************
+void Kwave::PeakPyramid::invalidateFrom(sample_index_t offset)
+{
+    for (unsigned int level = 0; level < m_levels.size(); ++level) {
+        Level &l = m_levels[level];
+        const size_t count = l.valid.size();
+        for (size_t i = static_cast<size_t>(offset / blockSize(level));
+             i < count; ++i)
+            l.valid[i] = false;
+    }
+}
+
+//***************************************************************************
+void Kwave::PeakPyramid::resize(sample_index_t length)
+{
+    QMutexLocker lock(&m_lock);
+    if (length == m_length) return;
+
+    ++m_generation;
+    invalidateFrom(qMin(length, m_length));
+    m_length = length;
+    resizeLevels();
+}
+
+//***************************************************************************
+void Kwave::PeakPyramid::insert(sample_index_t offset, sample_index_t length)
+{
+    if (!length) return;
+    QMutexLocker lock(&m_lock);
+
+    ++m_generation;
+    if (offset < m_length) {
+        for (unsigned int level = 0; level < m_levels.size(); ++level) {
+            const sample_index_t bs = blockSize(level);
+            if ((offset % bs) || (length % bs)) {
+                // not aligned to the blocks -> everything after is invalid
+                Level &l = m_levels[level];
+                for (size_t i = static_cast<size_t>(offset / bs);
+                     i < l.valid.size(); ++i)
+                    l.valid[i] = false;
+                continue;
+            }
+
+            // aligned: move the existing entries right
+            Level &l = m_levels[level];
+            const size_t pos   = static_cast<size_t>(offset / bs);
+            const size_t count = static_cast<size_t>(length / bs);
+            l.peaks.insert(l.peaks.begin() + pos, count, Peak());
+            l.valid.insert(l.valid.begin() + pos, count, false);
+        }
+        m_length += length;
+    } else {
+        // insert after the end, like a resize
+        invalidateFrom(m_length);
+        m_length = offset + length;
+    }
+
+    resizeLevels();
+}
+
+//***************************************************************************
+void Kwave::PeakPyramid::remove(sample_index_t offset, sample_index_t length)
+{
+    QMutexLocker lock(&m_lock);
+    if (offset >= m_length) return;
+    if (length > m_length - offset) length = m_length - offset;
+    if (!length) return;
+
+    ++m_generation;
+    for (unsigned int level = 0; level < m_levels.size(); ++level) {
+        const sample_index_t bs = blockSize(level);
+        Level &l = m_levels[level];
+        if ((offset % bs) || (length % bs)) {
+            // not aligned to the blocks -> everything after is invalid
+            for (size_t i = static_cast<size_t>(offset / bs);
+                 i < l.valid.size(); ++i)
+                l.valid[i] = false;
+            continue;
+        }
+
+        // aligned: move the following entries left
+        const size_t pos   = static_cast<size_t>(offset / bs);
+        const size_t count = static_cast<size_t>(length / bs);
+        l.peaks.erase(l.peaks.begin() + pos, l.peaks.begin() + pos + count);
+        l.valid.erase(l.valid.begin() + pos, l.valid.begin() + pos + count);
+    }
+    m_length -= length;
+
+    resizeLevels();
+}
+
+//***************************************************************************
+void Kwave::PeakPyramid::invalidate(sample_index_t offset,
+                                    sample_index_t length)
+{
+    if (!length) return;
+    QMutexLocker lock(&m_lock);
+    if (m_frozen || (offset >= m_length)) return;
+
+    ++m_generation;
+    const sample_index_t last = offset + length - 1;
+    for (unsigned int level = 0; level < m_levels.size(); ++level) {
+        const sample_index_t bs = blockSize(level);
+        Level &l = m_levels[level];
+        if (l.valid.empty()) continue;
+        const size_t first_idx = static_cast<size_t>(offset / bs);
+        const size_t last_idx  = static_cast<size_t>(
+            qMin<sample_index_t>(last / bs, l.valid.size() - 1));
+        for (size_t i = first_idx; i <= last_idx; ++i)
+            l.valid[i] = false;
+    }
+}
+
+//***************************************************************************
+const Kwave::PeakPyramid::Peak &Kwave::PeakPyramid::entry(unsigned int level,
+                                                         quint64 index)
+{
+    Level &l = m_levels[level];
+    if (l.valid[index]) return l.peaks[index];
+
+    Peak peak;
+    if (!level) {
+        // lowest level: scan the raw samples
+        const sample_index_t start = index << PEAK_BASE_SHIFT;
+        const sample_index_t end   = qMin(start + blockSize(0), m_length) - 1;
+        m_scanner(start, end, peak);
+    } else {
+        // combine the entries of the level below
+        const quint64 count = m_levels[level - 1].peaks.size();
+        const quint64 first = index << PEAK_LEVEL_SHIFT;
+        const quint64 last  = qMin<quint64>(
+            first + (1 << PEAK_LEVEL_SHIFT), count);
+        for (quint64 i = first; i < last; ++i)
+            peak.add(entry(level - 1, i));
+    }
+
+    l.peaks[index] = peak;
+    l.valid[index] = true;
+    return l.peaks[index];
+}
+
+//***************************************************************************
+void Kwave::PeakPyramid::queryLevel(unsigned int level,
+                                    sample_index_t first,
+                                    sample_index_t last,
+                                    Peak &peak)
+{
+    const sample_index_t bs = blockSize(level);
+    for (quint64 index = first / bs; index <= last / bs; ++index) {
+        const sample_index_t start = index * bs;
+        const sample_index_t end   = qMin(start + bs, m_length) - 1;
+        const sample_index_t left  = qMax(first, start);
+        const sample_index_t right = qMin(last,  end);
+
+        if ((left == start) && (right == end))
+            peak.add(entry(level, index));   // completely covered
+        else if (level)
+            queryLevel(level - 1, left, right, peak); // partially covered
+        else
+            m_scanner(left, right, peak);    // partial block of raw samples
+    }
+}
+
+//***************************************************************************
+Kwave::PeakPyramid::Peak Kwave::PeakPyramid::query(sample_index_t first,
+                                                   sample_index_t last)
+{
+    QMutexLocker lock(&m_lock);
+
+    Peak peak;
+    if (first >= m_length) return peak;
+    if (last >= m_length) last = m_length - 1;
+    if (last < first) return peak;
+
+    // use the coarsest level with blocks that fit into the range
+    const sample_index_t length = last - first + 1;
+    unsigned int level = 0;
+    while ((level + 1 < m_levels.size()) && (blockSize(level + 1) <= length))
+        ++level;
+
+    queryLevel(level, first, last, peak);
+    return peak;
+}
+
+//***************************************************************************
+void Kwave::PeakPyramid::collectMissing(unsigned int level, quint64 index,
+                                        std::vector<quint64> &blocks)
+{
+    if (m_levels[level].valid[index]) return;
+    if (!level) {
+        blocks.push_back(index);
+        return;
+    }
+
+    const quint64 count = m_levels[level - 1].peaks.size();
+    const quint64 first = index << PEAK_LEVEL_SHIFT;
+    const quint64 last  = qMin<quint64>(first + (1 << PEAK_LEVEL_SHIFT), count);
+    for (quint64 i = first; i < last; ++i)
+        collectMissing(level - 1, i, blocks);
+}
+
+//***************************************************************************
+void Kwave::PeakPyramid::collectMissing(unsigned int level,
+                                        sample_index_t first,
+                                        sample_index_t last,
+                                        std::vector<quint64> &blocks)
+{
+    // same traversal as queryLevel()
+    const sample_index_t bs = blockSize(level);
+    for (quint64 index = first / bs; index <= last / bs; ++index) {
+        const sample_index_t start = index * bs;
+        const sample_index_t end   = qMin(start + bs, m_length) - 1;
+        const sample_index_t left  = qMax(first, start);
+        const sample_index_t right = qMin(last,  end);
+
+        if ((left == start) && (right == end))
+            collectMissing(level, index, blocks);
+        else if (level)
+            collectMissing(level - 1, left, right, blocks);
+    }
+}
+
+//***************************************************************************
+std::vector<quint64> Kwave::PeakPyramid::missing(sample_index_t first,
+                                                 sample_index_t last)
+{
+    QMutexLocker lock(&m_lock);
+
+    std::vector<quint64> blocks;
+    if (first >= m_length) return blocks;
+    if (last >= m_length) last = m_length - 1;
+    if (last < first) return blocks;
+
+    const sample_index_t length = last - first + 1;
+    unsigned int level = 0;
+    while ((level + 1 < m_levels.size()) && (blockSize(level + 1) <= length))
+        ++level;
+
+    collectMissing(level, first, last, blocks);
+    return blocks;
+}
+
+//***************************************************************************
+std::vector<quint64> Kwave::PeakPyramid::missing(unsigned int level)
+{
+    QMutexLocker lock(&m_lock);
+
+    std::vector<quint64> blocks;
+    if (level >= m_levels.size()) return blocks;
+
+    const size_t count = m_levels[level].peaks.size();
+    for (size_t index = 0; index < count; ++index)
+        collectMissing(level, index, blocks);
+    return blocks;
+}
+
+//***************************************************************************
+quint64 Kwave::PeakPyramid::generation()
+{
+    QMutexLocker lock(&m_lock);
+    return m_generation;
+}
+
+//***************************************************************************
+bool Kwave::PeakPyramid::fill(const std::vector<quint64> &blocks,
+                              const std::vector<Peak> &peaks,
+                              quint64 generation)
+{
+    QMutexLocker lock(&m_lock);
+    if ((generation != m_generation) || m_levels.empty()) return false;
+    Q_ASSERT(blocks.size() == peaks.size());
+    if (blocks.size() != peaks.size()) return false;
+
+    Level &l = m_levels[0];
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const quint64 index = blocks[i];
+        if (index >= l.peaks.size()) return false;
+        l.peaks[index] = peaks[i];
+        l.valid[index] = true;
+    }
+    return true;
+}
+
+//***************************************************************************
+sample_index_t Kwave::PeakPyramid::blockStart(quint64 index)
+{
+    return index << PEAK_BASE_SHIFT;
+}
+
+//***************************************************************************
+unsigned int Kwave::PeakPyramid::levels()
+{
+    QMutexLocker lock(&m_lock);
+    return static_cast<unsigned int>(m_levels.size());
+}
+
+//***************************************************************************
+std::vector<Kwave::PeakPyramid::Peak> Kwave::PeakPyramid::level(
+    unsigned int level)
+{
+    QMutexLocker lock(&m_lock);
+    if (level >= m_levels.size()) return std::vector<Peak>();
+
+    const size_t count = m_levels[level].peaks.size();
+    for (size_t index = 0; index < count; ++index)
+        entry(level, index);
+    return m_levels[level].peaks;
+}
+
+//***************************************************************************
+bool Kwave::PeakPyramid::preset(unsigned int first_level,
+    const std::vector<std::vector<Peak> > &levels)
+{
+    QMutexLocker lock(&m_lock);
+    if (first_level + levels.size() > m_levels.size()) return false;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        if (levels[i].size() != m_levels[first_level + i].peaks.size())
+            return false;
+    }
+
+    for (size_t i = 0; i < levels.size(); ++i) {
+        Level &l = m_levels[first_level + i];
+        l.peaks = levels[i];
+        l.valid.assign(l.valid.size(), true);
+        l.preset = true;
+    }
+    return true;
+}
+
+//***************************************************************************
+void Kwave::PeakPyramid::setFrozen(bool frozen, bool keep_preset)
+{
+    QMutexLocker lock(&m_lock);
+    if (frozen == m_frozen) return;
+    m_frozen = frozen;
+    if (frozen) return;
+
+    ++m_generation;
+    // entries of levels that were not preset might have been computed
+    // from incomplete data
+    for (Level &l : m_levels) {
+        if (!l.preset || !keep_preset)
+            l.valid.assign(l.valid.size(), false);
+        l.preset = false;
+    }
+}
+
+//***************************************************************************
+//***************************************************************************
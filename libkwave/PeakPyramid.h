@@ -0,0 +1,289 @@
+/***************************************************************************
+          PeakPyramid.h  -  multi-resolution min/max/power cache
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PEAK_PYRAMID_H
+#define PEAK_PYRAMID_H
+
+#include "config.h"
+#include "libkwave_export.h"
+
+#include <functional>
+#include <vector>
+
+#include <QtGlobal>
+#include <QMutex>
+
+#include "libkwave/Sample.h"
+
+namespace Kwave
+{
+
+    /**
+     * Multi-resolution cache with minimum, maximum and power of a track.
+     *
+     * The lowest level holds one entry per block of 256 samples, each
+     * following level combines 16 entries of the level below. Entries
+     * are computed on demand and invalidated by range when the samples
+     * are modified, inserted or deleted. A query for a range of samples
+     * uses the coarsest level that fits into the range and descends only
+     * at the borders, so the costs do not depend on the length of
+     * the range.
+     */
+    class LIBKWAVE_EXPORT PeakPyramid
+    {
+    public:
+
+        /** minimum, maximum and sum of squares of a range of samples */
+        class Peak
+        {
+        public:
+            /** Constructor, creates an empty peak */
+            Peak() :min(SAMPLE_MAX), max(SAMPLE_MIN), power(0.0) { }
+
+            /** returns true if no samples have been added */
+            inline bool isEmpty() const { return (min > max); }
+
+            /** combines this peak with another one */
+            inline void add(const Peak &other) {
+                if (other.min < min) min = other.min;
+                if (other.max > max) max = other.max;
+                power += other.power;
+            }
+
+            /** lowest sample value */
+            sample_t min;
+
+            /** highest sample value */
+            sample_t max;
+
+            /** sum of the squares of all samples */
+            double power;
+        };
+
+        /**
+         * Function that scans a range of raw samples and adds them
+         * to a peak.
+         */
+        typedef std::function<void(sample_index_t first, sample_index_t last,
+                                   Kwave::PeakPyramid::Peak &peak)> Scanner;
+
+        /**
+         * Constructor
+         * @param scanner function for scanning raw samples
+         */
+        explicit PeakPyramid(Scanner scanner);
+
+        /** Destructor */
+        virtual ~PeakPyramid();
+
+        /** returns the number of samples covered by the pyramid */
+        sample_index_t length();
+
+        /**
+         * Sets a new length, invalidates everything after the
+         * shorter of the old and the new length.
+         * @param length the new number of samples
+         */
+        void resize(sample_index_t length);
+
+        /**
+         * Handles an insertion of samples
+         * @param offset position of the first inserted sample
+         * @param length number of samples inserted
+         */
+        void insert(sample_index_t offset, sample_index_t length);
+
+        /**
+         * Handles a deletion of samples
+         * @param offset position of the first deleted sample
+         * @param length number of samples deleted
+         */
+        void remove(sample_index_t offset, sample_index_t length);
+
+        /**
+         * Marks a range of samples as modified
+         * @param offset position of the first modified sample
+         * @param length number of modified samples
+         */
+        void invalidate(sample_index_t offset, sample_index_t length);
+
+        /**
+         * Returns minimum, maximum and power of a range of samples
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @return a peak, empty if the range is outside of the pyramid
+         */
+        Peak query(sample_index_t first, sample_index_t last);
+
+        /**
+         * Returns the index of all blocks of the lowest level that have
+         * to be scanned for a query, without the partial blocks at the
+         * borders. Together with generation() and fill() this allows
+         * scanning the samples without holding any lock.
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @return list of block indices, in ascending order
+         */
+        std::vector<quint64> missing(sample_index_t first,
+                                     sample_index_t last);
+
+        /**
+         * Returns the index of all blocks of the lowest level that have
+         * to be scanned for getting all entries of a level
+         * @see missing(sample_index_t, sample_index_t)
+         * @param level index of the level, zero is the finest one
+         * @return list of block indices, in ascending order
+         */
+        std::vector<quint64> missing(unsigned int level);
+
+        /**
+         * Returns a counter that changes whenever samples are modified,
+         * inserted or deleted
+         */
+        quint64 generation();
+
+        /**
+         * Takes over entries of the lowest level that have been scanned
+         * without holding a lock, but only if the samples have not been
+         * modified since then.
+         * @param blocks list of block indices, from missing()
+         * @param peaks list of entries, one per block index
+         * @param generation value of generation() when the samples to
+         *                   scan have been taken
+         * @return true if the entries have been taken over
+         */
+        bool fill(const std::vector<quint64> &blocks,
+                  const std::vector<Peak> &peaks, quint64 generation);
+
+        /** returns the number of levels */
+        unsigned int levels();
+
+        /**
+         * Returns the first sample of a block of the lowest level
+         * @param index the index of the block
+         */
+        static sample_index_t blockStart(quint64 index);
+
+        /**
+         * Returns all entries of one level, computes missing ones
+         * @param level index of the level, zero is the finest one
+         * @return list of entries, empty if the level does not exist
+         */
+        std::vector<Peak> level(unsigned int level);
+
+        /**
+         * Takes over all entries of some levels from an external source,
+         * like a peak file. The entries are treated as valid. Either all
+         * levels are taken over or none.
+         * @param first_level index of the first level to set
+         * @param levels list of levels, each with a list of entries that
+         *               must match the number of entries of the level
+         * @return true if succeeded, false if the sizes did not match
+         */
+        bool preset(unsigned int first_level,
+                    const std::vector<std::vector<Peak> > &levels);
+
+        /**
+         * Freezes the pyramid, so that modifications of samples do not
+         * invalidate any entries. This is used while a file is decoded
+         * into a track that already got its entries from a peak file.
+         * When unfreezing, all levels that have not been preset are
+         * invalidated.
+         * @param frozen true to freeze, false to unfreeze
+         * @param keep_preset if false, the levels that have been preset
+         *        are invalidated too when unfreezing, e.g. because the
+         *        decoder failed and the samples do not match them
+         */
+        void setFrozen(bool frozen, bool keep_preset = true);
+
+    private:
+
+        /** one level of the pyramid */
+        struct Level
+        {
+            /** cached entries */
+            std::vector<Peak> peaks;
+
+            /** validity of the cached entries */
+            std::vector<bool> valid;
+
+            /** true if the entries have been set through preset() */
+            bool preset = false;
+        };
+
+        /** returns the number of samples per entry in a level */
+        static sample_index_t blockSize(unsigned int level);
+
+        /** marks all entries from a given sample position on as invalid */
+        void invalidateFrom(sample_index_t offset);
+
+        /** adjusts number of levels and entries to the current length */
+        void resizeLevels();
+
+        /** returns an entry of a level, computes it if necessary */
+        const Peak &entry(unsigned int level, quint64 index);
+
+        /**
+         * appends the blocks of the lowest level that are needed for
+         * computing an entry of a level
+         */
+        void collectMissing(unsigned int level, quint64 index,
+                            std::vector<quint64> &blocks);
+
+        /**
+         * appends the blocks of the lowest level that are needed for
+         * a query, using the given level and the ones below
+         */
+        void collectMissing(unsigned int level,
+                            sample_index_t first, sample_index_t last,
+                            std::vector<quint64> &blocks);
+
+        /**
+         * adds a range of samples to a peak, using the given level
+         * and the ones below
+         */
+        void queryLevel(unsigned int level,
+                        sample_index_t first, sample_index_t last,
+                        Peak &peak);
+
+    private:
+
+        /** mutex for serializing access */
+        QMutex m_lock;
+
+        /** function for scanning raw samples */
+        Scanner m_scanner;
+
+        /** number of samples */
+        sample_index_t m_length;
+
+        /** list of levels, finest first */
+        std::vector<Level> m_levels;
+
+        /** if true, invalidate() is ignored */
+        bool m_frozen;
+
+        /** incremented on each modification, see generation() */
+        quint64 m_generation;
+
+    };
+}
+
+#endif /* PEAK_PYRAMID_H */
+
+//***************************************************************************
+//***************************************************************************
@@ -23,13 +23,15 @@
 #include <QList>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include "libkwave/Sample.h"
+#include "libkwave/SampleArray.h"
 #include "libkwave/String.h"
+#include "libkwave/Utils.h"
 
 namespace Kwave
 {
-    class SampleArray;
 
     /**
      * Abstract base class for all kinds of playback devices.
@@ -76,6 +78,41 @@ namespace Kwave
          */
         virtual int write(const Kwave::SampleArray &samples) = 0;
 
+        /**
+         * Writes a block of samples to the output device, with one array
+         * per output channel. Devices should override this and encode
+         * the whole block at once, the default implementation passes it
+         * frame by frame to write().
+         * @param channels one array per output channel, each with at least
+         *                 <c>length</c> samples
+         * @param length number of samples per channel
+         * @return 0 if successful, -EAGAIN if the block has been written
+         *         only partially and the caller should repeat the call
+         *         with the same block, the device then continues with the
+         *         rest of it, or another error code if failed
+         */
+        virtual int writeBlock(const QVector<Kwave::SampleArray> &channels,
+                               unsigned int length)
+        {
+            const unsigned int tracks = Kwave::toUint(channels.count());
+            Kwave::SampleArray frame(tracks);
+            for (unsigned int i = 0; i < length; ++i) {
+                for (unsigned int c = 0; c < tracks; ++c)
+                    frame[c] = channels[c][i];
+                int result = write(frame);
+                if (result) return result;
+            }
+            return 0;
+        }
+
+        /**
+         * Returns the number of samples per channel that the device
+         * would like to get with one call to writeBlock(), e.g. the
+         * period size of the hardware
+         * @return number of samples, or zero if unknown
+         */
+        virtual unsigned int periodSize() const { return 0; }
+
         /**
          * Closes the output device.
          */
@@ -17,8 +17,10 @@
 
 #include "config.h"
 
+#include <errno.h>
 #include <math.h>
 #include <new>
+#include <vector>
 
 #include <QMutexLocker>
 
@@ -39,13 +41,19 @@
 /** Sets the number of screen refreshes per second when in playback mode */
 #define SCREEN_REFRESHES_PER_SECOND 25
 
+/** lower limit of the number of frames rendered per period */
+#define MIN_PERIOD_FRAMES 64
+
+/** upper limit of the number of frames rendered per period */
+#define MAX_PERIOD_FRAMES 16384
+
 //***************************************************************************
 Kwave::PlaybackController::PlaybackController(
     Kwave::SignalManager &signal_manager
 )
     :m_signal_manager(signal_manager), m_thread(this, QVariant()),
      m_device(nullptr), m_lock_device(), m_playback_params(),
-     m_lock_playback(), m_should_seek(false), m_seek_pos(0),
+     m_should_seek(false), m_seek_pos(0),
      m_track_selection_changed(false),
      m_reload_mode(false), m_loop_mode(false), m_paused(false),
      m_playing(false), m_playback_position(0), m_playback_start(0),
@@ -173,12 +181,9 @@ void Kwave::PlaybackController::seekTo(sample_index_t pos)
     if (pos < m_playback_start) pos = m_playback_start;
     if (pos > m_playback_end)   pos = m_playback_end;
 
-    {
-        QMutexLocker lock(&m_lock_playback);
-        qDebug("seekTo(%llu)", pos);
-        m_seek_pos    = pos;
-        m_should_seek = true;
-    }
+    qDebug("seekTo(%llu)", pos);
+    m_seek_pos.store(pos);
+    m_should_seek.store(true);
 
     if (m_paused) {
         // if playback is paused, we want an update of the playback
@@ -390,8 +395,59 @@ void Kwave::PlaybackController::stopDevicePlayBack()
 //***************************************************************************
 void Kwave::PlaybackController::trackSelectionChanged()
 {
-    QMutexLocker lock(&m_lock_playback);
-    m_track_selection_changed = true;
+    m_track_selection_changed.store(true);
+}
+
+//***************************************************************************
+/**
+ * Determines the number of frames that are rendered in one period,
+ * derived from the buffer size of the playback device. Used if the
+ * device does not report a period size of its own.
+ * @param params the playback parameters
+ * @return number of frames per period
+ */
+static unsigned int periodFrames(const Kwave::PlayBackParam &params)
+{
+    const unsigned int bytes_per_frame = qMax(1U, params.channels) *
+        qMax(1U, (params.bits_per_sample + 7) >> 3);
+    const unsigned int bufbase = qBound(8U, params.bufbase, 24U);
+    unsigned int frames = (1U << bufbase) / bytes_per_frame;
+    return qBound<unsigned int>(MIN_PERIOD_FRAMES, frames, MAX_PERIOD_FRAMES);
+}
+
+//***************************************************************************
+/**
+ * Mixes a block of input tracks into one output channel.
+ *
+ * @param inputs list of input blocks, one per audible track
+ * @param gain column of the mixer matrix, one factor per input
+ * @param acc temporary accumulator with at least <c>length</c> elements
+ * @param output receives the mixed samples
+ * @param length number of frames to mix
+ */
+static void mixBlock(const QVector<Kwave::SampleArray> &inputs,
+                     const float *gain, float *acc,
+                     Kwave::SampleArray &output, unsigned int length)
+{
+    sample_t *out = output.data();
+    Q_ASSERT(out);
+    if (!out) return;
+
+    for (unsigned int i = 0; i < length; ++i)
+        acc[i] = 0.0f;
+
+    // single precision is sufficient for 24 bit samples and lets the
+    // compiler vectorize the inner loops
+    for (int x = 0; x < inputs.count(); ++x) {
+        const float g = gain[x];
+        if (g == 0.0f) continue;
+        const sample_t *in = inputs[x].constData();
+        for (unsigned int i = 0; i < length; ++i)
+            acc[i] += static_cast<float>(in[i]) * g;
+    }
+
+    for (unsigned int i = 0; i < length; ++i)
+        out[i] = static_cast<sample_t>(acc[i]);
 }
 
 //***************************************************************************
@@ -403,12 +459,17 @@ void Kwave::PlaybackController::run_wrapper(const QVariant &params)
     sample_index_t first      = m_playback_start;
     sample_index_t last       = m_playback_end;
     unsigned int out_channels = m_playback_params.channels;
+    const unsigned int device_period = (m_device) ?
+        m_device->periodSize() : 0;
+    const unsigned int period = (device_period) ?
+        qBound<unsigned int>(MIN_PERIOD_FRAMES, device_period,
+                             MAX_PERIOD_FRAMES) :
+        periodFrames(m_playback_params);
 
     QVector<unsigned int> all_tracks = m_signal_manager.allTracks();
     unsigned int tracks = static_cast<unsigned int>(all_tracks.count());
-    QVector<unsigned int> audible_tracks = m_signal_manager.selectedTracks();
-    unsigned int audible_count =
-        static_cast<unsigned int>(audible_tracks.count());
+    QVector<unsigned int> audible_tracks;
+    unsigned int audible_count = 0;
 
     // get the list of selected channels
     if (!tracks || !m_device) {
@@ -425,16 +486,25 @@ void Kwave::PlaybackController::run_wrapper(const QVariant &params)
 
     // create a new translation matrix for mixing up/down to the desired
     // number of output channels
-    m_track_selection_changed = false;
+    m_track_selection_changed.store(false);
+
+    // buffers for one period: one block per audible input track, one
+    // block per output channel and a mixing accumulator
+    QVector<Kwave::SampleArray> in_blocks;
+    QVector<Kwave::SampleArray> out_blocks(out_channels);
+    for (Kwave::SampleArray &block : out_blocks)
+        block.resize(period);
+    std::vector<float> gains;
+    std::vector<float> acc(period);
 
     // loop until process is stopped
     // or run once if not in loop mode
-    Kwave::SampleArray in_samples(tracks);
-    Kwave::SampleArray out_samples(out_channels);
     sample_index_t pos = m_playback_position;
     updatePlaybackPos(pos);
 
     // counter for refresh of the playback position
+    const unsigned int pos_interval = qMax(1U, Kwave::toUint(ceil(
+        m_playback_params.rate / SCREEN_REFRESHES_PER_SECOND)));
     unsigned int pos_countdown = 0;
 
     do {
@@ -442,39 +512,46 @@ void Kwave::PlaybackController::run_wrapper(const QVariant &params)
         // samples (this happens when resuming after a pause)
         if (pos > first) input.skip(pos - first);
 
-        while ((pos++ <= last) && !m_thread.isInterruptionRequested()) {
-            unsigned int x;
-            unsigned int y;
+        while ((pos <= last) && !m_thread.isInterruptionRequested()) {
             bool seek_again = false;
             bool seek_done  = false;
 
-            {
-                QMutexLocker _lock(&m_lock_playback);
-
-                // check for track selection change (need for new mixer)
-                if (m_track_selection_changed) {
-                    delete mixer;
-                    mixer = nullptr;
-                    m_track_selection_changed = false;
-                }
+            // check for track selection change (need for new mixer)
+            if (m_track_selection_changed.exchange(false)) {
+                delete mixer;
+                mixer = nullptr;
+            }
 
-                if (!mixer) {
-                    audible_tracks = m_signal_manager.selectedTracks();
-                    audible_count  =
-                        static_cast<unsigned int>(audible_tracks.count());
-                    mixer = new(std::nothrow)
-                        Kwave::MixerMatrix(audible_count, out_channels);
-                    Q_ASSERT(mixer);
-                    if (!mixer) break;
-                    seek_again = true; // re-synchronize all reader positions
-                }
+            if (!mixer) {
+                audible_tracks = m_signal_manager.selectedTracks();
+                audible_count  =
+                    static_cast<unsigned int>(audible_tracks.count());
+                mixer = new(std::nothrow)
+                    Kwave::MixerMatrix(audible_count, out_channels);
+                Q_ASSERT(mixer);
+                if (!mixer) break;
+
+                // transpose the matrix into one row of gains per output
+                gains.assign(out_channels * audible_count, 0.0f);
+                for (unsigned int y = 0; y < out_channels; ++y)
+                    for (unsigned int x = 0; x < audible_count; ++x)
+                        gains[y * audible_count + x] =
+                            static_cast<float>((*mixer)[x][y]);
+
+                in_blocks.resize(audible_count);
+                for (Kwave::SampleArray &block : in_blocks)
+                    block.resize(period);
+
+                seek_again = true; // re-synchronize all reader positions
+            }
 
-                // check for seek requests
-                if (m_should_seek && (m_seek_pos != pos)) {
-                    if (m_seek_pos < first) m_seek_pos = first;
-                    if (m_seek_pos > last)  { pos = last; break; }
-                    pos = m_seek_pos;
-                    m_should_seek = false;
+            // check for seek requests
+            if (m_should_seek.exchange(false)) {
+                sample_index_t seek_pos = m_seek_pos.load();
+                if (seek_pos < first) seek_pos = first;
+                if (seek_pos > last)  { pos = last; break; }
+                if (seek_pos != pos) {
+                    pos = seek_pos;
                     seek_again = true;
                     seek_done  = true;
                 }
@@ -483,50 +560,52 @@ void Kwave::PlaybackController::run_wrapper(const QVariant &params)
             if (seek_again) input.seek(pos);
             if (seek_done)  seekDone(pos);
 
-            // fill input buffer with samples
-            for (x = 0; x < audible_count; ++x) {
-                in_samples[x] = 0;
+            // length of the current period, the last one might be shorter
+            const unsigned int length = Kwave::toUint(
+                qMin<sample_index_t>(period, last - pos + 1));
+
+            // fill the input blocks with samples, pad with zeroes at eof
+            for (unsigned int x = 0; x < audible_count; ++x) {
+                Kwave::SampleArray &block = in_blocks[x];
                 Kwave::SampleReader *stream = input[audible_tracks[x]];
                 Q_ASSERT(stream);
-                if (!stream) continue;
-
-                if (!stream->eof()) (*stream) >> in_samples[x];
+                unsigned int count = 0;
+                if (stream && !stream->eof())
+                    count = stream->read(block, 0, length);
+                sample_t *p = block.data();
+                while (count < length)
+                    p[count++] = 0;
             }
 
             // multiply matrix with input to get output
-            const Kwave::SampleArray &in = in_samples;
-            for (y = 0; y < out_channels; ++y) {
-                double sum = 0;
-                for (x = 0; x < audible_count; ++x) {
-                    sum += static_cast<double>(in[x]) * (*mixer)[x][y];
-                }
-                out_samples[y] = static_cast<sample_t>(sum);
+            for (unsigned int y = 0; y < out_channels; ++y) {
+                mixBlock(in_blocks, gains.data() + (y * audible_count),
+                         acc.data(), out_blocks[y], length);
             }
 
-            // write samples to the playback device
+            // write the whole period to the playback device, if the device
+            // accepted only a part of it, it continues with the rest
             int result = -1;
-            {
-                unsigned int retry = 10;
-                while (retry-- && !m_thread.isInterruptionRequested()) {
-                    QMutexLocker lock(&m_lock_device);
-                    if (m_device)
-                        result = m_device->write(out_samples);
-                    if (result == 0)
-                        break;
-                }
-            }
+            do {
+                QMutexLocker lock(&m_lock_device);
+                result = (m_device) ?
+                    m_device->writeBlock(out_blocks, length) : -EIO;
+            } while ((result == -EAGAIN) &&
+                     !m_thread.isInterruptionRequested());
             if (result) {
                 m_thread.requestInterruption();
                 pos = last;
+                break;
             }
 
+            pos += length;
+
             // update the playback position if timer elapsed
-            if (!pos_countdown) {
-                pos_countdown = Kwave::toUint(ceil(
-                    m_playback_params.rate / SCREEN_REFRESHES_PER_SECOND));
+            if (pos_countdown <= length) {
+                pos_countdown = pos_interval;
                 updatePlaybackPos(pos);
             } else {
-                --pos_countdown;
+                pos_countdown -= length;
             }
         }
 
@@ -539,6 +618,8 @@ void Kwave::PlaybackController::run_wrapper(const QVariant &params)
 
     } while (m_loop_mode && !m_thread.isInterruptionRequested());
 
+    delete mixer;
+
     // playback is done
     emit sigDevicePlaybackDone();
 //     qDebug("PlaybackController::run() done.");
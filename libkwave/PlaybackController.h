@@ -21,6 +21,8 @@
 #include "config.h"
 #include "libkwave_export.h"
 
+#include <atomic>
+
 #include <QtGlobal>
 #include <QList>
 #include <QMutex>
@@ -281,19 +283,17 @@ namespace Kwave
         Kwave::PlayBackParam m_playback_params;
 
         /**
-         * Mutex for locking access to members that control the playback
-         * loop, like m_should_seek, m_seek_pos and m_mixer
+         * if true, m_seek_pos is valid and a seek has been requested.
+         * Set by the GUI thread after m_seek_pos has been stored, consumed
+         * by the playback thread once per period.
          */
-        QMutex m_lock_playback;
-
-        /** if true, m_seek_pos is valid and a seek has been requested */
-        bool m_should_seek;
+        std::atomic<bool> m_should_seek;
 
         /** position to seek to */
-        sample_index_t m_seek_pos;
+        std::atomic<sample_index_t> m_seek_pos;
 
         /** notification flag, true if the track selection has changed */
-        bool m_track_selection_changed;
+        std::atomic<bool> m_track_selection_changed;
 
         /**
          * If true, we are in "reload" mode. In this mode the playback is
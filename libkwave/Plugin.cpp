@@ -152,8 +152,9 @@ int Kwave::Plugin::start(QStringList &)
     Q_ASSERT(this->thread() == QThread::currentThread());
     Q_ASSERT(this->thread() == qApp->thread());
 
-    // create a progress dialog for processing mode (not used for pre-listen)
-    if (m_progress_enabled && !m_progress) {
+    // create a progress dialog for processing mode (not used for pre-listen
+    // and not without GUI)
+    if (m_progress_enabled && !m_progress && !Kwave::isHeadless()) {
         m_progress = new(std::nothrow) QProgressDialog(parentWidget());
         Q_ASSERT(m_progress);
     }
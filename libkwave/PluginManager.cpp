@@ -232,6 +232,12 @@ int Kwave::PluginManager::executePlugin(const QString &name,
     Q_ASSERT(this->thread() == QThread::currentThread());
     Q_ASSERT(this->thread() == qApp->thread());
 
+    // without GUI there is no setup dialog to ask for parameters
+    if (!params && Kwave::isHeadless()) {
+        qWarning("PluginManager: plugin '%s' needs parameters", DBG(name));
+        return -EINVAL;
+    }
+
     // synchronize: wait until any currently running plugins are done
     this->sync();
 
@@ -346,6 +352,12 @@ void Kwave::PluginManager::sync()
 int Kwave::PluginManager::setupPlugin(const QString &name,
                                       const QStringList &params)
 {
+    // the setup of a plugin always shows a dialog
+    if (Kwave::isHeadless()) {
+        qWarning("PluginManager: no setup of '%s' without GUI", DBG(name));
+        return -EINVAL;
+    }
+
     // load the plugin
     Kwave::Plugin *plugin = createPluginInstance(name);
     if (!plugin) return -ENOMEM;
@@ -0,0 +1,82 @@
+/***************************************************************************
+         RiffHeader.cpp  -  header of RIFF/WAVE files with RF64 support
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include "libkwave/RiffHeader.h"
+
+/** offset of the "JUNK" chunk that is reserved for a "ds64" chunk */
+#define DS64_OFFSET 12
+
+/** size of the content of a "ds64" chunk without table */
+#define DS64_SIZE 28
+
+//***************************************************************************
+void Kwave::RiffHeader::appendMainChunk(QByteArray &header)
+{
+    Q_ASSERT(header.isEmpty());
+
+    header.append("RIFF", 4);
+    appendLE<quint32>(header, 0);
+    header.append("WAVE", 4);
+
+    // placeholder for the "ds64" chunk of RF64
+    Q_ASSERT(header.size() == DS64_OFFSET);
+    header.append("JUNK", 4);
+    appendLE<quint32>(header, DS64_SIZE);
+    header.append(DS64_SIZE, '\0');
+}
+
+//***************************************************************************
+bool Kwave::RiffHeader::update(QIODevice &dst, quint64 data_size,
+                               quint64 frames, qint64 data_size_offset,
+                               qint64 fact_offset, quint64 max_size)
+{
+    const quint64 riff_size = static_cast<quint64>(dst.size()) - 8;
+    bool ok = true;
+
+    if ((riff_size < max_size) && (data_size < max_size)) {
+        // plain RIFF
+        ok &= writeLE<quint32>(dst, 4, static_cast<quint32>(riff_size));
+        ok &= writeLE<quint32>(dst, data_size_offset,
+                               static_cast<quint32>(data_size));
+        if (fact_offset)
+            ok &= writeLE<quint32>(dst, fact_offset,
+                                   static_cast<quint32>(frames));
+        return ok;
+    }
+
+    // too large for RIFF: promote to RF64, the 32 bit sizes are
+    // replaced by the 64 bit sizes in the "ds64" chunk
+    ok &= dst.seek(0) && (dst.write("RF64", 4) == 4);
+    ok &= writeLE<quint32>(dst, 4, static_cast<quint32>(RIFF_SIZE_MAX));
+    ok &= dst.seek(DS64_OFFSET) && (dst.write("ds64", 4) == 4);
+    ok &= writeLE<quint32>(dst, DS64_OFFSET +  4, DS64_SIZE);
+    ok &= writeLE<quint64>(dst, DS64_OFFSET +  8, riff_size);
+    ok &= writeLE<quint64>(dst, DS64_OFFSET + 16, data_size);
+    ok &= writeLE<quint64>(dst, DS64_OFFSET + 24, frames);
+    ok &= writeLE<quint32>(dst, DS64_OFFSET + 32, 0); // table length
+    ok &= writeLE<quint32>(dst, data_size_offset,
+                           static_cast<quint32>(RIFF_SIZE_MAX));
+    if (fact_offset)
+        ok &= writeLE<quint32>(dst, fact_offset,
+                               static_cast<quint32>(RIFF_SIZE_MAX));
+    return ok;
+}
+
+//***************************************************************************
+//***************************************************************************
@@ -0,0 +1,105 @@
+/***************************************************************************
+           RiffHeader.h  -  header of RIFF/WAVE files with RF64 support
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef RIFF_HEADER_H
+#define RIFF_HEADER_H
+
+#include "config.h"
+#include "libkwave_export.h"
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QIODevice>
+#include <QtEndian>
+
+/** largest size that fits into the size field of a RIFF chunk */
+#define RIFF_SIZE_MAX 0xFFFFFFFFULL
+
+namespace Kwave
+{
+
+    /**
+     * Appends a value in little endian byte order to a byte array
+     * @param data the byte array
+     * @param value the value to append
+     */
+    template <typename T> void appendLE(QByteArray &data, T value)
+    {
+        char bytes[sizeof(T)];
+        qToLittleEndian<T>(value, bytes);
+        data.append(bytes, sizeof(T));
+    }
+
+    /**
+     * Writes a value in little endian byte order at a given offset
+     * @param dst the destination
+     * @param offset the position within the destination
+     * @param value the value to write
+     * @return true if succeeded
+     */
+    template <typename T> bool writeLE(QIODevice &dst, qint64 offset,
+                                       T value)
+    {
+        char bytes[sizeof(T)];
+        qToLittleEndian<T>(value, bytes);
+        return dst.seek(offset) &&
+            (dst.write(bytes, sizeof(T)) == static_cast<qint64>(sizeof(T)));
+    }
+
+    /**
+     * Writes the sizes in the header of a RIFF/WAVE file. The header
+     * reserves space for a "ds64" chunk in a "JUNK" chunk right after
+     * the main chunk, so that a file that exceeds the limits of 32 bit
+     * sizes can be promoted to RF64 (EBU Tech 3306) in place.
+     */
+    class LIBKWAVE_EXPORT RiffHeader
+    {
+    public:
+
+        /**
+         * Appends the start of the header: the "RIFF" main chunk with
+         * the "WAVE" form type and the placeholder for the "ds64" chunk.
+         * The sizes are set later by update().
+         * @param header receives the data
+         */
+        static void appendMainChunk(QByteArray &header);
+
+        /**
+         * Writes the current sizes into the header, and promotes the
+         * file to RF64 if they do not fit into 32 bits. The position of
+         * the destination is not restored.
+         * @param dst the destination, with random access
+         * @param data_size number of bytes in the "data" chunk
+         * @param frames number of sample frames
+         * @param data_size_offset offset of the size of the "data" chunk
+         * @param fact_offset offset of the sample length in the "fact"
+         *                    chunk, or zero if there is none
+         * @param max_size largest size that is written as RIFF, only to
+         *                 be lowered for testing
+         * @return true if succeeded, false on write errors
+         */
+        static bool update(QIODevice &dst, quint64 data_size,
+                           quint64 frames, qint64 data_size_offset,
+                           qint64 fact_offset = 0,
+                           quint64 max_size = RIFF_SIZE_MAX);
+    };
+}
+
+#endif /* RIFF_HEADER_H */
+
+//***************************************************************************
+//***************************************************************************
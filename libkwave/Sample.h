@@ -27,9 +27,13 @@
 /** use an unsigned integer for sample offset/count calculations */
 typedef quint64 sample_index_t;
 
-/** the highest possible sample index (currently limited to 32bit integer */
+/**
+ * the highest possible sample index, limited to the range of a signed
+ * 64 bit integer so that differences of sample indices can still be
+ * expressed as qint64
+ */
 #define SAMPLE_INDEX_MAX (static_cast<sample_index_t>( \
-        std::numeric_limits<qint32>::max()) )
+        std::numeric_limits<qint64>::max()) )
 
 /**
  * Currently a "sample" is defined as a 32 bit integer
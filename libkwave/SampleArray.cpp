@@ -20,6 +20,7 @@
 #include <new>
 #include <stdlib.h>
 
+#include "libkwave/MemoryManager.h"
 #include "libkwave/SampleArray.h"
 #include "libkwave/memcpy.h"
 
@@ -125,7 +126,8 @@ Kwave::SampleArray::SampleStorage::SampleStorage(const SampleStorage &other)
         // print_backtrace();
 
         m_data = static_cast<sample_t *>(
-            ::malloc(other.m_size * sizeof(sample_t))
+            Kwave::MemoryManager::instance().allocate(
+                other.m_size * sizeof(sample_t))
         );
         if (m_data) {
             m_size = other.m_size;
@@ -137,7 +139,7 @@ Kwave::SampleArray::SampleStorage::SampleStorage(const SampleStorage &other)
 //***************************************************************************
 Kwave::SampleArray::SampleStorage::~SampleStorage()
 {
-    ::free(m_data);
+    Kwave::MemoryManager::instance().free(m_data, m_size * sizeof(sample_t));
     m_data = nullptr;
 }
 
@@ -145,9 +147,10 @@ Kwave::SampleArray::SampleStorage::~SampleStorage()
 void Kwave::SampleArray::SampleStorage::resize(unsigned int size)
 {
     if (size) {
-        // resize using realloc, keep existing data
+        // resize through the memory manager, keep existing data
         sample_t *new_data = static_cast<sample_t *>(
-            ::realloc(m_data, size * sizeof(sample_t)));
+            Kwave::MemoryManager::instance().resize(m_data,
+                m_size * sizeof(sample_t), size * sizeof(sample_t)));
         if (new_data) {
             // successful
             m_data = new_data;
@@ -167,9 +170,10 @@ void Kwave::SampleArray::SampleStorage::resize(unsigned int size)
         // resize to zero == delete/free memory
         Q_ASSERT(m_data);
         sample_t *t = m_data;
+        const size_t bytes = m_size * sizeof(sample_t);
         m_data = nullptr;
         m_size = 0;
-        ::free(t);
+        Kwave::MemoryManager::instance().free(t, bytes);
     }
 }
 
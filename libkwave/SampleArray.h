@@ -102,6 +102,36 @@ namespace Kwave
          */
         inline bool isEmpty() const { return (size() == 0); }
 
+        /**
+         * Checks whether the storage is used by this array only, so that
+         * writing into it does not cause a copy.
+         * @return true if not shared with another array
+         */
+        inline bool isDetached() const
+        {
+            return (!m_storage ||
+                    (m_storage.constData()->ref.loadRelaxed() == 1));
+        }
+
+        /**
+         * Returns an identifier of the storage, which is the same for
+         * all arrays that share it.
+         * @return pointer to the storage, or null if there is none
+         */
+        inline const void *storage() const
+        {
+            return m_storage.constData();
+        }
+
+        /**
+         * Returns the number of arrays that share the storage
+         * @return number of references, zero if there is no storage
+         */
+        inline int references() const
+        {
+            return (m_storage) ? m_storage.constData()->ref.loadRelaxed() : 0;
+        }
+
     private:
 
         class SampleStorage: public QSharedData {
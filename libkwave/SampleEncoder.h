@@ -48,6 +48,17 @@ namespace Kwave
                             unsigned int count,
                             QByteArray &raw_data) = 0;
 
+        /**
+         * Encodes samples directly into a given memory area, e.g. the
+         * buffer of a device, without any allocation.
+         * @param samples pointer to the samples
+         * @param count number of samples
+         * @param dst destination, must have room for
+         *            count * rawBytesPerSample() bytes
+         */
+        virtual void encode(const sample_t *samples, unsigned int count,
+                            quint8 *dst) = 0;
+
         /** Returns the number of bytes per sample in raw (not encoded) form */
         virtual unsigned int rawBytesPerSample() = 0;
 
@@ -22,6 +22,8 @@
 #include "libkwave/Sample.h"
 #include "libkwave/SampleEncoderLinear.h"
 #include "libkwave/SampleFormat.h"
+#include "libkwave/SampleKernels.h"
+#include "libkwave/SampleLinear.h"
 #include "libkwave/Utils.h"
 
 //***************************************************************************
@@ -33,58 +35,6 @@ static void encode_NULL(const sample_t *src, quint8 *dst, unsigned int count)
 //     qWarning("call to encode_NULL");
 }
 
-//***************************************************************************
-/**
- * Template for encoding a buffer with linear samples. The tricky part is
- * done in the compiler which optimizes away all unused parts of current
- * variant and does nice loop optimizing!
- * @param src array with samples in Kwave's format
- * @param dst array that receives the raw data
- * @param count the number of samples to be encoded
- */
-template<const unsigned int bits, const bool is_signed,
-         const bool is_little_endian>
-void encode_linear(const sample_t *src, quint8 *dst, unsigned int count)
-{
-    for ( ; count; --count) {
-        // read from source buffer
-        sample_t s = *(src++);
-
-        // convert to unsigned if necessary
-        if (!is_signed)
-            s += 1 << (SAMPLE_BITS - 1);
-
-        // shrink 18/20 bits and similar down, otherwise it does not work
-        // with ALSA for some dubious reason !?
-        if (bits == 20)
-            s >>= 4;
-        if (bits == 18) // don't ask me why... !!!???
-            s >>= 6;
-
-        if (is_little_endian) {
-            // little endian
-            if (bits > 24)
-                *(dst++) = 0x00;
-            if (bits > 16)
-                *(dst++) = static_cast<quint8>(s & 0xFF);
-            if (bits > 8)
-                *(dst++) = static_cast<quint8>(s >> 8);
-            if (bits >= 8)
-                *(dst++) = static_cast<quint8>(s >> 16);
-        } else {
-            // big endian
-            if (bits >= 8)
-                *(dst++) = static_cast<quint8>(s >> 16);
-            if (bits > 8)
-                *(dst++) = static_cast<quint8>(s >> 8);
-            if (bits > 16)
-                *(dst++) = static_cast<quint8>(s & 0xFF);
-            if (bits > 24)
-                *(dst++) = 0x00;
-        }
-    }
-}
-
 //***************************************************************************
 #define MAKE_ENCODER(bits)                             \
 if (sample_format != Kwave::SampleFormat::Unsigned) {  \
@@ -158,6 +108,15 @@ Kwave::SampleEncoderLinear::SampleEncoderLinear(
         DEFAULT_IGNORE;
     }
 
+    // use a vectorized variant if the CPU supports it
+    if (Kwave::SampleKernels::level() != Kwave::SampleKernels::Scalar) {
+        Kwave::SampleKernels::encoder_t fast =
+            Kwave::SampleKernels::linearEncoder(bits_per_sample,
+                (sample_format == Kwave::SampleFormat::Signed),
+                (endianness != Kwave::BigEndian));
+        if (fast) m_encoder = fast;
+    }
+
     Q_ASSERT(m_encoder != encode_NULL);
 }
 
@@ -183,6 +142,19 @@ void Kwave::SampleEncoderLinear::encode(const Kwave::SampleArray &samples,
     m_encoder(src, dst, count);
 }
 
+//***************************************************************************
+void Kwave::SampleEncoderLinear::encode(const sample_t *samples,
+                                        unsigned int count,
+                                        quint8 *dst)
+{
+    Q_ASSERT(m_encoder);
+    Q_ASSERT(samples);
+    Q_ASSERT(dst);
+    if (!m_encoder || !samples || !dst) return;
+
+    m_encoder(samples, dst, count);
+}
+
 //***************************************************************************
 unsigned int Kwave::SampleEncoderLinear::rawBytesPerSample()
 {
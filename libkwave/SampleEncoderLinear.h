@@ -56,6 +56,10 @@ namespace Kwave
                             unsigned int count,
                             QByteArray &raw_data) override;
 
+        /** @see Kwave::SampleEncoder::encode() */
+        virtual void encode(const sample_t *samples, unsigned int count,
+                            quint8 *dst) override;
+
         /** Returns the number of bytes per sample in raw (encoded) form */
         unsigned int rawBytesPerSample() override;
 
@@ -0,0 +1,583 @@
+/***************************************************************************
+        SampleKernels.cpp  -  optimized inner loops for sample processing
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <string.h>
+
+#ifdef HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#include "libkwave/SampleKernels.h"
+
+#ifdef HAVE_X86_SIMD
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+//***************************************************************************
+//***************************************************************************
+// portable scalar kernels, they also serve as reference
+
+//***************************************************************************
+static void minMax_scalar(const sample_t *buffer, unsigned int count,
+                          sample_t &min, sample_t &max)
+{
+    sample_t lo = min;
+    sample_t hi = max;
+    for (; count; --count) {
+        const sample_t s = *(buffer++);
+        lo = (s < lo) ? s : lo;
+        hi = (s > hi) ? s : hi;
+    }
+    min = lo;
+    max = hi;
+}
+
+//***************************************************************************
+static void encode_s8_scalar(const sample_t *src, quint8 *dst,
+                             unsigned int count)
+{
+    for (; count; --count)
+        *(dst++) = static_cast<quint8>(*(src++) >> 16);
+}
+
+//***************************************************************************
+static void encode_s16le_scalar(const sample_t *src, quint8 *dst,
+                                unsigned int count)
+{
+    for (; count; --count) {
+        const sample_t s = *(src++);
+        *(dst++) = static_cast<quint8>(s >> 8);
+        *(dst++) = static_cast<quint8>(s >> 16);
+    }
+}
+
+//***************************************************************************
+static void encode_s24le_scalar(const sample_t *src, quint8 *dst,
+                                unsigned int count)
+{
+    for (; count; --count) {
+        const sample_t s = *(src++);
+        *(dst++) = static_cast<quint8>(s);
+        *(dst++) = static_cast<quint8>(s >> 8);
+        *(dst++) = static_cast<quint8>(s >> 16);
+    }
+}
+
+//***************************************************************************
+static void encode_s32le_scalar(const sample_t *src, quint8 *dst,
+                                unsigned int count)
+{
+    for (; count; --count) {
+        const sample_t s = *(src++);
+        *(dst++) = 0x00;
+        *(dst++) = static_cast<quint8>(s);
+        *(dst++) = static_cast<quint8>(s >> 8);
+        *(dst++) = static_cast<quint8>(s >> 16);
+    }
+}
+
+//***************************************************************************
+static void decode_s8_scalar(const quint8 *src, sample_t *dst,
+                             unsigned int count)
+{
+    for (; count; --count)
+        *(dst++) = static_cast<sample_t>(static_cast<qint8>(*(src++))) * 65536;
+}
+
+//***************************************************************************
+static void decode_s16le_scalar(const quint8 *src, sample_t *dst,
+                                unsigned int count)
+{
+    for (; count; --count, src += 2) {
+        const qint16 v = static_cast<qint16>(src[0] | (src[1] << 8));
+        *(dst++) = static_cast<sample_t>(v) * 256;
+    }
+}
+
+//***************************************************************************
+static void decode_s24le_scalar(const quint8 *src, sample_t *dst,
+                                unsigned int count)
+{
+    for (; count; --count, src += 3) {
+        const quint32 v = src[0] | (src[1] << 8) | (src[2] << 16);
+        *(dst++) = static_cast<sample_t>(v << 8) >> 8;
+    }
+}
+
+//***************************************************************************
+static void decode_s32le_scalar(const quint8 *src, sample_t *dst,
+                                unsigned int count)
+{
+    for (; count; --count, src += 4) {
+        const quint32 v = src[0] | (src[1] << 8) | (src[2] << 16) |
+                          (static_cast<quint32>(src[3]) << 24);
+        *(dst++) = static_cast<sample_t>(v) >> 8;
+    }
+}
+
+#ifdef HAVE_X86_SIMD
+
+//***************************************************************************
+//***************************************************************************
+// SSE2 kernels
+
+//***************************************************************************
+TARGET_SSE2 static void minMax_sse2(const sample_t *buffer, unsigned int count,
+                                    sample_t &min, sample_t &max)
+{
+    if (count >= 4) {
+        __m128i lo = _mm_set1_epi32(min);
+        __m128i hi = _mm_set1_epi32(max);
+        for (; count >= 4; count -= 4, buffer += 4) {
+            const __m128i v = _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(buffer));
+            // SSE2 has no min/max for 32 bit -> compare and blend
+            const __m128i lt = _mm_cmpgt_epi32(lo, v);
+            lo = _mm_or_si128(_mm_and_si128(lt, v), _mm_andnot_si128(lt, lo));
+            const __m128i gt = _mm_cmpgt_epi32(v, hi);
+            hi = _mm_or_si128(_mm_and_si128(gt, v), _mm_andnot_si128(gt, hi));
+        }
+        sample_t l[4];
+        sample_t h[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(l), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(h), hi);
+        minMax_scalar(l, 4, min, max);
+        minMax_scalar(h, 4, min, max);
+    }
+    minMax_scalar(buffer, count, min, max);
+}
+
+//***************************************************************************
+TARGET_SSE2 static void encode_s8_sse2(const sample_t *src, quint8 *dst,
+                                       unsigned int count)
+{
+    // take bits 16...23 with sign extension, like the scalar variant,
+    // so that the packing below never saturates
+    for (; count >= 16; count -= 16, src += 16, dst += 16) {
+        const __m128i *s = reinterpret_cast<const __m128i *>(src);
+        const __m128i a = _mm_srai_epi32(
+            _mm_slli_epi32(_mm_loadu_si128(s + 0), 8), 24);
+        const __m128i b = _mm_srai_epi32(
+            _mm_slli_epi32(_mm_loadu_si128(s + 1), 8), 24);
+        const __m128i c = _mm_srai_epi32(
+            _mm_slli_epi32(_mm_loadu_si128(s + 2), 8), 24);
+        const __m128i d = _mm_srai_epi32(
+            _mm_slli_epi32(_mm_loadu_si128(s + 3), 8), 24);
+        const __m128i v = _mm_packs_epi16(_mm_packs_epi32(a, b),
+                                          _mm_packs_epi32(c, d));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), v);
+    }
+    encode_s8_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_SSE2 static void encode_s16le_sse2(const sample_t *src, quint8 *dst,
+                                          unsigned int count)
+{
+    // take bits 8...23 with sign extension, like the scalar variant,
+    // so that the packing below never saturates
+    for (; count >= 8; count -= 8, src += 8, dst += 16) {
+        const __m128i *s = reinterpret_cast<const __m128i *>(src);
+        const __m128i a = _mm_srai_epi32(
+            _mm_slli_epi32(_mm_loadu_si128(s + 0), 8), 16);
+        const __m128i b = _mm_srai_epi32(
+            _mm_slli_epi32(_mm_loadu_si128(s + 1), 8), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                         _mm_packs_epi32(a, b));
+    }
+    encode_s16le_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_SSE2 static void encode_s32le_sse2(const sample_t *src, quint8 *dst,
+                                          unsigned int count)
+{
+    for (; count >= 4; count -= 4, src += 4, dst += 16) {
+        const __m128i v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                         _mm_slli_epi32(v, 8));
+    }
+    encode_s32le_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_SSE2 static void decode_s8_sse2(const quint8 *src, sample_t *dst,
+                                       unsigned int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for (; count >= 16; count -= 16, src += 16, dst += 16) {
+        const __m128i v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src));
+        // move each byte into the highest byte of a 32 bit word,
+        // then shift it down arithmetically
+        const __m128i lo = _mm_unpacklo_epi8(zero, v);
+        const __m128i hi = _mm_unpackhi_epi8(zero, v);
+        __m128i *d = reinterpret_cast<__m128i *>(dst);
+        _mm_storeu_si128(d + 0,
+            _mm_srai_epi32(_mm_unpacklo_epi16(zero, lo), 8));
+        _mm_storeu_si128(d + 1,
+            _mm_srai_epi32(_mm_unpackhi_epi16(zero, lo), 8));
+        _mm_storeu_si128(d + 2,
+            _mm_srai_epi32(_mm_unpacklo_epi16(zero, hi), 8));
+        _mm_storeu_si128(d + 3,
+            _mm_srai_epi32(_mm_unpackhi_epi16(zero, hi), 8));
+    }
+    decode_s8_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_SSE2 static void decode_s16le_sse2(const quint8 *src, sample_t *dst,
+                                          unsigned int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for (; count >= 8; count -= 8, src += 16, dst += 8) {
+        const __m128i v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src));
+        __m128i *d = reinterpret_cast<__m128i *>(dst);
+        _mm_storeu_si128(d + 0, _mm_srai_epi32(_mm_unpacklo_epi16(zero, v), 8));
+        _mm_storeu_si128(d + 1, _mm_srai_epi32(_mm_unpackhi_epi16(zero, v), 8));
+    }
+    decode_s16le_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_SSE2 static void decode_s32le_sse2(const quint8 *src, sample_t *dst,
+                                          unsigned int count)
+{
+    for (; count >= 4; count -= 4, src += 16, dst += 4) {
+        const __m128i v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                         _mm_srai_epi32(v, 8));
+    }
+    decode_s32le_scalar(src, dst, count);
+}
+
+//***************************************************************************
+//***************************************************************************
+// AVX2 kernels
+
+//***************************************************************************
+TARGET_AVX2 static void minMax_avx2(const sample_t *buffer, unsigned int count,
+                                    sample_t &min, sample_t &max)
+{
+    if (count >= 16) {
+        __m256i lo0 = _mm256_set1_epi32(min);
+        __m256i hi0 = _mm256_set1_epi32(max);
+        __m256i lo1 = lo0;
+        __m256i hi1 = hi0;
+        for (; count >= 16; count -= 16, buffer += 16) {
+            const __m256i *p = reinterpret_cast<const __m256i *>(buffer);
+            const __m256i a = _mm256_loadu_si256(p + 0);
+            const __m256i b = _mm256_loadu_si256(p + 1);
+            lo0 = _mm256_min_epi32(lo0, a);
+            hi0 = _mm256_max_epi32(hi0, a);
+            lo1 = _mm256_min_epi32(lo1, b);
+            hi1 = _mm256_max_epi32(hi1, b);
+        }
+        sample_t l[8];
+        sample_t h[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(l),
+                            _mm256_min_epi32(lo0, lo1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(h),
+                            _mm256_max_epi32(hi0, hi1));
+        minMax_scalar(l, 8, min, max);
+        minMax_scalar(h, 8, min, max);
+    }
+    minMax_scalar(buffer, count, min, max);
+}
+
+//***************************************************************************
+TARGET_AVX2 static void encode_s16le_avx2(const sample_t *src, quint8 *dst,
+                                          unsigned int count)
+{
+    // take bits 8...23 with sign extension, like the scalar variant,
+    // so that the packing below never saturates
+    for (; count >= 16; count -= 16, src += 16, dst += 32) {
+        const __m256i *s = reinterpret_cast<const __m256i *>(src);
+        const __m256i a = _mm256_srai_epi32(
+            _mm256_slli_epi32(_mm256_loadu_si256(s + 0), 8), 16);
+        const __m256i b = _mm256_srai_epi32(
+            _mm256_slli_epi32(_mm256_loadu_si256(s + 1), 8), 16);
+        // packing works per 128 bit lane -> restore the order
+        const __m256i v = _mm256_permute4x64_epi64(
+            _mm256_packs_epi32(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), v);
+    }
+    encode_s16le_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_AVX2 static void encode_s24le_avx2(const sample_t *src, quint8 *dst,
+                                          unsigned int count)
+{
+    // collect the lower three bytes of four samples
+    const __m128i shuffle = _mm_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for (; count >= 4; count -= 4, src += 4, dst += 12) {
+        const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src)), shuffle);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), v);
+        const quint32 tail = static_cast<quint32>(
+            _mm_cvtsi128_si32(_mm_srli_si128(v, 8)));
+        memcpy(dst + 8, &tail, 4);
+    }
+    encode_s24le_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_AVX2 static void encode_s32le_avx2(const sample_t *src, quint8 *dst,
+                                          unsigned int count)
+{
+    for (; count >= 8; count -= 8, src += 8, dst += 32) {
+        const __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(src));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                            _mm256_slli_epi32(v, 8));
+    }
+    encode_s32le_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_AVX2 static void decode_s8_avx2(const quint8 *src, sample_t *dst,
+                                       unsigned int count)
+{
+    for (; count >= 8; count -= 8, src += 8, dst += 8) {
+        const __m256i v = _mm256_cvtepi8_epi32(_mm_loadl_epi64(
+            reinterpret_cast<const __m128i *>(src)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                            _mm256_slli_epi32(v, 16));
+    }
+    decode_s8_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_AVX2 static void decode_s16le_avx2(const quint8 *src, sample_t *dst,
+                                          unsigned int count)
+{
+    for (; count >= 8; count -= 8, src += 16, dst += 8) {
+        const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                            _mm256_slli_epi32(v, 8));
+    }
+    decode_s16le_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_AVX2 static void decode_s24le_avx2(const quint8 *src, sample_t *dst,
+                                          unsigned int count)
+{
+    // move three bytes into the upper part of a 32 bit word,
+    // then shift down arithmetically for sign extension
+    const __m128i shuffle = _mm_setr_epi8(
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+
+    // a load covers 16 bytes but only 12 are used, so stop early
+    // enough to not read beyond the end of the source
+    for (; count >= 6; count -= 4, src += 12, dst += 4) {
+        const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(src)), shuffle);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                         _mm_srai_epi32(v, 8));
+    }
+    decode_s24le_scalar(src, dst, count);
+}
+
+//***************************************************************************
+TARGET_AVX2 static void decode_s32le_avx2(const quint8 *src, sample_t *dst,
+                                          unsigned int count)
+{
+    for (; count >= 8; count -= 8, src += 32, dst += 8) {
+        const __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(src));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                            _mm256_srai_epi32(v, 8));
+    }
+    decode_s32le_scalar(src, dst, count);
+}
+
+#endif /* HAVE_X86_SIMD */
+
+//***************************************************************************
+//***************************************************************************
+Kwave::SampleKernels::Level Kwave::SampleKernels::level()
+{
+#ifdef HAVE_X86_SIMD
+    static const Level s_level =
+        (__builtin_cpu_supports("avx2")) ? AVX2 :
+        (__builtin_cpu_supports("sse2")) ? SSE2 : Scalar;
+    return s_level;
+#else
+    return Scalar;
+#endif
+}
+
+//***************************************************************************
+void Kwave::SampleKernels::minMax(const sample_t *buffer, unsigned int count,
+                                  sample_t &min, sample_t &max)
+{
+    minMax(level(), buffer, count, min, max);
+}
+
+//***************************************************************************
+void Kwave::SampleKernels::minMax(Level level,
+                                  const sample_t *buffer, unsigned int count,
+                                  sample_t &min, sample_t &max)
+{
+    switch (level) {
+#ifdef HAVE_X86_SIMD
+        case AVX2:
+            minMax_avx2(buffer, count, min, max);
+            break;
+        case SSE2:
+            minMax_sse2(buffer, count, min, max);
+            break;
+#endif
+        default:
+            minMax_scalar(buffer, count, min, max);
+            break;
+    }
+}
+
+//***************************************************************************
+Kwave::SampleKernels::encoder_t Kwave::SampleKernels::linearEncoder(
+    unsigned int bits, bool is_signed, bool is_little_endian)
+{
+    return linearEncoder(level(), bits, is_signed, is_little_endian);
+}
+
+//***************************************************************************
+Kwave::SampleKernels::encoder_t Kwave::SampleKernels::linearEncoder(
+    Level level, unsigned int bits, bool is_signed, bool is_little_endian)
+{
+    // only signed little endian is optimized, 8 bit has no byte order
+    if (!is_signed) return nullptr;
+    if (!is_little_endian && (bits != 8)) return nullptr;
+
+    switch (level) {
+#ifdef HAVE_X86_SIMD
+        case AVX2:
+            switch (bits) {
+                case  8: return encode_s8_sse2;
+                case 16: return encode_s16le_avx2;
+                case 24: return encode_s24le_avx2;
+                case 32: return encode_s32le_avx2;
+                default: return nullptr;
+            }
+        case SSE2:
+            switch (bits) {
+                case  8: return encode_s8_sse2;
+                case 16: return encode_s16le_sse2;
+                case 24: return encode_s24le_scalar;
+                case 32: return encode_s32le_sse2;
+                default: return nullptr;
+            }
+#endif
+        default:
+            switch (bits) {
+                case  8: return encode_s8_scalar;
+                case 16: return encode_s16le_scalar;
+                case 24: return encode_s24le_scalar;
+                case 32: return encode_s32le_scalar;
+                default: return nullptr;
+            }
+    }
+}
+
+//***************************************************************************
+Kwave::SampleKernels::decoder_t Kwave::SampleKernels::linearDecoder(
+    unsigned int bits, bool is_signed, bool is_little_endian)
+{
+    return linearDecoder(level(), bits, is_signed, is_little_endian);
+}
+
+//***************************************************************************
+Kwave::SampleKernels::decoder_t Kwave::SampleKernels::linearDecoder(
+    Level level, unsigned int bits, bool is_signed, bool is_little_endian)
+{
+    // only signed little endian is optimized, 8 bit has no byte order
+    if (!is_signed) return nullptr;
+    if (!is_little_endian && (bits != 8)) return nullptr;
+
+    switch (level) {
+#ifdef HAVE_X86_SIMD
+        case AVX2:
+            switch (bits) {
+                case  8: return decode_s8_avx2;
+                case 16: return decode_s16le_avx2;
+                case 24: return decode_s24le_avx2;
+                case 32: return decode_s32le_avx2;
+                default: return nullptr;
+            }
+        case SSE2:
+            switch (bits) {
+                case  8: return decode_s8_sse2;
+                case 16: return decode_s16le_sse2;
+                case 24: return decode_s24le_scalar;
+                case 32: return decode_s32le_sse2;
+                default: return nullptr;
+            }
+#endif
+        default:
+            switch (bits) {
+                case  8: return decode_s8_scalar;
+                case 16: return decode_s16le_scalar;
+                case 24: return decode_s24le_scalar;
+                case 32: return decode_s32le_scalar;
+                default: return nullptr;
+            }
+    }
+}
+
+//***************************************************************************
+void Kwave::SampleKernels::interleave(const sample_t * const *src,
+                                      unsigned int channels,
+                                      unsigned int count,
+                                      sample_t *dst)
+{
+    switch (channels) {
+        case 1:
+            for (unsigned int i = 0; i < count; ++i)
+                dst[i] = src[0][i];
+            break;
+        case 2: {
+            // the most common case, simple enough for the compiler
+            const sample_t *left  = src[0];
+            const sample_t *right = src[1];
+            for (unsigned int i = 0; i < count; ++i) {
+                *(dst++) = left[i];
+                *(dst++) = right[i];
+            }
+            break;
+        }
+        default:
+            for (unsigned int c = 0; c < channels; ++c) {
+                const sample_t *in  = src[c];
+                sample_t       *out = dst + c;
+                for (unsigned int i = 0; i < count; ++i, out += channels)
+                    *out = in[i];
+            }
+    }
+}
+
+//***************************************************************************
+//***************************************************************************
@@ -0,0 +1,121 @@
+/***************************************************************************
+          SampleKernels.h  -  optimized inner loops for sample processing
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SAMPLE_KERNELS_H
+#define SAMPLE_KERNELS_H
+
+#include "config.h"
+#include "libkwave_export.h"
+
+#include <QtGlobal>
+
+#include "libkwave/Sample.h"
+
+namespace Kwave
+{
+
+    /**
+     * Collection of the innermost loops that dominate loading, saving
+     * and drawing: min/max reduction and conversion between Kwave's
+     * sample format and signed little endian PCM with 8, 16, 24 or 32
+     * bits. Each kernel exists in a portable scalar variant and, on x86,
+     * in SSE2 and AVX2 variants. The best variant that is supported by
+     * the CPU is chosen at runtime.
+     */
+    class LIBKWAVE_EXPORT SampleKernels
+    {
+    public:
+
+        /** instruction set level of a kernel */
+        typedef enum {
+            Scalar = 0, /**< portable code */
+            SSE2,       /**< x86 SSE2 */
+            AVX2        /**< x86 AVX2 (including SSSE3) */
+        } Level;
+
+        /** function for encoding samples into raw data */
+        typedef void (*encoder_t)(const sample_t *src, quint8 *dst,
+                                  unsigned int count);
+
+        /** function for decoding raw data into samples */
+        typedef void (*decoder_t)(const quint8 *src, sample_t *dst,
+                                  unsigned int count);
+
+        /** returns the best level supported by the CPU */
+        static Level level();
+
+        /**
+         * Determines minimum and maximum of an array of samples
+         * @param buffer pointer to the samples
+         * @param count number of samples
+         * @param min receives the lowest value (must be initialized)
+         * @param max receives the highest value (must be initialized)
+         */
+        static void minMax(const sample_t *buffer, unsigned int count,
+                           sample_t &min, sample_t &max);
+
+        /** same as minMax(), with a given level */
+        static void minMax(Level level,
+                           const sample_t *buffer, unsigned int count,
+                           sample_t &min, sample_t &max);
+
+        /**
+         * Returns an encoder for linear PCM of the best supported level
+         * @param bits number of bits per sample, 8, 16, 24 or 32
+         * @param is_signed true for signed format
+         * @param is_little_endian true for little endian byte order
+         * @return an encoder or null if there is no optimized one
+         */
+        static encoder_t linearEncoder(unsigned int bits, bool is_signed,
+                                       bool is_little_endian);
+
+        /** same as linearEncoder(), with a given level */
+        static encoder_t linearEncoder(Level level, unsigned int bits,
+                                       bool is_signed, bool is_little_endian);
+
+        /**
+         * Returns a decoder for linear PCM of the best supported level
+         * @param bits number of bits per sample, 8, 16, 24 or 32
+         * @param is_signed true for signed format
+         * @param is_little_endian true for little endian byte order
+         * @return a decoder or null if there is no optimized one
+         */
+        static decoder_t linearDecoder(unsigned int bits, bool is_signed,
+                                       bool is_little_endian);
+
+        /** same as linearDecoder(), with a given level */
+        static decoder_t linearDecoder(Level level, unsigned int bits,
+                                       bool is_signed, bool is_little_endian);
+
+        /**
+         * Interleaves blocks of samples, one per channel, into frames
+         * @param src array of pointers to the samples of each channel
+         * @param channels number of channels
+         * @param count number of samples per channel
+         * @param dst receives count * channels samples
+         */
+        static void interleave(const sample_t * const *src,
+                               unsigned int channels, unsigned int count,
+                               sample_t *dst);
+
+    };
+}
+
+#endif /* SAMPLE_KERNELS_H */
+
+//***************************************************************************
+//***************************************************************************
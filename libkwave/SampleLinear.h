@@ -0,0 +1,155 @@
+/***************************************************************************
+          SampleLinear.h  -  templates for linear sample formats
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SAMPLE_LINEAR_H
+#define SAMPLE_LINEAR_H
+
+#include "config.h"
+
+#include <QtGlobal>
+
+#include "libkwave/Sample.h"
+
+/*
+ * Generic conversion between Kwave's sample format and all non-compressed
+ * linear formats. They are used for the formats that have no optimized
+ * variant in Kwave::SampleKernels and serve as reference for them.
+ */
+
+namespace Kwave
+{
+
+    /**
+     * Template for encoding a buffer with linear samples. The tricky
+     * part is done in the compiler which optimizes away all unused parts
+     * of current variant and does nice loop optimizing!
+     * @param src array with samples in Kwave's format
+     * @param dst array that receives the raw data
+     * @param count the number of samples to be encoded
+     */
+    template<const unsigned int bits, const bool is_signed,
+             const bool is_little_endian>
+    void encode_linear(const sample_t *src, quint8 *dst,
+                       unsigned int count)
+    {
+        for ( ; count; --count) {
+            // read from source buffer
+            sample_t s = *(src++);
+
+            // convert to unsigned if necessary
+            if (!is_signed)
+                s += 1 << (SAMPLE_BITS - 1);
+
+            // shrink 18/20 bits and similar down, otherwise it does not
+            // work with ALSA for some dubious reason !?
+            if (bits == 20)
+                s >>= 4;
+            if (bits == 18) // don't ask me why... !!!???
+                s >>= 6;
+
+            if (is_little_endian) {
+                // little endian
+                if (bits > 24)
+                    *(dst++) = 0x00;
+                if (bits > 16)
+                    *(dst++) = static_cast<quint8>(s & 0xFF);
+                if (bits > 8)
+                    *(dst++) = static_cast<quint8>(s >> 8);
+                if (bits >= 8)
+                    *(dst++) = static_cast<quint8>(s >> 16);
+            } else {
+                // big endian
+                if (bits >= 8)
+                    *(dst++) = static_cast<quint8>(s >> 16);
+                if (bits > 8)
+                    *(dst++) = static_cast<quint8>(s >> 8);
+                if (bits > 16)
+                    *(dst++) = static_cast<quint8>(s & 0xFF);
+                if (bits > 24)
+                    *(dst++) = 0x00;
+            }
+        }
+    }
+
+    // this little function is provided as inline code to avaid a compiler
+    // warning about negative shift value when included directly
+    static inline quint32 shl(const quint32 v, const int s)
+    {
+        if (!s)
+            return v;
+        else if (s > 0)
+            return (v << s);
+        else
+            return (v >> (-s));
+    }
+
+    /**
+     * Template for decoding a buffer with linear samples. The tricky
+     * part is done in the compiler which optimizes away all unused parts
+     * of current variant and does nice loop optimizing!
+     * @param src array with raw data
+     * @param dst array that receives the samples in Kwave's format
+     * @param count the number of samples to be decoded
+     */
+    template<const unsigned int bits, const bool is_signed,
+             const bool is_little_endian>
+    void decode_linear(const quint8 *src, sample_t *dst,
+                       unsigned int count)
+    {
+        const int shift = (SAMPLE_BITS - bits);
+        const quint32 sign = 1 << (SAMPLE_BITS-1);
+        const quint32 negative = ~(sign - 1);
+        const quint32 bytes = (bits+7) >> 3;
+
+        while (count) {
+            count--;
+
+            // read from source buffer
+            quint32 s = 0;
+            if (is_little_endian) {
+                // little endian
+                for (unsigned int byte = 0; byte < bytes;
+                     ++byte, ++src)
+                {
+                    s |= static_cast<quint8>(*src) << (byte << 3);
+                }
+            } else {
+                // big endian
+                for (int byte = bytes - 1; byte >= 0; --byte, ++src) {
+                    s |= static_cast<quint8>(*src) << (byte << 3);
+                }
+            }
+
+            // convert to signed
+            if (!is_signed) s -= shl(1, bits-1)-1;
+
+            // shift up to Kwave's bit count
+            s = shl(s, shift);
+
+            // sign correcture for negative values
+            if (is_signed && (s & sign)) s |= negative;
+
+            // write to destination buffer
+            *(dst++) = static_cast<sample_t>(s);
+        }
+    }
+}
+
+#endif /* SAMPLE_LINEAR_H */
+
+//***************************************************************************
+//***************************************************************************
@@ -35,7 +35,7 @@ Kwave::SampleReader::SampleReader(Kwave::ReaderMode mode,
      m_src_position(stripes.left()), m_first(stripes.left()),
      m_last(stripes.right()), m_buffer(blockSize()),
      m_buffer_used(0), m_buffer_position(0),
-     m_progress_time(), m_last_seek_pos(stripes.right())
+     m_progress_time(), m_last_seek_pos(stripes.right()), m_block()
 {
     m_progress_time.start();
 }
@@ -157,7 +157,6 @@ unsigned int Kwave::SampleReader::read(Kwave::SampleArray &buffer,
         rest   -= cnt;
         dstoff += cnt;
 
-        qDebug("filling from buffer dstoff=%u, cnt=%u",dstoff,cnt);
         const Kwave::SampleArray &in = m_buffer;
         MEMCPY(&(buffer[dst]), &(in[src]), cnt * sizeof(sample_t));
 
@@ -291,9 +290,14 @@ Kwave::SampleReader &Kwave::SampleReader::operator >> (
 //***************************************************************************
 void Kwave::SampleReader::goOn()
 {
-    Kwave::SampleArray buffer(blockSize());
-    (*this) >> buffer;
-    output(buffer);
+    // re-use the previous block, unless a sink still holds a reference
+    // to it or it has been shrunk at the end of the input
+    const unsigned int block_size = blockSize();
+    if (!m_block.isDetached() || (m_block.size() != block_size))
+        m_block = Kwave::SampleArray(block_size);
+
+    (*this) >> m_block;
+    output(m_block);
 }
 
 //***************************************************************************
@@ -317,7 +321,7 @@ unsigned int Kwave::SampleReader::readSamples(sample_index_t offset,
 
         if (left < start) {
             // gap before the stripe -> pad
-            sample_index_t pad = Kwave::toUint(start - left);
+            sample_index_t pad = start - left;
             if (pad > rest) pad = rest;
             padBuffer(buffer, buf_offset, Kwave::toUint(pad));
             buf_offset += pad;
@@ -198,6 +198,9 @@ namespace Kwave
         /** last seek position, needed in SinglePassReverse mode */
         sample_index_t m_last_seek_pos;
 
+        /** block passed to the output, re-used if nobody kept a copy */
+        Kwave::SampleArray m_block;
+
     };
 }
 
@@ -182,6 +182,48 @@ Kwave::Stripe::List Kwave::Signal::stripes(unsigned int track,
     return Kwave::Stripe::List(); // track does not exist !
 }
 
+//***************************************************************************
+void Kwave::Signal::minMax(unsigned int track,
+                           sample_index_t first, sample_index_t last,
+                           sample_t &min, sample_t &max)
+{
+    QReadLocker lock(&m_lock_tracks);
+
+    min = 0;
+    max = 0;
+    if (static_cast<size_t>(track) < m_tracks.size()) {
+        Kwave::Track *t = m_tracks.at(track);
+        Q_ASSERT(t);
+        if (t) t->minMax(first, last, min, max);
+    }
+}
+
+//***************************************************************************
+bool Kwave::Signal::cachedAnalysis(unsigned int track, const QString &key,
+                                   sample_index_t first, sample_index_t last,
+                                   double &value)
+{
+    QReadLocker lock(&m_lock_tracks);
+
+    if (static_cast<size_t>(track) >= m_tracks.size()) return false;
+    Kwave::Track *t = m_tracks.at(track);
+    Q_ASSERT(t);
+    return (t) ? t->cachedAnalysis(key, first, last, value) : false;
+}
+
+//***************************************************************************
+void Kwave::Signal::cacheAnalysis(unsigned int track, const QString &key,
+                                  sample_index_t first, sample_index_t last,
+                                  double value)
+{
+    QReadLocker lock(&m_lock_tracks);
+
+    if (static_cast<size_t>(track) >= m_tracks.size()) return;
+    Kwave::Track *t = m_tracks.at(track);
+    Q_ASSERT(t);
+    if (t) t->cacheAnalysis(key, first, last, value);
+}
+
 //***************************************************************************
 bool Kwave::Signal::mergeStripes(const Kwave::Stripe::List &stripes,
                                  unsigned int track)
@@ -300,6 +342,15 @@ quint64 Kwave::Signal::uidOfTrack(unsigned int track)
     return m_tracks.at(track)->uid();
 }
 
+//***************************************************************************
+Kwave::Track *Kwave::Signal::track(unsigned int track)
+{
+    QReadLocker lock(&m_lock_tracks);
+
+    if (static_cast<size_t>(track) >= m_tracks.size()) return nullptr;
+    return m_tracks.at(track);
+}
+
 //// now follow the various editing and effects functions
 ////**********************************************************
 //#define MAXPRIME 512
@@ -28,6 +28,7 @@
 
 #include <QtGlobal>
 #include <QReadWriteLock>
+#include <QString>
 #include <QVector>
 
 #include "libkwave/InsertMode.h"
@@ -136,6 +137,38 @@ namespace Kwave
                                     sample_index_t left = 0,
                                     sample_index_t right = SAMPLE_INDEX_MAX);
 
+        /**
+         * Returns the minimum and maximum sample value within a range
+         * of samples of a track, using the peak cache of the track.
+         * @param track index of the track
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @param min receives the lowest value, zero if not available
+         * @param max receives the highest value, zero if not available
+         */
+        void minMax(unsigned int track,
+                    sample_index_t first, sample_index_t last,
+                    sample_t &min, sample_t &max);
+
+        /**
+         * Looks up a cached result of an analysis of a range of samples
+         * @see Kwave::Track::cachedAnalysis
+         * @param track index of the track
+         * @return true if found, false if not cached
+         */
+        bool cachedAnalysis(unsigned int track, const QString &key,
+                            sample_index_t first, sample_index_t last,
+                            double &value);
+
+        /**
+         * Stores the result of an analysis of a range of samples
+         * @see Kwave::Track::cacheAnalysis
+         * @param track index of the track
+         */
+        void cacheAnalysis(unsigned int track, const QString &key,
+                           sample_index_t first, sample_index_t last,
+                           double value);
+
         /**
          * Merge a list of stripes into the signal.
          * @param stripes list of stripes
@@ -198,6 +231,15 @@ namespace Kwave
          */
         quint64 uidOfTrack(unsigned int track);
 
+        /**
+         * Returns a pointer to a track
+         * @param track index of the track [0...tracks-1]
+         * @return pointer to the track or null if the track does not
+         *         exist. The pointer is only valid as long as the
+         *         track is not deleted.
+         */
+        Kwave::Track *track(unsigned int track);
+
     signals:
 
         /**
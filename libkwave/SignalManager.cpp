@@ -31,6 +31,8 @@
 #include <QFileInfo>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QHash>
+#include <QList>
 #include <QMutableListIterator>
 #include <QMutexLocker>
 #include <QUrl>
@@ -43,6 +45,7 @@
 
 #include "libkwave/ClipBoard.h"
 #include "libkwave/CodecManager.h"
+#include "libkwave/Compression.h"
 #include "libkwave/Decoder.h"
 #include "libkwave/Encoder.h"
 #include "libkwave/FileProgress.h"
@@ -52,6 +55,7 @@
 #include "libkwave/MultiTrackReader.h"
 #include "libkwave/MultiTrackWriter.h"
 #include "libkwave/Parser.h"
+#include "libkwave/PeakFile.h"
 #include "libkwave/Sample.h"
 #include "libkwave/Signal.h"
 #include "libkwave/SignalManager.h"
@@ -74,6 +78,127 @@
 
 #define CASE_COMMAND(x) } else if (parser.command() == _(x)) {
 
+namespace Kwave
+{
+    /**
+     * Keeps track of the memory used by undo and redo transactions.
+     * Sample storage that is shared by several transactions is counted
+     * only once. Deleting a transaction only measures the transactions
+     * again that shared storage with it.
+     */
+    class UndoMemory
+    {
+    public:
+        /** Constructor */
+        UndoMemory()
+            :m_sizes(), m_maps(), m_storage(), m_size(0), m_unique(0)
+        {
+        }
+
+        /** Destructor */
+        virtual ~UndoMemory()
+        {
+        }
+
+        /** returns the memory used by all transactions [bytes] */
+        qint64 size() const { return m_size + m_unique; }
+
+        /**
+         * Measures a transaction and adds it
+         * @param transaction an undo or redo transaction, not null
+         */
+        void add(Kwave::UndoTransaction *transaction)
+        {
+            Kwave::Stripe::StorageMap map;
+            const qint64 bytes = transaction->countStorage(map);
+
+            for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+                auto use = m_storage.find(it.key());
+                if (use == m_storage.end()) {
+                    use = m_storage.insert(it.key(), it.value());
+                } else {
+                    m_unique -= Kwave::Stripe::uniqueSize(*use);
+                    use->references += it->references;
+                    use->total       = it->total;
+                }
+                m_unique += Kwave::Stripe::uniqueSize(*use);
+            }
+
+            m_size += bytes;
+            m_sizes.insert(transaction, bytes);
+            m_maps.insert(transaction, map);
+        }
+
+        /**
+         * Deletes a transaction and measures the transactions again
+         * that shared sample storage with it
+         * @param transaction one of the added transactions
+         */
+        void deleteTransaction(Kwave::UndoTransaction *transaction)
+        {
+            const Kwave::Stripe::StorageMap map = m_maps.value(transaction);
+            remove(transaction);
+            delete transaction;
+            if (map.isEmpty()) return;
+
+            const QList<const void *> storage = map.keys();
+            QList<Kwave::UndoTransaction *> sharing;
+            for (auto it = m_maps.constBegin(); it != m_maps.constEnd(); ++it) {
+                for (const void *key : storage) {
+                    if (!it->contains(key)) continue;
+                    sharing.append(it.key());
+                    break;
+                }
+            }
+
+            for (Kwave::UndoTransaction *other : sharing) {
+                remove(other);
+                add(other);
+            }
+        }
+
+    private:
+
+        /**
+         * Removes a transaction without deleting it
+         * @param transaction one of the added transactions
+         */
+        void remove(Kwave::UndoTransaction *transaction)
+        {
+            const Kwave::Stripe::StorageMap map = m_maps.take(transaction);
+            m_size -= m_sizes.take(transaction);
+
+            for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+                auto use = m_storage.find(it.key());
+                if (use == m_storage.end()) continue;
+                m_unique -= Kwave::Stripe::uniqueSize(*use);
+                use->references -= it->references;
+                if (use->references > 0)
+                    m_unique += Kwave::Stripe::uniqueSize(*use);
+                else
+                    m_storage.erase(use);
+            }
+        }
+
+    private:
+
+        /** size of each transaction, without its sample storage */
+        QHash<Kwave::UndoTransaction *, qint64> m_sizes;
+
+        /** sample storage of each transaction */
+        QHash<Kwave::UndoTransaction *, Kwave::Stripe::StorageMap> m_maps;
+
+        /** sample storage of all transactions */
+        Kwave::Stripe::StorageMap m_storage;
+
+        /** sum of m_sizes */
+        qint64 m_size;
+
+        /** storage in m_storage that nobody else uses [bytes] */
+        qint64 m_unique;
+    };
+}
+
 //***************************************************************************
 Kwave::SignalManager::SignalManager(QWidget *parent)
     :QObject(),
@@ -189,6 +314,7 @@ int Kwave::SignalManager::loadFile(const QUrl &url)
         Q_ASSERT(tracks);
         if (!tracks) break;
 
+        QList<Kwave::Track *> new_tracks;
         for (track = 0; track < tracks; ++track) {
             Kwave::Track *t = m_signal.insertTrack(0, length, 0);
             Q_ASSERT(t);
@@ -197,9 +323,15 @@ int Kwave::SignalManager::loadFile(const QUrl &url)
                 res = -ENOMEM;
                 break;
             }
+            new_tracks.prepend(t);
         }
         if (track < tracks) break;
 
+        // take over the peaks from the last time the file was loaded
+        // or saved, this makes the overview available immediately
+        const bool peaks_loaded = !streaming &&
+            Kwave::PeakFile(fi.absoluteFilePath()).load(new_tracks, length);
+
         // create the multitrack writer as destination
         // if length was zero -> append mode / decode a stream ?
         Kwave::InsertMode mode = (streaming) ? Kwave::Append : Kwave::Overwrite;
@@ -213,11 +345,13 @@ int Kwave::SignalManager::loadFile(const QUrl &url)
         bool use_src_size = (!resulting_size);
         if (use_src_size) resulting_size = src.size();
 
-        // prepare and show the progress dialog
-        dialog = new(std::nothrow) Kwave::FileProgress(m_parent_widget,
-            QUrl(filename), resulting_size,
-            info.length(), info.rate(), info.bits(), info.tracks());
-        Q_ASSERT(dialog);
+        // prepare and show the progress dialog, not without GUI
+        if (!Kwave::isHeadless()) {
+            dialog = new(std::nothrow) Kwave::FileProgress(m_parent_widget,
+                QUrl(filename), resulting_size,
+                info.length(), info.rate(), info.bits(), info.tracks());
+            Q_ASSERT(dialog);
+        }
 
         if (dialog)
         {
@@ -271,6 +405,17 @@ int Kwave::SignalManager::loadFile(const QUrl &url)
 
         decoder->close();
 
+        // the peaks are complete now if the file has been decoded up to
+        // the end, otherwise remember them for the next time
+        const bool complete = ok && !writers.isCanceled() &&
+            (info.length() == length);
+        if (peaks_loaded) {
+            for (Kwave::Track *t : new_tracks)
+                t->freezePeaks(false, complete);
+        } else if (complete && Kwave::PeakFile::isUseful(length)) {
+            savePeakFile(fi.absoluteFilePath());
+        }
+
         // check for length info in stream mode
         if (!res && streaming) {
             // source was opened in stream mode -> now we have the length
@@ -367,6 +512,7 @@ int Kwave::SignalManager::save(const QUrl &url, bool selection)
 
     Kwave::Encoder *encoder = Kwave::CodecManager::encoder(mimetype_name);
     Kwave::FileInfo file_info(m_meta_data);
+    bool lossless = false;
     if (encoder) {
 
         // maybe we now have a new mime type
@@ -374,31 +520,9 @@ int Kwave::SignalManager::save(const QUrl &url, bool selection)
 
         // check if we lose information and ask the user if this would
         // be acceptable
-        QList<Kwave::FileProperty> unsupported = encoder->unsupportedProperties(
-            file_info.properties().keys());
-        if (!unsupported.isEmpty()) {
-            QString list_of_lost_properties = _("\n");
-            for (const Kwave::FileProperty &p : unsupported) {
-                list_of_lost_properties +=
-                    i18n(UTF8(file_info.name(p))) + _("\n");
-            }
-
-            // show a warning to the user and ask him if he wants to continue
-            if (Kwave::MessageBox::warningContinueCancel(m_parent_widget,
-                i18n("Saving in this format will lose the following "
-                     "additional file attribute(s):\n"
-                     "%1\n"
-                     "Do you still want to continue?",
-                     list_of_lost_properties),
-                QString(),
-                QString(),
-                QString(),
-                _("accept_lose_attributes_on_export")
-                ) != KMessageBox::Continue)
-            {
-                delete encoder;
-                return -1;
-            }
+        if (!acceptLostProperties(*encoder, file_info)) {
+            delete encoder;
+            return -1;
         }
 
         // open the destination file
@@ -410,41 +534,29 @@ int Kwave::SignalManager::save(const QUrl &url, bool selection)
             ofs, ofs + len - 1);
 
         // update the file information
-        file_info.setLength(len);
-        file_info.setRate(rate());
-        file_info.setBits(bits);
-        file_info.setTracks(tracks);
-
-        if (!file_info.contains(Kwave::INF_SOFTWARE) &&
-            encoder->supportedProperties().contains(Kwave::INF_SOFTWARE))
-        {
-            // add our Kwave Software tag
-            const KAboutData about_data = KAboutData::applicationData();
-            QString software = about_data.displayName() + _("-") +
-                               about_data.version() + _(" ") +
-                               i18n("(built with KDE Frameworks %1)",
-                                    _(KXMLGUI_VERSION_STRING));
-            file_info.set(Kwave::INF_SOFTWARE, software);
-        }
-
-        if (!file_info.contains(Kwave::INF_CREATION_DATE) &&
-            encoder->supportedProperties().contains(Kwave::INF_CREATION_DATE))
-        {
-            // add a date tag
-            QString date(QDate::currentDate().toString(_("yyyy-MM-dd")));
-            qDebug("adding date tag: '%s'", DBG(date));
-            file_info.set(Kwave::INF_CREATION_DATE, date);
-        }
-
-        // prepare and show the progress dialog
-        Kwave::FileProgress *dialog = new(std::nothrow)
-            Kwave::FileProgress(m_parent_widget, QUrl(filename),
+        prepareFileInfo(file_info, *encoder, len, tracks);
+
+        // lossless compression and no reduced resolution ?
+        const Kwave::Compression::Type compression =
+            Kwave::Compression::fromInt(
+                file_info.get(Kwave::INF_COMPRESSION).toInt());
+        lossless = ((compression == Kwave::Compression::NONE) ||
+                    (compression == Kwave::Compression::FLAC) ||
+                    (compression == Kwave::Compression::ALAC)) &&
+                   (file_info.bits() >= SAMPLE_BITS);
+
+        // prepare and show the progress dialog, not without GUI
+        Kwave::FileProgress *dialog = nullptr;
+        if (!Kwave::isHeadless()) {
+            dialog = new(std::nothrow) Kwave::FileProgress(m_parent_widget,
+                QUrl(filename),
                 file_info.length() * file_info.tracks() *
                 (file_info.bits() >> 3),
                 file_info.length(), file_info.rate(), file_info.bits(),
                 file_info.tracks()
             );
-        Q_ASSERT(dialog);
+            Q_ASSERT(dialog);
+        }
         if (dialog) {
             QObject::connect(&src,   SIGNAL(progress(qreal)),
                              dialog, SLOT(setValue(qreal)),
@@ -509,6 +621,11 @@ int Kwave::SignalManager::save(const QUrl &url, bool selection)
         flushUndoBuffers();
         enableModifiedChange(true);
         setModified(false);
+
+        // remember the peaks of the saved file for the next time, but
+        // only if reading it back will give exactly the same samples
+        if (lossless && Kwave::PeakFile::isUseful(length()))
+            savePeakFile(url.path());
     }
 
     emit sigMetaDataChanged(m_meta_data);
@@ -516,6 +633,65 @@ int Kwave::SignalManager::save(const QUrl &url, bool selection)
     return res;
 }
 
+//***************************************************************************
+bool Kwave::SignalManager::acceptLostProperties(Kwave::Encoder &encoder,
+                                                const Kwave::FileInfo &info)
+{
+    QList<Kwave::FileProperty> unsupported = encoder.unsupportedProperties(
+        info.properties().keys());
+    if (unsupported.isEmpty()) return true;
+
+    QString list_of_lost_properties = _("\n");
+    for (const Kwave::FileProperty &p : unsupported)
+        list_of_lost_properties += i18n(UTF8(info.name(p))) + _("\n");
+
+    // show a warning to the user and ask him if he wants to continue
+    return (Kwave::MessageBox::warningContinueCancel(m_parent_widget,
+        i18n("Saving in this format will lose the following "
+             "additional file attribute(s):\n"
+             "%1\n"
+             "Do you still want to continue?",
+             list_of_lost_properties),
+        QString(),
+        QString(),
+        QString(),
+        _("accept_lose_attributes_on_export")
+        ) == KMessageBox::Continue);
+}
+
+//***************************************************************************
+void Kwave::SignalManager::prepareFileInfo(Kwave::FileInfo &info,
+                                           Kwave::Encoder &encoder,
+                                           sample_index_t length,
+                                           unsigned int tracks)
+{
+    info.setLength(length);
+    info.setRate(rate());
+    info.setBits(bits());
+    info.setTracks(tracks);
+
+    if (!info.contains(Kwave::INF_SOFTWARE) &&
+        encoder.supportedProperties().contains(Kwave::INF_SOFTWARE))
+    {
+        // add our Kwave Software tag
+        const KAboutData about_data = KAboutData::applicationData();
+        QString software = about_data.displayName() + _("-") +
+                           about_data.version() + _(" ") +
+                           i18n("(built with KDE Frameworks %1)",
+                                _(KXMLGUI_VERSION_STRING));
+        info.set(Kwave::INF_SOFTWARE, software);
+    }
+
+    if (!info.contains(Kwave::INF_CREATION_DATE) &&
+        encoder.supportedProperties().contains(Kwave::INF_CREATION_DATE))
+    {
+        // add a date tag
+        QString date(QDate::currentDate().toString(_("yyyy-MM-dd")));
+        qDebug("adding date tag: '%s'", DBG(date));
+        info.set(Kwave::INF_CREATION_DATE, date);
+    }
+}
+
 //***************************************************************************
 void Kwave::SignalManager::newSignal(sample_index_t samples, double rate,
                                      unsigned int bits, unsigned int tracks)
@@ -755,6 +931,39 @@ int Kwave::SignalManager::executeCommand(const QString &command)
         int index = parser.toInt();
         deleteLabel(index, true);
 
+    // --- only reached here if there is no main widget ---
+    CASE_COMMAND("label:add")
+        // without GUI the description cannot be edited, it stays empty
+        sample_index_t pos = parser.toSampleIndex();
+        const QString description =
+            (!parser.isDone()) ? parser.nextParam() : QString();
+        addLabel(pos, description);
+    CASE_COMMAND("label:edit")
+        qWarning("SignalManager: no label dialog without GUI");
+        return -EINVAL;
+    CASE_COMMAND("goto")
+        selectRange(parser.toSampleIndex(), 0);
+    CASE_COMMAND("selectall")
+        selectRange(0, this->length());
+    CASE_COMMAND("selectnext")
+        if (length)
+            selectRange(m_selection.last() + 1, length);
+        else
+            selectRange(this->length() - 1, 0);
+    CASE_COMMAND("selectprev")
+        sample_index_t len = (length) ? length : 1;
+        if (len > offset) len = offset;
+        selectRange(offset - len, len);
+    CASE_COMMAND("selecttoleft")
+        selectRange(0, m_selection.last() + 1);
+    CASE_COMMAND("selecttoright")
+        selectRange(offset, this->length() - offset);
+    CASE_COMMAND("selectvisible")
+        // without a view the whole signal is visible
+        selectRange(0, this->length());
+    CASE_COMMAND("selectnone")
+        selectRange(offset, 0);
+
     CASE_COMMAND("expandtolabel")
         Kwave::UndoTransactionGuard undo(*this,
                                          i18n("Expand Selection to Label"));
@@ -1296,6 +1505,7 @@ void Kwave::SignalManager::closeUndoTransaction()
                     m_undo_transaction = nullptr;
                 } else {
                     m_undo_buffer.append(m_undo_transaction);
+                    packUndoData();
                 }
             } else {
                 qDebug("SignalManager::closeUndoTransaction(): empty");
@@ -1480,32 +1690,24 @@ bool Kwave::SignalManager::saveUndoDelete(QVector<unsigned int> &track_list,
 }
 
 //***************************************************************************
-qint64 Kwave::SignalManager::usedUndoRedoMemory()
+void Kwave::SignalManager::freeUndoMemory(qint64 needed)
 {
-    qint64 size = 0;
+    const qint64 undo_limit = Kwave::undoLimit() << 20;
 
+    // measure everything once, deleting a transaction then updates
+    // only the ones that shared storage with it
+    Kwave::UndoMemory memory;
     for (Kwave::UndoTransaction *undo : m_undo_buffer)
-        if (undo) size += undo->undoSize();
-
+        if (undo) memory.add(undo);
     for (Kwave::UndoTransaction *redo : m_redo_buffer)
-        if (redo) size += redo->undoSize();
-
-    return size;
-}
-
-//***************************************************************************
-void Kwave::SignalManager::freeUndoMemory(qint64 needed)
-{
-    qint64 size = usedUndoRedoMemory() + needed;
-    qint64 undo_limit = Kwave::undoLimit() << 20;
+        if (redo) memory.add(redo);
 
     // remove old undo actions if not enough free memory
-    while (!m_undo_buffer.isEmpty() && (size > undo_limit)) {
+    while (!m_undo_buffer.isEmpty() && (memory.size() + needed > undo_limit))
+    {
         Kwave::UndoTransaction *undo = m_undo_buffer.takeFirst();
         if (!undo) continue;
-        qint64 s = undo->undoSize();
-        size = (size >= s) ? (size - s) : 0;
-        delete undo;
+        memory.deleteTransaction(undo);
 
         // if the signal was modified, it will stay in this state, it is
         // not possible to change to "non-modified" state through undo
@@ -1513,15 +1715,38 @@ void Kwave::SignalManager::freeUndoMemory(qint64 needed)
     }
 
     // remove old redo actions if still not enough memory
-    while (!m_redo_buffer.isEmpty() && (size > undo_limit)) {
+    while (!m_redo_buffer.isEmpty() && (memory.size() + needed > undo_limit))
+    {
         Kwave::UndoTransaction *redo = m_redo_buffer.takeLast();
         if (!redo) continue;
-        qint64 s = redo->undoSize();
-        size = (size >= s) ? (size - s) : 0;
-        delete redo;
+        memory.deleteTransaction(redo);
     }
 }
 
+//***************************************************************************
+void Kwave::SignalManager::packUndoData()
+{
+    if (m_undo_buffer.count() < 2) return;
+
+    Kwave::UndoTransaction *transaction =
+        m_undo_buffer.at(m_undo_buffer.count() - 2);
+    if (transaction) transaction->startPacking();
+}
+
+//***************************************************************************
+void Kwave::SignalManager::savePeakFile(const QString &filename)
+{
+    const sample_index_t length = this->length();
+    if (!length) return;
+
+    // scanning all samples takes a while, so do it on a snapshot
+    const QList<Kwave::Stripe::List> snapshot =
+        stripes(allTracks(), 0, length - 1);
+    auto discard = QtConcurrent::run([filename, snapshot, length]() {
+        Kwave::PeakFile(filename).save(snapshot, length);
+    });
+}
+
 //***************************************************************************
 void Kwave::SignalManager::emitUndoRedoInfo()
 {
@@ -1566,6 +1791,9 @@ void Kwave::SignalManager::undo()
     Kwave::UndoTransaction *undo_transaction = m_undo_buffer.takeLast();
     if (!undo_transaction) return;
 
+    // it might still be packed in the background, stop that
+    undo_transaction->cancelPacking();
+
     // dump, for debugging
 //     undo_transaction->dump("before undo: ");
 
@@ -45,6 +45,7 @@ class QUrl;
 namespace Kwave
 {
 
+    class Encoder;
     class UndoAction;
     class UndoInsertAction;
     class UndoTransaction;
@@ -168,6 +169,28 @@ namespace Kwave
          */
         int save(const QUrl &url, bool selection);
 
+        /**
+         * Checks whether an encoder would lose some properties of a file
+         * info and asks the user whether this is acceptable.
+         * @param encoder the encoder that will be used for saving
+         * @param info the file info that will be saved
+         * @return true if nothing gets lost or the user accepted it
+         */
+        bool acceptLostProperties(Kwave::Encoder &encoder,
+                                  const Kwave::FileInfo &info);
+
+        /**
+         * Completes a file info for saving a range of samples. Sets the
+         * length, rate, resolution and number of tracks and adds a
+         * software and a date tag if the encoder supports them.
+         * @param info the file info to be completed
+         * @param encoder the encoder that will be used for saving
+         * @param length number of samples that will be saved
+         * @param tracks number of tracks that will be saved
+         */
+        void prepareFileInfo(Kwave::FileInfo &info, Kwave::Encoder &encoder,
+                             sample_index_t length, unsigned int tracks);
+
         /**
          * Deletes a range of samples and creates an undo action.
          * @param offset index of the first sample
@@ -275,6 +298,40 @@ namespace Kwave
             return m_signal.openReader(mode, track, left, right);
         }
 
+        /**
+         * Returns the minimum and maximum sample value within a range
+         * of samples of a track.
+         * @see Kwave::Signal::minMax
+         */
+        inline void minMax(unsigned int track,
+                           sample_index_t first, sample_index_t last,
+                           sample_t &min, sample_t &max)
+        {
+            m_signal.minMax(track, first, last, min, max);
+        }
+
+        /**
+         * Looks up a cached result of an analysis of a range of samples
+         * @see Kwave::Signal::cachedAnalysis
+         */
+        inline bool cachedAnalysis(unsigned int track, const QString &key,
+                                   sample_index_t first, sample_index_t last,
+                                   double &value)
+        {
+            return m_signal.cachedAnalysis(track, key, first, last, value);
+        }
+
+        /**
+         * Stores the result of an analysis of a range of samples
+         * @see Kwave::Signal::cacheAnalysis
+         */
+        inline void cacheAnalysis(unsigned int track, const QString &key,
+                                  sample_index_t first, sample_index_t last,
+                                  double value)
+        {
+            m_signal.cacheAnalysis(track, key, first, last, value);
+        }
+
 
         /**
          * Get a list of stripes that matches a given range of samples
@@ -667,11 +724,6 @@ namespace Kwave
          */
         bool continueWithoutUndo();
 
-        /**
-         * Returns the amount of memory currently used for undo + redo.
-         */
-        qint64 usedUndoRedoMemory();
-
         /**
          * Makes sure that enough memory for a following undo (or redo) action
          * is available. If necessary, it deletes old undo transactions and if
@@ -680,6 +732,22 @@ namespace Kwave
          */
         void freeUndoMemory(qint64 needed);
 
+        /**
+         * Starts compressing the data of the undo transaction before the
+         * last one in a background thread. The last one is kept as it is,
+         * as it is the one that will be undone first.
+         * @see Kwave::UndoTransaction::startPacking()
+         */
+        void packUndoData();
+
+        /**
+         * Writes the peak file of an audio file in a background thread,
+         * from a snapshot of all tracks of the signal
+         * @param filename path of the audio file
+         * @see Kwave::PeakFile
+         */
+        void savePeakFile(const QString &filename);
+
         /**
          * Enables changes of the modified flag.
          * @param en new value for m_modified_enabled
@@ -19,6 +19,10 @@
 
 #include <string.h> // for some speed-ups like memmove, memcpy ...
 
+#include <algorithm>
+
+#include "libkwave/MemoryManager.h"
+#include "libkwave/SampleKernels.h"
 #include "libkwave/Stripe.h"
 #include "libkwave/Utils.h"
 #include "libkwave/memcpy.h"
@@ -118,6 +122,51 @@ sample_index_t Kwave::Stripe::end() const
     return (size) ? (m_start + size - 1) : 0;
 }
 
+//***************************************************************************
+qint64 Kwave::Stripe::uniqueSize() const
+{
+    QMutexLocker lock(&m_lock);
+    if (!m_data.isDetached()) return 0;
+    return static_cast<qint64>(m_data.size()) * sizeof(sample_t);
+}
+
+//***************************************************************************
+void Kwave::Stripe::countStorage(StorageMap &map) const
+{
+    QMutexLocker lock(&m_lock);
+    const void *storage = m_data.storage();
+    if (!storage) return;
+
+    StorageMap::iterator it = map.find(storage);
+    if (it == map.end()) {
+        StorageUse use;
+        use.references = 1;
+        use.total      = m_data.references();
+        use.bytes      = static_cast<qint64>(m_data.size()) * sizeof(sample_t);
+        map.insert(storage, use);
+    } else {
+        it->references++;
+        it->total = m_data.references();
+    }
+}
+
+//***************************************************************************
+qint64 Kwave::Stripe::uniqueSize(const StorageMap &map)
+{
+    qint64 size = 0;
+    for (const StorageUse &use : map)
+        size += uniqueSize(use);
+    return size;
+}
+
+//***************************************************************************
+qint64 Kwave::Stripe::uniqueSize(const StorageUse &use)
+{
+    // NOTE: lists of stripes can be implicitly shared, so a stripe may
+    //       be counted more often than its storage has references
+    return (use.references >= use.total) ? use.bytes : 0;
+}
+
 //***************************************************************************
 unsigned int Kwave::Stripe::resize(unsigned int length)
 {
@@ -222,6 +271,7 @@ void Kwave::Stripe::overwrite(unsigned int offset,
     const sample_t *src = source.constData();
     sample_t       *dst = this->m_data.data();
     unsigned int    len = srclen * sizeof(sample_t);
+    Kwave::MemoryManager::instance().touch(dst);
     MEMCPY(dst + offset, src + srcoff, len);
 }
 
@@ -244,6 +294,7 @@ unsigned int Kwave::Stripe::read(Kwave::SampleArray &buffer,
 
     // directly memcpy
     const sample_t *src = m_data.constData();
+    Kwave::MemoryManager::instance().touch(src);
     sample_t       *dst = buffer.data();
     unsigned int    len = length * sizeof(sample_t);
     MEMCPY(dst + dstoff, src + offset, len);
@@ -260,34 +311,82 @@ void Kwave::Stripe::minMax(unsigned int first, unsigned int last,
 
     const sample_t *buffer = m_data.constData();
     if (!buffer) return;
+    Kwave::MemoryManager::instance().touch(buffer);
 
     // loop over the storage to get min/max
-    sample_t lo = min;
-    sample_t hi = max;
+    Q_ASSERT(first < m_data.size());
+    Q_ASSERT(first <= last);
+    Q_ASSERT(last < m_data.size());
+    Kwave::SampleKernels::minMax(buffer + first, last - first + 1, min, max);
+}
+
+//***************************************************************************
+void Kwave::Stripe::peaks(unsigned int first, unsigned int last,
+                          sample_t &min, sample_t &max, double &power)
+{
+    QMutexLocker lock(&m_lock);
+    if (m_data.isEmpty()) return;
+
+    const sample_t *buffer = m_data.constData();
+    if (!buffer) return;
+    Kwave::MemoryManager::instance().touch(buffer);
+
     Q_ASSERT(first < m_data.size());
     Q_ASSERT(first <= last);
     Q_ASSERT(last < m_data.size());
     buffer += first;
     unsigned int remaining = last - first + 1;
 
-    // speedup: process a block of 8 samples at once, to allow loop unrolling
-    const unsigned int block = 8;
-    while (Q_LIKELY(remaining >= block)) {
-        for (unsigned int count = 0; Q_LIKELY(count < block); count++) {
-            sample_t s = *(buffer++);
-            if (Q_UNLIKELY(s < lo)) lo = s;
-            if (Q_UNLIKELY(s > hi)) hi = s;
-        }
-        remaining -= block;
-    }
+    // loop over the storage to get min/max and the sum of squares
+    sample_t lo = min;
+    sample_t hi = max;
+    double sum = 0.0;
     while (Q_LIKELY(remaining)) {
-        sample_t s = *(buffer++);
+        const sample_t s = *(buffer++);
         if (Q_UNLIKELY(s < lo)) lo = s;
         if (Q_UNLIKELY(s > hi)) hi = s;
+        const double d = static_cast<double>(s);
+        sum += d * d;
         remaining--;
     }
-    min = lo;
-    max = hi;
+    min    = lo;
+    max    = hi;
+    power += sum;
+}
+
+//***************************************************************************
+void Kwave::Stripe::peaks(Kwave::Stripe *stripes, qsizetype count,
+                          sample_index_t first, sample_index_t last,
+                          sample_t &min, sample_t &max, double &power)
+{
+    // skip all stripes that end before the range
+    Kwave::Stripe *end_of_list = stripes + count;
+    Kwave::Stripe *it = std::lower_bound(stripes, end_of_list, first,
+        [](const Kwave::Stripe &stripe, sample_index_t pos) {
+            return (stripe.end() < pos);
+        });
+
+    sample_index_t covered = 0;
+    for (; it != end_of_list; ++it) {
+        Kwave::Stripe &stripe = *it;
+        if (!stripe.length()) continue;
+        const sample_index_t start = stripe.start();
+        const sample_index_t end   = stripe.end();
+        if (start > last) break;
+
+        const unsigned int s1 = Kwave::toUint(
+            (first > start) ? (first - start) : 0);
+        const unsigned int s2 = Kwave::toUint(
+            ((last < end) ? last : end) - start);
+        stripe.peaks(s1, s2, min, max, power);
+        covered += s2 - s1 + 1;
+    }
+
+    // gaps between the stripes contain silence
+    if (covered < last - first + 1) {
+        if (min > 0) min = 0;
+        if (max < 0) max = 0;
+    }
 }
 
 //***************************************************************************
@@ -24,6 +24,7 @@
 #include <QByteArray>
 #include <QtGlobal>
 #include <QExplicitlySharedDataPointer>
+#include <QHash>
 #include <QList>
 #include <QMutex>
 #include <QSharedData>
@@ -38,6 +39,16 @@ namespace Kwave
     {
     public:
 
+        /** usage of one sample storage, see countStorage() */
+        typedef struct {
+            int    references; /**< number of counted stripes using it  */
+            int    total;      /**< number of all arrays sharing it     */
+            qint64 bytes;      /**< size of the storage in bytes        */
+        } StorageUse;
+
+        /** map of sample storage, indexed by SampleArray::storage() */
+        typedef QHash<const void *, StorageUse> StorageMap;
+
         /**
          * Default constructor. Creates an empty stripe with zero-length.
          */
@@ -103,6 +114,41 @@ namespace Kwave
          */
         sample_index_t end() const;
 
+        /**
+         * Returns the number of bytes of sample storage that are used by
+         * this stripe only, e.g. not shared with a copy of the stripe in
+         * a track, the clipboard or an undo action. This is the amount
+         * of memory that gets freed when the stripe is deleted.
+         * @return size in bytes, zero if the storage is shared
+         */
+        qint64 uniqueSize() const;
+
+        /**
+         * Registers the sample storage of this stripe in a map, to find
+         * out how much storage is used only by a set of stripes, even
+         * if they share it among each other.
+         * @param map receives the storage, references are incremented
+         *            if it already is present
+         * @see uniqueSize(const StorageMap &)
+         */
+        void countStorage(StorageMap &map) const;
+
+        /**
+         * Returns the number of bytes of sample storage that is used
+         * only by the stripes that have been counted in a map
+         * @param map storage that has been filled by countStorage()
+         * @return size in bytes
+         */
+        static qint64 uniqueSize(const StorageMap &map);
+
+        /**
+         * Returns the number of bytes of one sample storage that is used
+         * only by the stripes that have been counted
+         * @param use entry of a map filled by countStorage()
+         * @return size in bytes, zero if something else also uses it
+         */
+        static qint64 uniqueSize(const StorageUse &use);
+
         /**
          * Resizes the stripe to a new number of samples. If the array
          * size is reduced, samples from the end are thrown away. If
@@ -177,6 +223,33 @@ namespace Kwave
         void minMax(unsigned int first, unsigned int last,
                     sample_t &min, sample_t &max);
 
+        /**
+         * Like minMax(), but additionally sums up the squares of the
+         * samples within the range.
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @param min receives the lowest value (must be initialized)
+         * @param max receives the highest value (must be initialized)
+         * @param power receives the sum of squares (is added to)
+         */
+        void peaks(unsigned int first, unsigned int last,
+                   sample_t &min, sample_t &max, double &power);
+
+        /**
+         * Like peaks(), for a range of samples that may span several
+         * stripes. Gaps between the stripes are treated as silence.
+         * @param stripes array of stripes, sorted by start
+         * @param count number of stripes
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @param min receives the lowest value (must be initialized)
+         * @param max receives the highest value (must be initialized)
+         * @param power receives the sum of squares (is added to)
+         */
+        static void peaks(Kwave::Stripe *stripes, qsizetype count,
+                          sample_index_t first, sample_index_t last,
+                          sample_t &min, sample_t &max, double &power);
+
         /**
          * Operator for appending an array of samples to the
          * end of the stripe.
@@ -221,6 +294,29 @@ namespace Kwave
             /** returns the index of the last sample */
             inline sample_index_t right() const { return m_right; }
 
+            /**
+             * returns the number of bytes used by the stripes of this
+             * list only
+             * @see Stripe::uniqueSize()
+             */
+            qint64 uniqueSize() const
+            {
+                qint64 size = 0;
+                for (const Kwave::Stripe &stripe : *this)
+                    size += stripe.uniqueSize();
+                return size;
+            }
+
+            /**
+             * registers the storage of all stripes of this list
+             * @see Stripe::countStorage()
+             */
+            void countStorage(StorageMap &map) const
+            {
+                for (const Kwave::Stripe &stripe : *this)
+                    stripe.countStorage(map);
+            }
+
         private:
             /** index of the first sample */
             sample_index_t m_left;
@@ -232,7 +328,7 @@ namespace Kwave
     private:
 
         /** mutex for locking some operations */
-        QMutex m_lock;
+        mutable QMutex m_lock;
 
         /** start position within the track */
         sample_index_t m_start;
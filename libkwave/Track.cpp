@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <math.h>
 #include <new>
 
 #include <QMutexLocker>
@@ -56,6 +57,18 @@
  */
 #define STRIPE_LENGTH_MINIMUM (STRIPE_LENGTH_OPTIMAL / 2)
 
+/** maximum number of cached analysis results per track */
+#define ANALYSIS_CACHE_SIZE 32
+
+/**
+ * minimum number of missing blocks of the peak cache that are scanned
+ * without holding the lock of the track
+ */
+#define PEAK_UNLOCKED_SCAN_BLOCKS 64
+
+/** number of attempts to scan the peaks while the track is modified */
+#define PEAK_UNLOCKED_SCAN_RETRIES 3
+
 //***************************************************************************
 static inline quint64 createUid()
 {
@@ -65,15 +78,23 @@ static inline quint64 createUid()
 
 //***************************************************************************
 Kwave::Track::Track()
-    :m_lock(), m_lock_usage(), m_stripes(), m_selected(true),
-     m_uid(createUid())
+    :m_lock(), m_lock_usage(), m_stripes(),
+     m_peaks([this](sample_index_t first, sample_index_t last,
+                    Kwave::PeakPyramid::Peak &peak) {
+         scanPeaks(first, last, peak);
+     }),
+     m_selected(true), m_uid(createUid())
 {
 }
 
 //***************************************************************************
 Kwave::Track::Track(sample_index_t length, quint64 uid)
-    :m_lock(), m_lock_usage(), m_stripes(), m_selected(true),
-     m_uid((uid) ? uid : createUid())
+    :m_lock(), m_lock_usage(), m_stripes(),
+     m_peaks([this](sample_index_t first, sample_index_t last,
+                    Kwave::PeakPyramid::Peak &peak) {
+         scanPeaks(first, last, peak);
+     }),
+     m_selected(true), m_uid((uid) ? uid : createUid())
 {
     if (length <= STRIPE_LENGTH_MAXIMUM) {
         if (length) appendStripe(length);
@@ -82,6 +103,7 @@ Kwave::Track::Track(sample_index_t length, quint64 uid)
         s.resize(STRIPE_LENGTH_OPTIMAL);
         if (s.length()) m_stripes.push_back(s);
     }
+    m_peaks.resize(unlockedLength());
 }
 
 //***************************************************************************
@@ -114,6 +136,7 @@ void Kwave::Track::appendStripe(sample_index_t length)
         m_stripes.push_back(s);
     } while (length);
 
+    m_peaks.resize(unlockedLength());
 }
 
 //***************************************************************************
@@ -269,6 +292,10 @@ bool Kwave::Track::mergeStripes(const Kwave::Stripe::List &stripes)
                 break;
             }
         }
+        m_peaks.invalidate(stripes.left(),
+                           stripes.right() - stripes.left() + 1);
+        invalidateAnalysis(stripes.left(), stripes.right());
+        m_peaks.resize(unlockedLength());
     }
 
     // do some defragmentation, to combine the ends of the inserted stripes
@@ -311,6 +338,14 @@ void Kwave::Track::deleteRange(sample_index_t offset, sample_index_t length,
     {
         QMutexLocker lock(&m_lock);
         unlockedDelete(offset, length, make_gap);
+        if (make_gap) {
+            m_peaks.invalidate(offset, length);
+            invalidateAnalysis(offset, offset + length - 1);
+        } else {
+            m_peaks.remove(offset, length);
+            invalidateAnalysis(offset);
+        }
+        m_peaks.resize(unlockedLength());
     }
 
     // deletion without gap might have left some fragments
@@ -364,6 +399,9 @@ bool Kwave::Track::insertSpace(sample_index_t offset, sample_index_t shift)
             s.resize(1);
             if (s.length()) m_stripes.push_back(s);
         }
+        m_peaks.insert(offset, shift);
+        invalidateAnalysis(offset);
+        m_peaks.resize(unlockedLength());
     }
 
 //  dump();
@@ -467,6 +505,176 @@ void Kwave::Track::unlockedDelete(sample_index_t offset, sample_index_t length,
     }
 }
 
+//***************************************************************************
+void Kwave::Track::minMax(sample_index_t first, sample_index_t last,
+                          sample_t &min, sample_t &max)
+{
+    fillPeaks(0, first, last);
+
+    QMutexLocker lock(&m_lock);
+    const Kwave::PeakPyramid::Peak peak = m_peaks.query(first, last);
+    if (peak.isEmpty()) {
+        min = 0;
+        max = 0;
+    } else {
+        min = peak.min;
+        max = peak.max;
+    }
+}
+
+//***************************************************************************
+double Kwave::Track::rms(sample_index_t first, sample_index_t last)
+{
+    fillPeaks(0, first, last);
+
+    QMutexLocker lock(&m_lock);
+    const sample_index_t length = unlockedLength();
+    if ((first > last) || (first >= length)) return 0.0;
+    if (last >= length) last = length - 1;
+
+    const Kwave::PeakPyramid::Peak peak = m_peaks.query(first, last);
+    return sqrt(peak.power / static_cast<double>(last - first + 1));
+}
+
+//***************************************************************************
+bool Kwave::Track::cachedAnalysis(const QString &key,
+                                  sample_index_t first, sample_index_t last,
+                                  double &value)
+{
+    QMutexLocker lock(&m_lock);
+    for (const Analysis &analysis : m_analysis) {
+        if ((analysis.first == first) && (analysis.last == last) &&
+            (analysis.key == key))
+        {
+            value = analysis.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+//***************************************************************************
+void Kwave::Track::cacheAnalysis(const QString &key,
+                                 sample_index_t first, sample_index_t last,
+                                 double value)
+{
+    QMutexLocker lock(&m_lock);
+    for (Analysis &analysis : m_analysis) {
+        if ((analysis.first == first) && (analysis.last == last) &&
+            (analysis.key == key))
+        {
+            analysis.value = value;
+            return;
+        }
+    }
+
+    // drop the oldest entry if the cache is full
+    if (m_analysis.count() >= ANALYSIS_CACHE_SIZE)
+        m_analysis.removeFirst();
+
+    Analysis analysis;
+    analysis.key   = key;
+    analysis.first = first;
+    analysis.last  = last;
+    analysis.value = value;
+    m_analysis.append(analysis);
+}
+
+//***************************************************************************
+void Kwave::Track::invalidateAnalysis(sample_index_t first,
+                                      sample_index_t last)
+{
+    QList<Analysis>::iterator it = m_analysis.begin();
+    while (it != m_analysis.end()) {
+        if ((it->last >= first) && (it->first <= last))
+            it = m_analysis.erase(it);
+        else
+            ++it;
+    }
+}
+
+//***************************************************************************
+unsigned int Kwave::Track::peakLevels()
+{
+    QMutexLocker lock(&m_lock);
+    return m_peaks.levels();
+}
+
+//***************************************************************************
+std::vector<Kwave::PeakPyramid::Peak> Kwave::Track::peaks(unsigned int level)
+{
+    fillPeaks(level, 1, 0);
+
+    QMutexLocker lock(&m_lock);
+    return m_peaks.level(level);
+}
+
+//***************************************************************************
+bool Kwave::Track::presetPeaks(unsigned int first_level,
+    const std::vector<std::vector<Kwave::PeakPyramid::Peak> > &levels)
+{
+    QMutexLocker lock(&m_lock);
+    return m_peaks.preset(first_level, levels);
+}
+
+//***************************************************************************
+void Kwave::Track::freezePeaks(bool frozen, bool keep_preset)
+{
+    QMutexLocker lock(&m_lock);
+    m_peaks.setFrozen(frozen, keep_preset);
+}
+
+//***************************************************************************
+void Kwave::Track::scanPeaks(sample_index_t first, sample_index_t last,
+                             Kwave::PeakPyramid::Peak &peak)
+{
+    QMutexLocker lock(&m_lock);
+    Kwave::Stripe::peaks(m_stripes.data(), m_stripes.size(), first, last,
+                         peak.min, peak.max, peak.power);
+}
+
+//***************************************************************************
+void Kwave::Track::fillPeaks(unsigned int level,
+                             sample_index_t first, sample_index_t last)
+{
+    for (unsigned int retry = 0; retry < PEAK_UNLOCKED_SCAN_RETRIES; ++retry)
+    {
+        // take a snapshot of the stripes, the samples are shared with
+        // the track until they get modified
+        std::vector<quint64> blocks;
+        std::vector<Stripe> stripes;
+        sample_index_t length;
+        quint64 generation;
+        {
+            QMutexLocker lock(&m_lock);
+            blocks = (first <= last) ? m_peaks.missing(first, last) :
+                                       m_peaks.missing(level);
+            if (blocks.size() < PEAK_UNLOCKED_SCAN_BLOCKS) return;
+            stripes    = m_stripes;
+            length     = unlockedLength();
+            generation = m_peaks.generation();
+        }
+
+        // scan without holding the lock
+        std::vector<Kwave::PeakPyramid::Peak> peaks(blocks.size());
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            const sample_index_t start =
+                Kwave::PeakPyramid::blockStart(blocks[i]);
+            const sample_index_t end = qMin(
+                Kwave::PeakPyramid::blockStart(blocks[i] + 1), length) - 1;
+            Kwave::PeakPyramid::Peak &peak = peaks[i];
+            Kwave::Stripe::peaks(stripes.data(), stripes.size(), start, end,
+                                 peak.min, peak.max, peak.power);
+        }
+
+        // the result is dropped if the track has been modified meanwhile
+        QMutexLocker lock(&m_lock);
+        if (m_peaks.fill(blocks, peaks, generation)) return;
+    }
+
+    // modified all the time: the pyramid scans with the lock held
+}
+
 //***************************************************************************
 void Kwave::Track::select(bool selected)
 {
@@ -586,6 +794,11 @@ bool Kwave::Track::writeSamples(Kwave::InsertMode mode,
                     m_stripes.empty() ? nullptr : &(m_stripes.back()),
                     offset, buffer,
                     buf_offset, length);
+                if (appended) {
+                    m_peaks.insert(offset, length);
+                    m_peaks.resize(unlockedLength());
+                    invalidateAnalysis(offset);
+                }
             }
             if (appended)
                 emit sigSamplesInserted(this, offset, length);
@@ -636,6 +849,9 @@ bool Kwave::Track::writeSamples(Kwave::InsertMode mode,
                 moveRight(offset, length);
                 appendAfter(stripe_before, offset, buffer,
                             buf_offset, length);
+                m_peaks.insert(offset, length);
+                m_peaks.resize(unlockedLength());
+                invalidateAnalysis(offset);
                 m_lock.unlock();
                 emit sigSamplesInserted(this, offset, length);
                 break;
@@ -667,6 +883,9 @@ bool Kwave::Track::writeSamples(Kwave::InsertMode mode,
                             buf_offset, length);
             }
 
+            m_peaks.insert(offset, length);
+            m_peaks.resize(unlockedLength());
+            invalidateAnalysis(offset);
             m_lock.unlock();
             emit sigSamplesInserted(this, offset, length);
 
@@ -691,6 +910,9 @@ bool Kwave::Track::writeSamples(Kwave::InsertMode mode,
                     if (s.end() < offset) stripe_before = &s;
                 }
                 appendAfter(stripe_before, offset, buffer, buf_offset, length);
+                m_peaks.invalidate(offset, length);
+                m_peaks.resize(unlockedLength());
+                invalidateAnalysis(offset, offset + length - 1);
             }
             emit sigSamplesModified(this, offset, length);
             break;
@@ -24,11 +24,14 @@
 #include <vector>
 
 #include <QtGlobal>
+#include <QList>
 #include <QObject>
 #include <QReadWriteLock>
 #include <QRecursiveMutex>
+#include <QString>
 
 #include "libkwave/InsertMode.h"
+#include "libkwave/PeakPyramid.h"
 #include "libkwave/ReaderMode.h"
 #include "libkwave/SampleArray.h"
 #include "libkwave/Stripe.h"
@@ -131,6 +134,74 @@ namespace Kwave
          */
         bool insertSpace(sample_index_t offset, sample_index_t shift);
 
+        /**
+         * Returns the minimum and maximum sample value within a range
+         * of samples, using the peak cache of the track.
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @param min receives the lowest value, zero if range is empty
+         * @param max receives the highest value, zero if range is empty
+         */
+        void minMax(sample_index_t first, sample_index_t last,
+                    sample_t &min, sample_t &max);
+
+        /**
+         * Returns the RMS value within a range of samples, using the
+         * peak cache of the track.
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @return RMS value in units of sample_t, zero if range is empty
+         */
+        double rms(sample_index_t first, sample_index_t last);
+
+        /**
+         * Looks up the result of an analysis of a range of samples that
+         * has been stored with cacheAnalysis(). Results are dropped as
+         * soon as a sample within their range is modified or moved.
+         * @param key identifies the kind of analysis and its parameters
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @param value receives the result
+         * @return true if found, false if not cached
+         */
+        bool cachedAnalysis(const QString &key,
+                            sample_index_t first, sample_index_t last,
+                            double &value);
+
+        /**
+         * Stores the result of an analysis of a range of samples
+         * @see cachedAnalysis
+         * @param key identifies the kind of analysis and its parameters
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @param value the result
+         */
+        void cacheAnalysis(const QString &key,
+                           sample_index_t first, sample_index_t last,
+                           double value);
+
+        /** returns the number of levels of the peak cache */
+        unsigned int peakLevels();
+
+        /**
+         * Returns all entries of one level of the peak cache
+         * @see Kwave::PeakPyramid::level
+         */
+        std::vector<Kwave::PeakPyramid::Peak> peaks(unsigned int level);
+
+        /**
+         * Sets all entries of one level of the peak cache
+         * @see Kwave::PeakPyramid::preset
+         */
+        bool presetPeaks(unsigned int first_level,
+            const std::vector<std::vector<Kwave::PeakPyramid::Peak> > &levels);
+
+        /**
+         * Freezes or unfreezes the peak cache
+         * @see Kwave::PeakPyramid::setFrozen
+         */
+        void freezePeaks(bool frozen, bool keep_preset = true);
+
         /** Returns the "selected" flag. */
         inline bool selected() const { return m_selected; }
 
@@ -301,7 +372,46 @@ namespace Kwave
          */
         Stripe *newStripe(sample_index_t start, unsigned int length);
 
+        /**
+         * Scans a range of raw samples for the peak cache. Gaps between
+         * stripes are treated as silence.
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @param peak receives min/max/power of the range
+         */
+        void scanPeaks(sample_index_t first, sample_index_t last,
+                       Kwave::PeakPyramid::Peak &peak);
+
+        /**
+         * Scans the blocks of the peak cache that are missing, on a
+         * copy of the stripes and without holding the lock of the track
+         * while scanning. Few missing blocks are left to the cache.
+         * @param level index of a level of the peak cache, used if
+         *              first > last
+         * @param first index of the first sample of a query
+         * @param last index of the last sample of a query
+         */
+        void fillPeaks(unsigned int level,
+                       sample_index_t first, sample_index_t last);
+
+        /**
+         * Drops all cached analysis results that overlap a range
+         * @param first index of the first modified sample
+         * @param last index of the last modified sample
+         * @note this must be private, it does no locking !
+         */
+        void invalidateAnalysis(sample_index_t first,
+                                sample_index_t last = SAMPLE_INDEX_MAX);
+
     private:
+
+        /** cached result of an analysis, see cachedAnalysis() */
+        typedef struct {
+            QString        key;   /**< kind of analysis */
+            sample_index_t first; /**< index of the first sample */
+            sample_index_t last;  /**< index of the last sample */
+            double         value; /**< result */
+        } Analysis;
         /** lock for access to the whole track */
         QRecursiveMutex m_lock;
 
@@ -311,6 +421,12 @@ namespace Kwave
         /** list of stripes (a track actually is a container for stripes) */
         std::vector<Stripe> m_stripes;
 
+        /** cache with min/max/power, protected by m_lock */
+        Kwave::PeakPyramid m_peaks;
+
+        /** cached analysis results, protected by m_lock */
+        QList<Analysis> m_analysis;
+
         /** True if the track is selected */
         bool m_selected;
 
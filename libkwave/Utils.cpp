@@ -21,6 +21,8 @@
 #include <pthread.h>
 #include <string.h>
 
+#include <atomic>
+
 #include <QDate>
 #include <QDateTime>
 #include <QDir>
@@ -35,6 +37,12 @@
 #include "libkwave/String.h"
 #include "libkwave/Utils.h"
 
+/** true if running without GUI, see Kwave::setHeadless() */
+static bool g_headless = false;
+
+/** true if an error has been reported without GUI, see Kwave::setFailed() */
+static std::atomic<bool> g_failed(false);
+
 //***************************************************************************
 void Kwave::yield()
 {
@@ -100,7 +108,7 @@ QString Kwave::ms2string(double ms, int precision)
 //***************************************************************************
 QString Kwave::samples2string(sample_index_t samples)
 {
-    return QLocale().toString(Kwave::toUint(samples));
+    return QLocale().toString(static_cast<qulonglong>(samples));
 }
 
 //***************************************************************************
@@ -207,5 +215,29 @@ quint64 Kwave::undoLimit()
     return 2048;
 }
 
+//***************************************************************************
+void Kwave::setHeadless(bool headless)
+{
+    g_headless = headless;
+}
+
+//***************************************************************************
+bool Kwave::isHeadless()
+{
+    return g_headless;
+}
+
+//***************************************************************************
+void Kwave::setFailed(bool failed)
+{
+    g_failed = failed;
+}
+
+//***************************************************************************
+bool Kwave::hasFailed()
+{
+    return g_failed;
+}
+
 //***************************************************************************
 //***************************************************************************
@@ -162,6 +162,29 @@ namespace Kwave
      */
     quint64 undoLimit() LIBKWAVE_EXPORT;
 
+    /**
+     * Switches the headless mode on or off. In headless mode Kwave runs
+     * without a GUI, e.g. for processing a script in batch mode, and
+     * must not show any dialog or message box.
+     * @param headless if true, run without GUI
+     */
+    void setHeadless(bool headless) LIBKWAVE_EXPORT;
+
+    /** returns true if running in headless mode, see setHeadless() */
+    bool isHeadless() LIBKWAVE_EXPORT;
+
+    /**
+     * Records that an error has been reported, for the exit code of the
+     * batch mode. Without GUI an error message is only logged, so this
+     * is the only way to notice failures that are not returned as
+     * result of a command, e.g. in the run() function of a plugin.
+     * @param failed true if an error occurred, false to reset
+     */
+    void setFailed(bool failed) LIBKWAVE_EXPORT;
+
+    /** returns true if an error has been recorded, see setFailed() */
+    bool hasFailed() LIBKWAVE_EXPORT;
+
 }
 
 #endif /* KWAVE_UTILS_H */
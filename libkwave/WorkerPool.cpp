@@ -0,0 +1,163 @@
+/***************************************************************************
+           WorkerPool.cpp  -  persistent pool of worker threads
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <new>
+
+#include <QMutexLocker>
+
+#include "libkwave/WorkerPool.h"
+
+/** static instance of the worker pool */
+static Kwave::WorkerPool g_worker_pool;
+
+//***************************************************************************
+Kwave::WorkerPool::Thread::Thread(Kwave::WorkerPool *pool)
+    :QThread(), m_pool(pool)
+{
+}
+
+//***************************************************************************
+Kwave::WorkerPool::Thread::~Thread()
+{
+}
+
+//***************************************************************************
+void Kwave::WorkerPool::Thread::run()
+{
+    m_pool->work();
+}
+
+//***************************************************************************
+//***************************************************************************
+Kwave::WorkerPool::WorkerPool()
+    :m_lock(), m_wake_workers(), m_wake_callers(), m_batches(),
+     m_threads(), m_started(false), m_stop(false)
+{
+}
+
+//***************************************************************************
+Kwave::WorkerPool::~WorkerPool()
+{
+    {
+        QMutexLocker lock(&m_lock);
+        m_stop = true;
+        m_wake_workers.wakeAll();
+    }
+
+    while (!m_threads.isEmpty()) {
+        Thread *thread = m_threads.takeLast();
+        thread->wait();
+        delete thread;
+    }
+}
+
+//***************************************************************************
+Kwave::WorkerPool &Kwave::WorkerPool::instance()
+{
+    return g_worker_pool;
+}
+
+//***************************************************************************
+void Kwave::WorkerPool::start()
+{
+    // the calling thread of run() always helps, so one CPU less
+    const int count = QThread::idealThreadCount() - 1;
+    for (int i = 0; i < count; ++i) {
+        Thread *thread = new(std::nothrow) Thread(this);
+        Q_ASSERT(thread);
+        if (!thread) break;
+        m_threads.append(thread);
+        thread->start();
+    }
+    m_started = true;
+}
+
+//***************************************************************************
+void Kwave::WorkerPool::run(unsigned int count, const Job &job)
+{
+    if (!count) return;
+
+    if (count == 1) {
+        // nothing to distribute
+        job(0);
+        return;
+    }
+
+    Batch batch;
+    batch.job   = &job;
+    batch.count = count;
+    batch.next  = 0;
+    batch.users = 0;
+
+    {
+        QMutexLocker lock(&m_lock);
+        if (!m_started) start();
+        m_batches.append(&batch);
+        m_wake_workers.wakeAll();
+    }
+
+    // do our share of the work, maybe all of it
+    process(&batch);
+
+    // no other thread can join the batch after this, wait until
+    // all that already joined are done
+    QMutexLocker lock(&m_lock);
+    m_batches.removeOne(&batch);
+    while (batch.users)
+        m_wake_callers.wait(&m_lock);
+}
+
+//***************************************************************************
+void Kwave::WorkerPool::work()
+{
+    QMutexLocker lock(&m_lock);
+    while (!m_stop) {
+        // look for a batch that has jobs left
+        Batch *batch = nullptr;
+        for (Batch *b : m_batches) {
+            if (b->next.load() < b->count) {
+                batch = b;
+                break;
+            }
+        }
+        if (!batch) {
+            m_wake_workers.wait(&m_lock);
+            continue;
+        }
+
+        batch->users++;
+        lock.unlock();
+        process(batch);
+        lock.relock();
+        if (!--batch->users) m_wake_callers.wakeAll();
+    }
+}
+
+//***************************************************************************
+void Kwave::WorkerPool::process(Batch *batch)
+{
+    for (unsigned int index = batch->next++; index < batch->count;
+         index = batch->next++)
+    {
+        (*batch->job)(index);
+    }
+}
+
+//***************************************************************************
+//***************************************************************************
@@ -0,0 +1,139 @@
+/***************************************************************************
+             WorkerPool.h  -  persistent pool of worker threads
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "config.h"
+#include "libkwave_export.h"
+
+#include <atomic>
+#include <functional>
+
+#include <QtGlobal>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+namespace Kwave
+{
+
+    /**
+     * Pool of threads that stay alive as long as the application runs,
+     * used for processing the blocks of all tracks of a stream in
+     * parallel. Handing over a batch of jobs needs no allocation and no
+     * futures, which matters because it happens once per block.
+     *
+     * The calling thread always works on its own batch, too. Jobs may
+     * start further batches themselves without the risk of a deadlock,
+     * a caller never waits for a job that has not been started yet.
+     */
+    class LIBKWAVE_EXPORT WorkerPool
+    {
+    public:
+
+        /** function that processes the job with a given index */
+        typedef std::function<void(unsigned int)> Job;
+
+        /** Constructor, does not start any thread yet */
+        WorkerPool();
+
+        /** Destructor, stops all threads */
+        virtual ~WorkerPool();
+
+        /** returns the static instance of the worker pool */
+        static WorkerPool &instance();
+
+        /**
+         * Runs a job for the indices [0 ... count - 1] in parallel and
+         * returns when all of them are done. The order of execution is
+         * not defined.
+         * @param count number of jobs
+         * @param job the function to run for each index
+         */
+        void run(unsigned int count, const Job &job);
+
+    private:
+
+        /** a batch of jobs, started by one call to run() */
+        typedef struct {
+            const Job                *job;   /**< function to run */
+            unsigned int              count; /**< number of jobs */
+            std::atomic<unsigned int> next;  /**< index of the next job */
+            unsigned int              users; /**< threads working on it */
+        } Batch;
+
+        /** thread of the pool, runs work() until the pool is stopped */
+        class Thread: public QThread
+        {
+        public:
+            /** Constructor */
+            explicit Thread(Kwave::WorkerPool *pool);
+
+            /** Destructor */
+            ~Thread() override;
+
+            /** @see QThread::run() */
+            void run() override;
+
+        private:
+            /** the pool we belong to */
+            Kwave::WorkerPool *m_pool;
+        };
+
+        /** starts the threads, if not already done */
+        void start();
+
+        /** main loop of the pool threads */
+        void work();
+
+        /**
+         * Runs the jobs of a batch until none is left
+         * @param batch the batch to work on
+         */
+        static void process(Batch *batch);
+
+    private:
+
+        /** lock for the list of batches and the threads */
+        QMutex m_lock;
+
+        /** wakes up threads of the pool when a batch is available */
+        QWaitCondition m_wake_workers;
+
+        /** wakes up callers of run() when a batch is done */
+        QWaitCondition m_wake_callers;
+
+        /** list of batches that are currently processed */
+        QList<Batch *> m_batches;
+
+        /** threads of the pool */
+        QList<Thread *> m_threads;
+
+        /** true if the threads have been started */
+        bool m_started;
+
+        /** true if the threads should terminate */
+        bool m_stop;
+    };
+}
+
+#endif /* WORKER_POOL_H */
+
+//***************************************************************************
+//***************************************************************************
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+#include "MemoryManager.h"
+#include <QDir>
+#include <QTemporaryDir>
+#include <QTest>
+#include <string.h>
+
+class TestMemoryManager : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void unlimited();
+    void swapBeyondLimit();
+    void resizeIntoSwap();
+
+private:
+    static int swapFiles(const QTemporaryDir &dir);
+    static void fill(void *block, size_t size, quint8 seed);
+    static bool check(const void *block, size_t size, quint8 seed);
+};
+
+int TestMemoryManager::swapFiles(const QTemporaryDir &dir)
+{
+    return QDir(dir.path()).entryList(QDir::Files).count();
+}
+
+void TestMemoryManager::fill(void *block, size_t size, quint8 seed)
+{
+    quint8 *p = static_cast<quint8 *>(block);
+    for (size_t i = 0; i < size; ++i)
+        p[i] = static_cast<quint8>(i + seed);
+}
+
+bool TestMemoryManager::check(const void *block, size_t size, quint8 seed)
+{
+    const quint8 *p = static_cast<const quint8 *>(block);
+    for (size_t i = 0; i < size; ++i)
+        if (p[i] != static_cast<quint8>(i + seed)) return false;
+    return true;
+}
+
+void TestMemoryManager::unlimited()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    Kwave::MemoryManager mem;
+    mem.setSwapDirectory(dir.path());
+    mem.setPhysicalLimit(0);
+
+    // without a limit everything stays on the heap
+    const size_t size = 4 << 20;
+    void *block = mem.allocate(size);
+    QVERIFY(block);
+    fill(block, size, 1);
+    mem.touch(block);
+    QCOMPARE(swapFiles(dir), 0);
+    QVERIFY(check(block, size, 1));
+    mem.free(block, size);
+}
+
+void TestMemoryManager::swapBeyondLimit()
+{
+#ifndef HAVE_SYS_MMAN_H
+    QSKIP("no support for memory mapped files");
+#endif
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    Kwave::MemoryManager mem;
+    mem.setSwapDirectory(dir.path());
+    mem.setPhysicalLimit(1);
+    QCOMPARE(mem.physicalLimit(), quint64(1));
+
+    // below the limit: heap
+    const size_t small = 512 << 10;
+    void *heap = mem.allocate(small);
+    QVERIFY(heap);
+    QCOMPARE(swapFiles(dir), 0);
+
+    // beyond the limit: one swap file per block
+    const size_t large = 1 << 20;
+    void *swap1 = mem.allocate(large);
+    QVERIFY(swap1);
+    QCOMPARE(swapFiles(dir), 1);
+    fill(swap1, large, 2);
+
+    // small blocks stay on the heap, even beyond the limit
+    void *buffer = mem.allocate(64 << 10);
+    QVERIFY(buffer);
+    QCOMPARE(swapFiles(dir), 1);
+    buffer = mem.resize(buffer, 64 << 10, 128 << 10);
+    QVERIFY(buffer);
+    QCOMPARE(swapFiles(dir), 1);
+    mem.free(buffer, 128 << 10);
+
+    // the next one evicts the first from physical memory
+    void *swap2 = mem.allocate(large);
+    QVERIFY(swap2);
+    QCOMPARE(swapFiles(dir), 2);
+    fill(swap2, large, 3);
+
+    // evicted content is paged in again on access
+    mem.touch(swap1);
+    QVERIFY(check(swap1, large, 2));
+    mem.touch(swap2);
+    QVERIFY(check(swap2, large, 3));
+
+    // growing a block in swap keeps its content
+    void *grown = mem.resize(swap1, large, 2 * large);
+    QVERIFY(grown);
+    QVERIFY(check(grown, large, 2));
+    QCOMPARE(swapFiles(dir), 2);
+
+    // freeing removes the files
+    mem.free(grown, 2 * large);
+    mem.free(swap2, large);
+    mem.free(heap, small);
+    QCOMPARE(swapFiles(dir), 0);
+}
+
+void TestMemoryManager::resizeIntoSwap()
+{
+#ifndef HAVE_SYS_MMAN_H
+    QSKIP("no support for memory mapped files");
+#endif
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    Kwave::MemoryManager mem;
+    mem.setSwapDirectory(dir.path());
+    mem.setPhysicalLimit(1);
+
+    // a heap block that grows beyond the limit moves into a swap file
+    const size_t size = 256 << 10;
+    void *block = mem.allocate(size);
+    QVERIFY(block);
+    fill(block, size, 4);
+    QCOMPARE(swapFiles(dir), 0);
+
+    void *moved = mem.resize(block, size, 2 << 20);
+    QVERIFY(moved);
+    QCOMPARE(swapFiles(dir), 1);
+    QVERIFY(check(moved, size, 4));
+
+    mem.free(moved, 2 << 20);
+    QCOMPARE(swapFiles(dir), 0);
+}
+
+QTEST_MAIN(TestMemoryManager)
+#include "test_MemoryManager.moc"
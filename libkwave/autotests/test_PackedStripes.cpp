@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <atomic>
+
+#include "SampleArray.h"
+#include "Stripe.h"
+#include "undo/PackedStripes.h"
+#include <QTest>
+
+class TestPackedStripes : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void roundTrip_data();
+    void roundTrip();
+    void sharedIsNotPacked();
+    void cancelled();
+
+private:
+    static sample_t value(unsigned int index, int kind);
+};
+
+sample_t TestPackedStripes::value(unsigned int index, int kind)
+{
+    switch (kind) {
+        case 0:  // silence
+            return 0;
+        case 1:  // 16 bit material, scaled up to 24 bit
+            return static_cast<sample_t>(((index * 7919) % 65536) - 32768)
+                * 256;
+        default: // full scale 24 bit noise
+            return static_cast<sample_t>((index * 2654435761U) >> 8)
+                - (1 << 23);
+    }
+}
+
+void TestPackedStripes::roundTrip_data()
+{
+    QTest::addColumn<int>("kind");
+    QTest::addColumn<unsigned int>("length");
+
+    QTest::newRow("silence")        << 0 << 100000U;
+    QTest::newRow("16 bit")         << 1 << 100000U;
+    QTest::newRow("24 bit")         << 2 << 100000U;
+    QTest::newRow("one sample")     << 2 << 1U;
+    QTest::newRow("block boundary") << 2 << 65536U;
+}
+
+void TestPackedStripes::roundTrip()
+{
+    QFETCH(int, kind);
+    QFETCH(unsigned int, length);
+
+    QList<Kwave::Stripe::List> stripes;
+    for (unsigned int track = 0; track < 2; ++track) {
+        Kwave::SampleArray samples(length);
+        QCOMPARE(samples.size(), length);
+        for (unsigned int i = 0; i < length; ++i)
+            samples[i] = value(i + track, kind);
+        Kwave::Stripe::List list(1000, 1000 + length - 1);
+        list.append(Kwave::Stripe(1000, samples));
+        stripes.append(list);
+    }
+
+    Kwave::PackedStripes packed;
+    QVERIFY(packed.pack(stripes));
+    QVERIFY(stripes.isEmpty());
+    QVERIFY(!packed.isEmpty());
+
+    QVERIFY(packed.unpack(stripes));
+    QVERIFY(packed.isEmpty());
+    QCOMPARE(stripes.count(), 2);
+    for (unsigned int track = 0; track < 2; ++track) {
+        Kwave::Stripe::List &list = stripes[track];
+        QCOMPARE(list.left(), sample_index_t(1000));
+        QCOMPARE(list.right(), sample_index_t(1000 + length - 1));
+        QCOMPARE(list.count(), 1);
+
+        Kwave::Stripe &stripe = list[0];
+        QCOMPARE(stripe.start(), sample_index_t(1000));
+        QCOMPARE(stripe.length(), length);
+
+        Kwave::SampleArray samples(length);
+        QCOMPARE(stripe.read(samples, 0, 0, length), length);
+        for (unsigned int i = 0; i < length; ++i)
+            QCOMPARE(samples[i], value(i + track, kind));
+    }
+}
+
+void TestPackedStripes::sharedIsNotPacked()
+{
+    Kwave::SampleArray samples(1000);
+    QList<Kwave::Stripe::List> stripes;
+    Kwave::Stripe::List list(0, 999);
+    list.append(Kwave::Stripe(0, samples));
+    stripes.append(list);
+    list.clear();
+
+    // the storage is still used by "samples"
+    Kwave::PackedStripes packed;
+    QVERIFY(!packed.pack(stripes));
+    QCOMPARE(stripes.count(), 1);
+
+    samples = Kwave::SampleArray();
+    QVERIFY(packed.pack(stripes));
+    QVERIFY(stripes.isEmpty());
+}
+
+void TestPackedStripes::cancelled()
+{
+    QList<Kwave::Stripe::List> stripes;
+    Kwave::Stripe::List list(0, 999);
+    list.append(Kwave::Stripe(0, Kwave::SampleArray(1000)));
+    stripes.append(list);
+    list.clear();
+
+    // a cancelled packer leaves the stripes untouched
+    const std::atomic<bool> cancel(true);
+    Kwave::PackedStripes packed;
+    QVERIFY(!packed.pack(stripes, &cancel));
+    QVERIFY(packed.isEmpty());
+    QCOMPARE(stripes.count(), 1);
+    QCOMPARE(stripes[0].count(), 1);
+    QCOMPARE(stripes[0][0].length(), 1000U);
+}
+
+QTEST_MAIN(TestPackedStripes)
+#include "test_PackedStripes.moc"
@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "PeakFile.h"
+#include "Track.h"
+#include "Writer.h"
+#include <QFile>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+/** length of the test tracks, just long enough for a peak file */
+static const sample_index_t LENGTH = 4 * 1024 * 1024;
+
+class TestPeakFile : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void roundTrip();
+    void tooShort();
+    void mismatch();
+    void outdated();
+    void corrupt();
+
+private:
+    static bool fill(Kwave::Track &track, sample_index_t length, int seed);
+    static bool writeAudio(const QString &path, char content);
+    static QList<Kwave::Stripe::List> snapshot(Kwave::Track &track);
+};
+
+bool TestPeakFile::fill(Kwave::Track &track, sample_index_t length, int seed)
+{
+    Kwave::Writer *writer = track.openWriter(Kwave::Append);
+    if (!writer) return false;
+    for (sample_index_t i = 0; i < length; ++i)
+        *writer << static_cast<sample_t>((i * 7919 + seed) % 65536) - 32768;
+    delete writer;
+    return (track.length() >= length);
+}
+
+bool TestPeakFile::writeAudio(const QString &path, char content)
+{
+    // the peak file only looks at size, time and content of the file
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    return (file.write(QByteArray(256 * 1024, content)) == 256 * 1024);
+}
+
+QList<Kwave::Stripe::List> TestPeakFile::snapshot(Kwave::Track &track)
+{
+    QList<Kwave::Stripe::List> stripes;
+    stripes.append(track.stripes(0, track.length() - 1));
+    return stripes;
+}
+
+void TestPeakFile::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestPeakFile::roundTrip()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString audio = dir.filePath(QStringLiteral("audio.wav"));
+    QVERIFY(writeAudio(audio, 'a'));
+
+    Kwave::Track source{0, 1};
+    QVERIFY(fill(source, LENGTH, 0));
+    QCOMPARE(source.length(), LENGTH);
+
+    Kwave::PeakFile peak_file(audio);
+    QVERIFY(peak_file.save(snapshot(source), LENGTH));
+    QVERIFY(QFile::exists(peak_file.path()));
+
+    // an empty track of the same length takes over all stored levels
+    Kwave::Track dest{LENGTH, 2};
+    QVERIFY(peak_file.load({ &dest }, LENGTH));
+    const unsigned int levels = dest.peakLevels();
+    QCOMPARE(levels, source.peakLevels());
+    QVERIFY(levels > 1);
+    for (unsigned int level = 1; level < levels; ++level) {
+        const std::vector<Kwave::PeakPyramid::Peak> expected =
+            source.peaks(level);
+        const std::vector<Kwave::PeakPyramid::Peak> loaded =
+            dest.peaks(level);
+        QCOMPARE(loaded.size(), expected.size());
+        for (size_t i = 0; i < loaded.size(); ++i) {
+            QCOMPARE(loaded[i].min, expected[i].min);
+            QCOMPARE(loaded[i].max, expected[i].max);
+            // the power is stored with single precision
+            QVERIFY(qAbs(loaded[i].power - expected[i].power) <=
+                    1e-6 * qAbs(expected[i].power) + 1.0);
+        }
+    }
+
+    // the stored levels survive unfreezing, unless they are dropped
+    dest.freezePeaks(false);
+    QCOMPARE(dest.peaks(levels - 1)[0].max, source.peaks(levels - 1)[0].max);
+
+    Kwave::Track dropped{LENGTH, 3};
+    QVERIFY(peak_file.load({ &dropped }, LENGTH));
+    dropped.freezePeaks(false, false);
+    QCOMPARE(dropped.peaks(levels - 1)[0].max, sample_t(0));
+
+    QFile::remove(peak_file.path());
+}
+
+void TestPeakFile::tooShort()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString audio = dir.filePath(QStringLiteral("short.wav"));
+    QVERIFY(writeAudio(audio, 's'));
+
+    Kwave::Track track{0, 1};
+    QVERIFY(fill(track, 1000, 0));
+
+    Kwave::PeakFile peak_file(audio);
+    QVERIFY(!Kwave::PeakFile::isUseful(1000));
+    QVERIFY(!peak_file.save(snapshot(track), 1000));
+    QVERIFY(!QFile::exists(peak_file.path()));
+}
+
+void TestPeakFile::mismatch()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString audio = dir.filePath(QStringLiteral("mismatch.wav"));
+    QVERIFY(writeAudio(audio, 'm'));
+
+    Kwave::Track source{0, 1};
+    QVERIFY(fill(source, LENGTH, 1));
+    Kwave::PeakFile peak_file(audio);
+    QVERIFY(peak_file.save(snapshot(source), LENGTH));
+
+    // different number of tracks
+    Kwave::Track left{LENGTH, 2};
+    Kwave::Track right{LENGTH, 3};
+    QVERIFY(!peak_file.load({ &left, &right }, LENGTH));
+
+    // different length
+    Kwave::Track longer{LENGTH + 1, 4};
+    QVERIFY(!peak_file.load({ &longer }, LENGTH + 1));
+
+    // another audio file has no peak file
+    const QString other = dir.filePath(QStringLiteral("other.wav"));
+    QVERIFY(writeAudio(other, 'm'));
+    QVERIFY(!Kwave::PeakFile(other).load({ &left }, LENGTH));
+
+    QFile::remove(peak_file.path());
+}
+
+void TestPeakFile::outdated()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString audio = dir.filePath(QStringLiteral("outdated.wav"));
+    QVERIFY(writeAudio(audio, 'o'));
+
+    Kwave::Track source{0, 1};
+    QVERIFY(fill(source, LENGTH, 2));
+    Kwave::PeakFile peak_file(audio);
+    QVERIFY(peak_file.save(snapshot(source), LENGTH));
+
+    // same size, but different content
+    QVERIFY(writeAudio(audio, 'x'));
+    Kwave::Track dest{LENGTH, 2};
+    QVERIFY(!peak_file.load({ &dest }, LENGTH));
+
+    QFile::remove(peak_file.path());
+}
+
+void TestPeakFile::corrupt()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString audio = dir.filePath(QStringLiteral("corrupt.wav"));
+    QVERIFY(writeAudio(audio, 'c'));
+
+    Kwave::Track source{0, 1};
+    QVERIFY(fill(source, LENGTH, 3));
+    Kwave::PeakFile peak_file(audio);
+    QVERIFY(peak_file.save(snapshot(source), LENGTH));
+
+    // truncated
+    QFile file(peak_file.path());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() / 2));
+    file.close();
+    Kwave::Track dest{LENGTH, 2};
+    QVERIFY(!peak_file.load({ &dest }, LENGTH));
+
+    // wrong magic
+    QVERIFY(peak_file.save(snapshot(source), LENGTH));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.write("XXXX", 4) == 4);
+    file.close();
+    QVERIFY(!peak_file.load({ &dest }, LENGTH));
+
+    QFile::remove(peak_file.path());
+}
+
+QTEST_MAIN(TestPeakFile)
+#include "test_PeakFile.moc"
@@ -0,0 +1,313 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "SampleKernels.h"
+#include "SampleLinear.h"
+#include <QRandomGenerator>
+#include <QTest>
+#include <QVector>
+
+using Kwave::SampleKernels;
+
+Q_DECLARE_METATYPE(Kwave::SampleKernels::Level)
+
+class TestSampleKernels : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void minMax_data();
+    void minMax();
+
+    void linear_data();
+    void linear();
+
+    void interleave_data();
+    void interleave();
+
+    void benchmarkMinMax_data();
+    void benchmarkMinMax();
+
+    void benchmarkEncode_data();
+    void benchmarkEncode();
+
+    void benchmarkDecode_data();
+    void benchmarkDecode();
+
+private:
+    void addLevels();
+    void addLevelsAndBits(bool with_reference);
+
+    static SampleKernels::encoder_t referenceEncoder(unsigned int bits);
+    static SampleKernels::decoder_t referenceDecoder(unsigned int bits);
+    static bool inRange(sample_t s);
+
+    QVector<sample_t> m_samples;
+    QByteArray m_raw;
+};
+
+static const unsigned int BENCHMARK_SAMPLES = 1024 * 1024;
+
+void TestSampleKernels::initTestCase()
+{
+    QRandomGenerator rnd(42);
+    m_samples.resize(BENCHMARK_SAMPLES);
+    for (sample_t &s : m_samples)
+        s = static_cast<sample_t>(rnd.bounded(SAMPLE_MIN, SAMPLE_MAX + 1));
+
+    // some samples beyond the range, as produced by effects that
+    // overdrive the signal
+    for (int i = 0; i < m_samples.size(); i += 7)
+        m_samples[i] = static_cast<sample_t>(rnd.generate());
+    m_samples[1] = SAMPLE_MAX + 1;
+    m_samples[2] = SAMPLE_MIN - 1;
+    m_raw.resize(BENCHMARK_SAMPLES * 4);
+    for (char &c : m_raw)
+        c = static_cast<char>(rnd.bounded(256));
+}
+
+void TestSampleKernels::addLevels()
+{
+    QTest::addColumn<SampleKernels::Level>("level");
+    QTest::newRow("scalar") << SampleKernels::Scalar;
+    QTest::newRow("sse2")   << SampleKernels::SSE2;
+    QTest::newRow("avx2")   << SampleKernels::AVX2;
+}
+
+void TestSampleKernels::addLevelsAndBits(bool with_reference)
+{
+    QTest::addColumn<SampleKernels::Level>("level");
+    QTest::addColumn<unsigned int>("bits");
+    QTest::addColumn<bool>("reference");
+    const char *names[] = { "scalar", "sse2", "avx2" };
+    for (int level = SampleKernels::Scalar; level <= SampleKernels::AVX2;
+         ++level)
+    {
+        for (unsigned int bits : { 8U, 16U, 24U, 32U }) {
+            QTest::addRow("%s %u bit", names[level], bits)
+                << static_cast<SampleKernels::Level>(level) << bits
+                << false;
+        }
+    }
+    if (!with_reference) return;
+
+    // the generic templates, which were used before the kernels
+    for (unsigned int bits : { 8U, 16U, 24U, 32U }) {
+        QTest::addRow("template %u bit", bits)
+            << SampleKernels::Scalar << bits << true;
+    }
+}
+
+SampleKernels::encoder_t TestSampleKernels::referenceEncoder(
+    unsigned int bits)
+{
+    switch (bits) {
+        case  8: return Kwave::encode_linear< 8, true, true>;
+        case 16: return Kwave::encode_linear<16, true, true>;
+        case 24: return Kwave::encode_linear<24, true, true>;
+        case 32: return Kwave::encode_linear<32, true, true>;
+        default: return nullptr;
+    }
+}
+
+SampleKernels::decoder_t TestSampleKernels::referenceDecoder(
+    unsigned int bits)
+{
+    switch (bits) {
+        case  8: return Kwave::decode_linear< 8, true, true>;
+        case 16: return Kwave::decode_linear<16, true, true>;
+        case 24: return Kwave::decode_linear<24, true, true>;
+        case 32: return Kwave::decode_linear<32, true, true>;
+        default: return nullptr;
+    }
+}
+
+bool TestSampleKernels::inRange(sample_t s)
+{
+    return (s >= SAMPLE_MIN) && (s <= SAMPLE_MAX);
+}
+
+void TestSampleKernels::minMax_data()
+{
+    addLevels();
+}
+
+void TestSampleKernels::minMax()
+{
+    QFETCH(SampleKernels::Level, level);
+    if (level > SampleKernels::level())
+        QSKIP("not supported by this CPU");
+
+    // all lengths around the vector sizes, with any alignment
+    for (unsigned int ofs = 0; ofs < 8; ++ofs) {
+        for (unsigned int count = 0; count < 100; ++count) {
+            const sample_t *p = m_samples.constData() + ofs;
+            sample_t min = SAMPLE_MAX;
+            sample_t max = SAMPLE_MIN;
+            SampleKernels::minMax(level, p, count, min, max);
+
+            sample_t ref_min = SAMPLE_MAX;
+            sample_t ref_max = SAMPLE_MIN;
+            for (unsigned int i = 0; i < count; ++i) {
+                ref_min = qMin(ref_min, p[i]);
+                ref_max = qMax(ref_max, p[i]);
+            }
+            QCOMPARE(min, ref_min);
+            QCOMPARE(max, ref_max);
+        }
+    }
+}
+
+void TestSampleKernels::linear_data()
+{
+    addLevelsAndBits(false);
+}
+
+void TestSampleKernels::linear()
+{
+    QFETCH(SampleKernels::Level, level);
+    QFETCH(unsigned int, bits);
+    if (level > SampleKernels::level())
+        QSKIP("not supported by this CPU");
+
+    SampleKernels::encoder_t encode =
+        SampleKernels::linearEncoder(level, bits, true, true);
+    SampleKernels::encoder_t encode_ref = referenceEncoder(bits);
+    SampleKernels::decoder_t decode =
+        SampleKernels::linearDecoder(level, bits, true, true);
+    SampleKernels::decoder_t decode_ref = referenceDecoder(bits);
+    QVERIFY(encode && encode_ref && decode && decode_ref);
+
+    const unsigned int bytes = bits / 8;
+    for (unsigned int count = 0; count < 100; ++count) {
+        // encoding, compared against the generic template, also
+        // with samples out of range
+        QByteArray raw(count * bytes, 0);
+        QByteArray raw_ref(count * bytes, 0);
+        encode(m_samples.constData(),
+               reinterpret_cast<quint8 *>(raw.data()), count);
+        encode_ref(m_samples.constData(),
+                   reinterpret_cast<quint8 *>(raw_ref.data()), count);
+        QCOMPARE(raw, raw_ref);
+
+        // decoding, compared against the generic template
+        QVector<sample_t> samples(count);
+        QVector<sample_t> samples_ref(count);
+        const quint8 *src = reinterpret_cast<const quint8 *>(
+            m_raw.constData());
+        decode(src, samples.data(), count);
+        decode_ref(src, samples_ref.data(), count);
+        QCOMPARE(samples, samples_ref);
+
+        // round trip with full resolution
+        if (bits >= 24) {
+            decode(reinterpret_cast<const quint8 *>(raw.constData()),
+                   samples.data(), count);
+            for (unsigned int i = 0; i < count; ++i)
+                if (inRange(m_samples[i]))
+                    QCOMPARE(samples[i], m_samples[i]);
+        }
+    }
+}
+
+void TestSampleKernels::interleave_data()
+{
+    QTest::addColumn<unsigned int>("channels");
+
+    QTest::newRow("mono")   << 1U;
+    QTest::newRow("stereo") << 2U;
+    QTest::newRow("5.1")    << 6U;
+}
+
+void TestSampleKernels::interleave()
+{
+    QFETCH(unsigned int, channels);
+    const unsigned int count = 1001;
+
+    QVector<QVector<sample_t> > planar(channels);
+    QVector<const sample_t *> src(channels);
+    for (unsigned int c = 0; c < channels; ++c) {
+        planar[c].resize(count);
+        for (unsigned int i = 0; i < count; ++i)
+            planar[c][i] = static_cast<sample_t>(i * 16 + c);
+        src[c] = planar[c].constData();
+    }
+
+    QVector<sample_t> frames(count * channels, -1);
+    SampleKernels::interleave(src.constData(), channels, count,
+                              frames.data());
+    for (unsigned int i = 0; i < count; ++i)
+        for (unsigned int c = 0; c < channels; ++c)
+            QCOMPARE(frames[i * channels + c],
+                     static_cast<sample_t>(i * 16 + c));
+}
+
+void TestSampleKernels::benchmarkMinMax_data()
+{
+    addLevels();
+}
+
+void TestSampleKernels::benchmarkMinMax()
+{
+    QFETCH(SampleKernels::Level, level);
+    if (level > SampleKernels::level())
+        QSKIP("not supported by this CPU");
+
+    sample_t min = SAMPLE_MAX;
+    sample_t max = SAMPLE_MIN;
+    QBENCHMARK {
+        SampleKernels::minMax(level, m_samples.constData(),
+                              BENCHMARK_SAMPLES, min, max);
+    }
+    QVERIFY(min <= max);
+}
+
+void TestSampleKernels::benchmarkEncode_data()
+{
+    addLevelsAndBits(true);
+}
+
+void TestSampleKernels::benchmarkEncode()
+{
+    QFETCH(SampleKernels::Level, level);
+    QFETCH(unsigned int, bits);
+    QFETCH(bool, reference);
+    if (level > SampleKernels::level())
+        QSKIP("not supported by this CPU");
+
+    SampleKernels::encoder_t encode = (reference) ? referenceEncoder(bits) :
+        SampleKernels::linearEncoder(level, bits, true, true);
+    QVERIFY(encode);
+    quint8 *dst = reinterpret_cast<quint8 *>(m_raw.data());
+    QBENCHMARK {
+        encode(m_samples.constData(), dst, BENCHMARK_SAMPLES);
+    }
+}
+
+void TestSampleKernels::benchmarkDecode_data()
+{
+    addLevelsAndBits(true);
+}
+
+void TestSampleKernels::benchmarkDecode()
+{
+    QFETCH(SampleKernels::Level, level);
+    QFETCH(unsigned int, bits);
+    QFETCH(bool, reference);
+    if (level > SampleKernels::level())
+        QSKIP("not supported by this CPU");
+
+    SampleKernels::decoder_t decode = (reference) ? referenceDecoder(bits) :
+        SampleKernels::linearDecoder(level, bits, true, true);
+    QVERIFY(decode);
+    QVector<sample_t> samples(BENCHMARK_SAMPLES);
+    const quint8 *src = reinterpret_cast<const quint8 *>(m_raw.constData());
+    QBENCHMARK {
+        decode(src, samples.data(), BENCHMARK_SAMPLES);
+    }
+}
+
+QTEST_MAIN(TestSampleKernels)
+#include "test_SampleKernels.moc"
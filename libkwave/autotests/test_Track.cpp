@@ -1,7 +1,9 @@
 // SPDX-FileCopyrightText: 2024 Mark Penner <mrp@markpenner.space>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "PeakPyramid.h"
 #include "Track.h"
+#include "Writer.h"
 #include <QTest>
 
 class TestTrack : public QObject
@@ -11,6 +13,11 @@ class TestTrack : public QObject
 private Q_SLOTS:
     void deleteRange_data();
     void deleteRange();
+    void minMax();
+    void fillPeaks();
+    void cachedAnalysis();
+    void analysisAfterOverwrite();
+    void uniqueSize();
 };
 
 void TestTrack::deleteRange_data()
@@ -37,5 +44,201 @@ void TestTrack::deleteRange()
     QCOMPARE(t.length(), trackLen - deleteLen);
 }
 
+void TestTrack::minMax()
+{
+    quint64 uid = 1;
+    auto t = Kwave::Track{0, uid};
+    sample_t min = -1;
+    sample_t max = -1;
+
+    // empty track
+    t.minMax(0, 100, min, max);
+    QCOMPARE(min, 0);
+    QCOMPARE(max, 0);
+
+    // a ramp from -50000 to 49999
+    {
+        Kwave::Writer *writer = t.openWriter(Kwave::Append);
+        QVERIFY(writer);
+        for (sample_t s = -50000; s < 50000; ++s)
+            *writer << s;
+        delete writer;
+    }
+    QCOMPARE(t.length(), 100000ull);
+
+    t.minMax(0, 99999, min, max);
+    QCOMPARE(min, -50000);
+    QCOMPARE(max,  49999);
+
+    t.minMax(1000, 1999, min, max);
+    QCOMPARE(min, -49000);
+    QCOMPARE(max, -48001);
+
+    // delete the start, the cache has to follow the shift
+    t.deleteRange(0, 40000);
+    t.minMax(0, 4095, min, max);
+    QCOMPARE(min, -10000);
+    QCOMPARE(max,  -5905);
+
+    // range after the end is clipped
+    t.minMax(59000, 1000000, min, max);
+    QCOMPARE(min, 49000);
+    QCOMPARE(max, 49999);
+}
+
+void TestTrack::fillPeaks()
+{
+    // every sample has the value of its block, counts the raw scans
+    unsigned int scans = 0;
+    Kwave::PeakPyramid pyramid([&scans](sample_index_t first,
+        sample_index_t last, Kwave::PeakPyramid::Peak &peak) {
+        ++scans;
+        const sample_t value = static_cast<sample_t>(first / 256);
+        if (value < peak.min) peak.min = value;
+        if (value > peak.max) peak.max = value;
+        peak.power += static_cast<double>(last - first + 1);
+    });
+    pyramid.resize(100 * 256);
+
+    // everything is missing, except the partial blocks at the borders
+    std::vector<quint64> blocks = pyramid.missing(128, 100 * 256 - 1);
+    QCOMPARE(blocks.size(), size_t(99));
+    QCOMPARE(blocks.front(), quint64(1));
+    QCOMPARE(pyramid.missing(0U).size(), size_t(100));
+
+    // scanned entries are dropped if modified meanwhile
+    quint64 generation = pyramid.generation();
+    std::vector<Kwave::PeakPyramid::Peak> peaks(blocks.size());
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        peaks[i].min = peaks[i].max = static_cast<sample_t>(blocks[i]);
+        peaks[i].power = 256.0;
+    }
+    pyramid.invalidate(0, 1);
+    QVERIFY(!pyramid.fill(blocks, peaks, generation));
+    QCOMPARE(pyramid.missing(128, 100 * 256 - 1).size(), size_t(99));
+
+    // otherwise a query needs no more scans for complete blocks
+    generation = pyramid.generation();
+    QVERIFY(pyramid.fill(blocks, peaks, generation));
+    QVERIFY(pyramid.missing(256, 100 * 256 - 1).empty());
+    scans = 0;
+    const Kwave::PeakPyramid::Peak peak =
+        pyramid.query(256, 100 * 256 - 1);
+    QCOMPARE(scans, 0U);
+    QCOMPARE(peak.min, sample_t(1));
+    QCOMPARE(peak.max, sample_t(99));
+    QCOMPARE(peak.power, 99.0 * 256.0);
+}
+
+void TestTrack::cachedAnalysis()
+{
+    quint64 uid = 1;
+    auto t = Kwave::Track{100000, uid};
+    const QString key = QStringLiteral("test");
+    double value = 0.0;
+
+    QVERIFY(!t.cachedAnalysis(key, 0, 999, value));
+    t.cacheAnalysis(key, 0, 999, 1.0);
+    t.cacheAnalysis(key, 5000, 5999, 2.0);
+    QVERIFY(t.cachedAnalysis(key, 0, 999, value));
+    QCOMPARE(value, 1.0);
+    QVERIFY(!t.cachedAnalysis(QStringLiteral("other"), 0, 999, value));
+    QVERIFY(!t.cachedAnalysis(key, 0, 1000, value));
+
+    // modifying samples drops only the overlapping results
+    {
+        Kwave::Writer *writer = t.openWriter(Kwave::Overwrite, 5500, 5500);
+        QVERIFY(writer);
+        *writer << sample_t(1);
+        delete writer;
+    }
+    QVERIFY(t.cachedAnalysis(key, 0, 999, value));
+    QVERIFY(!t.cachedAnalysis(key, 5000, 5999, value));
+
+    // inserting moves all samples after the insert position
+    t.cacheAnalysis(key, 5000, 5999, 2.0);
+    t.insertSpace(2000, 10);
+    QVERIFY(t.cachedAnalysis(key, 0, 999, value));
+    QVERIFY(!t.cachedAnalysis(key, 5000, 5999, value));
+
+    // deleting does the same
+    t.deleteRange(500, 10);
+    QVERIFY(!t.cachedAnalysis(key, 0, 999, value));
+}
+
+void TestTrack::analysisAfterOverwrite()
+{
+    quint64 uid = 1;
+    auto t = Kwave::Track{100000, uid};
+    const QString key = QStringLiteral("test");
+    double value = 0.0;
+
+    // like normalizing twice: analyze, overwrite the whole range and
+    // store the level of what has been written
+    for (int pass = 1; pass <= 2; ++pass) {
+        if (pass == 1) {
+            QVERIFY(!t.cachedAnalysis(key, 1000, 1999, value));
+            t.cacheAnalysis(key, 1000, 1999, 1.0);
+        } else {
+            QVERIFY(t.cachedAnalysis(key, 1000, 1999, value));
+            QCOMPARE(value, 4.0);
+        }
+
+        Kwave::Writer *writer = t.openWriter(Kwave::Overwrite, 1000, 1999);
+        QVERIFY(writer);
+        for (int i = 0; i < 1000; ++i)
+            *writer << sample_t(i * pass);
+        writer->flush();
+        QVERIFY(!t.cachedAnalysis(key, 1000, 1999, value));
+
+        t.cacheAnalysis(key, 1000, 1999, 4.0);
+        delete writer;
+        QVERIFY(t.cachedAnalysis(key, 1000, 1999, value));
+    }
+}
+
+void TestTrack::uniqueSize()
+{
+    quint64 uid = 1;
+    auto t = Kwave::Track{100000, uid};
+    const qint64 bytes = 100000 * sizeof(sample_t);
+
+    // a complete stripe shares its storage with the track
+    Kwave::Stripe::List all = t.stripes(0, 99999);
+    QCOMPARE(all.count(), 1);
+    QCOMPARE(all.uniqueSize(), 0);
+
+    // a cropped copy has storage of its own
+    Kwave::Stripe::List part = t.stripes(0, 999);
+    QCOMPARE(part.uniqueSize(), qint64(1000 * sizeof(sample_t)));
+
+    // modifying the track detaches it from the copy
+    {
+        Kwave::Writer *writer = t.openWriter(Kwave::Overwrite, 5000, 5000);
+        QVERIFY(writer);
+        *writer << sample_t(1);
+        delete writer;
+    }
+    QCOMPARE(all.uniqueSize(), bytes);
+
+    // a second copy of the stripe shares it again
+    Kwave::Stripe stripe(all.constFirst());
+    QCOMPARE(all.uniqueSize(), 0);
+    QCOMPARE(stripe.uniqueSize(), 0);
+
+    // ...but counted together, the storage is used by both only
+    Kwave::Stripe::StorageMap map;
+    all.countStorage(map);
+    QCOMPARE(Kwave::Stripe::uniqueSize(map), 0);
+    stripe.countStorage(map);
+    QCOMPARE(map.count(), 1);
+    QCOMPARE(Kwave::Stripe::uniqueSize(map), bytes);
+
+    // storage that still is in the track is never counted
+    Kwave::Stripe::StorageMap in_track;
+    t.stripes(0, 99999).countStorage(in_track);
+    QCOMPARE(Kwave::Stripe::uniqueSize(in_track), 0);
+}
+
 QTEST_MAIN(TestTrack)
 #include "test_Track.moc"
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "WorkerPool.h"
+#include <QTest>
+#include <atomic>
+#include <vector>
+
+using Kwave::WorkerPool;
+
+class TestWorkerPool : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void run_data();
+    void run();
+    void nested();
+};
+
+void TestWorkerPool::run_data()
+{
+    QTest::addColumn<unsigned int>("count");
+    QTest::newRow("none") << 0U;
+    QTest::newRow("one")  << 1U;
+    QTest::newRow("two")  << 2U;
+    QTest::newRow("many") << 10000U;
+}
+
+void TestWorkerPool::run()
+{
+    QFETCH(unsigned int, count);
+
+    // every index has to be processed exactly once
+    std::vector<std::atomic<int>> done(count);
+    WorkerPool::instance().run(count, [&done](unsigned int index) {
+        done[index]++;
+    });
+    for (unsigned int i = 0; i < count; ++i)
+        QCOMPARE(done[i].load(), 1);
+}
+
+void TestWorkerPool::nested()
+{
+    // jobs that start batches themselves must not deadlock
+    std::atomic<unsigned int> total(0);
+    for (int round = 0; round < 100; ++round) {
+        WorkerPool::instance().run(8, [&total](unsigned int) {
+            WorkerPool::instance().run(8, [&total](unsigned int) {
+                total++;
+            });
+        });
+    }
+    QCOMPARE(total.load(), 100U * 8U * 8U);
+}
+
+QTEST_MAIN(TestWorkerPool)
+#include "test_WorkerPool.moc"
@@ -24,11 +24,12 @@
 
 //***************************************************************************
 Kwave::RateConverter::RateConverter()
-    :Kwave::SampleSource(), m_ratio(1.0), m_converter(nullptr),
+    :Kwave::SampleSource(), m_ratio(1.0),
+     m_converter_type(SRC_SINC_MEDIUM_QUALITY), m_converter(nullptr),
      m_converter_in(), m_converter_out()
 {
     int error = 0;
-    m_converter = src_new(SRC_SINC_MEDIUM_QUALITY, 1, &error);
+    m_converter = src_new(m_converter_type, 1, &error);
     Q_ASSERT(m_converter);
     if (!m_converter) qWarning("creating converter failed: '%s",
         src_strerror(error));
@@ -133,6 +134,24 @@ void Kwave::RateConverter::setRatio(const QVariant ratio)
     m_ratio = QVariant(ratio).toDouble();
 }
 
+//***************************************************************************
+void Kwave::RateConverter::setQuality(const QVariant quality)
+{
+    const int type = QVariant(quality).toInt();
+    if (type == m_converter_type) return;
+
+    int error = 0;
+    SRC_STATE *converter = src_new(type, 1, &error);
+    if (!converter) {
+        qWarning("creating converter failed: '%s", src_strerror(error));
+        return;
+    }
+
+    src_delete(m_converter);
+    m_converter      = converter;
+    m_converter_type = type;
+}
+
 //***************************************************************************
 //***************************************************************************
 
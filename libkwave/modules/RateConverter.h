@@ -59,11 +59,20 @@ namespace Kwave
          */
         void setRatio(const QVariant r);
 
+        /**
+         * Sets the type of the libsamplerate converter, which selects
+         * between quality and speed, e.g. SRC_SINC_MEDIUM_QUALITY
+         */
+        void setQuality(const QVariant q);
+
     private:
 
         /** conversion ratio, ((new rate) / (old rate)) */
         double m_ratio;
 
+        /** type of the libsamplerate converter */
+        int m_converter_type;
+
         /** sample rate converter context for libsamplerate */
         SRC_STATE *m_converter;
 
@@ -17,13 +17,12 @@
 
 #include "config.h"
 
-#include <QFutureSynchronizer>
 #include <QString>
 #include <QVariant>
-#include <QtConcurrentRun>
 
 #include "libkwave/SampleSink.h"
 #include "libkwave/SampleSource.h"
+#include "libkwave/WorkerPool.h"
 #include "libkwave/modules/StreamObject.h"
 
 /** interactive mode */
@@ -111,15 +110,15 @@ void Kwave::StreamObject::output(Kwave::SampleArray &data)
 {
     qsizetype count = m_sinks.count();
     if (count > 1) {
-        QFutureSynchronizer<void> synchronizer;
-        for (auto &sink : m_sinks) {
-            if (sink.m_sink == nullptr) continue;
-            synchronizer.addFuture(QtConcurrent::run(
-                [&sink, &data] () {
+        const QList<ConnectedSink> &sinks = m_sinks;
+        Kwave::WorkerPool::instance().run(
+            static_cast<unsigned int>(count),
+            [&sinks, &data] (unsigned int index) {
+                const ConnectedSink &sink = sinks.at(index);
+                if (sink.m_sink != nullptr)
                     sink.m_sink->input(sink.m_port, data);
-            }));
-        }
-        synchronizer.waitForFinished();
+            }
+        );
     } else if (count == 1) {
         auto &sink = m_sinks.first();
         if (sink.m_sink != nullptr)
@@ -0,0 +1,347 @@
+/*************************************************************************
+      PackedStripes.cpp  -  losslessly compressed storage for undo data
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <atomic>
+#include <new>
+
+#include <QTemporaryFile>
+#include <QtEndian>
+
+#include "libkwave/MemoryManager.h"
+#include "libkwave/SampleArray.h"
+#include "libkwave/String.h"
+#include "libkwave/Utils.h"
+#include "libkwave/WorkerPool.h"
+#include "libkwave/undo/PackedStripes.h"
+
+/** number of samples that are compressed as one block */
+#define PACK_BLOCK_LENGTH (64U * 1024U)
+
+/** size of the header of a block: compressed size and shift */
+#define PACK_BLOCK_HEADER 5
+
+/** compression level passed to zlib */
+#define PACK_COMPRESSION_LEVEL 6
+
+/** packed data larger than this [bytes] is moved into a temporary file */
+#define PACK_SPILL_THRESHOLD (4 * 1024 * 1024)
+
+//***************************************************************************
+Kwave::PackedStripes::PackedStripes()
+    :m_lists(), m_file(nullptr)
+{
+}
+
+//***************************************************************************
+Kwave::PackedStripes::~PackedStripes()
+{
+    clear();
+}
+
+//***************************************************************************
+void Kwave::PackedStripes::clear()
+{
+    m_lists.clear();
+    delete m_file;
+    m_file = nullptr;
+}
+
+//***************************************************************************
+qint64 Kwave::PackedStripes::size() const
+{
+    qint64 size = 0;
+    for (const PackedList &list : m_lists) {
+        size += sizeof(list);
+        for (const Packed &packed : list.stripes)
+            size += sizeof(packed) + packed.data.size();
+    }
+    return size;
+}
+
+//***************************************************************************
+bool Kwave::PackedStripes::pack(QList<Kwave::Stripe::List> &stripes,
+                                 const std::atomic<bool> *cancel)
+{
+    if (!isEmpty() || stripes.isEmpty()) return false;
+
+    // packing only saves memory if nobody else uses the storage
+    for (const Kwave::Stripe::List &list : stripes) {
+        qint64 bytes = 0;
+        for (const Kwave::Stripe &stripe : list)
+            bytes += static_cast<qint64>(stripe.length()) * sizeof(sample_t);
+        if (list.uniqueSize() != bytes) return false;
+    }
+
+    // prepare the destination and a flat list of jobs
+    QList<PackedList> lists;
+    for (const Kwave::Stripe::List &list : stripes) {
+        PackedList packed_list;
+        packed_list.left  = list.left();
+        packed_list.right = list.right();
+        packed_list.stripes.resize(list.count());
+        lists.append(packed_list);
+    }
+    QVector<Kwave::Stripe *> sources;
+    QVector<Packed *>        destinations;
+    for (int l = 0; l < stripes.count(); ++l) {
+        Kwave::Stripe::List &list = stripes[l];
+        for (int s = 0; s < list.count(); ++s) {
+            sources.append(&(list[s]));
+            destinations.append(&(lists[l].stripes[s]));
+        }
+    }
+
+    // compress all stripes in parallel
+    std::atomic<bool> failed(false);
+    Kwave::WorkerPool::instance().run(Kwave::toUint(sources.count()),
+        [&](unsigned int index) {
+            if (failed) return;
+            if (cancel && *cancel)
+                failed = true;
+            else if (!encode(*sources[index], *destinations[index]))
+                failed = true;
+        }
+    );
+    if (cancel && *cancel) return false;
+    if (failed) {
+        qWarning("PackedStripes::pack() failed, OOM?");
+        return false;
+    }
+
+    // take over the packed data and release the samples
+    sources.clear();
+    destinations.clear();
+    m_lists = lists;
+    lists.clear();
+    stripes.clear();
+
+    if (size() > PACK_SPILL_THRESHOLD) spill();
+
+    return true;
+}
+
+//***************************************************************************
+bool Kwave::PackedStripes::unpack(QList<Kwave::Stripe::List> &stripes)
+{
+    if (isEmpty()) return true;
+
+    // get back the data from the temporary file
+    if (m_file) {
+        for (PackedList &list : m_lists) {
+            for (Packed &packed : list.stripes) {
+                if (!m_file->seek(packed.offset)) return false;
+                packed.data = m_file->read(packed.bytes);
+                if (packed.data.size() != packed.bytes) {
+                    qWarning("PackedStripes::unpack(): reading '%s' failed",
+                             DBG(m_file->fileName()));
+                    return false;
+                }
+            }
+        }
+        delete m_file;
+        m_file = nullptr;
+    }
+
+    // decompress all stripes in parallel
+    QVector<const Packed *> sources;
+    for (const PackedList &list : m_lists)
+        for (const Packed &packed : list.stripes)
+            sources.append(&packed);
+    QVector<Kwave::SampleArray> samples(sources.count());
+    std::atomic<bool> failed(false);
+    Kwave::WorkerPool::instance().run(Kwave::toUint(sources.count()),
+        [&](unsigned int index) {
+            if (failed) return;
+            const Packed *packed = sources[index];
+            if (!decode(packed->data, *packed, samples[index]))
+                failed = true;
+        }
+    );
+    if (failed) {
+        qWarning("PackedStripes::unpack() failed, OOM?");
+        return false;
+    }
+
+    // build the stripe lists out of the samples
+    stripes.clear();
+    int index = 0;
+    for (const PackedList &packed_list : m_lists) {
+        Kwave::Stripe::List list(packed_list.left, packed_list.right);
+        for (const Packed &packed : packed_list.stripes)
+            list.append(Kwave::Stripe(packed.start, samples[index++]));
+        stripes.append(list);
+    }
+
+    samples.clear();
+    clear();
+    return true;
+}
+
+//***************************************************************************
+bool Kwave::PackedStripes::encode(Kwave::Stripe &stripe, Packed &packed)
+{
+    const unsigned int length = stripe.length();
+    Kwave::SampleArray block(qMin(length, PACK_BLOCK_LENGTH));
+    if (block.size() != qMin(length, PACK_BLOCK_LENGTH)) return false;
+
+    // a sample needs at most five bytes
+    QByteArray raw(PACK_BLOCK_LENGTH * 5, Qt::Uninitialized);
+    QByteArray &data = packed.data;
+    data.clear();
+
+    for (unsigned int offset = 0; offset < length; ) {
+        const unsigned int len = qMin(length - offset, PACK_BLOCK_LENGTH);
+        if (stripe.read(block, 0, offset, len) != len) return false;
+        const sample_t *src = block.constData();
+
+        // skip the bits that are zero in all samples, e.g. 16 bit data
+        quint32 bits = 0;
+        for (unsigned int i = 0; i < len; ++i)
+            bits |= static_cast<quint32>(src[i]);
+        unsigned int shift = 0;
+        while (bits && !(bits & 1)) {
+            bits >>= 1;
+            ++shift;
+        }
+
+        // zigzag encoded differences, seven bits per byte
+        quint8 *start = reinterpret_cast<quint8 *>(raw.data());
+        quint8 *out   = start;
+        quint32 last  = 0;
+        for (unsigned int i = 0; i < len; ++i) {
+            const quint32 value = static_cast<quint32>(src[i] >> shift);
+            const quint32 diff  = value - last;
+            quint32 z = (diff << 1) ^ (0U - (diff >> 31));
+            last = value;
+            while (z >= 0x80) {
+                *(out++) = static_cast<quint8>(z | 0x80);
+                z >>= 7;
+            }
+            *(out++) = static_cast<quint8>(z);
+        }
+
+        const QByteArray compressed = qCompress(start,
+            static_cast<qsizetype>(out - start), PACK_COMPRESSION_LEVEL);
+        if (compressed.isEmpty()) return false;
+
+        char header[PACK_BLOCK_HEADER];
+        qToLittleEndian<quint32>(static_cast<quint32>(compressed.size()),
+                                 header);
+        header[4] = static_cast<char>(shift);
+        data.append(header, PACK_BLOCK_HEADER);
+        data.append(compressed);
+
+        offset += len;
+    }
+
+    data.squeeze();
+    packed.start  = stripe.start();
+    packed.length = length;
+    packed.offset = 0;
+    packed.bytes  = data.size();
+    return true;
+}
+
+//***************************************************************************
+bool Kwave::PackedStripes::decode(const QByteArray &data,
+                                  const Packed &packed,
+                                  Kwave::SampleArray &samples)
+{
+    if (!samples.resize(packed.length)) return false;
+    sample_t *dst = samples.data();
+
+    const uchar *in  = reinterpret_cast<const uchar *>(data.constData());
+    const uchar *end = in + data.size();
+    for (unsigned int pos = 0; pos < packed.length; ) {
+        if (end - in < PACK_BLOCK_HEADER) return false;
+        const quint32 bytes = qFromLittleEndian<quint32>(in);
+        const unsigned int shift = in[4];
+        in += PACK_BLOCK_HEADER;
+        if ((shift >= 32) || (static_cast<quint32>(end - in) < bytes))
+            return false;
+
+        const QByteArray raw = qUncompress(in, static_cast<qsizetype>(bytes));
+        in += bytes;
+
+        const quint8 *p     = reinterpret_cast<const quint8 *>(raw.constData());
+        const quint8 *p_end = p + raw.size();
+        const unsigned int len = qMin(packed.length - pos, PACK_BLOCK_LENGTH);
+        quint32 last = 0;
+        for (unsigned int i = 0; i < len; ++i) {
+            quint32 z = 0;
+            unsigned int bit = 0;
+            forever {
+                if (p >= p_end) return false;
+                const quint8 b = *(p++);
+                z |= static_cast<quint32>(b & 0x7F) << bit;
+                if (!(b & 0x80)) break;
+                bit += 7;
+                if (bit > 28) return false;
+            }
+            last += (z >> 1) ^ (0U - (z & 1));
+            *(dst++) = static_cast<sample_t>(last << shift);
+        }
+
+        pos += len;
+    }
+
+    return true;
+}
+
+//***************************************************************************
+bool Kwave::PackedStripes::spill()
+{
+    const QString dir = Kwave::MemoryManager::instance().swapDirectory();
+    QTemporaryFile *file = new(std::nothrow)
+        QTemporaryFile(dir + _("/kwave-undo-XXXXXX"));
+    Q_ASSERT(file);
+    if (!file) return false;
+    if (!file->open()) {
+        qWarning("PackedStripes: cannot create a file in '%s'", DBG(dir));
+        delete file;
+        return false;
+    }
+
+    qint64 offset = 0;
+    for (const PackedList &list : m_lists) {
+        for (const Packed &packed : list.stripes) {
+            if (file->write(packed.data) != packed.bytes) {
+                qWarning("PackedStripes: writing to '%s' failed",
+                         DBG(file->fileName()));
+                delete file;
+                return false;
+            }
+        }
+    }
+
+    // everything is on disk, release the memory
+    for (PackedList &list : m_lists) {
+        for (Packed &packed : list.stripes) {
+            packed.offset = offset;
+            offset += packed.bytes;
+            packed.data = QByteArray();
+        }
+    }
+    m_file = file;
+
+    return true;
+}
+
+//***************************************************************************
+//***************************************************************************
@@ -0,0 +1,147 @@
+/*************************************************************************
+        PackedStripes.h  -  losslessly compressed storage for undo data
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PACKED_STRIPES_H
+#define PACKED_STRIPES_H
+
+#include "config.h"
+#include "libkwave_export.h"
+
+#include <atomic>
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include "libkwave/Sample.h"
+#include "libkwave/Stripe.h"
+
+class QTemporaryFile;
+
+namespace Kwave
+{
+
+    /**
+     * Keeps the samples of a list of stripes losslessly compressed, for
+     * undo data that will probably not be needed soon. The samples of
+     * each stripe are delta encoded, stored with a variable number of
+     * bytes and then compressed with zlib. If the result is still large,
+     * it is moved into a temporary file in the swap directory.
+     */
+    class LIBKWAVE_EXPORT PackedStripes
+    {
+    public:
+
+        /** Constructor */
+        PackedStripes();
+
+        /** Destructor */
+        virtual ~PackedStripes();
+
+        /**
+         * Compresses a list of stripes and clears it if successful.
+         * Nothing is done if some storage of the stripes is still shared
+         * with the signal or another copy, as that would not free any
+         * memory.
+         * @param stripes list of stripe lists, one per track
+         * @param cancel optional flag, if it becomes true packing is
+         *        given up and the stripes are left as they are
+         * @return true if the stripes have been packed
+         */
+        bool pack(QList<Kwave::Stripe::List> &stripes,
+                  const std::atomic<bool> *cancel = nullptr);
+
+        /**
+         * Restores the stripes if they have been packed before and
+         * releases the packed data
+         * @param stripes receives the list of stripe lists
+         * @return true if succeeded or if nothing was packed, false if
+         *         out of memory or reading the temporary file failed
+         */
+        bool unpack(QList<Kwave::Stripe::List> &stripes);
+
+        /** returns true if nothing is packed */
+        inline bool isEmpty() const { return m_lists.isEmpty(); }
+
+        /**
+         * Returns the number of bytes that are kept in memory, data in
+         * the temporary file is not included
+         */
+        qint64 size() const;
+
+    private:
+
+        /** one compressed stripe */
+        typedef struct {
+            sample_index_t start;  /**< start of the stripe */
+            unsigned int   length; /**< number of samples */
+            unsigned int   shift;  /**< bits that are zero in all samples */
+            qint64         offset; /**< position in the file if spilled */
+            qint64         bytes;  /**< size of the compressed data */
+            QByteArray     data;   /**< compressed data if not spilled */
+        } Packed;
+
+        /** compressed counterpart of a Kwave::Stripe::List */
+        typedef struct {
+            sample_index_t   left;    /**< first sample */
+            sample_index_t   right;   /**< last sample */
+            QVector<Packed>  stripes; /**< the compressed stripes */
+        } PackedList;
+
+        /**
+         * Compresses the samples of one stripe
+         * @param stripe the source stripe
+         * @param packed receives the compressed data
+         * @return true if succeeded
+         */
+        static bool encode(Kwave::Stripe &stripe, Packed &packed);
+
+        /**
+         * Restores the samples of one stripe
+         * @param data the compressed data
+         * @param packed description of the stripe
+         * @param samples receives the samples
+         * @return true if succeeded
+         */
+        static bool decode(const QByteArray &data, const Packed &packed,
+                           Kwave::SampleArray &samples);
+
+        /**
+         * Moves the compressed data into a temporary file
+         * @return true if succeeded, false if the data stays in memory
+         */
+        bool spill();
+
+        /** releases all packed data and the temporary file */
+        void clear();
+
+    private:
+
+        /** the compressed stripes, one list per track */
+        QList<PackedList> m_lists;
+
+        /** temporary file with the compressed data, or null */
+        QTemporaryFile *m_file;
+
+    };
+}
+
+#endif /* PACKED_STRIPES_H */
+
+//***************************************************************************
+//***************************************************************************
@@ -22,10 +22,14 @@
 #include "config.h"
 #include "libkwave_export.h"
 
+#include <atomic>
+
 #include <QtGlobal>
+#include <QList>
 #include <QString>
 
 #include "libkwave/String.h"
+#include "libkwave/Stripe.h"
 
 namespace Kwave
 {
@@ -61,6 +65,10 @@ namespace Kwave
          * Returns the required amount of memory that is needed for storing
          * undo data for the operation. This will be called to determine the
          * free memory to be reserved.
+         * After store() has been called, actions that hold stripes should
+         * only count the sample storage that is not shared with the
+         * signal or other copies, as only that would be freed when the
+         * action is deleted.
          * @note this is the first step (after the constructor)
          */
         virtual qint64 undoSize() = 0;
@@ -79,6 +87,30 @@ namespace Kwave
          */
         virtual bool store(Kwave::SignalManager &manager) = 0;
 
+        /**
+         * Compresses the stored data, to save memory while the action is
+         * probably not needed soon. This is called from a background
+         * thread, no other method is called at the same time. The
+         * default implementation does nothing.
+         * @param cancel becomes true if packing should be given up, the
+         *        stored data then has to stay usable
+         */
+        virtual void pack(const std::atomic<bool> & /* cancel */) { }
+
+        /**
+         * Registers the sample storage held by the action in a map, so
+         * that storage shared by several actions is counted only once.
+         * The default implementation holds no stripes and only returns
+         * undoSize().
+         * @param map receives the sample storage
+         * @return size in bytes, without the registered storage
+         * @see Kwave::Stripe::countStorage()
+         */
+        virtual qint64 countStorage(Kwave::Stripe::StorageMap & /* map */)
+        {
+            return undoSize();
+        }
+
         /**
          * Takes back an action by creating a new undo action (for further
          * redo) and restoring the previous state.
@@ -107,6 +139,36 @@ namespace Kwave
             qDebug("%s%s", DBG(indent), DBG(description()));
         }
 
+    protected:
+
+        /**
+         * Returns the number of bytes of sample storage that is
+         * referenced only by a list of stripes
+         * @param stripes list of stripe lists, one per track
+         * @return size in bytes
+         * @see Kwave::Stripe::uniqueSize()
+         */
+        static qint64 uniqueSize(const QList<Kwave::Stripe::List> &stripes)
+        {
+            qint64 size = 0;
+            for (const Kwave::Stripe::List &list : stripes)
+                size += list.uniqueSize();
+            return size;
+        }
+
+        /**
+         * Registers the sample storage of a list of stripes in a map
+         * @param stripes list of stripe lists, one per track
+         * @param map receives the sample storage
+         * @see Kwave::Stripe::countStorage()
+         */
+        static void addStorage(const QList<Kwave::Stripe::List> &stripes,
+                               Kwave::Stripe::StorageMap &map)
+        {
+            for (const Kwave::Stripe::List &list : stripes)
+                list.countStorage(map);
+        }
+
     };
 }
 
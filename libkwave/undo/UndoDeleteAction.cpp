@@ -37,7 +37,7 @@ Kwave::UndoDeleteAction::UndoDeleteAction(
 )
     :Kwave::UndoAction(),
      m_parent_widget(parent_widget),
-     m_stripes(), m_meta_data(),
+     m_stripes(), m_packed(), m_meta_data(),
      m_track_list(track_list),
      m_offset(offset), m_length(length),
      m_undo_size(sizeof(*this))
@@ -61,7 +61,20 @@ QString Kwave::UndoDeleteAction::description()
 //***************************************************************************
 qint64 Kwave::UndoDeleteAction::undoSize()
 {
-    return m_undo_size;
+    if (!m_packed.isEmpty()) return sizeof(*this) + m_packed.size();
+    if (m_stripes.isEmpty()) return m_undo_size;
+
+    // count only what is not shared with the clipboard or other actions
+    return sizeof(*this) + uniqueSize(m_stripes);
+}
+
+//***************************************************************************
+qint64 Kwave::UndoDeleteAction::countStorage(Kwave::Stripe::StorageMap &map)
+{
+    if (!m_packed.isEmpty() || m_stripes.isEmpty()) return undoSize();
+
+    addStorage(m_stripes, map);
+    return sizeof(*this);
 }
 
 //***************************************************************************
@@ -88,12 +101,24 @@ bool Kwave::UndoDeleteAction::store(Kwave::SignalManager &manager)
     return true;
 }
 
+//***************************************************************************
+void Kwave::UndoDeleteAction::pack(const std::atomic<bool> &cancel)
+{
+    m_packed.pack(m_stripes, &cancel);
+}
+
 //***************************************************************************
 Kwave::UndoAction *Kwave::UndoDeleteAction::undo(Kwave::SignalManager &manager,
                                                  bool with_redo)
 {
     Kwave::UndoAction *redo_action = nullptr;
 
+    // restore the stripes if they have been packed
+    if (!m_packed.unpack(m_stripes)) {
+        qWarning("UndoDeleteAction::undo() FAILED [unpack]");
+        return nullptr;
+    }
+
     // store data for redo
     if (with_redo) {
         redo_action = new(std::nothrow) Kwave::UndoInsertAction(
@@ -27,6 +27,7 @@
 #include "libkwave/MetaDataList.h"
 #include "libkwave/Sample.h"
 #include "libkwave/String.h"
+#include "libkwave/undo/PackedStripes.h"
 #include "libkwave/undo/UndoAction.h"
 
 class QWidget;
@@ -72,6 +73,12 @@ namespace Kwave
          */
         bool store(Kwave::SignalManager &manager) override;
 
+        /** @see UndoAction::pack() */
+        void pack(const std::atomic<bool> &cancel) override;
+
+        /** @see UndoAction::countStorage() */
+        qint64 countStorage(Kwave::Stripe::StorageMap &map) override;
+
         /**
          * Copies the samples to be deleted to the internal buffer.
          * @see UndoAction::undo()
@@ -90,6 +97,9 @@ namespace Kwave
         /** storage for all deleted stripes */
         QList<Kwave::Stripe::List> m_stripes;
 
+        /** the deleted stripes in compressed form, after pack() */
+        Kwave::PackedStripes m_packed;
+
         /** storage for the affected meta data items */
         Kwave::MetaDataList m_meta_data;
 
@@ -102,8 +112,8 @@ namespace Kwave
         /** number of deleted samples */
         sample_index_t m_length;
 
-        /** memory needed for undo */
-        unsigned int m_undo_size;
+        /** memory needed for undo, estimated before storing */
+        qint64 m_undo_size;
 
     };
 }
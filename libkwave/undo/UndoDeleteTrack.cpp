@@ -30,7 +30,8 @@
 Kwave::UndoDeleteTrack::UndoDeleteTrack(Kwave::Signal &signal,
                                         unsigned int track)
     :UndoAction(), m_signal(signal), m_track(track),
-     m_length(signal.length()), m_stripes(), m_uid(signal.uidOfTrack(track))
+     m_length(signal.length()), m_stripes(), m_packed(),
+     m_uid(signal.uidOfTrack(track))
 {
 }
 
@@ -48,7 +49,22 @@ QString Kwave::UndoDeleteTrack::description()
 //***************************************************************************
 qint64 Kwave::UndoDeleteTrack::undoSize()
 {
-    return sizeof(*this) + m_length * sizeof(sample_t);
+    if (!m_packed.isEmpty())
+        return sizeof(*this) + m_packed.size();
+
+    if (m_stripes.isEmpty())
+        return sizeof(*this) + m_length * sizeof(sample_t);
+
+    return sizeof(*this) + uniqueSize(m_stripes);
+}
+
+//***************************************************************************
+qint64 Kwave::UndoDeleteTrack::countStorage(Kwave::Stripe::StorageMap &map)
+{
+    if (!m_packed.isEmpty() || m_stripes.isEmpty()) return undoSize();
+
+    addStorage(m_stripes, map);
+    return sizeof(*this);
 }
 
 //***************************************************************************
@@ -72,12 +88,24 @@ bool Kwave::UndoDeleteTrack::store(Kwave::SignalManager &manager)
     return true;
 }
 
+//***************************************************************************
+void Kwave::UndoDeleteTrack::pack(const std::atomic<bool> &cancel)
+{
+    m_packed.pack(m_stripes, &cancel);
+}
+
 //***************************************************************************
 Kwave::UndoAction *Kwave::UndoDeleteTrack::undo(Kwave::SignalManager &manager,
                                                 bool with_redo)
 {
     Kwave::UndoAction *redo_action = nullptr;
 
+    // restore the stripes if they have been packed
+    if (!m_packed.unpack(m_stripes)) {
+        qWarning("UndoDeleteTrack::undo() FAILED [unpack]");
+        return nullptr;
+    }
+
     // create a redo action
     if (with_redo) {
         redo_action =
@@ -25,6 +25,7 @@
 
 #include "libkwave/Sample.h"
 #include "libkwave/Stripe.h"
+#include "libkwave/undo/PackedStripes.h"
 #include "libkwave/undo/UndoAction.h"
 
 namespace Kwave
@@ -63,6 +64,12 @@ namespace Kwave
         /** @see UndoAction::store() */
         bool store(SignalManager &manager) override;
 
+        /** @see UndoAction::pack() */
+        void pack(const std::atomic<bool> &cancel) override;
+
+        /** @see UndoAction::countStorage() */
+        qint64 countStorage(Kwave::Stripe::StorageMap &map) override;
+
         /** @see UndoAction::undo() */
         Kwave::UndoAction *undo(Kwave::SignalManager &manager,
                                         bool with_redo) override;
@@ -81,6 +88,9 @@ namespace Kwave
         /** storage for all deleted stripes */
         QList<Kwave::Stripe::List> m_stripes;
 
+        /** the deleted stripes in compressed form, after pack() */
+        Kwave::PackedStripes m_packed;
+
         /** unique ID of the deleted track */
         quint64 m_uid;
 
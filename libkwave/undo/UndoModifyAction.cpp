@@ -30,7 +30,7 @@ Kwave::UndoModifyAction::UndoModifyAction(unsigned int track,
                                           sample_index_t offset,
                                           sample_index_t length)
     :UndoAction(), m_track(track), m_offset(offset), m_length(length),
-     m_stripes()
+     m_stripes(), m_packed()
 {
 }
 
@@ -48,7 +48,24 @@ QString Kwave::UndoModifyAction::description()
 //***************************************************************************
 qint64 Kwave::UndoModifyAction::undoSize()
 {
-    return sizeof(*this) + (m_length * sizeof(sample_t));
+    if (!m_packed.isEmpty())
+        return sizeof(*this) + m_packed.size();
+
+    // before storing, assume that the whole range will get detached
+    // from the signal by the following modification
+    if (m_stripes.isEmpty())
+        return sizeof(*this) + (m_length * sizeof(sample_t));
+
+    return sizeof(*this) + uniqueSize(m_stripes);
+}
+
+//***************************************************************************
+qint64 Kwave::UndoModifyAction::countStorage(Kwave::Stripe::StorageMap &map)
+{
+    if (!m_packed.isEmpty() || m_stripes.isEmpty()) return undoSize();
+
+    addStorage(m_stripes, map);
+    return sizeof(*this);
 }
 
 //***************************************************************************
@@ -68,6 +85,12 @@ bool Kwave::UndoModifyAction::store(Kwave::SignalManager &manager)
     return true;
 }
 
+//***************************************************************************
+void Kwave::UndoModifyAction::pack(const std::atomic<bool> &cancel)
+{
+    m_packed.pack(m_stripes, &cancel);
+}
+
 //***************************************************************************
 Kwave::UndoAction *Kwave::UndoModifyAction::undo(
     Kwave::SignalManager &manager, bool with_redo)
@@ -79,6 +102,12 @@ Kwave::UndoAction *Kwave::UndoModifyAction::undo(
     track_list.append(m_track);
     bool ok = true;
 
+    // restore the stripes if they have been packed
+    if (!m_packed.unpack(m_stripes)) {
+        qWarning("UndoModifyAction::undo() FAILED [unpack]");
+        return nullptr;
+    }
+
     if (m_length && with_redo) {
         // save the current stripes for later redo
         redo_data = manager.stripes(track_list, left, right);
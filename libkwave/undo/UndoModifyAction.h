@@ -25,6 +25,7 @@
 #include "libkwave/Sample.h"
 #include "libkwave/Stripe.h"
 
+#include "libkwave/undo/PackedStripes.h"
 #include "libkwave/undo/UndoAction.h"
 
 namespace Kwave
@@ -60,6 +61,12 @@ namespace Kwave
         */
         bool store(Kwave::SignalManager &manager) override;
 
+        /** @see UndoAction::pack() */
+        void pack(const std::atomic<bool> &cancel) override;
+
+        /** @see UndoAction::countStorage() */
+        qint64 countStorage(Kwave::Stripe::StorageMap &map) override;
+
         /**
          * Exchange samples from the current signal and the internal undo
          * buffer. So this instance will be reused for redo and so does not
@@ -83,6 +90,9 @@ namespace Kwave
         /** storage for all deleted stripes */
         QList<Kwave::Stripe::List> m_stripes;
 
+        /** the stripes in compressed form, after pack() */
+        Kwave::PackedStripes m_packed;
+
     };
 }
 
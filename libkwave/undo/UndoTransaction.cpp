@@ -18,6 +18,7 @@
 #include "config.h"
 
 #include <QListIterator>
+#include <QtConcurrentRun>
 
 #include "libkwave/String.h"
 #include "libkwave/undo/UndoAction.h"
@@ -25,13 +26,15 @@
 
 //***************************************************************************
 Kwave::UndoTransaction::UndoTransaction(const QString &name)
-    :QList<UndoAction *>(), m_description(name), m_aborted(false)
+    :QList<UndoAction *>(), m_description(name), m_aborted(false),
+     m_packer(), m_pack_cancel(false), m_pack_size(0)
 {
 }
 
 //***************************************************************************
 Kwave::UndoTransaction::~UndoTransaction()
 {
+    cancelPacking();
     while (!isEmpty()) {
         delete takeLast();
     }
@@ -40,6 +43,9 @@ Kwave::UndoTransaction::~UndoTransaction()
 //***************************************************************************
 qint64 Kwave::UndoTransaction::undoSize()
 {
+    // do not touch the actions while they are being packed
+    if (m_packer.isRunning()) return m_pack_size;
+
     qint64 s = 0;
     QListIterator<UndoAction *> it(*this);
     while (it.hasNext()) {
@@ -49,6 +55,21 @@ qint64 Kwave::UndoTransaction::undoSize()
     return s;
 }
 
+//***************************************************************************
+qint64 Kwave::UndoTransaction::countStorage(Kwave::Stripe::StorageMap &map)
+{
+    // do not touch the actions while they are being packed
+    if (m_packer.isRunning()) return m_pack_size;
+
+    qint64 s = 0;
+    QListIterator<UndoAction *> it(*this);
+    while (it.hasNext()) {
+        UndoAction *undo = it.next();
+        if (undo) s += undo->countStorage(map);
+    }
+    return s;
+}
+
 //***************************************************************************
 qint64 Kwave::UndoTransaction::redoSize()
 {
@@ -61,6 +82,29 @@ qint64 Kwave::UndoTransaction::redoSize()
     return s;
 }
 
+//***************************************************************************
+void Kwave::UndoTransaction::startPacking()
+{
+    cancelPacking();
+    m_pack_size = undoSize();
+    m_pack_cancel = false;
+
+    const QList<UndoAction *> actions(*this);
+    m_packer = QtConcurrent::run([this, actions]() {
+        for (UndoAction *undo : actions) {
+            if (m_pack_cancel) break;
+            if (undo) undo->pack(m_pack_cancel);
+        }
+    });
+}
+
+//***************************************************************************
+void Kwave::UndoTransaction::cancelPacking()
+{
+    m_pack_cancel = true;
+    m_packer.waitForFinished();
+}
+
 //***************************************************************************
 QString Kwave::UndoTransaction::description()
 {
@@ -20,9 +20,14 @@
 
 #include "config.h"
 
+#include <atomic>
+
+#include <QFuture>
 #include <QList>
 #include <QString>
 
+#include "libkwave/Stripe.h"
+
 class UndoAction;
 
 namespace Kwave {
@@ -49,12 +54,44 @@ namespace Kwave {
         /** Destructor */
         virtual ~UndoTransaction();
 
-        /** Returns the size in bytes summed up over all undo actions */
+        /**
+         * Returns the size in bytes summed up over all undo actions. While
+         * the data is being packed, the size before packing is returned,
+         * without waiting.
+         */
         qint64 undoSize();
 
+        /**
+         * Registers the sample storage of all undo actions in a map, so
+         * that storage shared with other transactions can be counted
+         * only once. While the data is being packed, nothing is
+         * registered and the size before packing is returned.
+         * @param map receives the sample storage
+         * @return size in bytes, without the registered storage
+         * @see UndoAction::countStorage()
+         */
+        qint64 countStorage(Kwave::Stripe::StorageMap &map);
+
         /** Returns the additional memory needed for storing redo data */
         qint64 redoSize();
 
+        /**
+         * Starts compressing the data of all undo actions in a background
+         * thread. Nothing else may be done with the transaction until
+         * packing has finished or has been cancelled, except asking for
+         * its size or description.
+         * @see UndoAction::pack()
+         * @see cancelPacking()
+         */
+        void startPacking();
+
+        /**
+         * Stops compressing the data in the background and waits until
+         * the background thread has finished. Actions that already have
+         * been packed stay packed, the others are left as they are.
+         */
+        void cancelPacking();
+
         /**
          * Returns the description of the undo transaction as a user-readable
          * localized string. If no name has been passed at initialization
@@ -92,6 +129,15 @@ namespace Kwave {
         /** if true, the transaction has been aborted */
         bool m_aborted;
 
+        /** compresses the data in the background */
+        QFuture<void> m_packer;
+
+        /** set to true for cancelling the packer */
+        std::atomic<bool> m_pack_cancel;
+
+        /** size of the undo data when packing has been started */
+        qint64 m_pack_size;
+
     };
 }
 
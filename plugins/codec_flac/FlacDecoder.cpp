@@ -17,11 +17,14 @@
 
 #include "config.h"
 
+#include <algorithm>
 #include <new>
 
 #include <QDateTime>
+#include <QFile>
 #include <QFutureSynchronizer>
 #include <QIODevice>
+#include <QThread>
 #include <QtConcurrentRun>
 
 #include <KLocalizedString>
@@ -31,10 +34,19 @@
 #include "libkwave/MultiWriter.h"
 #include "libkwave/Sample.h"
 #include "libkwave/String.h"
+#include "libkwave/Utils.h"
+#include "libkwave/WorkerPool.h"
 #include "libkwave/Writer.h"
 
 #include "FlacCodecPlugin.h"
 #include "FlacDecoder.h"
+#include "FlacSegmentDecoder.h"
+
+/**
+ * nominal length of a segment for parallel decoding [samples per track],
+ * the real segments start at a seek point near a multiple of this
+ */
+#define SEGMENT_LENGTH (512 * 1024)
 
 //***************************************************************************
 Kwave::FlacDecoder::FlacDecoder()
@@ -42,7 +54,9 @@ Kwave::FlacDecoder::FlacDecoder()
      FLAC::Decoder::Stream(),
      m_source(nullptr),
      m_dest(nullptr),
-     m_vorbis_comment_map()
+     m_vorbis_comment_map(),
+     m_seek_points(),
+     m_skip(0)
 {
     REGISTER_MIME_TYPES
     REGISTER_COMPRESSION_TYPES
@@ -96,7 +110,19 @@ Kwave::Decoder *Kwave::FlacDecoder::instance()
     if (!buffer || !frame || !m_dest)
         return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
 
-    const unsigned int samples = frame->header.blocksize;
+    unsigned int samples = frame->header.blocksize;
+    unsigned int offset  = 0;
+
+    // drop samples that already have been written
+    if (m_skip >= samples) {
+        m_skip -= samples;
+        return (m_dest->isCanceled()) ?
+            FLAC__STREAM_DECODER_WRITE_STATUS_ABORT :
+            FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+    }
+    offset   = Kwave::toUint(m_skip);
+    samples -= offset;
+    m_skip   = 0;
 
     const unsigned int tracks  = Kwave::FileInfo(metaData()).tracks();
     Q_ASSERT(samples);
@@ -116,7 +142,7 @@ Kwave::Decoder *Kwave::FlacDecoder::instance()
         Kwave::Writer *writer = (*m_dest)[track];
         if (!writer) continue;
 
-        const FLAC__int32 *buf = buffer[track];
+        const FLAC__int32 *buf = buffer[track] + offset;
 
         synchronizer.addFuture(QtConcurrent::run(
             [buf, samples, shift, mul, writer]() {
@@ -222,6 +248,22 @@ void Kwave::FlacDecoder::parseVorbisComments(
      metaData().replace(Kwave::MetaDataList(info));
 }
 
+//***************************************************************************
+void Kwave::FlacDecoder::parseSeekTable(
+    const FLAC::Metadata::SeekTable &seek_table)
+{
+    m_seek_points.clear();
+    for (unsigned int i = 0; i < seek_table.get_num_points(); i++) {
+        const ::FLAC__StreamMetadata_SeekPoint point =
+            seek_table.get_point(i);
+        if (point.sample_number == FLAC__STREAM_METADATA_SEEKPOINT_PLACEHOLDER)
+            continue;
+        m_seek_points.append(point.sample_number);
+    }
+    std::sort(m_seek_points.begin(), m_seek_points.end());
+    qDebug("FLAC seek table with %d seek points", m_seek_points.count());
+}
+
 //***************************************************************************
 void Kwave::FlacDecoder::metadata_callback(
     const ::FLAC__StreamMetadata *metadata)
@@ -242,9 +284,12 @@ void Kwave::FlacDecoder::metadata_callback(
         case FLAC__METADATA_TYPE_APPLICATION:
             qDebug("FLAC metadata: application data");
             break;
-        case FLAC__METADATA_TYPE_SEEKTABLE:
-            qDebug("FLAC metadata: seektable - not supported yet");
+        case FLAC__METADATA_TYPE_SEEKTABLE: {
+            FLAC::Metadata::SeekTable seek_table(
+                const_cast< ::FLAC__StreamMetadata * >(metadata), true);
+            parseSeekTable(seek_table);
             break;
+        }
         case FLAC__METADATA_TYPE_VORBIS_COMMENT: {
             FLAC::Metadata::VorbisComment vorbis_comments(
                 const_cast< ::FLAC__StreamMetadata * >(metadata), true);
@@ -270,6 +315,7 @@ void Kwave::FlacDecoder::error_callback(::FLAC__StreamDecoderErrorStatus status)
 bool Kwave::FlacDecoder::open(QWidget *widget, QIODevice &src)
 {
     metaData().clear();
+    m_seek_points.clear();
     Q_ASSERT(!m_source);
     if (m_source) qWarning("FlacDecoder::open(), already open !");
 
@@ -323,9 +369,28 @@ bool Kwave::FlacDecoder::decode(QWidget * /* widget */,
 
     m_dest = &dst;
 
-    // read in all remaining data
-    qDebug("FlacDecoder::decode(...)");
-    process_until_end_of_stream();
+    // long files can be split into segments that are decoded in parallel,
+    // this needs random access to the file from several threads
+    const QFile *file = qobject_cast<QFile *>(m_source);
+    const sample_index_t length = Kwave::FileInfo(metaData()).length();
+    if (file && (length >= 2 * SEGMENT_LENGTH) &&
+        (QThread::idealThreadCount() > 1))
+    {
+        qDebug("FlacDecoder::decode(...) - in segments");
+        if (!decodeSegments(file->fileName()) && !dst.isCanceled()) {
+            // continue sequentially after the last sample that has been
+            // written, the stream still is positioned after the metadata
+            m_skip = dst.last() ? (dst.last() + 1) : 0;
+            qWarning("FlacDecoder::decode(...) - continuing "
+                     "sequentially at sample %llu", m_skip);
+            process_until_end_of_stream();
+            m_skip = 0;
+        }
+    } else {
+        // read in all remaining data
+        qDebug("FlacDecoder::decode(...)");
+        process_until_end_of_stream();
+    }
 
     m_dest = nullptr;
     Kwave::FileInfo info(metaData());
@@ -336,6 +401,89 @@ bool Kwave::FlacDecoder::decode(QWidget * /* widget */,
     return true;
 }
 
+//***************************************************************************
+bool Kwave::FlacDecoder::decodeSegments(const QString &filename)
+{
+    const Kwave::FileInfo info(metaData());
+    const sample_index_t length = info.length();
+    const unsigned int   tracks = info.tracks();
+    const unsigned int   bits   = info.bits();
+    Q_ASSERT(m_dest);
+    if (!m_dest || !length || !tracks) return false;
+
+    // start a segment at each multiple of the nominal length, or at
+    // the nearest seek point if there is one, seeking to it is cheap
+    QVector<sample_index_t> starts;
+    starts.append(0);
+    for (sample_index_t pos = SEGMENT_LENGTH; pos < length;
+         pos += SEGMENT_LENGTH)
+    {
+        sample_index_t start = pos;
+        QVector<sample_index_t>::const_iterator it = std::lower_bound(
+            m_seek_points.constBegin(), m_seek_points.constEnd(),
+            pos - (SEGMENT_LENGTH / 2));
+        if ((it != m_seek_points.constEnd()) &&
+            (*it < pos + (SEGMENT_LENGTH / 2)) && (*it < length))
+            start = *it;
+        if (start > starts.last()) starts.append(start);
+    }
+    starts.append(length);
+
+    // decode as many segments in parallel as we have cores, then write
+    // them to the tracks in their order
+    const int segments = starts.count() - 1;
+    const int window   = qMax(QThread::idealThreadCount(), 1);
+    for (int first = 0; first < segments; first += window) {
+        const int count = qMin(window, segments - first);
+        QVector<QVector<Kwave::SampleArray> > blocks(count);
+        QVector<unsigned int> decoded(count, 0);
+
+        Kwave::WorkerPool::instance().run(Kwave::toUint(count),
+            [&](unsigned int index) {
+                const sample_index_t start = starts[first + index];
+                const unsigned int   len   =
+                    Kwave::toUint(starts[first + index + 1] - start);
+
+                QVector<Kwave::SampleArray> &block = blocks[index];
+                block.resize(tracks);
+                for (Kwave::SampleArray &samples : block) {
+                    if (!samples.resize(len)) return; // out of memory
+                }
+
+                Kwave::FlacSegmentDecoder decoder(filename, bits);
+                decoded[index] = decoder.decode(start, block);
+            }
+        );
+
+        for (int index = 0; index < count; ++index) {
+            const sample_index_t start = starts[first + index];
+            const unsigned int   len   =
+                Kwave::toUint(starts[first + index + 1] - start);
+            QVector<Kwave::SampleArray> &block = blocks[index];
+            if (decoded[index] < len) {
+                for (Kwave::SampleArray &samples : block)
+                    samples.resize(decoded[index]);
+            }
+
+            for (unsigned int track = 0; track < tracks; ++track) {
+                Kwave::Writer *writer = (*m_dest)[track];
+                if (writer && decoded[index]) (*writer) << block[track];
+            }
+            block.clear();
+
+            // a damaged or truncated stream ends with the first gap
+            if (decoded[index] < len) {
+                qWarning("FlacDecoder: decoding stopped at sample %llu",
+                         start + decoded[index]);
+                return false;
+            }
+            if (m_dest->isCanceled()) return true;
+        }
+    }
+
+    return true;
+}
+
 //***************************************************************************
 void Kwave::FlacDecoder::close()
 {
@@ -25,6 +25,7 @@
 #include <QObject>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include <FLAC++/decoder.h>
 #include <FLAC++/metadata.h>
@@ -32,6 +33,7 @@
 
 #include "libkwave/Decoder.h"
 #include "libkwave/FileInfo.h"
+#include "libkwave/Sample.h"
 #include "libkwave/VorbisCommentMap.h"
 
 class QWidget;
@@ -94,6 +96,23 @@ namespace Kwave
         void parseVorbisComments(
             const FLAC::Metadata::VorbisComment &vorbis_comments);
 
+        /**
+         * Parse the seek table, for splitting the stream into segments
+         *
+         * @param seek_table FLAC metadata with the seek points
+         */
+        void parseSeekTable(const FLAC::Metadata::SeekTable &seek_table);
+
+        /**
+         * Decodes the stream in segments that are processed in parallel,
+         * each one with a decoder of its own. The segments start at seek
+         * points if possible.
+         *
+         * @param filename name of the file with the stream
+         * @return true if succeeded, false on errors
+         */
+        bool decodeSegments(const QString &filename);
+
         /**
          * FLAC decoder interface: read callback.
          *
@@ -143,6 +162,15 @@ namespace Kwave
         /** map for translating vorbis comments to FileInfo properties */
         Kwave::VorbisCommentMap m_vorbis_comment_map;
 
+        /** sample indices of the seek points of the stream, ascending */
+        QVector<sample_index_t> m_seek_points;
+
+        /**
+         * number of samples per track that the write callback has to
+         * drop, because they have already been written
+         */
+        sample_index_t m_skip;
+
     };
 }
 
@@ -20,12 +20,14 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include <atomic>
 #include <new>
 
 #include <QApplication>
 #include <QByteArray>
 #include <QIODevice>
 #include <QList>
+#include <QThread>
 #include <QVarLengthArray>
 
 #include <KLocalizedString>
@@ -41,10 +43,17 @@
 #include "libkwave/SampleReader.h"
 #include "libkwave/String.h"
 #include "libkwave/Utils.h"
+#include "libkwave/WorkerPool.h"
 
 #include "FlacCodecPlugin.h"
 #include "FlacEncoder.h"
 
+/** distance between two seek points [seconds] */
+#define SEEK_POINT_INTERVAL 10
+
+/** upper limit of the number of encoder threads */
+#define MAX_ENCODER_THREADS 64
+
 /***************************************************************************/
 Kwave::FlacEncoder::FlacEncoder()
     :Kwave::Encoder(), FLAC::Encoder::Stream(),
@@ -89,6 +98,35 @@ QList<Kwave::FileProperty> Kwave::FlacEncoder::supportedProperties()
         FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
 }
 
+/***************************************************************************/
+::FLAC__StreamEncoderSeekStatus Kwave::FlacEncoder::seek_callback(
+        FLAC__uint64 absolute_byte_offset)
+{
+    Q_ASSERT(m_dst);
+    if (!m_dst) return FLAC__STREAM_ENCODER_SEEK_STATUS_ERROR;
+    if (m_dst->isSequential())
+        return FLAC__STREAM_ENCODER_SEEK_STATUS_UNSUPPORTED;
+
+    return m_dst->seek(static_cast<qint64>(absolute_byte_offset)) ?
+        FLAC__STREAM_ENCODER_SEEK_STATUS_OK :
+        FLAC__STREAM_ENCODER_SEEK_STATUS_ERROR;
+}
+
+/***************************************************************************/
+::FLAC__StreamEncoderTellStatus Kwave::FlacEncoder::tell_callback(
+        FLAC__uint64 *absolute_byte_offset)
+{
+    Q_ASSERT(m_dst);
+    Q_ASSERT(absolute_byte_offset);
+    if (!m_dst || !absolute_byte_offset)
+        return FLAC__STREAM_ENCODER_TELL_STATUS_ERROR;
+    if (m_dst->isSequential())
+        return FLAC__STREAM_ENCODER_TELL_STATUS_UNSUPPORTED;
+
+    *absolute_byte_offset = static_cast<FLAC__uint64>(m_dst->pos());
+    return FLAC__STREAM_ENCODER_TELL_STATUS_OK;
+}
+
 /***************************************************************************/
 void Kwave::FlacEncoder::metadata_callback(const ::FLAC__StreamMetadata *)
 {
@@ -162,6 +200,30 @@ void Kwave::FlacEncoder::encodeMetaData(const Kwave::FileInfo &info,
     }
     flac_metadata.append(vc.data());
 
+    // reserve a seek table, the encoder fills it in when it is finished
+    const sample_index_t length = info.length();
+    const unsigned int   rate   = Kwave::toUint(info.rate());
+    if (length && rate) {
+        FLAC__StreamMetadata *seek_table =
+            FLAC__metadata_object_new(FLAC__METADATA_TYPE_SEEKTABLE);
+        Q_ASSERT(seek_table);
+        if (seek_table) {
+            const unsigned int points = Kwave::toUint(
+                length / (SEEK_POINT_INTERVAL * rate)) + 1;
+            bool ok =
+                FLAC__metadata_object_seektable_template_append_spaced_points(
+                    seek_table, points, length) &&
+                FLAC__metadata_object_seektable_template_sort(
+                    seek_table, true);
+            if (ok) {
+                flac_metadata.append(seek_table);
+            } else {
+                qWarning("FlacEncoder: creating the seek table failed");
+                FLAC__metadata_object_delete(seek_table);
+            }
+        }
+    }
+
     // todo: add cue sheet etc here...
 
 }
@@ -198,6 +260,14 @@ bool Kwave::FlacEncoder::encode(QWidget *widget,
     set_total_samples_estimate(static_cast<FLAC__uint64>(length));
     set_verify(false); // <- set to "true" for debugging
 
+#ifdef HAVE_FLAC_NUM_THREADS
+    // let libFLAC encode the frames in parallel
+    const unsigned int threads = qBound<unsigned int>(
+        1, Kwave::toUint(QThread::idealThreadCount()), MAX_ENCODER_THREADS);
+    if (set_num_threads(threads) != FLAC__STREAM_ENCODER_SET_NUM_THREADS_OK)
+        qWarning("FlacEncoder: using %u threads failed", threads);
+#endif
+
     // use mid-side stereo encoding if we have two channels
     set_do_mid_side_stereo(tracks == 2);
     set_loose_mid_side_stereo(tracks == 2);
@@ -246,12 +316,11 @@ bool Kwave::FlacEncoder::encode(QWidget *widget,
             flac_buffer.append(buffer);
         }
 
-        // allocate input buffer, with Kwave's sample_t
-        Kwave::SampleArray in_buffer(len);
-        Q_ASSERT(in_buffer.size() == len);
+        // allocate input buffers, with Kwave's sample_t
+        QVector<Kwave::SampleArray> in_buffers(tracks);
         Q_ASSERT(flac_buffer.size() == tracks);
 
-        if ((in_buffer.size() < len) || (flac_buffer.size() < tracks))
+        if (flac_buffer.size() < tracks)
         {
             Kwave::MessageBox::error(widget, i18n("Out of memory"));
             result = false;
@@ -270,42 +339,45 @@ bool Kwave::FlacEncoder::encode(QWidget *widget,
         while (rest && len && !src.isCanceled() && result) {
             // limit to rest of signal
             if (len > rest) len = Kwave::toUint(rest);
-            if (!in_buffer.resize(len)) {
-                Kwave::MessageBox::error(widget, i18n("Out of memory"));
-                result = false;
-                break;
-            }
 
-            // add all samples to one single buffer
-            for (int track = 0; track < tracks; track++) {
-                Kwave::SampleReader *reader = src[track];
-                Q_ASSERT(reader);
-                if (!reader) break;
-
-                (*reader) >> in_buffer;           // read samples into in_buffer
-                unsigned int l = in_buffer.size();// in_buffer might be empty!
-                if (l < len) {
-                    if (!in_buffer.resize(len)) {
-                        Kwave::MessageBox::error(widget, i18n("Out of memory"));
-                        result = false;
-                        break;
+            // read and convert the samples of all tracks in parallel
+            std::atomic<bool> failed(false);
+            Kwave::WorkerPool::instance().run(Kwave::toUint(tracks),
+                [&](unsigned int track) {
+                    Kwave::SampleReader *reader = src[track];
+                    FLAC__int32 *buf = flac_buffer.at(track);
+                    Kwave::SampleArray &in_buffer = in_buffers[track];
+                    Q_ASSERT(reader);
+                    Q_ASSERT(buf);
+                    if (!reader || !buf || !in_buffer.resize(len)) {
+                        failed = true;
+                        return;
+                    }
+
+                    (*reader) >> in_buffer;      // read samples into in_buffer
+                    unsigned int l = in_buffer.size(); // might be empty!
+                    if (l < len) {
+                        if (!in_buffer.resize(len)) {
+                            failed = true;
+                            return;
+                        }
+                        while (l < len) in_buffer[l++] = 0;
                     }
-                    while (l < len) in_buffer[l++] = 0;
-                }
 
-                FLAC__int32 *buf = flac_buffer.at(track);
-                Q_ASSERT(buf);
-                if (!buf) break;
-
-                const Kwave::SampleArray &in = in_buffer;
-                for (unsigned int in_pos = 0; in_pos < len; in_pos++) {
-                    FLAC__int32 s = in[in_pos];
-                    if (div) s /= div;
-                    if (s > clip_max) s = clip_max;
-                    if (s < clip_min) s = clip_min;
-                    *buf = s;
-                    buf++;
+                    const sample_t *in = in_buffer.constData();
+                    for (unsigned int in_pos = 0; in_pos < len; in_pos++) {
+                        FLAC__int32 s = in[in_pos];
+                        if (div) s /= div;
+                        if (s > clip_max) s = clip_max;
+                        if (s < clip_min) s = clip_min;
+                        *buf = s;
+                        buf++;
+                    }
                 }
+            );
+            if (failed) {
+                Kwave::MessageBox::error(widget, i18n("Out of memory"));
+                result = false;
             }
             if (!result) break; // error occurred?
 
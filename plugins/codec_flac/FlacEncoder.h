@@ -86,6 +86,25 @@ namespace Kwave
             const FLAC__byte buffer[], size_t bytes,
             unsigned samples, unsigned current_frame) override;
 
+        /**
+         * Callback for seeking in the output, needed for updating the
+         * stream info and the seek table when the encoder is finished
+         *
+         * @param absolute_byte_offset the position to seek to
+         * @return FLAC stream encoder seek status
+         */
+        virtual ::FLAC__StreamEncoderSeekStatus seek_callback(
+            FLAC__uint64 absolute_byte_offset) override;
+
+        /**
+         * Callback for getting the current position in the output
+         *
+         * @param absolute_byte_offset receives the current position
+         * @return FLAC stream encoder tell status
+         */
+        virtual ::FLAC__StreamEncoderTellStatus tell_callback(
+            FLAC__uint64 *absolute_byte_offset) override;
+
         /**
          * Callback for encoding meta data
          *
@@ -0,0 +1,174 @@
+/*************************************************************************
+ FlacSegmentDecoder.cpp  -  decodes one segment of a FLAC file
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include "libkwave/String.h"
+#include "libkwave/Utils.h"
+
+#include "FlacSegmentDecoder.h"
+
+//***************************************************************************
+Kwave::FlacSegmentDecoder::FlacSegmentDecoder(const QString &filename,
+                                              unsigned int bits)
+    :FLAC::Decoder::Stream(),
+     m_file(filename),
+     m_shift((bits < SAMPLE_BITS) ? (SAMPLE_BITS - bits) : 0),
+     m_dest(nullptr),
+     m_length(0),
+     m_filled(0)
+{
+}
+
+//***************************************************************************
+Kwave::FlacSegmentDecoder::~FlacSegmentDecoder()
+{
+}
+
+//***************************************************************************
+unsigned int Kwave::FlacSegmentDecoder::decode(
+    sample_index_t first, QVector<Kwave::SampleArray> &tracks)
+{
+    Q_ASSERT(!tracks.isEmpty());
+    if (tracks.isEmpty()) return 0;
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning("FlacSegmentDecoder: opening '%s' failed",
+                 DBG(m_file.fileName()));
+        return 0;
+    }
+
+    m_dest   = &tracks;
+    m_length = tracks[0].size();
+    m_filled = 0;
+
+    if (init() == FLAC__STREAM_DECODER_INIT_STATUS_OK) {
+        // the seek already delivers the frame with the first sample
+        bool ok = seek_absolute(first);
+        while (ok && (m_filled < m_length)) {
+            ok = process_single();
+            if (get_state() >= FLAC__STREAM_DECODER_END_OF_STREAM) break;
+        }
+        if (m_filled < m_length)
+            qWarning("FlacSegmentDecoder: segment at %llu ended after "
+                     "%u of %u samples (%s)", first, m_filled, m_length,
+                     get_state().as_cstring());
+        finish();
+    }
+
+    m_file.close();
+    m_dest = nullptr;
+    return m_filled;
+}
+
+//***************************************************************************
+::FLAC__StreamDecoderReadStatus Kwave::FlacSegmentDecoder::read_callback(
+        FLAC__byte buffer[], size_t *bytes)
+{
+    Q_ASSERT(bytes);
+    if (!bytes) return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+
+    const qint64 read = m_file.read(reinterpret_cast<char *>(buffer),
+                                    static_cast<qint64>(*bytes));
+    if (read < 0) return FLAC__STREAM_DECODER_READ_STATUS_ABORT;
+
+    *bytes = static_cast<size_t>(read);
+    return (read) ? FLAC__STREAM_DECODER_READ_STATUS_CONTINUE :
+                    FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+}
+
+//***************************************************************************
+::FLAC__StreamDecoderSeekStatus Kwave::FlacSegmentDecoder::seek_callback(
+        FLAC__uint64 absolute_byte_offset)
+{
+    return m_file.seek(static_cast<qint64>(absolute_byte_offset)) ?
+        FLAC__STREAM_DECODER_SEEK_STATUS_OK :
+        FLAC__STREAM_DECODER_SEEK_STATUS_ERROR;
+}
+
+//***************************************************************************
+::FLAC__StreamDecoderTellStatus Kwave::FlacSegmentDecoder::tell_callback(
+        FLAC__uint64 *absolute_byte_offset)
+{
+    Q_ASSERT(absolute_byte_offset);
+    if (!absolute_byte_offset)
+        return FLAC__STREAM_DECODER_TELL_STATUS_ERROR;
+
+    *absolute_byte_offset = static_cast<FLAC__uint64>(m_file.pos());
+    return FLAC__STREAM_DECODER_TELL_STATUS_OK;
+}
+
+//***************************************************************************
+::FLAC__StreamDecoderLengthStatus Kwave::FlacSegmentDecoder::length_callback(
+        FLAC__uint64 *stream_length)
+{
+    Q_ASSERT(stream_length);
+    if (!stream_length) return FLAC__STREAM_DECODER_LENGTH_STATUS_ERROR;
+
+    *stream_length = static_cast<FLAC__uint64>(m_file.size());
+    return FLAC__STREAM_DECODER_LENGTH_STATUS_OK;
+}
+
+//***************************************************************************
+bool Kwave::FlacSegmentDecoder::eof_callback()
+{
+    return m_file.atEnd();
+}
+
+//***************************************************************************
+::FLAC__StreamDecoderWriteStatus Kwave::FlacSegmentDecoder::write_callback(
+        const ::FLAC__Frame *frame,
+        const FLAC__int32 * const buffer[])
+{
+    Q_ASSERT(buffer);
+    Q_ASSERT(frame);
+    Q_ASSERT(m_dest);
+    if (!buffer || !frame || !m_dest)
+        return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+
+    // the last frame of the segment may reach into the next one
+    const unsigned int count = qMin<unsigned int>(
+        frame->header.blocksize, m_length - m_filled);
+    const unsigned int tracks = qMin<unsigned int>(
+        frame->header.channels, Kwave::toUint(m_dest->size()));
+    const unsigned int mul = (1 << m_shift);
+
+    for (unsigned int track = 0; track < tracks; ++track) {
+        const FLAC__int32 *src = buffer[track];
+        sample_t *dst = (*m_dest)[track].data() + m_filled;
+        if (m_shift) {
+            for (unsigned int sample = 0; sample < count; ++sample)
+                *(dst++) = static_cast<sample_t>(*(src++)) * mul;
+        } else {
+            for (unsigned int sample = 0; sample < count; ++sample)
+                *(dst++) = static_cast<sample_t>(*(src++));
+        }
+    }
+
+    m_filled += count;
+    return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+}
+
+//***************************************************************************
+void Kwave::FlacSegmentDecoder::error_callback(
+    ::FLAC__StreamDecoderErrorStatus status)
+{
+    qDebug("FlacSegmentDecoder::error_callback: status=%d", status);
+}
+
+//***************************************************************************
+//***************************************************************************
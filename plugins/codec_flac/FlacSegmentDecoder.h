@@ -0,0 +1,138 @@
+/*************************************************************************
+   FlacSegmentDecoder.h  -  decodes one segment of a FLAC file
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FLAC_SEGMENT_DECODER_H
+#define FLAC_SEGMENT_DECODER_H
+
+#include "config.h"
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+#include <FLAC++/decoder.h>
+#include <FLAC/format.h>
+
+#include "libkwave/Sample.h"
+#include "libkwave/SampleArray.h"
+
+namespace Kwave
+{
+    /**
+     * Decodes a range of samples out of a FLAC file, with a libFLAC
+     * decoder instance and a file handle of its own. Several of them can
+     * work on the same file in parallel, each one seeks to the start of
+     * its range, using the seek table of the file if there is one.
+     */
+    class FlacSegmentDecoder: protected FLAC::Decoder::Stream
+    {
+    public:
+        /**
+         * Constructor
+         * @param filename name of the FLAC file
+         * @param bits number of bits per sample of the stream
+         */
+        FlacSegmentDecoder(const QString &filename, unsigned int bits);
+
+        /** Destructor */
+        ~FlacSegmentDecoder() override;
+
+        /**
+         * Decodes a range of samples
+         * @param first index of the first sample
+         * @param tracks one array per track that receives the samples,
+         *               the size of the arrays determines the length of
+         *               the range
+         * @return number of decoded samples per track, less than the
+         *         length of the range if the stream ended early or
+         *         decoding failed
+         */
+        unsigned int decode(sample_index_t first,
+                            QVector<Kwave::SampleArray> &tracks);
+
+    protected:
+
+        /** @see Kwave::FlacDecoder::read_callback */
+        virtual ::FLAC__StreamDecoderReadStatus read_callback(
+            FLAC__byte buffer[], size_t *bytes) override;
+
+        /**
+         * FLAC decoder interface: seek callback.
+         *
+         * @param absolute_byte_offset the position to seek to
+         * @return seek state
+         */
+        virtual ::FLAC__StreamDecoderSeekStatus seek_callback(
+            FLAC__uint64 absolute_byte_offset) override;
+
+        /**
+         * FLAC decoder interface: tell callback.
+         *
+         * @param absolute_byte_offset receives the current position
+         * @return tell state
+         */
+        virtual ::FLAC__StreamDecoderTellStatus tell_callback(
+            FLAC__uint64 *absolute_byte_offset) override;
+
+        /**
+         * FLAC decoder interface: length callback.
+         *
+         * @param stream_length receives the length of the file in bytes
+         * @return length state
+         */
+        virtual ::FLAC__StreamDecoderLengthStatus length_callback(
+            FLAC__uint64 *stream_length) override;
+
+        /**
+         * FLAC decoder interface: eof callback.
+         *
+         * @return true if the end of the file has been reached
+         */
+        virtual bool eof_callback() override;
+
+        /** @see Kwave::FlacDecoder::write_callback */
+        virtual ::FLAC__StreamDecoderWriteStatus write_callback(
+            const ::FLAC__Frame *frame,
+            const FLAC__int32 *const buffer[]) override;
+
+        /** @see Kwave::FlacDecoder::error_callback */
+        virtual void error_callback(::FLAC__StreamDecoderErrorStatus status)
+            override;
+
+    private:
+
+        /** the FLAC file */
+        QFile m_file;
+
+        /** number of bits the samples have to be shifted up */
+        unsigned int m_shift;
+
+        /** destination of the audio data, one array per track */
+        QVector<Kwave::SampleArray> *m_dest;
+
+        /** number of samples per track that are wanted */
+        unsigned int m_length;
+
+        /** number of samples per track that have been decoded */
+        unsigned int m_filled;
+    };
+}
+
+#endif /* FLAC_SEGMENT_DECODER_H */
+
+//***************************************************************************
+//***************************************************************************
@@ -18,19 +18,26 @@
 #include "config.h"
 
 #include <math.h>
+#include <atomic>
 #include <new>
 
 #include <id3/globals.h>
 #include <id3/misc_support.h>
 #include <id3/tag.h>
 
+#ifdef HAVE_LIBMP3LAME
+#include <lame/lame.h>
+#endif
+
 #include <QBuffer>
 #include <QByteArray>
 #include <QDate>
 #include <QDateTime>
+#include <QFileInfo>
 #include <QLatin1Char>
 #include <QList>
 #include <QMap>
+#include <QVector>
 
 #include <KLocalizedString>
 
@@ -44,6 +51,7 @@
 #include "libkwave/SampleReader.h"
 #include "libkwave/String.h"
 #include "libkwave/Utils.h"
+#include "libkwave/WorkerPool.h"
 
 #include "ID3_QIODeviceReader.h"
 #include "ID3_QIODeviceWriter.h"
@@ -366,6 +374,21 @@ bool Kwave::MP3Encoder::encode(QWidget *widget, Kwave::MultiTrackReader &src,
     ID3_QIODeviceWriter id3_writer(dst);
     encodeID3Tags(meta_data, id3_tag);
 
+#ifdef HAVE_LIBMP3LAME
+    // if LAME is the selected encoder, use the library instead
+    if (QFileInfo(settings.m_path).baseName() == _("lame")) {
+        if (id3_tag_type == ID3TT_ID3V2)
+            id3_tag.Render(id3_writer, id3_tag_type);
+
+        result = encodeWithLame(widget, src, dst, info, settings);
+
+        QMutexLocker _lock(&m_lock);
+        m_dst = nullptr;
+        dst.close();
+        return result;
+    }
+#endif
+
     OPTION(m_flags.m_prepend);          // optional parameters at the very start
 
     // mandantory audio input format and encoding options
@@ -620,6 +643,217 @@ bool Kwave::MP3Encoder::encode(QWidget *widget, Kwave::MultiTrackReader &src,
     return result;
 }
 
+#ifdef HAVE_LIBMP3LAME
+/***************************************************************************/
+/**
+ * Finds the numeric argument of a command line option within a string
+ * with command line parameters
+ * @param params the command line parameters, like "-q 2"
+ * @param option the option, like "-q"
+ * @return the value of the option, or -1 if not found
+ */
+static int optionValue(const QString &params, const QString &option)
+{
+    const QStringList list = params.split(QLatin1Char(' '),
+                                          Qt::SkipEmptyParts);
+    const qsizetype index = list.indexOf(option);
+    if ((index < 0) || (index + 1 >= list.count())) return -1;
+
+    bool ok = false;
+    const int value = list.at(index + 1).toInt(&ok);
+    return (ok) ? value : -1;
+}
+
+/***************************************************************************/
+bool Kwave::MP3Encoder::encodeWithLame(
+    QWidget *widget, Kwave::MultiTrackReader &src, QIODevice &dst,
+    const Kwave::FileInfo &info, const Kwave::MP3EncoderSettings &settings)
+{
+    const unsigned int   tracks     = src.tracks();
+    const sample_index_t length     = src.last() - src.first() + 1;
+    const unsigned int   out_tracks = qMin(tracks, 2U);
+    bool result = true;
+
+    lame_global_flags *lame = lame_init();
+    Q_ASSERT(lame);
+    if (!lame) {
+        Kwave::MessageBox::error(widget, i18n("Out of memory"));
+        return false;
+    }
+
+    // the same options as passed to the external program
+    lame_set_in_samplerate(lame, static_cast<int>(info.rate()));
+    lame_set_num_channels(lame, static_cast<int>(out_tracks));
+    lame_set_mode(lame, (out_tracks == 1) ? MONO : JOINT_STEREO);
+    lame_set_num_samples(lame, static_cast<unsigned long>(length));
+    lame_set_write_id3tag_automatic(lame, 0);
+
+    int bitrate_min =   8;
+    int bitrate_max = 320;
+    int bitrate_nom = 128;
+    if (info.contains(Kwave::INF_BITRATE_NOMINAL)) {
+        // nominal bitrate => use ABR mode
+        bitrate_nom = info.get(Kwave::INF_BITRATE_NOMINAL).toInt() / 1000;
+        bitrate_nom = qBound(bitrate_min, bitrate_nom, bitrate_max);
+        lame_set_VBR(lame, vbr_abr);
+        lame_set_VBR_mean_bitrate_kbps(lame, bitrate_nom);
+    }
+    if (info.contains(Kwave::INF_BITRATE_LOWER)) {
+        int bitrate = info.get(Kwave::INF_BITRATE_LOWER).toInt() / 1000;
+        bitrate_min = qBound(bitrate_min, bitrate, bitrate_nom);
+        lame_set_brate(lame, bitrate_min);
+        lame_set_VBR_min_bitrate_kbps(lame, bitrate_min);
+    }
+    if (info.contains(Kwave::INF_BITRATE_UPPER)) {
+        int bitrate = info.get(Kwave::INF_BITRATE_UPPER).toInt() / 1000;
+        bitrate_max = qBound(bitrate_nom, bitrate, bitrate_max);
+        lame_set_VBR_max_bitrate_kbps(lame, bitrate_max);
+    }
+
+    if (info.contains(Kwave::INF_MPEG_EMPHASIS)) {
+        const int emphasis = info.get(Kwave::INF_MPEG_EMPHASIS).toInt();
+        lame_set_emphasis(lame, ((emphasis == 1) || (emphasis == 3)) ?
+            emphasis : 0);
+    }
+
+    const int quality = optionValue(settings.m_encoding.m_noise_shaping,
+                                    _("-q"));
+    if (quality >= 0) lame_set_quality(lame, quality);
+    if (settings.m_encoding.m_compatibility.length())
+        lame_set_strict_ISO(lame, 1);
+
+    if (settings.m_flags.m_copyright.length() &&
+        info.contains(Kwave::INF_COPYRIGHTED) &&
+        info.get(Kwave::INF_COPYRIGHTED).toBool())
+        lame_set_copyright(lame, 1);
+    if (settings.m_flags.m_original.length() &&
+        info.contains(Kwave::INF_ORIGINAL) &&
+        !info.get(Kwave::INF_ORIGINAL).toBool())
+        lame_set_original(lame, 0);
+    if (settings.m_flags.m_protect.length())
+        lame_set_error_protection(lame, 1);
+
+    if (lame_init_params(lame) < 0) {
+        lame_close(lame);
+        Kwave::MessageBox::error(widget,
+            i18n("Unable to open the MP3 encoder."));
+        return false;
+    }
+
+    // the first frame is reserved for the LAME/Xing info tag
+    const qint64 tag_offset = dst.pos();
+
+    // worst case size of the output: 1.25 * samples + 7200 bytes
+    const unsigned int block = src.blockSize();
+    QVector<Kwave::SampleArray> in_samples(tracks);
+    QVector<int> out_samples[2];
+    for (unsigned int y = 0; y < out_tracks; ++y)
+        out_samples[y].resize(block);
+    QByteArray mp3_buffer(block + (block / 4) + 7200, '\0');
+    unsigned char *mp3 = reinterpret_cast<unsigned char *>(mp3_buffer.data());
+    const int mp3_size = Kwave::toInt(mp3_buffer.size());
+
+    // MP3 supports only mono and stereo, prepare a mixer matrix
+    // (not used in case of tracks <= 2)
+    Kwave::MixerMatrix mixer(tracks, out_tracks);
+
+    sample_index_t rest = length;
+    while (result && rest && !src.isCanceled()) {
+        const unsigned int count = Kwave::toUint(
+            qMin<sample_index_t>(rest, block));
+
+        // read all tracks in parallel
+        std::atomic<bool> failed(false);
+        Kwave::WorkerPool::instance().run(tracks, [&](unsigned int track) {
+            Kwave::SampleArray &samples = in_samples[track];
+            Kwave::SampleReader *stream = src[track];
+            Q_ASSERT(stream);
+            if (!samples.resize(count)) {
+                failed = true;
+                return;
+            }
+            if (stream) (*stream) >> samples;
+
+            // the reader might deliver less than requested
+            unsigned int l = samples.size();
+            if (l < count) {
+                if (!samples.resize(count)) {
+                    failed = true;
+                    return;
+                }
+                while (l < count) samples[l++] = 0;
+            }
+        });
+        if (failed) {
+            Kwave::MessageBox::error(widget, i18n("Out of memory"));
+            result = false;
+            break;
+        }
+
+        // mix down and scale up to the full range of int
+        for (unsigned int y = 0; y < out_tracks; ++y) {
+            int *out = out_samples[y].data();
+            if (tracks > 2) {
+                for (unsigned int i = 0; i < count; ++i) {
+                    double sum = 0;
+                    for (unsigned int x = 0; x < tracks; ++x)
+                        sum += static_cast<double>(
+                            in_samples[x].constData()[i]) * mixer[x][y];
+                    out[i] = static_cast<int>(sum) * (1 << 8);
+                }
+            } else {
+                const sample_t *in = in_samples[y].constData();
+                for (unsigned int i = 0; i < count; ++i)
+                    out[i] = static_cast<int>(in[i]) * (1 << 8);
+            }
+        }
+
+        const int bytes = lame_encode_buffer_int(lame,
+            out_samples[0].constData(),
+            out_samples[(out_tracks > 1) ? 1 : 0].constData(),
+            static_cast<int>(count), mp3, mp3_size);
+        if ((bytes < 0) || (dst.write(mp3_buffer.constData(), bytes) != bytes))
+        {
+            qWarning("MP3Encoder: encoding failed (%d)", bytes);
+            result = false;
+            break;
+        }
+
+        Q_ASSERT(rest >= count);
+        rest -= count;
+    }
+
+    // flush the frames that are still buffered in the encoder
+    if (result) {
+        const int bytes = lame_encode_flush(lame, mp3, mp3_size);
+        if ((bytes < 0) || (dst.write(mp3_buffer.constData(), bytes) != bytes))
+            result = false;
+    }
+
+    // with a seekable output, fill in the LAME/Xing tag for gapless playback
+    if (result && !dst.isSequential()) {
+        const size_t tag_size = lame_get_lametag_frame(lame, mp3,
+            static_cast<size_t>(mp3_size));
+        if (tag_size && (tag_size <= static_cast<size_t>(mp3_size))) {
+            const qint64 end = dst.pos();
+            result = dst.seek(tag_offset) &&
+                (dst.write(mp3_buffer.constData(),
+                           static_cast<qint64>(tag_size)) ==
+                 static_cast<qint64>(tag_size)) &&
+                dst.seek(end);
+        }
+    }
+
+    lame_close(lame);
+
+    if (!result && !src.isCanceled())
+        Kwave::MessageBox::error(widget,
+            i18n("An error occurred while encoding the MP3 data."));
+
+    return result;
+}
+#endif
+
 /***************************************************************************/
 void Kwave::MP3Encoder::dataAvailable()
 {
@@ -37,7 +37,9 @@ class QWidget;
 namespace Kwave
 {
 
+    class FileInfo;
     class MultiTrackReader;
+    struct MP3EncoderSettings;
 
     class MP3Encoder: public Kwave::Encoder
     {
@@ -85,6 +87,22 @@ namespace Kwave
         void encodeID3Tags(const Kwave::MetaDataList &meta_data,
                            ID3_Tag &tag);
 
+#ifdef HAVE_LIBMP3LAME
+        /**
+         * Encodes the audio data in-process with libmp3lame, using the
+         * same options as the external "lame" program would get
+         * @param widget a widget for displaying message boxes
+         * @param src MultiTrackReader used as source of the audio data
+         * @param dst file or other device that receives the MP3 frames
+         * @param info file info of the signal
+         * @param settings the encoder settings
+         * @return true if succeeded, false on errors
+         */
+        bool encodeWithLame(QWidget *widget, Kwave::MultiTrackReader &src,
+                            QIODevice &dst, const Kwave::FileInfo &info,
+                            const Kwave::MP3EncoderSettings &settings);
+#endif
+
     private:
 
         /** property - to - ID3 mapping */
@@ -0,0 +1,403 @@
+/***************************************************************************
+      WavDataReader.cpp  -  native reader for uncompressed WAV sample data
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <string.h>
+
+#include <QFileDevice>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QVector>
+#include <QtEndian>
+
+#include "libkwave/MultiWriter.h"
+#include "libkwave/SampleArray.h"
+#include "libkwave/SampleKernels.h"
+#include "libkwave/String.h"
+#include "libkwave/Utils.h"
+#include "libkwave/WorkerPool.h"
+#include "libkwave/Writer.h"
+
+#include "WavDataReader.h"
+#include "WavFileFormat.h"
+
+/** number of frames that are converted at once */
+#define BLOCK_FRAMES (256U * 1024U)
+
+/** maximum length of a fmt chunk that is evaluated */
+#define MAX_FMT_LENGTH 512
+
+/** GUID of the "riff" chunk of a Wave64 file */
+static const char W64_GUID_RIFF[16] = {
+    'r', 'i', 'f', 'f', '\x2E', '\x91', '\xCF', '\x11',
+    '\xA5', '\xD6', '\x28', '\xDB', '\x04', '\xC1', '\x00', '\x00'
+};
+
+/**
+ * Common last 12 bytes of the GUIDs of the "wave", "fmt " and "data"
+ * chunks of a Wave64 file, the first four bytes are the chunk name
+ */
+static const char W64_GUID_SUFFIX[12] = {
+    '\xF3', '\xAC', '\xD3', '\x11', '\x8C', '\xD1', '\x00', '\xC0',
+    '\x4F', '\x8E', '\xDB', '\x8A'
+};
+
+//***************************************************************************
+/**
+ * Checks whether a Wave64 GUID belongs to a chunk with a given name
+ * @param guid pointer to 16 bytes with the GUID
+ * @param name the name, 4 characters
+ * @return true if matches
+ */
+static bool isW64Guid(const char *guid, const char *name)
+{
+    return (!memcmp(guid, name, 4) &&
+            !memcmp(guid + 4, W64_GUID_SUFFIX, sizeof(W64_GUID_SUFFIX)));
+}
+
+//***************************************************************************
+/**
+ * Converts a floating point value into a sample, with clipping
+ * @param value a value in the range [-1.0 ... +1.0]
+ * @return a sample
+ */
+static inline sample_t clippedSample(double value)
+{
+    return qBound<sample_t>(SAMPLE_MIN,
+        double2sample(qBound<double>(-1.0, value, 1.0)), SAMPLE_MAX);
+}
+
+//***************************************************************************
+Kwave::WavDataReader::WavDataReader()
+    :m_source(nullptr), m_container(None), m_format_tag(0), m_tracks(0),
+     m_rate(0), m_bits(0), m_sample_bytes(0), m_frame_bytes(0),
+     m_data_start(0), m_data_length(0)
+{
+}
+
+//***************************************************************************
+Kwave::WavDataReader::~WavDataReader()
+{
+}
+
+//***************************************************************************
+void Kwave::WavDataReader::close()
+{
+    m_source       = nullptr;
+    m_container    = None;
+    m_format_tag   = 0;
+    m_tracks       = 0;
+    m_rate         = 0;
+    m_bits         = 0;
+    m_sample_bytes = 0;
+    m_frame_bytes  = 0;
+    m_data_start   = 0;
+    m_data_length  = 0;
+}
+
+//***************************************************************************
+bool Kwave::WavDataReader::open(QIODevice &source)
+{
+    close();
+
+    const quint64 size = static_cast<quint64>(source.size());
+    if (!source.seek(0)) return false;
+    const QByteArray head = source.read(40);
+    if (head.size() < 12) return false;
+
+    bool found_fmt  = false;
+    bool found_data = false;
+
+    if ((head.startsWith("RIFF") || head.startsWith("RF64")) &&
+        (head.mid(8, 4) == "WAVE"))
+    {
+        // RIFF and RF64: 4 byte name + 4 byte length, padded to 16 bit
+        m_container = head.startsWith("RF64") ? Rf64 : Riff;
+        quint64 ds64_data_length = 0;
+        quint64 pos = 12;
+        while ((pos + 8 <= size) && !(found_fmt && found_data)) {
+            source.seek(static_cast<qint64>(pos));
+            const QByteArray header = source.read(8);
+            if (header.size() < 8) break;
+            const QByteArray name = header.left(4);
+            quint64 length = qFromLittleEndian<quint32>(header.constData() + 4);
+
+            if (name == "ds64") {
+                // RF64: 64 bit sizes of the RIFF and the data chunk
+                const QByteArray ds64 = source.read(24);
+                if (ds64.size() < 24) break;
+                ds64_data_length =
+                    qFromLittleEndian<quint64>(ds64.constData() + 8);
+            } else if (name == "fmt ") {
+                found_fmt = parseFormat(source.read(
+                    static_cast<qint64>(qMin<quint64>(length, MAX_FMT_LENGTH))
+                ));
+            } else if (name == "data") {
+                if ((m_container == Rf64) && (length == 0xFFFFFFFFU))
+                    length = ds64_data_length;
+                m_data_start  = pos + 8;
+                m_data_length = length;
+                found_data    = true;
+            }
+            pos += 8 + length + (length & 1);
+        }
+    } else if ((head.size() >= 40) &&
+               !memcmp(head.constData(), W64_GUID_RIFF, 16) &&
+               isW64Guid(head.constData() + 24, "wave"))
+    {
+        // Wave64: 16 byte GUID + 8 byte length including the header,
+        // padded to 64 bit
+        m_container = Wave64;
+        quint64 pos = 40;
+        while ((pos + 24 <= size) && !(found_fmt && found_data)) {
+            source.seek(static_cast<qint64>(pos));
+            const QByteArray header = source.read(24);
+            if (header.size() < 24) break;
+            const quint64 length =
+                qFromLittleEndian<quint64>(header.constData() + 16);
+            if (length < 24) break;
+
+            if (isW64Guid(header.constData(), "fmt ")) {
+                found_fmt = parseFormat(source.read(static_cast<qint64>(
+                    qMin<quint64>(length - 24, MAX_FMT_LENGTH))));
+            } else if (isW64Guid(header.constData(), "data")) {
+                m_data_start  = pos + 24;
+                m_data_length = length - 24;
+                found_data    = true;
+            }
+            pos += (length + 7) & ~static_cast<quint64>(7);
+        }
+    }
+
+    if (!found_fmt || !found_data) {
+        close();
+        return false;
+    }
+
+    // a truncated file contains less than announced
+    const quint64 available = (m_data_start < size) ?
+        (size - m_data_start) : 0;
+    if (m_data_length > available) {
+        qWarning("WavDataReader: data chunk truncated, %llu of %llu bytes",
+                 available, m_data_length);
+        m_data_length = available;
+    }
+
+    m_source = &source;
+    return true;
+}
+
+//***************************************************************************
+bool Kwave::WavDataReader::parseFormat(const QByteArray &fmt)
+{
+    if (fmt.size() < 16) return false;
+    const char *p = fmt.constData();
+
+    m_format_tag      = qFromLittleEndian<quint16>(p);
+    m_tracks          = qFromLittleEndian<quint16>(p + 2);
+    m_rate            = qFromLittleEndian<quint32>(p + 4);
+    m_frame_bytes     = qFromLittleEndian<quint16>(p + 12);
+    m_bits            = qFromLittleEndian<quint16>(p + 14);
+    m_sample_bytes    = (m_tracks) ? (m_frame_bytes / m_tracks) : 0;
+
+    if ((m_format_tag == Kwave::WAVE_FORMAT_EXTENSIBLE) &&
+        (fmt.size() >= 40))
+    {
+        // the real format is in the first two bytes of the sub format
+        const unsigned int valid_bits = qFromLittleEndian<quint16>(p + 18);
+        if (valid_bits && (valid_bits < m_bits)) m_bits = valid_bits;
+        m_format_tag = qFromLittleEndian<quint16>(p + 24);
+    }
+
+    return (m_tracks != 0);
+}
+
+//***************************************************************************
+bool Kwave::WavDataReader::isSupported() const
+{
+    if (!m_tracks || !m_rate || !m_sample_bytes) return false;
+    if (m_frame_bytes != m_sample_bytes * m_tracks) return false;
+    if (!m_bits || (m_bits > 8 * m_sample_bytes)) return false;
+
+    switch (m_format_tag) {
+        case Kwave::WAVE_FORMAT_PCM:
+            return (m_sample_bytes <= 4);
+        case Kwave::WAVE_FORMAT_IEEE_FLOAT:
+            return ((m_sample_bytes == 4) || (m_sample_bytes == 8));
+        default:
+            return false;
+    }
+}
+
+//***************************************************************************
+Kwave::SampleFormat::Format Kwave::WavDataReader::sampleFormat() const
+{
+    if (m_format_tag == Kwave::WAVE_FORMAT_IEEE_FLOAT)
+        return (m_sample_bytes == 8) ? Kwave::SampleFormat::Double :
+                                       Kwave::SampleFormat::Float;
+
+    // 8 bit WAV is unsigned, everything above is signed
+    return (m_sample_bytes == 1) ? Kwave::SampleFormat::Unsigned :
+                                   Kwave::SampleFormat::Signed;
+}
+
+//***************************************************************************
+sample_index_t Kwave::WavDataReader::length() const
+{
+    return (m_frame_bytes) ? (m_data_length / m_frame_bytes) : 0;
+}
+
+//***************************************************************************
+void Kwave::WavDataReader::convert(const quint8 *raw, unsigned int frames,
+                                   sample_t *dst)
+{
+    const unsigned int count = frames * m_tracks;
+
+    if (m_format_tag == Kwave::WAVE_FORMAT_IEEE_FLOAT) {
+        if (m_sample_bytes == 8) {
+            for (unsigned int i = 0; i < count; ++i, raw += 8)
+                dst[i] = clippedSample(qFromLittleEndian<double>(raw));
+        } else {
+            for (unsigned int i = 0; i < count; ++i, raw += 4)
+                dst[i] = clippedSample(qFromLittleEndian<float>(raw));
+        }
+        return;
+    }
+
+    if (m_sample_bytes == 1) {
+        // unsigned 8 bit, scaled up with a multiplication as a left
+        // shift of a negative value is undefined
+        for (unsigned int i = 0; i < count; ++i)
+            dst[i] = (static_cast<sample_t>(raw[i]) - 128) *
+                (1 << (SAMPLE_BITS - 8));
+        return;
+    }
+
+    // signed little endian, 16, 24 or 32 bit
+    Kwave::SampleKernels::decoder_t decoder =
+        Kwave::SampleKernels::linearDecoder(8 * m_sample_bytes, true, true);
+    Q_ASSERT(decoder);
+    if (decoder) decoder(raw, dst, count);
+}
+
+//***************************************************************************
+bool Kwave::WavDataReader::decode(Kwave::MultiWriter &dst)
+{
+    const unsigned int tracks = m_tracks;
+    if (!m_source || !isSupported()) return false;
+    if (dst.tracks() != tracks) return false;
+
+    // map the data chunk if the source is a regular file, otherwise
+    // read blocks. Accessing a mapping beyond the end of a file raises
+    // SIGBUS, so check the size again once it is mapped, in case the
+    // file has been truncated in the meantime.
+    const qint64 end = static_cast<qint64>(m_data_start + m_data_length);
+    QFileDevice *file = qobject_cast<QFileDevice *>(m_source);
+    if (file && !QFileInfo(file->fileName()).isFile()) file = nullptr;
+    uchar *map = (file) ? file->map(static_cast<qint64>(m_data_start),
+                                    static_cast<qint64>(m_data_length)) :
+                          nullptr;
+    if (map && (QFileInfo(file->fileName()).size() < end)) {
+        qWarning("WavDataReader: '%s' has been truncated",
+                 DBG(file->fileName()));
+        file->unmap(map);
+        map = nullptr;
+    }
+    QByteArray buffer;
+    if (!map) {
+        buffer.resize(BLOCK_FRAMES * m_frame_bytes);
+        if (!m_source->seek(static_cast<qint64>(m_data_start)))
+            return false;
+    }
+
+    QVector<sample_t> interleaved(BLOCK_FRAMES * tracks);
+    QVector<Kwave::SampleArray> samples(tracks);
+    Kwave::SampleArray *blocks = samples.data();
+    Kwave::WorkerPool &pool = Kwave::WorkerPool::instance();
+
+    const sample_index_t length = this->length();
+    sample_index_t pos = 0;
+    while (pos < length) {
+        unsigned int frames = Kwave::toUint(
+            qMin<sample_index_t>(length - pos, BLOCK_FRAMES));
+
+        const quint8 *raw = nullptr;
+        if (map) {
+            raw = map + (pos * m_frame_bytes);
+        } else {
+            const qint64 bytes = m_source->read(buffer.data(),
+                frames * m_frame_bytes);
+            frames = (bytes > 0) ?
+                Kwave::toUint(bytes / m_frame_bytes) : 0;
+            if (!frames) break;
+            raw = reinterpret_cast<const quint8 *>(buffer.constData());
+        }
+
+        if (tracks == 1) {
+            // mono: convert directly into the block of the track
+            Kwave::SampleArray &block = blocks[0];
+            if (block.size() != frames) block.resize(frames);
+            convert(raw, frames, block.data());
+            *(dst[0]) << block;
+        } else {
+            // convert slices of the interleaved data in parallel
+            sample_t *all = interleaved.data();
+            const unsigned int frame_bytes = m_frame_bytes;
+            pool.run(tracks, [this, raw, all, frames, tracks, frame_bytes](
+                unsigned int slice)
+            {
+                const unsigned int first = (frames * slice) / tracks;
+                const unsigned int next  = (frames * (slice + 1)) / tracks;
+                convert(raw + (first * frame_bytes), next - first,
+                        all + (first * tracks));
+            });
+
+            // split into the tracks, each one in parallel
+            pool.run(tracks, [blocks, all, frames, tracks, &dst](
+                unsigned int track)
+            {
+                Kwave::SampleArray &block = blocks[track];
+                if (block.size() != frames) block.resize(frames);
+                sample_t *out = block.data();
+                const sample_t *in = all + track;
+                for (unsigned int i = 0; i < frames; ++i, in += tracks)
+                    out[i] = *in;
+                *(dst[track]) << block;
+            });
+        }
+
+        pos += frames;
+
+        // abort if the user pressed cancel
+        if (dst.isCanceled()) break;
+    }
+
+    if (map) file->unmap(map);
+
+    // a short read leaves the rest of the signal empty
+    if ((pos < length) && !dst.isCanceled()) {
+        qWarning("WavDataReader: read only %llu of %llu samples",
+                 pos, length);
+        return false;
+    }
+
+    return true;
+}
+
+//***************************************************************************
+//***************************************************************************
@@ -0,0 +1,162 @@
+/***************************************************************************
+        WavDataReader.h  -  native reader for uncompressed WAV sample data
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef WAV_DATA_READER_H
+#define WAV_DATA_READER_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QByteArray>
+
+#include "libkwave/Sample.h"
+#include "libkwave/SampleFormat.h"
+
+class QIODevice;
+
+namespace Kwave
+{
+
+    class MultiWriter;
+
+    /**
+     * Reads the sample data of uncompressed PCM and IEEE float files in
+     * RIFF/WAVE, RF64 or Sony Wave64 containers, without libaudiofile.
+     * The container is scanned with 64 bit offsets, so that files larger
+     * than 4GB can be handled, which is beyond the RIFF parser. The data
+     * chunk is memory mapped if the source is a file, converted with the
+     * optimized kernels of Kwave::SampleKernels and split into the tracks
+     * in parallel.
+     */
+    class WavDataReader
+    {
+    public:
+
+        /** type of the container */
+        typedef enum {
+            None,   /**< no supported container */
+            Riff,   /**< RIFF/WAVE with 32 bit sizes */
+            Rf64,   /**< RF64/WAVE (EBU Tech 3306) with a ds64 chunk */
+            Wave64  /**< Sony Wave64 with GUIDs and 64 bit sizes */
+        } Container;
+
+        /** Constructor */
+        WavDataReader();
+
+        /** Destructor */
+        virtual ~WavDataReader();
+
+        /**
+         * Scans the container for the format and the data chunk
+         * @param source an opened source with random access
+         * @return true if a container with a fmt and a data chunk
+         *         has been found, even if the format is not supported
+         */
+        bool open(QIODevice &source);
+
+        /** resets to initial state */
+        void close();
+
+        /** returns the type of the container */
+        inline Container container() const { return m_container; }
+
+        /** returns true if the sample format can be read natively */
+        bool isSupported() const;
+
+        /** returns the format tag, with the sub format of extensible ones */
+        inline quint16 formatTag() const { return m_format_tag; }
+
+        /** returns the number of tracks */
+        inline unsigned int tracks() const { return m_tracks; }
+
+        /** returns the sample rate */
+        inline unsigned int rate() const { return m_rate; }
+
+        /** returns the number of valid bits per sample */
+        inline unsigned int bits() const { return m_bits; }
+
+        /** returns the sample format */
+        Kwave::SampleFormat::Format sampleFormat() const;
+
+        /** returns the number of samples per track */
+        sample_index_t length() const;
+
+        /** returns the offset of the data chunk's content */
+        inline quint64 dataStart() const { return m_data_start; }
+
+        /**
+         * Decodes the whole data chunk into a MultiWriter
+         * @param dst MultiWriter that receives the audio data
+         * @return true if succeeded, false on errors
+         */
+        bool decode(Kwave::MultiWriter &dst);
+
+    private:
+
+        /**
+         * Parses the content of a fmt chunk
+         * @param fmt the content of the chunk
+         * @return true if valid
+         */
+        bool parseFormat(const QByteArray &fmt);
+
+        /**
+         * Converts interleaved raw samples into samples of all tracks
+         * @param raw pointer to the raw data
+         * @param frames number of frames (samples per track)
+         * @param dst array that receives the interleaved samples
+         */
+        void convert(const quint8 *raw, unsigned int frames, sample_t *dst);
+
+    private:
+
+        /** the source, valid after open() */
+        QIODevice *m_source;
+
+        /** type of the container */
+        Container m_container;
+
+        /** format tag */
+        quint16 m_format_tag;
+
+        /** number of tracks */
+        unsigned int m_tracks;
+
+        /** sample rate */
+        unsigned int m_rate;
+
+        /** valid bits per sample */
+        unsigned int m_bits;
+
+        /** bytes per sample of one track */
+        unsigned int m_sample_bytes;
+
+        /** bytes per frame (block align) */
+        unsigned int m_frame_bytes;
+
+        /** offset of the data chunk's content */
+        quint64 m_data_start;
+
+        /** length of the data chunk's content */
+        quint64 m_data_length;
+    };
+}
+
+#endif /* WAV_DATA_READER_H */
+
+//***************************************************************************
+//***************************************************************************
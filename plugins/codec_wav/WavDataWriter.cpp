@@ -0,0 +1,322 @@
+/***************************************************************************
+      WavDataWriter.cpp  -  native writer for uncompressed WAV sample data
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <QByteArray>
+#include <QFuture>
+#include <QIODevice>
+#include <QVector>
+#include <QtConcurrentRun>
+#include <QtEndian>
+
+#include "libkwave/MultiTrackReader.h"
+#include "libkwave/RiffHeader.h"
+#include "libkwave/SampleArray.h"
+#include "libkwave/SampleKernels.h"
+#include "libkwave/SampleReader.h"
+#include "libkwave/Utils.h"
+#include "libkwave/WorkerPool.h"
+
+#include "WavDataWriter.h"
+#include "WavFileFormat.h"
+
+/** number of frames that are converted and written at once */
+#define BLOCK_FRAMES (256U * 1024U)
+
+//***************************************************************************
+/**
+ * 32-bit pseudo-random number generator, same as in the MP3 decoder
+ * @param state the previous state
+ * @return the next state
+ */
+static inline quint32 prng(quint32 state)
+{
+    return (state * 0x0019660DU + 0x3C6EF35FU);
+}
+
+//***************************************************************************
+Kwave::WavDataWriter::WavDataWriter(QIODevice &dst)
+    :m_dst(dst), m_format(Kwave::SampleFormat::Signed), m_tracks(0),
+     m_bits(0), m_sample_bytes(0), m_data_size_offset(0), m_fact_offset(0),
+     m_frames(0)
+{
+}
+
+//***************************************************************************
+Kwave::WavDataWriter::~WavDataWriter()
+{
+}
+
+//***************************************************************************
+bool Kwave::WavDataWriter::isSupported(Kwave::SampleFormat::Format format,
+                                       unsigned int bits)
+{
+    switch (format) {
+        case Kwave::SampleFormat::Unsigned:
+            return (bits >= 1) && (bits <= 8);
+        case Kwave::SampleFormat::Signed:
+            return (bits > 8) && (bits <= 32);
+        case Kwave::SampleFormat::Float:  /* FALLTHROUGH */
+        case Kwave::SampleFormat::Double:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//***************************************************************************
+bool Kwave::WavDataWriter::writeHeader(unsigned int tracks, unsigned int rate,
+                                       unsigned int bits,
+                                       Kwave::SampleFormat::Format format)
+{
+    if (!tracks || !isSupported(format, bits)) return false;
+
+    m_format = format;
+    m_tracks = tracks;
+    m_frames = 0;
+
+    quint16 format_tag = Kwave::WAVE_FORMAT_PCM;
+    switch (format) {
+        case Kwave::SampleFormat::Float:
+            format_tag = Kwave::WAVE_FORMAT_IEEE_FLOAT;
+            m_bits     = 32;
+            break;
+        case Kwave::SampleFormat::Double:
+            format_tag = Kwave::WAVE_FORMAT_IEEE_FLOAT;
+            m_bits     = 64;
+            break;
+        default:
+            m_bits     = bits;
+            break;
+    }
+    m_sample_bytes = (m_bits + 7) >> 3;
+    const unsigned int frame_bytes = m_sample_bytes * m_tracks;
+    const bool is_float = (format_tag == Kwave::WAVE_FORMAT_IEEE_FLOAT);
+
+    QByteArray header;
+
+    // main chunk, sizes are set in finish()
+    Kwave::RiffHeader::appendMainChunk(header);
+
+    // format, non-PCM formats have a cbSize field
+    header.append("fmt ", 4);
+    appendLE<quint32>(header, (is_float) ? 18 : 16);
+    appendLE<quint16>(header, format_tag);
+    appendLE<quint16>(header, static_cast<quint16>(m_tracks));
+    appendLE<quint32>(header, rate);
+    appendLE<quint32>(header, rate * frame_bytes);
+    appendLE<quint16>(header, static_cast<quint16>(frame_bytes));
+    appendLE<quint16>(header, static_cast<quint16>(m_bits));
+    if (is_float) appendLE<quint16>(header, 0);
+
+    // non-PCM formats need a "fact" chunk with the length
+    m_fact_offset = 0;
+    if (is_float) {
+        header.append("fact", 4);
+        appendLE<quint32>(header, 4);
+        m_fact_offset = header.size();
+        appendLE<quint32>(header, 0);
+    }
+
+    header.append("data", 4);
+    m_data_size_offset = header.size();
+    appendLE<quint32>(header, 0);
+
+    return m_dst.seek(0) && (m_dst.write(header) == header.size());
+}
+
+//***************************************************************************
+void Kwave::WavDataWriter::quantize(sample_t *samples, unsigned int count,
+                                    bool dither, quint32 &random) const
+{
+    if (m_format == Kwave::SampleFormat::Float) return;
+    if (m_format == Kwave::SampleFormat::Double) return;
+    if (m_bits >= SAMPLE_BITS) return;
+
+    const unsigned int shift = SAMPLE_BITS - m_bits;
+    const sample_t     mask  = (1 << shift) - 1;
+
+    if (!dither) {
+        // truncate, as done by the encoders
+        for (unsigned int i = 0; i < count; ++i)
+            samples[i] &= ~mask;
+        return;
+    }
+
+    // round, with triangular (TPDF) dither of +/- 1 LSB
+    const sample_t bias = 1 << (shift - 1);
+    for (unsigned int i = 0; i < count; ++i) {
+        const quint32 next = prng(random);
+        sample_t s = samples[i] + bias +
+            static_cast<sample_t>(next & mask) -
+            static_cast<sample_t>(random & mask);
+        random = next;
+        samples[i] = qBound<sample_t>(SAMPLE_MIN, s, SAMPLE_MAX) & ~mask;
+    }
+}
+
+//***************************************************************************
+void Kwave::WavDataWriter::convert(const sample_t *src, unsigned int count,
+                                   quint8 *dst) const
+{
+    switch (m_format) {
+        case Kwave::SampleFormat::Float:
+            for (unsigned int i = 0; i < count; ++i, dst += 4)
+                qToLittleEndian<float>(sample2float(src[i]), dst);
+            return;
+        case Kwave::SampleFormat::Double:
+            for (unsigned int i = 0; i < count; ++i, dst += 8)
+                qToLittleEndian<double>(sample2double(src[i]), dst);
+            return;
+        case Kwave::SampleFormat::Unsigned:
+            for (unsigned int i = 0; i < count; ++i)
+                dst[i] = static_cast<quint8>((src[i] >> 16) + 128);
+            return;
+        default:
+            break;
+    }
+
+    // signed little endian, 16, 24 or 32 bit
+    Kwave::SampleKernels::encoder_t encoder =
+        Kwave::SampleKernels::linearEncoder(8 * m_sample_bytes, true, true);
+    Q_ASSERT(encoder);
+    if (encoder) encoder(src, dst, count);
+}
+
+//***************************************************************************
+bool Kwave::WavDataWriter::writeData(Kwave::MultiTrackReader &src,
+                                     sample_index_t length, bool dither)
+{
+    const unsigned int tracks      = m_tracks;
+    const unsigned int frame_bytes = m_sample_bytes * tracks;
+    if (!tracks || (src.tracks() != tracks)) return false;
+
+    // two output buffers: one is written while the other one is filled
+    QByteArray buffers[2];
+    quint8 *raw[2];
+    for (unsigned int i = 0; i < 2; ++i) {
+        buffers[i].resize(BLOCK_FRAMES * frame_bytes);
+        raw[i] = reinterpret_cast<quint8 *>(buffers[i].data());
+    }
+    unsigned int current = 0;
+    QFuture<bool> pending;
+
+    QVector<sample_t> interleaved(BLOCK_FRAMES * tracks);
+    sample_t *all = interleaved.data();
+    QVector<Kwave::SampleArray> samples(tracks);
+    Kwave::SampleArray *blocks = samples.data();
+    QVector<quint32> random(tracks);
+    quint32 *states = random.data();
+    for (unsigned int t = 0; t < tracks; ++t)
+        states[t] = t + 1;
+
+    Kwave::WorkerPool &pool = Kwave::WorkerPool::instance();
+    QIODevice &dst = m_dst;
+    bool ok = true;
+
+    sample_index_t rest = length;
+    while (rest) {
+        const unsigned int frames = Kwave::toUint(
+            qMin<sample_index_t>(rest, BLOCK_FRAMES));
+
+        // read and quantize all tracks, merge them into the interleaved
+        // samples
+        pool.run(tracks, [this, &src, blocks, states, all, frames, tracks,
+                          dither](unsigned int track)
+        {
+            Kwave::SampleArray &block = blocks[track];
+            if (block.size() != frames) block.resize(frames);
+            sample_t *in = block.data();
+
+            Kwave::SampleReader *reader = src[track];
+            unsigned int count = 0;
+            while (reader && (count < frames) && !reader->eof()) {
+                const unsigned int len =
+                    reader->read(block, count, frames - count);
+                if (!len) break;
+                count += len;
+            }
+            for (; count < frames; ++count)
+                in[count] = 0;
+
+            quantize(in, frames, dither, states[track]);
+
+            sample_t *out = all + track;
+            for (unsigned int i = 0; i < frames; ++i, out += tracks)
+                *out = in[i];
+        });
+
+        // convert slices of the interleaved samples in parallel
+        quint8 *buffer = raw[current];
+        pool.run(tracks, [this, all, buffer, frames, tracks](
+            unsigned int slice)
+        {
+            const unsigned int first = (frames * slice) / tracks;
+            const unsigned int next  = (frames * (slice + 1)) / tracks;
+            convert(all + (first * tracks), (next - first) * tracks,
+                    buffer + (first * tracks * m_sample_bytes));
+        });
+
+        // wait for the previous block, then write this one
+        if (pending.isValid() && !pending.result()) {
+            ok = false;
+            break;
+        }
+        const qint64 bytes = static_cast<qint64>(frames) * frame_bytes;
+        pending = QtConcurrent::run([&dst, buffer, bytes]() {
+            return (dst.write(reinterpret_cast<const char *>(buffer),
+                              bytes) == bytes);
+        });
+        current ^= 1;
+
+        m_frames += frames;
+        rest     -= frames;
+
+        // abort if the user pressed cancel
+        // --> this would leave a truncated, but consistent file
+        if (src.isCanceled()) break;
+    }
+
+    if (pending.isValid() && !pending.result()) ok = false;
+    if (!ok) return false;
+
+    // the data chunk is padded to an even length
+    if ((m_frames * frame_bytes) & 1) {
+        const char zero = 0;
+        if (m_dst.write(&zero, 1) != 1) return false;
+    }
+
+    return true;
+}
+
+//***************************************************************************
+bool Kwave::WavDataWriter::finish(quint64 max_size)
+{
+    const quint64 data_size = m_frames * m_sample_bytes * m_tracks;
+    if ((data_size >= max_size) ||
+        (static_cast<quint64>(m_dst.size()) - 8 >= max_size))
+        qDebug("WavDataWriter: %llu bytes, promoting to RF64",
+               static_cast<unsigned long long>(m_dst.size()));
+
+    return Kwave::RiffHeader::update(m_dst, data_size, m_frames,
+                                     m_data_size_offset, m_fact_offset,
+                                     max_size);
+}
+
+//***************************************************************************
+//***************************************************************************
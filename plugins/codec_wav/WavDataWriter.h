@@ -0,0 +1,153 @@
+/***************************************************************************
+        WavDataWriter.h  -  native writer for uncompressed WAV sample data
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef WAV_DATA_WRITER_H
+#define WAV_DATA_WRITER_H
+
+#include "config.h"
+
+#include <QtGlobal>
+
+#include "libkwave/RiffHeader.h"
+#include "libkwave/Sample.h"
+#include "libkwave/SampleFormat.h"
+
+class QIODevice;
+
+namespace Kwave
+{
+
+    class MultiTrackReader;
+
+    /**
+     * Writes uncompressed PCM or IEEE float sample data into a RIFF/WAVE
+     * file, without libaudiofile. The header reserves space for a "ds64"
+     * chunk in a "JUNK" chunk, so that a file that exceeds the limits of
+     * 32 bit sizes can be promoted to RF64 (EBU Tech 3306) when finished.
+     *
+     * The blocks of all tracks are read, quantized and interleaved in
+     * parallel, while the previous block is written to the destination
+     * in the background.
+     */
+    class WavDataWriter
+    {
+    public:
+
+        /**
+         * Constructor
+         * @param dst an opened destination with random access
+         */
+        explicit WavDataWriter(QIODevice &dst);
+
+        /** Destructor */
+        virtual ~WavDataWriter();
+
+        /**
+         * Checks whether a sample format can be written
+         * @param format the sample format
+         * @param bits number of bits per sample
+         * @return true if supported
+         */
+        static bool isSupported(Kwave::SampleFormat::Format format,
+                                unsigned int bits);
+
+        /**
+         * Writes the header, up to the start of the data chunk
+         * @param tracks number of tracks
+         * @param rate sample rate
+         * @param bits number of valid bits per sample
+         * @param format sample format
+         * @return true if succeeded, false on errors
+         */
+        bool writeHeader(unsigned int tracks, unsigned int rate,
+                         unsigned int bits,
+                         Kwave::SampleFormat::Format format);
+
+        /**
+         * Writes the content of the data chunk
+         * @param src MultiTrackReader used as source of the audio data
+         * @param length number of samples per track
+         * @param dither if true, add TPDF dither when reducing the
+         *               resolution, otherwise truncate
+         * @return true if succeeded, false on write errors
+         */
+        bool writeData(Kwave::MultiTrackReader &src, sample_index_t length,
+                       bool dither);
+
+        /**
+         * Updates the sizes in the header, must be called after all
+         * further chunks have been appended. Promotes the file to RF64
+         * if the sizes do not fit into 32 bits.
+         * @param max_size largest size that is written as RIFF, only to
+         *                 be lowered for testing
+         * @return true if succeeded, false on errors
+         */
+        bool finish(quint64 max_size = RIFF_SIZE_MAX);
+
+    private:
+
+        /**
+         * Reduces the resolution of the samples of one track
+         * @param samples array with samples, modified in place
+         * @param count number of samples
+         * @param dither if true, add TPDF dither, otherwise truncate
+         * @param random state of the random generator of the track
+         */
+        void quantize(sample_t *samples, unsigned int count, bool dither,
+                      quint32 &random) const;
+
+        /**
+         * Converts interleaved samples into the raw format
+         * @param src array with interleaved samples
+         * @param count number of samples (not frames)
+         * @param dst buffer that receives the raw data
+         */
+        void convert(const sample_t *src, unsigned int count,
+                     quint8 *dst) const;
+
+    private:
+
+        /** the destination */
+        QIODevice &m_dst;
+
+        /** sample format */
+        Kwave::SampleFormat::Format m_format;
+
+        /** number of tracks */
+        unsigned int m_tracks;
+
+        /** valid bits per sample */
+        unsigned int m_bits;
+
+        /** bytes per sample of one track */
+        unsigned int m_sample_bytes;
+
+        /** offset of the size of the "data" chunk */
+        qint64 m_data_size_offset;
+
+        /** offset of the sample length in the "fact" chunk, or zero */
+        qint64 m_fact_offset;
+
+        /** number of frames written to the data chunk */
+        quint64 m_frames;
+    };
+}
+
+#endif /* WAV_DATA_WRITER_H */
+
+//***************************************************************************
+//***************************************************************************
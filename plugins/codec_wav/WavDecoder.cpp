@@ -57,6 +57,7 @@
 #include "RecoveryMapping.h"
 #include "RecoverySource.h"
 #include "RepairVirtualAudioFile.h"
+#include "WavDataReader.h"
 #include "WavDecoder.h"
 #include "WavFileFormat.h"
 #include "WavFormatMap.h"
@@ -68,18 +69,29 @@ Kwave::WavDecoder::WavDecoder()
     :Kwave::Decoder(),
      m_source(nullptr),
      m_src_adapter(nullptr),
+     m_data_reader(),
+     m_native(false),
      m_known_chunks(),
      m_property_map()
 {
     REGISTER_MIME_TYPES
     REGISTER_COMPRESSION_TYPES
 
+    // containers with 64 bit sizes, only read natively
+    addMimeType("audio/x-rf64",
+                i18n("RF64 audio (EBU Tech 3306)"),
+                "*.rf64");
+    addMimeType("audio/x-w64",
+                i18n("Sony Wave64 audio"),
+                "*.w64");
+
     // native WAVE chunk names
     m_known_chunks.append(_("cue ")); /* Markers */
     m_known_chunks.append(_("data")); /* Sound Data */
     m_known_chunks.append(_("fact")); /* Fact (length in samples) */
     m_known_chunks.append(_("fmt ")); /* Format */
     m_known_chunks.append(_("inst")); /* Instrument */
+    m_known_chunks.append(_("JUNK")); /* Padding, space for "ds64" */
     m_known_chunks.append(_("labl")); /* label */
     m_known_chunks.append(_("ltxt")); /* labeled text */
     m_known_chunks.append(_("note")); /* note chunk */
@@ -133,6 +145,37 @@ bool Kwave::WavDecoder::open(QWidget *widget, QIODevice &src)
         return false;
     }
 
+    // RF64 and Wave64 exceed the 32 bit limits of the RIFF parser,
+    // these are read natively, without labels and file properties
+    m_native = false;
+    if (m_data_reader.open(src) &&
+        (m_data_reader.container() != Kwave::WavDataReader::Riff))
+    {
+        if (!m_data_reader.isSupported() || !m_data_reader.length()) {
+            Kwave::MessageBox::sorry(widget,
+                i18n("The opened file contains no uncompressed PCM or "
+                     "floating point sound data,\n"
+                     "which is the only format supported for RF64 and "
+                     "Wave64 files."));
+            m_data_reader.close();
+            return false;
+        }
+
+        info.setRate(m_data_reader.rate());
+        info.setBits(m_data_reader.bits());
+        info.setTracks(m_data_reader.tracks());
+        info.setLength(m_data_reader.length());
+        info.set(Kwave::INF_SAMPLE_FORMAT,
+            Kwave::SampleFormat(m_data_reader.sampleFormat()).toInt());
+        info.set(Kwave::INF_COMPRESSION,
+            Kwave::Compression(Kwave::Compression::NONE).toInt());
+        metaData().replace(Kwave::MetaDataList(info));
+
+        m_source = &src;
+        m_native = true;
+        return true;
+    }
+
     QStringList main_chunks;
     main_chunks.append(_("RIFF")); /* RIFF, little-endian */
     main_chunks.append(_("RIFX")); /* RIFF, big-endian */
@@ -339,110 +382,124 @@ bool Kwave::WavDecoder::open(QWidget *widget, QIODevice &src)
 //     qDebug("bits/sample = %d", header.min.bitwidth);
 //     qDebug("-------------------------");
 
-    // open the file through libaudiofile :)
-    if (need_repair) {
-        QList<Kwave::RecoverySource *> *repair_list =
-            new(std::nothrow) QList<Kwave::RecoverySource *>();
-        Q_ASSERT(repair_list);
-        if (!repair_list) return false;
-
-        Kwave::RIFFChunk *root = (riff_chunk) ? riff_chunk :
-                                                parser.findChunk("");
+    sample_index_t length = 0;
+    Kwave::SampleFormat::Format fmt = Kwave::SampleFormat::Unknown;
+    Kwave::Compression::Type compression = Kwave::Compression::NONE;
+
+    // intact files with uncompressed samples are read natively, all
+    // others through libaudiofile
+    m_native = !need_repair && m_data_reader.isSupported() &&
+        (m_data_reader.container() == Kwave::WavDataReader::Riff) &&
+        data_chunk && (m_data_reader.dataStart() == data_chunk->dataStart());
+    if (m_native) {
+        length = m_data_reader.length();
+        bits   = m_data_reader.bits();
+        fmt    = m_data_reader.sampleFormat();
+    } else {
+        // open the file through libaudiofile :)
+        if (need_repair) {
+            QList<Kwave::RecoverySource *> *repair_list =
+                new(std::nothrow) QList<Kwave::RecoverySource *>();
+            Q_ASSERT(repair_list);
+            if (!repair_list) return false;
+
+            Kwave::RIFFChunk *root = (riff_chunk) ? riff_chunk :
+                                                    parser.findChunk("");
 //      parser.dumpStructure();
 //      qDebug("riff chunk = %p, parser.findChunk('')=%p", riff_chunk,
 //          parser.findChunk(""));
-        repair(repair_list, root, fmt_chunk, data_chunk);
-        m_src_adapter = new(std::nothrow)
-            Kwave::RepairVirtualAudioFile(*m_source, repair_list);
-    } else {
-        m_src_adapter = new(std::nothrow) Kwave::VirtualAudioFile(*m_source);
-    }
+            repair(repair_list, root, fmt_chunk, data_chunk);
+            m_src_adapter = new(std::nothrow)
+                Kwave::RepairVirtualAudioFile(*m_source, repair_list);
+        } else {
+            m_src_adapter = new(std::nothrow)
+                Kwave::VirtualAudioFile(*m_source);
+        }
 
-    Q_ASSERT(m_src_adapter);
-    if (!m_src_adapter) return false;
+        Q_ASSERT(m_src_adapter);
+        if (!m_src_adapter) return false;
+
+        m_src_adapter->open(m_src_adapter, nullptr);
+
+        AFfilehandle fh = m_src_adapter->handle();
+        if (!fh || (m_src_adapter->lastError() >= 0)) {
+            QString reason;
+
+            switch (m_src_adapter->lastError()) {
+                case AF_BAD_NOT_IMPLEMENTED:
+                    reason = i18n("Format or function is not implemented") +
+                             _("\n(") + format_name + _(")");
+                    break;
+                case AF_BAD_MALLOC:
+                    reason = i18n("Out of memory");
+                    break;
+                case AF_BAD_HEADER:
+                    reason = i18n("file header is damaged");
+                    break;
+                case AF_BAD_CODEC_TYPE:
+                    reason = i18n("Invalid codec type") +
+                             _("\n(") + format_name + _(")");
+                    break;
+                case AF_BAD_OPEN:
+                    reason = i18n("Opening the file failed");
+                    break;
+                case AF_BAD_READ:
+                    reason = i18n("Read access failed");
+                    break;
+                case AF_BAD_SAMPFMT:
+                    reason = i18n("Invalid sample format");
+                    break;
+                default:
+                    reason = i18n("internal libaudiofile error #%1: '%2'",
+                        m_src_adapter->lastError(),
+                        m_src_adapter->lastErrorText()
+                    );
+            }
 
-    m_src_adapter->open(m_src_adapter, nullptr);
+            QString text = i18n(
+                "An error occurred while opening the file:\n'%1'", reason);
+            Kwave::MessageBox::error(widget, text);
 
-    AFfilehandle fh = m_src_adapter->handle();
-    if (!fh || (m_src_adapter->lastError() >= 0)) {
-        QString reason;
+            return false;
+        }
 
-        switch (m_src_adapter->lastError()) {
-            case AF_BAD_NOT_IMPLEMENTED:
-                reason = i18n("Format or function is not implemented") +
-                         _("\n(") + format_name + _(")");
-                break;
-            case AF_BAD_MALLOC:
-                reason = i18n("Out of memory");
-                break;
-            case AF_BAD_HEADER:
-                reason = i18n("file header is damaged");
-                break;
-            case AF_BAD_CODEC_TYPE:
-                reason = i18n("Invalid codec type") +
-                         _("\n(") + format_name + _(")");
+        length = afGetFrameCount(fh, AF_DEFAULT_TRACK);
+        tracks = afGetVirtualChannels(fh, AF_DEFAULT_TRACK);
+
+        int af_sample_format;
+        afGetVirtualSampleFormat(fh, AF_DEFAULT_TRACK, &af_sample_format,
+            reinterpret_cast<int *>(&bits));
+        if (static_cast<signed int>(bits) < 0) bits = 0;
+        switch (af_sample_format)
+        {
+            case AF_SAMPFMT_TWOSCOMP:
+                fmt = Kwave::SampleFormat::Signed;
                 break;
-            case AF_BAD_OPEN:
-                reason = i18n("Opening the file failed");
+            case AF_SAMPFMT_UNSIGNED:
+                fmt = Kwave::SampleFormat::Unsigned;
                 break;
-            case AF_BAD_READ:
-                reason = i18n("Read access failed");
+            case AF_SAMPFMT_FLOAT:
+                fmt = Kwave::SampleFormat::Float;
                 break;
-            case AF_BAD_SAMPFMT:
-                reason = i18n("Invalid sample format");
+            case AF_SAMPFMT_DOUBLE:
+                fmt = Kwave::SampleFormat::Double;
                 break;
             default:
-                reason = i18n("internal libaudiofile error #%1: '%2'",
-                    m_src_adapter->lastError(),
-                    m_src_adapter->lastErrorText()
-                );
+                fmt = Kwave::SampleFormat::Unknown;
+                break;
         }
 
-        QString text= i18n("An error occurred while opening the file:\n'%1'",
-                            reason);
-        Kwave::MessageBox::error(widget, text);
-
-        return false;
+        int af_compression = afGetCompression(fh, AF_DEFAULT_TRACK);
+        compression = Kwave::Compression::fromAudiofile(af_compression);
     }
 
-    AFframecount length = afGetFrameCount(fh, AF_DEFAULT_TRACK);
-    tracks = afGetVirtualChannels(fh, AF_DEFAULT_TRACK);
-
-    int af_sample_format;
-    afGetVirtualSampleFormat(fh, AF_DEFAULT_TRACK, &af_sample_format,
-        reinterpret_cast<int *>(&bits));
-    if (static_cast<signed int>(bits) < 0) bits = 0;
-    Kwave::SampleFormat::Format fmt;
-    switch (af_sample_format)
-    {
-        case AF_SAMPFMT_TWOSCOMP:
-            fmt = Kwave::SampleFormat::Signed;
-            break;
-        case AF_SAMPFMT_UNSIGNED:
-            fmt = Kwave::SampleFormat::Unsigned;
-            break;
-        case AF_SAMPFMT_FLOAT:
-            fmt = Kwave::SampleFormat::Float;
-            break;
-        case AF_SAMPFMT_DOUBLE:
-            fmt = Kwave::SampleFormat::Double;
-            break;
-        default:
-            fmt = Kwave::SampleFormat::Unknown;
-            break;
-    }
-
-    int af_compression = afGetCompression(fh, AF_DEFAULT_TRACK);
-    const Kwave::Compression compression(
-        Kwave::Compression::fromAudiofile(af_compression)
-    );
-
     info.setRate(rate);
     info.setBits(bits);
     info.setTracks(tracks);
     info.setLength(length);
     info.set(Kwave::INF_SAMPLE_FORMAT, Kwave::SampleFormat(fmt).toInt());
-    info.set(Kwave::INF_COMPRESSION, compression.toInt());
+    info.set(Kwave::INF_COMPRESSION,
+             Kwave::Compression(compression).toInt());
 
     // read in all info from the LIST (INFO) chunk
     Kwave::RIFFChunk *info_chunk = parser.findChunk("/RIFF:WAVE/LIST:INFO");
@@ -594,13 +651,17 @@ bool Kwave::WavDecoder::open(QWidget *widget, QIODevice &src)
     metaData().replace(labels.toMetaDataList());
 
     // set up libaudiofile to produce Kwave's internal sample format
+    if (!m_native) {
+        AFfilehandle fh = m_src_adapter->handle();
 #if Q_BYTE_ORDER == Q_BIG_ENDIAN
-    afSetVirtualByteOrder(fh, AF_DEFAULT_TRACK, AF_BYTEORDER_BIGENDIAN);
+        afSetVirtualByteOrder(fh, AF_DEFAULT_TRACK, AF_BYTEORDER_BIGENDIAN);
 #else
-    afSetVirtualByteOrder(fh, AF_DEFAULT_TRACK, AF_BYTEORDER_LITTLEENDIAN);
+        afSetVirtualByteOrder(fh, AF_DEFAULT_TRACK,
+                              AF_BYTEORDER_LITTLEENDIAN);
 #endif
-    afSetVirtualSampleFormat(fh, AF_DEFAULT_TRACK,
-        AF_SAMPFMT_TWOSCOMP, SAMPLE_STORAGE_BITS);
+        afSetVirtualSampleFormat(fh, AF_DEFAULT_TRACK,
+            AF_SAMPFMT_TWOSCOMP, SAMPLE_STORAGE_BITS);
+    }
 
     return true;
 }
@@ -608,6 +669,12 @@ bool Kwave::WavDecoder::open(QWidget *widget, QIODevice &src)
 //***************************************************************************
 bool Kwave::WavDecoder::decode(QWidget */*widget*/, Kwave::MultiWriter &dst)
 {
+    if (m_native) {
+        Q_ASSERT(m_source);
+        if (!m_source) return false;
+        return m_data_reader.decode(dst);
+    }
+
     Q_ASSERT(m_src_adapter);
     Q_ASSERT(m_source);
     if (!m_source) return false;
@@ -838,6 +905,8 @@ void Kwave::WavDecoder::close()
 {
     delete m_src_adapter;
     m_src_adapter = nullptr;
+    m_data_reader.close();
+    m_native = false;
     m_source = nullptr;
 }
 
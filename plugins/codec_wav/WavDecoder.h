@@ -28,6 +28,7 @@
 #include "libkwave/Decoder.h"
 #include "libkwave/FileInfo.h"
 
+#include "WavDataReader.h"
 #include "WavPropertyMap.h"
 
 
@@ -105,6 +106,12 @@ namespace Kwave
         /** adapter for libaudiofile */
         Kwave::VirtualAudioFile *m_src_adapter;
 
+        /** native reader for uncompressed sample data */
+        Kwave::WavDataReader m_data_reader;
+
+        /** true if the native reader is used instead of libaudiofile */
+        bool m_native;
+
         /** list of all known chunk names */
         QStringList m_known_chunks;
 
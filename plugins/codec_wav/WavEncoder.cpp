@@ -23,7 +23,10 @@
 #include <limits>
 #include <new>
 
+#include <KConfig>
+#include <KConfigGroup>
 #include <KLocalizedString>
+#include <KSharedConfig>
 
 #include <QByteArray>
 #include <QIODevice>
@@ -38,12 +41,17 @@
 #include "libkwave/Sample.h"
 #include "libkwave/SampleFormat.h"
 #include "libkwave/SampleReader.h"
+#include "libkwave/String.h"
 #include "libkwave/Utils.h"
 #include "libkwave/VirtualAudioFile.h"
 
+#include "WavDataWriter.h"
 #include "WavEncoder.h"
 #include "WavFileFormat.h"
 
+/** section in the config file with the settings of the WAV codec */
+#define CONFIG_SECTION _("plugin codec_wav")
+
 /***************************************************************************/
 Kwave::WavEncoder::WavEncoder()
     :Kwave::Encoder(), m_property_map()
@@ -198,8 +206,21 @@ void Kwave::WavEncoder::writeInfoChunk(QIODevice &dst, Kwave::FileInfo &info)
 
 /***************************************************************************/
 void Kwave::WavEncoder::writeLabels(QIODevice &dst,
-                                    const Kwave::LabelList &labels)
+                                    const Kwave::LabelList &all_labels)
 {
+    // the cue list has only 32 bit sample positions, labels beyond that
+    // cannot be stored
+    Kwave::LabelList labels;
+    for (const Kwave::Label &label : all_labels) {
+        if (label.isNull()) continue;
+        if (label.pos() > std::numeric_limits<quint32>::max()) {
+            qWarning("WavEncoder: label at sample %llu is out of the "
+                     "range of a cue point, skipped", label.pos());
+            continue;
+        }
+        labels.append(label);
+    }
+
     const quint32 labels_count = static_cast<quint32>(labels.count());
     quint32 size, additional_size = 0, index, data;
 
@@ -272,7 +293,7 @@ void Kwave::WavEncoder::writeLabels(QIODevice &dst,
         dst.write("data", 4);        // fccChunk
         dst.write(reinterpret_cast<char *>(&data), 4); // dwChunkStart
         dst.write(reinterpret_cast<char *>(&data), 4); // dwBlockStart
-        data = qToLittleEndian<quint32>(Kwave::toUint(label.pos()));
+        data = qToLittleEndian<quint32>(static_cast<quint32>(label.pos()));
         dst.write(reinterpret_cast<char *>(&data), 4); // dwSampleOffset
         index++;
     }
@@ -409,6 +430,33 @@ bool Kwave::WavEncoder::encode(QWidget *widget, Kwave::MultiTrackReader &src,
         return false;
     }
 
+    // uncompressed data is written natively, as RF64 if it gets too large
+    if ((compression == Kwave::Compression::NONE) &&
+        Kwave::WavDataWriter::isSupported(format, bits))
+    {
+        KConfigGroup cfg = KSharedConfig::openConfig()->group(CONFIG_SECTION);
+        const bool dither = cfg.readEntry("dither", false);
+
+        Kwave::WavDataWriter writer(dst);
+        if (!writer.writeHeader(tracks, Kwave::toUint(rate + 0.5), bits,
+                                format) ||
+            !writer.writeData(src, length, dither))
+        {
+            Kwave::MessageBox::error(widget,
+                i18n("An error occurred while writing the file."));
+            return false;
+        }
+
+        // put the properties into the INFO chunk
+        writeInfoChunk(dst, info);
+
+        // write the labels list
+        writeLabels(dst, Kwave::LabelList(meta_data));
+
+        // set the final sizes in the header
+        return writer.finish();
+    }
+
     // check for proper size: WAV supports only 32bit addressing
     if (length * ((bits + 7) / 8) >= std::numeric_limits<quint32>::max()) {
         Kwave::MessageBox::error(widget, i18n("File or selection too large"));
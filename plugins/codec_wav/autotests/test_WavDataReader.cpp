@@ -0,0 +1,292 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+
+#include "WavDataReader.h"
+#include "libkwave/MultiWriter.h"
+#include "libkwave/RiffHeader.h"
+#include "libkwave/SampleArray.h"
+#include "libkwave/SampleReader.h"
+#include "libkwave/String.h"
+#include "libkwave/Track.h"
+#include "libkwave/Writer.h"
+#include <QBuffer>
+#include <QRegularExpression>
+#include <QTemporaryFile>
+#include <QTest>
+
+Q_DECLARE_METATYPE(Kwave::WavDataReader::Container)
+
+/** number of tracks of the test files */
+static const unsigned int TRACKS = 2;
+
+/** number of frames of the test files */
+static const unsigned int FRAMES = 8;
+
+/** common last 12 bytes of the GUIDs of Wave64 chunks */
+static const char W64_GUID_SUFFIX[12] = {
+    '\xF3', '\xAC', '\xD3', '\x11', '\x8C', '\xD1', '\x00', '\xC0',
+    '\x4F', '\x8E', '\xDB', '\x8A'
+};
+
+/** GUID of the "riff" chunk of a Wave64 file */
+static const char W64_GUID_RIFF[16] = {
+    'r', 'i', 'f', 'f', '\x2E', '\x91', '\xCF', '\x11',
+    '\xA5', '\xD6', '\x28', '\xDB', '\x04', '\xC1', '\x00', '\x00'
+};
+
+class TestWavDataReader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void read_data();
+    void read();
+    void truncated();
+    void ds64Above32Bit();
+    void mapped();
+
+private:
+    static qint16 value(unsigned int frame, unsigned int track);
+    static QByteArray fmtChunk();
+    static QByteArray samples(unsigned int frames);
+    static QByteArray riff(const QByteArray &data, quint32 data_size);
+    static QByteArray rf64(const QByteArray &data, quint64 data_size);
+    static QByteArray wave64(const QByteArray &data);
+    static bool decode(Kwave::WavDataReader &reader,
+                       QList<Kwave::Track *> &tracks);
+    static bool verify(QList<Kwave::Track *> &tracks, unsigned int frames);
+};
+
+qint16 TestWavDataReader::value(unsigned int frame, unsigned int track)
+{
+    return static_cast<qint16>(
+        static_cast<int>((frame * 1000) + (track * 100)) - 4000);
+}
+
+QByteArray TestWavDataReader::fmtChunk()
+{
+    // 16 bit PCM, 44.1kHz
+    QByteArray fmt;
+    Kwave::appendLE<quint16>(fmt, 0x0001);
+    Kwave::appendLE<quint16>(fmt, TRACKS);
+    Kwave::appendLE<quint32>(fmt, 44100);
+    Kwave::appendLE<quint32>(fmt, 44100 * 2 * TRACKS);
+    Kwave::appendLE<quint16>(fmt, 2 * TRACKS);
+    Kwave::appendLE<quint16>(fmt, 16);
+    return fmt;
+}
+
+QByteArray TestWavDataReader::samples(unsigned int frames)
+{
+    QByteArray data;
+    for (unsigned int frame = 0; frame < frames; ++frame)
+        for (unsigned int track = 0; track < TRACKS; ++track)
+            Kwave::appendLE<qint16>(data, value(frame, track));
+    return data;
+}
+
+QByteArray TestWavDataReader::riff(const QByteArray &data,
+                                   quint32 data_size)
+{
+    const QByteArray fmt = fmtChunk();
+    QByteArray file("RIFF");
+    Kwave::appendLE<quint32>(file, 4 + 8 + fmt.size() + 8 + data_size);
+    file.append("WAVE");
+    file.append("fmt ");
+    Kwave::appendLE<quint32>(file, fmt.size());
+    file.append(fmt);
+    file.append("data");
+    Kwave::appendLE<quint32>(file, data_size);
+    file.append(data);
+    return file;
+}
+
+QByteArray TestWavDataReader::rf64(const QByteArray &data,
+                                   quint64 data_size)
+{
+    const QByteArray fmt = fmtChunk();
+    QByteArray file("RF64");
+    Kwave::appendLE<quint32>(file, 0xFFFFFFFFU);
+    file.append("WAVE");
+    file.append("ds64");
+    Kwave::appendLE<quint32>(file, 28);
+    Kwave::appendLE<quint64>(file, 4 + 36 + 8 + fmt.size() + 8 + data_size);
+    Kwave::appendLE<quint64>(file, data_size);
+    Kwave::appendLE<quint64>(file, data_size / (2 * TRACKS));
+    Kwave::appendLE<quint32>(file, 0);
+    file.append("fmt ");
+    Kwave::appendLE<quint32>(file, fmt.size());
+    file.append(fmt);
+    file.append("data");
+    Kwave::appendLE<quint32>(file, 0xFFFFFFFFU);
+    file.append(data);
+    return file;
+}
+
+QByteArray TestWavDataReader::wave64(const QByteArray &data)
+{
+    // chunks are padded to 64 bit, the lengths include the header
+    QByteArray fmt = fmtChunk();
+    while (fmt.size() & 7)
+        fmt.append('\0');
+    QByteArray file(W64_GUID_RIFF, sizeof(W64_GUID_RIFF));
+    Kwave::appendLE<quint64>(file,
+        40 + 24 + fmt.size() + 24 + data.size());
+    file.append("wave");
+    file.append(W64_GUID_SUFFIX, sizeof(W64_GUID_SUFFIX));
+    file.append("fmt ");
+    file.append(W64_GUID_SUFFIX, sizeof(W64_GUID_SUFFIX));
+    Kwave::appendLE<quint64>(file, 24 + fmtChunk().size());
+    file.append(fmt);
+    file.append("data");
+    file.append(W64_GUID_SUFFIX, sizeof(W64_GUID_SUFFIX));
+    Kwave::appendLE<quint64>(file, 24 + data.size());
+    file.append(data);
+    return file;
+}
+
+bool TestWavDataReader::decode(Kwave::WavDataReader &reader,
+                               QList<Kwave::Track *> &tracks)
+{
+    Kwave::MultiWriter writers;
+    for (unsigned int track = 0; track < TRACKS; ++track) {
+        tracks.append(new Kwave::Track(0, track + 1));
+        Kwave::Writer *writer = tracks.last()->openWriter(Kwave::Append);
+        if (!writer || !writers.insert(track, writer)) return false;
+    }
+    const bool ok = reader.decode(writers);
+    writers.clear(); // flushes the writers
+    return ok;
+}
+
+bool TestWavDataReader::verify(QList<Kwave::Track *> &tracks,
+                               unsigned int frames)
+{
+    if (tracks.count() != static_cast<int>(TRACKS)) return false;
+    for (unsigned int track = 0; track < TRACKS; ++track) {
+        if (tracks[track]->length() != frames) return false;
+        Kwave::SampleReader *reader =
+            tracks[track]->openReader(Kwave::SinglePassForward);
+        if (!reader) return false;
+        Kwave::SampleArray buffer(frames);
+        const unsigned int read = reader->read(buffer, 0, frames);
+        delete reader;
+        if (read != frames) return false;
+        for (unsigned int frame = 0; frame < frames; ++frame) {
+            const sample_t expected =
+                static_cast<sample_t>(value(frame, track)) * 256;
+            if (buffer[frame] != expected) {
+                qWarning("track %u, frame %u: %d instead of %d",
+                         track, frame, buffer[frame], expected);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void TestWavDataReader::read_data()
+{
+    QTest::addColumn<QByteArray>("file");
+    QTest::addColumn<Kwave::WavDataReader::Container>("container");
+
+    const QByteArray data = samples(FRAMES);
+    QTest::newRow("RIFF")   << riff(data, data.size())
+                            << Kwave::WavDataReader::Riff;
+    QTest::newRow("RF64")   << rf64(data, data.size())
+                            << Kwave::WavDataReader::Rf64;
+    QTest::newRow("Wave64") << wave64(data)
+                            << Kwave::WavDataReader::Wave64;
+}
+
+void TestWavDataReader::read()
+{
+    QFETCH(QByteArray, file);
+    QFETCH(Kwave::WavDataReader::Container, container);
+
+    QBuffer source(&file);
+    QVERIFY(source.open(QIODevice::ReadOnly));
+
+    Kwave::WavDataReader reader;
+    QVERIFY(reader.open(source));
+    QCOMPARE(reader.container(), container);
+    QVERIFY(reader.isSupported());
+    QCOMPARE(reader.tracks(), TRACKS);
+    QCOMPARE(reader.rate(), 44100U);
+    QCOMPARE(reader.bits(), 16U);
+    QCOMPARE(reader.sampleFormat(), Kwave::SampleFormat::Signed);
+    QCOMPARE(reader.length(), sample_index_t(FRAMES));
+
+    QList<Kwave::Track *> tracks;
+    QVERIFY(decode(reader, tracks));
+    QVERIFY(verify(tracks, FRAMES));
+    qDeleteAll(tracks);
+}
+
+void TestWavDataReader::truncated()
+{
+    // the data chunk announces twice as much as the file contains
+    const QByteArray data = samples(FRAMES);
+    QByteArray file = riff(data, 2 * data.size());
+    QBuffer source(&file);
+    QVERIFY(source.open(QIODevice::ReadOnly));
+
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression(_("data chunk truncated")));
+    Kwave::WavDataReader reader;
+    QVERIFY(reader.open(source));
+    QCOMPARE(reader.container(), Kwave::WavDataReader::Riff);
+    QCOMPARE(reader.length(), sample_index_t(FRAMES));
+
+    QList<Kwave::Track *> tracks;
+    QVERIFY(decode(reader, tracks));
+    QVERIFY(verify(tracks, FRAMES));
+    qDeleteAll(tracks);
+}
+
+void TestWavDataReader::ds64Above32Bit()
+{
+    // a size in the ds64 chunk beyond 4GB, only the lower 32 bits
+    // would give a length of two frames instead of the available eight
+    const QByteArray data = samples(FRAMES);
+    QByteArray file = rf64(data, Q_UINT64_C(0x100000000) + 8);
+    QBuffer source(&file);
+    QVERIFY(source.open(QIODevice::ReadOnly));
+
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression(_("data chunk truncated")));
+    Kwave::WavDataReader reader;
+    QVERIFY(reader.open(source));
+    QCOMPARE(reader.container(), Kwave::WavDataReader::Rf64);
+    QCOMPARE(reader.length(), sample_index_t(FRAMES));
+
+    QList<Kwave::Track *> tracks;
+    QVERIFY(decode(reader, tracks));
+    QVERIFY(verify(tracks, FRAMES));
+    qDeleteAll(tracks);
+}
+
+void TestWavDataReader::mapped()
+{
+    // a regular file is memory mapped instead of read in blocks
+    const QByteArray data = samples(FRAMES);
+    QTemporaryFile source;
+    QVERIFY(source.open());
+    const QByteArray file = riff(data, data.size());
+    QCOMPARE(source.write(file), file.size());
+    QVERIFY(source.flush());
+
+    Kwave::WavDataReader reader;
+    QVERIFY(reader.open(source));
+    QCOMPARE(reader.length(), sample_index_t(FRAMES));
+
+    QList<Kwave::Track *> tracks;
+    QVERIFY(decode(reader, tracks));
+    QVERIFY(verify(tracks, FRAMES));
+    qDeleteAll(tracks);
+}
+
+QTEST_MAIN(TestWavDataReader)
+#include "test_WavDataReader.moc"
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "WavDataReader.h"
+#include "WavDataWriter.h"
+#include "libkwave/MultiTrackReader.h"
+#include "libkwave/MultiWriter.h"
+#include "libkwave/RiffHeader.h"
+#include "libkwave/SampleArray.h"
+#include "libkwave/SampleReader.h"
+#include "libkwave/Stripe.h"
+#include "libkwave/Track.h"
+#include "libkwave/Writer.h"
+#include <QBuffer>
+#include <QTest>
+#include <QtEndian>
+
+Q_DECLARE_METATYPE(Kwave::WavDataReader::Container)
+
+/** number of tracks of the test files */
+static const unsigned int TRACKS = 2;
+
+/** number of frames of the test files */
+static const unsigned int FRAMES = 1000;
+
+class TestWavDataWriter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void finish_data();
+    void finish();
+
+private:
+    static sample_t value(unsigned int frame, unsigned int track);
+};
+
+sample_t TestWavDataWriter::value(unsigned int frame, unsigned int track)
+{
+    // 16 bit values, scaled up to 24 bit
+    return static_cast<sample_t>(
+        ((frame * 7919) + (track * 104729)) % 65536) * 256 - SAMPLE_MAX - 1;
+}
+
+void TestWavDataWriter::finish_data()
+{
+    QTest::addColumn<quint64>("max_size");
+    QTest::addColumn<Kwave::WavDataReader::Container>("container");
+
+    // the data chunk has 4000 bytes, the file some bytes more
+    QTest::newRow("RIFF")         << quint64(RIFF_SIZE_MAX)
+                                  << Kwave::WavDataReader::Riff;
+    QTest::newRow("RF64 by data") << quint64(4000)
+                                  << Kwave::WavDataReader::Rf64;
+    QTest::newRow("RF64 by file") << quint64(4010)
+                                  << Kwave::WavDataReader::Rf64;
+}
+
+void TestWavDataWriter::finish()
+{
+    QFETCH(quint64, max_size);
+    QFETCH(Kwave::WavDataReader::Container, container);
+
+    // source: one stripe per track
+    QList<Kwave::Stripe::List> stripes;
+    for (unsigned int track = 0; track < TRACKS; ++track) {
+        Kwave::SampleArray samples(FRAMES);
+        QCOMPARE(samples.size(), FRAMES);
+        for (unsigned int frame = 0; frame < FRAMES; ++frame)
+            samples[frame] = value(frame, track);
+        Kwave::Stripe::List list(0, FRAMES - 1);
+        list.append(Kwave::Stripe(0, samples));
+        stripes.append(list);
+    }
+
+    // write 16 bit PCM, with a lowered limit for the promotion to RF64
+    QByteArray file;
+    QBuffer dst(&file);
+    QVERIFY(dst.open(QIODevice::ReadWrite));
+    {
+        Kwave::MultiTrackReader src(Kwave::SinglePassForward, stripes);
+        Kwave::WavDataWriter writer(dst);
+        QVERIFY(writer.writeHeader(TRACKS, 44100, 16,
+                                   Kwave::SampleFormat::Signed));
+        QVERIFY(writer.writeData(src, FRAMES, false));
+        QVERIFY(writer.finish(max_size));
+    }
+
+    const bool is_rf64 = (container == Kwave::WavDataReader::Rf64);
+    QCOMPARE(file.left(4), QByteArray(is_rf64 ? "RF64" : "RIFF"));
+    QCOMPARE(file.mid(12, 4), QByteArray(is_rf64 ? "ds64" : "JUNK"));
+    if (is_rf64) {
+        // 64 bit sizes of the file, the data chunk and the frames
+        const char *ds64 = file.constData() + 20;
+        QCOMPARE(qFromLittleEndian<quint64>(ds64),
+                 quint64(file.size() - 8));
+        QCOMPARE(qFromLittleEndian<quint64>(ds64 + 8),
+                 quint64(FRAMES * TRACKS * 2));
+        QCOMPARE(qFromLittleEndian<quint64>(ds64 + 16), quint64(FRAMES));
+    }
+
+    // parse the result
+    Kwave::WavDataReader reader;
+    QVERIFY(reader.open(dst));
+    QCOMPARE(reader.container(), container);
+    QCOMPARE(reader.tracks(), TRACKS);
+    QCOMPARE(reader.rate(), 44100U);
+    QCOMPARE(reader.bits(), 16U);
+    QCOMPARE(reader.length(), sample_index_t(FRAMES));
+
+    QList<Kwave::Track *> tracks;
+    bool ok = true;
+    {
+        Kwave::MultiWriter writers;
+        for (unsigned int track = 0; ok && (track < TRACKS); ++track) {
+            tracks.append(new Kwave::Track(0, track + 1));
+            Kwave::Writer *writer =
+                tracks.last()->openWriter(Kwave::Append);
+            ok = writer && writers.insert(track, writer);
+        }
+        ok = ok && reader.decode(writers);
+    } // the writers are flushed here
+    QVERIFY(ok);
+
+    for (unsigned int track = 0; track < TRACKS; ++track) {
+        QCOMPARE(tracks[track]->length(), sample_index_t(FRAMES));
+        Kwave::SampleReader *samples =
+            tracks[track]->openReader(Kwave::SinglePassForward);
+        QVERIFY(samples);
+        Kwave::SampleArray buffer(FRAMES);
+        QCOMPARE(samples->read(buffer, 0, FRAMES), FRAMES);
+        delete samples;
+        for (unsigned int frame = 0; frame < FRAMES; ++frame)
+            QCOMPARE(buffer[frame], value(frame, track));
+    }
+    qDeleteAll(tracks);
+}
+
+QTEST_MAIN(TestWavDataWriter)
+#include "test_WavDataWriter.moc"
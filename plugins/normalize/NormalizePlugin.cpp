@@ -23,11 +23,9 @@
 #include <math.h>
 #include <new>
 
-#include <QFutureSynchronizer>
 #include <QList>
 #include <QStringList>
-#include <QThread>
-#include <QtConcurrentRun>
+#include <QtConcurrentMap>
 
 #include <KLocalizedString> // for the i18n macro
 
@@ -36,7 +34,10 @@
 #include "libkwave/MultiTrackReader.h"
 #include "libkwave/MultiTrackWriter.h"
 #include "libkwave/PluginManager.h"
+#include "libkwave/SampleArray.h"
+#include "libkwave/SampleReader.h"
 #include "libkwave/SignalManager.h"
+#include "libkwave/String.h"
 #include "libkwave/Utils.h"
 #include "libkwave/Writer.h"
 #include "libkwave/undo/UndoTransactionGuard.h"
@@ -50,12 +51,15 @@
 /** target volume level [dB] */
 #define TARGET_LEVEL -12
 
+/** number of blocks (10ms) per chunk of the parallel volume analysis */
+#define CHUNK_BLOCKS 1000
+
 KWAVE_PLUGIN(normalize, NormalizePlugin)
 
 //***************************************************************************
 Kwave::NormalizePlugin::NormalizePlugin(QObject *parent,
                                         const QVariantList &args)
-    :Kwave::Plugin(parent, args)
+    :Kwave::Plugin(parent, args), m_chunks_total(0), m_chunks_done(0)
 {
 }
 
@@ -78,22 +82,10 @@ void Kwave::NormalizePlugin::run(QStringList params)
     if (!length || tracks.isEmpty()) return;
 
     // get the current volume level
-    double level = 0.0;
-    {
-        Kwave::MultiTrackReader src(Kwave::SinglePassForward,
-            signalManager(), tracks, first, last);
-
-        // connect the progress dialog
-        connect(&src, SIGNAL(progress(qreal)),
-                this,  SLOT(updateProgress(qreal)),
-                Qt::BlockingQueuedConnection);
-
-        // detect the peak value
-        emit setProgressText(i18n("Analyzing volume level..."));
-//         qDebug("NormalizePlugin: getting peak...");
-        level = getMaxPower(src);
-//         qDebug("NormalizePlugin: level is %g", level);
-    }
+//     qDebug("NormalizePlugin: getting peak...");
+    const double level = getMaxPower(tracks, first, last);
+//     qDebug("NormalizePlugin: level is %g", level);
+    if (shouldStop() || (level <= 0.0)) return;
 
     Kwave::MultiTrackReader source(Kwave::SinglePassForward,
         signalManager(), tracks, first, last);
@@ -123,62 +115,103 @@ void Kwave::NormalizePlugin::run(QStringList params)
     emit setProgressText(i18n("Normalizing (%1 dB) ...",
         db.asprintf("%+0.1f", 20 * log10(gain))));
 
+    // measure the output with the same blocks as the analysis
+    const double rate = Kwave::FileInfo(signalManager().metaData()).rate();
+    const unsigned int window_size = Kwave::toUint(rate / 100);
+    for (unsigned int i = 0; i < normalizer.tracks(); ++i)
+        normalizer.at(i)->setWindowSize(window_size);
+
     normalizer.setAttribute(SLOT(setGain(QVariant)), QVariant(gain));
     while (!shouldStop() && !source.eof()) {
         source.goOn();
     }
 
     sink.flush();
+
+    // overwriting dropped the analysis result of the range, remember
+    // the level of the normalized samples instead, so that normalizing
+    // again does not need to analyze them
+    if (!shouldStop() && window_size) {
+        const QString key = analysisKey(window_size);
+        for (unsigned int i = 0; i < normalizer.tracks(); ++i) {
+            signalManager().cacheAnalysis(tracks[i], key, first, last,
+                smoothedMaxPower(normalizer.at(i)->blockPowers()));
+        }
+    }
 }
 
 //***************************************************************************
-double Kwave::NormalizePlugin::getMaxPower(Kwave::MultiTrackReader &source)
+double Kwave::NormalizePlugin::getMaxPower(const QVector<unsigned int> &tracks,
+                                           sample_index_t first,
+                                           sample_index_t last)
 {
-    double maxpow = 0.0;
-    const unsigned int tracks = source.tracks();
     const double rate = Kwave::FileInfo(signalManager().metaData()).rate();
     const unsigned int window_size = Kwave::toUint(rate / 100);
     if (!window_size) return 0;
 
-    // set up smoothing window buffer
-    QVector<Kwave::NormalizePlugin::Average> average(tracks);
-    for (unsigned int t = 0; t < tracks; t++) {
-        average[t].fifo = QVector<double>(SMOOTHLEN, double(0.0));
-        average[t].wp  = 0;
-        average[t].n   = 0;
-        average[t].sum = 0.0;
-        average[t].max = 0.0;
+    const QString key = analysisKey(window_size);
+
+    // take what is already known from the cache
+    double maxpow = 0.0;
+    QVector<unsigned int> uncached;
+    for (unsigned int track : tracks) {
+        double pow = 0.0;
+        if (signalManager().cachedAnalysis(track, key, first, last, pow))
+            maxpow = qMax(maxpow, pow);
+        else
+            uncached.append(track);
     }
 
-    while (!shouldStop() && !source.eof()) {
-        QFutureSynchronizer<void> synchronizer;
-
-        for (unsigned int t = 0; t < tracks; t++) {
-            Kwave::SampleReader *reader = source[t];
-            if (!reader) continue;
-            if (reader->eof()) continue;
-
-            synchronizer.addFuture(QtConcurrent::run(
-                &Kwave::NormalizePlugin::getMaxPowerOfTrack,
-                this,
-                reader, &(average[t]), window_size
-            ));
-        }
-        synchronizer.waitForFinished();
-     }
-
-    if (average[0].n < SMOOTHLEN) {
-        // if file was too short, calculate power out of what we have
-        for (unsigned int t = 0; t < tracks; t++) {
-            Kwave::NormalizePlugin::Average &avg = average[t];
-            double pow = avg.sum / static_cast<double>(avg.n);
-            if (pow > maxpow) maxpow = pow;
+    if (!uncached.isEmpty()) {
+        // split all remaining tracks into chunks of whole blocks, for
+        // getting the power of each block in parallel
+        const sample_index_t length = last - first + 1;
+        const sample_index_t blocks =
+            (length + window_size - 1) / window_size;
+        const sample_index_t chunk_length =
+            static_cast<sample_index_t>(window_size) * CHUNK_BLOCKS;
+
+        QVector<QVector<double> > power(uncached.count());
+        QVector<Kwave::NormalizePlugin::Chunk> chunks;
+        for (int index = 0; index < uncached.count(); ++index) {
+            power[index].resize(Kwave::toInt(blocks));
+            for (sample_index_t pos = first; pos <= last;
+                 pos += chunk_length)
+            {
+                Kwave::NormalizePlugin::Chunk chunk;
+                chunk.track = uncached[index];
+                chunk.first = pos;
+                chunk.last  = qMin(pos + chunk_length - 1, last);
+                chunk.power = power[index].data() +
+                    ((pos - first) / window_size);
+                chunks.append(chunk);
+                if (chunk.last == last) break;
+            }
         }
-    } else {
-        // get maximum among all tracks
-        for (unsigned int t = 0; t < tracks; t++) {
-            double p = average[t].max;
-            if (p > maxpow) maxpow = p;
+
+        // let the thread pool work through all chunks, whoever is idle
+        // takes the next one
+        emit setProgressText(i18n("Analyzing volume level..."));
+        connect(this, SIGNAL(analysisProgress(qreal)),
+                this, SLOT(updateProgress(qreal)),
+                Qt::QueuedConnection);
+        m_chunks_total = Kwave::toUint(chunks.count());
+        m_chunks_done  = 0;
+        QtConcurrent::blockingMap(chunks,
+            [this, window_size](Kwave::NormalizePlugin::Chunk &chunk) {
+                analyzeChunk(chunk, window_size);
+            }
+        );
+        disconnect(this, SIGNAL(analysisProgress(qreal)),
+                   this, SLOT(updateProgress(qreal)));
+        if (shouldStop()) return 0;
+
+        // smooth the block powers of each track and detect the maximum
+        for (int index = 0; index < uncached.count(); ++index) {
+            const double pow = smoothedMaxPower(power[index]);
+            signalManager().cacheAnalysis(uncached[index], key,
+                                          first, last, pow);
+            maxpow = qMax(maxpow, pow);
         }
     }
 
@@ -187,19 +220,56 @@ double Kwave::NormalizePlugin::getMaxPower(Kwave::MultiTrackReader &source)
 }
 
 //***************************************************************************
-void Kwave::NormalizePlugin::getMaxPowerOfTrack(
-    Kwave::SampleReader *reader,
-    Kwave::NormalizePlugin::Average *p_average,
+double Kwave::NormalizePlugin::smoothedMaxPower(const QVector<double> &power)
+{
+    QVector<double> fifo(SMOOTHLEN, double(0.0));
+    unsigned int wp  = 0;
+    unsigned int n   = 0;
+    double       sum = 0.0;
+    double       max = 0.0;
+    for (double pow : power) {
+        sum -= fifo[wp];
+        sum += pow;
+        fifo[wp] = pow;
+        if (++wp >= SMOOTHLEN) wp = 0;
+        if (n == SMOOTHLEN) {
+            // detect power peak
+            double p = sum / static_cast<double>(SMOOTHLEN);
+            if (p > max) max = p;
+        } else {
+            n++;
+        }
+    }
+
+    // if file was too short, calculate power out of what we have
+    return (n < SMOOTHLEN) ? ((n) ? (sum / static_cast<double>(n)) : 0.0) :
+                             max;
+}
+
+//***************************************************************************
+QString Kwave::NormalizePlugin::analysisKey(unsigned int window_size)
+{
+    // the result depends on the size of the blocks and the smoothing
+    return _("power/%1/%2").arg(window_size).arg(SMOOTHLEN);
+}
+
+//***************************************************************************
+void Kwave::NormalizePlugin::analyzeChunk(
+    const Kwave::NormalizePlugin::Chunk &chunk,
     unsigned int window_size)
 {
-    Kwave::NormalizePlugin::Average &average = *p_average;
-    Kwave::SampleArray data(window_size);
-    unsigned int round = 0;
-    unsigned int loops = 5 * reader->blockSize() / window_size;
-    loops++;
+    if (shouldStop()) return;
+
+    Kwave::SampleReader *reader = signalManager().openReader(
+        Kwave::SinglePassForward, chunk.track, chunk.first, chunk.last);
+    Q_ASSERT(reader);
+    if (!reader) return;
 
-    while ((round++ < loops) && !reader->eof()) {
+    Kwave::SampleArray data(window_size);
+    double *power = chunk.power;
+    while (!reader->eof() && !shouldStop()) {
         unsigned int len = reader->read(data, 0, window_size);
+        if (!len) break;
 
         // calculate power of one block
         double sum = 0;
@@ -209,24 +279,13 @@ void Kwave::NormalizePlugin::getMaxPowerOfTrack(
             double d   = sample2double(s);
             sum += (d * d);
         }
-        double pow = sum / static_cast<double>(len);
-
-        // collect all power values in a FIFO
-        unsigned int wp = average.wp;
-        average.sum -= average.fifo[wp];
-        average.sum += pow;
-        average.fifo[wp] = pow;
-        if (++wp >= SMOOTHLEN) wp = 0;
-        average.wp = wp;
-        if (average.n == SMOOTHLEN) {
-            // detect power peak
-            double p = average.sum / static_cast<double>(SMOOTHLEN);
-            if (p > average.max) average.max = p;
-        } else {
-            average.n++;
-        }
+        *(power++) = sum / static_cast<double>(len);
     }
-//     qDebug("%p -> pos=%llu, max=%g", this, reader->pos(), average.max);
+    delete reader;
+
+    const unsigned int done = ++m_chunks_done;
+    emit analysisProgress(100.0 * static_cast<qreal>(done) /
+                          static_cast<qreal>(m_chunks_total));
 }
 
 //***************************************************************************
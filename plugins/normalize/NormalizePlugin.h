@@ -23,6 +23,8 @@
 
 #include "config.h"
 
+#include <atomic>
+
 #include <QString>
 #include <QStringList>
 #include <QVector>
@@ -33,12 +35,13 @@
 
 namespace Kwave
 {
-    class MultiTrackReader;
-    class SampleReader;
 
     /**
      * This is a two-pass plugin that determines the average volume level
      * of a signal and then calls the volume plugin to adjust the volume.
+     * The volume analysis runs in parallel over chunks of all tracks,
+     * its result is cached per track, so that the analysis pass is
+     * skipped if the selected range did not change since the last time.
      */
     class NormalizePlugin: public Kwave::Plugin
     {
@@ -62,30 +65,69 @@ namespace Kwave
          */
         void run(QStringList params) override;
 
+    signals:
+
+        /**
+         * emitted from the worker threads of the volume analysis
+         * @param progress the current progress in percent [0...100]
+         */
+        void analysisProgress(qreal progress);
+
     private:
+
+        /** a range of one track, a work item of the volume analysis */
         typedef struct {
-            QVector<double> fifo; /**< FIFO for power values */
-            unsigned int    wp;   /**< FIFO write pointer */
-            unsigned int    n;    /**< number of elements in the FIFO */
-            double          sum;  /**< sum of queued power values */
-            double          max;  /**< maximum power value */
-        } Average;
+            unsigned int   track; /**< index of the track */
+            sample_index_t first; /**< index of the first sample */
+            sample_index_t last;  /**< index of the last sample */
+            double        *power; /**< receives the power of each block */
+        } Chunk;
+
+        /**
+         * get the maximum power level of the selection, either from the
+         * cache of the tracks or by analyzing them
+         * @param tracks list of track indices
+         * @param first index of the first sample
+         * @param last index of the last sample
+         * @return peak of the smoothed RMS level, zero if aborted
+         */
+        double getMaxPower(const QVector<unsigned int> &tracks,
+                           sample_index_t first, sample_index_t last);
 
         /**
-         * get the maximum power level of the input
+         * calculate the power of all blocks within one chunk
+         *
+         * @param chunk the range to analyze
+         * @param window_size length of a block for volume detection
+         */
+        void analyzeChunk(const Kwave::NormalizePlugin::Chunk &chunk,
+                          unsigned int window_size);
+
+        /**
+         * smooth the powers of a sequence of blocks with a sliding window
+         * and detect the maximum
+         *
+         * @param power list with the power of each block
+         * @return peak of the smoothed power
          */
-        double getMaxPower(Kwave::MultiTrackReader &source);
+        static double smoothedMaxPower(const QVector<double> &power);
 
         /**
-         * calculate the maximum power of one track
+         * returns the key of the volume analysis in the cache of the
+         * tracks, the result depends on the size of the blocks and the
+         * smoothing
          *
-         * @param reader reference to a SampleReader to read from
-         * @param average reference to smoothing information
-         * @param window_size length of the sliding window for volume detection
+         * @param window_size length of a block for volume detection
          */
-        void getMaxPowerOfTrack(Kwave::SampleReader *reader,
-                                Kwave::NormalizePlugin::Average *average,
-                                unsigned int window_size);
+        static QString analysisKey(unsigned int window_size);
+
+    private:
+
+        /** number of chunks of the running analysis */
+        unsigned int m_chunks_total;
+
+        /** number of chunks that have already been analyzed */
+        std::atomic<unsigned int> m_chunks_done;
 
     };
 }
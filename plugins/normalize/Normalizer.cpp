@@ -28,7 +28,8 @@
 
 //***************************************************************************
 Kwave::Normalizer::Normalizer()
-    :Kwave::SampleSource(nullptr), m_gain(1.0), m_limit(0.5)
+    :Kwave::SampleSource(nullptr), m_gain(1.0), m_limit(0.5),
+     m_window(0), m_sum(0.0), m_count(0), m_powers()
 {
 }
 
@@ -82,9 +83,39 @@ void Kwave::Normalizer::input(Kwave::SampleArray &data)
         data[i] = double2sample(s);
     }
 
+    // measure the power of what really gets written
+    if (m_window) {
+        for (unsigned int i = 0; i < len; i++) {
+            const double d = sample2double(data[i]);
+            m_sum += (d * d);
+            if (++m_count == m_window) {
+                m_powers.append(m_sum / static_cast<double>(m_window));
+                m_sum   = 0.0;
+                m_count = 0;
+            }
+        }
+    }
+
     output(data);
 }
 
+//***************************************************************************
+void Kwave::Normalizer::setWindowSize(unsigned int window)
+{
+    m_window = window;
+    m_sum    = 0.0;
+    m_count  = 0;
+    m_powers.clear();
+}
+
+//***************************************************************************
+QVector<double> Kwave::Normalizer::blockPowers() const
+{
+    QVector<double> powers(m_powers);
+    if (m_count) powers.append(m_sum / static_cast<double>(m_count));
+    return powers;
+}
+
 //***************************************************************************
 void Kwave::Normalizer::setGain(const QVariant g)
 {
@@ -25,6 +25,7 @@
 
 #include <QObject>
 #include <QVariant>
+#include <QVector>
 
 #include "libkwave/SampleArray.h"
 #include "libkwave/SampleSource.h"
@@ -49,6 +50,20 @@ namespace Kwave
         /** receives input data */
         void input(Kwave::SampleArray &data) override;
 
+        /**
+         * Enables measuring the power of the output, in blocks of a
+         * given length, starting with the first sample
+         * @param window length of a block [samples], zero to disable
+         */
+        void setWindowSize(unsigned int window);
+
+        /**
+         * Returns the power of each block of the output, including the
+         * incomplete last block
+         * @see setWindowSize
+         */
+        QVector<double> blockPowers() const;
+
     public slots:
 
         /**
@@ -72,6 +87,18 @@ namespace Kwave
         /** limiter level */
         double m_limit;
 
+        /** length of a block for measuring the output power */
+        unsigned int m_window;
+
+        /** sum of squares of the current block */
+        double m_sum;
+
+        /** number of samples in the current block */
+        unsigned int m_count;
+
+        /** power of each complete block of the output */
+        QVector<double> m_powers;
+
     };
 }
 
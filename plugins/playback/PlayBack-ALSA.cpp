@@ -39,9 +39,9 @@
 #include "libkwave/Compression.h"
 #include "libkwave/SampleEncoderLinear.h"
 #include "libkwave/SampleFormat.h"
+#include "libkwave/SampleKernels.h"
 #include "libkwave/String.h"
 #include "libkwave/Utils.h"
-#include "libkwave/memcpy.h"
 
 #include "PlayBack-ALSA.h"
 
@@ -204,7 +204,9 @@ Kwave::PlayBackALSA::PlayBackALSA()
     m_format(),
     m_chunk_size(0),
     m_supported_formats(),
-    m_encoder(nullptr)
+    m_encoder(nullptr),
+    m_interleaved(),
+    m_block_src()
 {
 }
 
@@ -605,6 +607,12 @@ QString Kwave::PlayBackALSA::open(const QString &device, double rate,
     m_buffer.resize(m_buffer_size);
     m_buffer_size = static_cast<unsigned int>(m_buffer.size());
 
+    // room for interleaving a whole buffer
+    if (!m_interleaved.resize((m_buffer_size / m_bytes_per_sample) *
+                              m_channels))
+        return i18n("Out of memory");
+    m_block_src.resize(m_channels);
+
 //     qDebug("PlayBackALSA::open: OK, buffer resized to %u bytes",
 //            m_buffer_size);
 
@@ -626,9 +634,8 @@ int Kwave::PlayBackALSA::write(const Kwave::SampleArray &samples)
         return -EIO;
     }
 
-    QByteArray raw(bytes, char(0));
-    m_encoder->encode(samples, m_channels, raw);
-    MEMCPY(m_buffer.data() + m_buffer_used, raw.constData(), bytes);
+    m_encoder->encode(samples.constData(), m_channels,
+        reinterpret_cast<quint8 *>(m_buffer.data()) + m_buffer_used);
     m_buffer_used += bytes;
 
     // write buffer to device if full
@@ -637,6 +644,49 @@ int Kwave::PlayBackALSA::write(const Kwave::SampleArray &samples)
     return 0;
 }
 
+//***************************************************************************
+int Kwave::PlayBackALSA::writeBlock(
+    const QVector<Kwave::SampleArray> &channels, unsigned int length)
+{
+    Q_ASSERT(m_encoder);
+    if (!m_encoder || !m_bytes_per_sample) return -EIO;
+    Q_ASSERT(Kwave::toUint(channels.count()) >= m_channels);
+    if (Kwave::toUint(channels.count()) < m_channels) return -EINVAL;
+
+    unsigned int offset = 0;
+    while (offset < length) {
+        // as many frames as fit into the rest of the buffer
+        const unsigned int room =
+            (m_buffer_size - m_buffer_used) / m_bytes_per_sample;
+        const unsigned int count = qMin(length - offset, room);
+        Q_ASSERT(count);
+        if (!count) return -EIO;
+
+        for (unsigned int c = 0; c < m_channels; ++c)
+            m_block_src[c] = channels[c].constData() + offset;
+        Kwave::SampleKernels::interleave(m_block_src.constData(),
+            m_channels, count, m_interleaved.data());
+        m_encoder->encode(m_interleaved.constData(), count * m_channels,
+            reinterpret_cast<quint8 *>(m_buffer.data()) + m_buffer_used);
+        m_buffer_used += count * m_bytes_per_sample;
+        offset        += count;
+
+        // write buffer to device if full
+        if (m_buffer_used >= m_buffer_size) {
+            int result = flush();
+            if (result) return result;
+        }
+    }
+
+    return 0;
+}
+
+//***************************************************************************
+unsigned int Kwave::PlayBackALSA::periodSize() const
+{
+    return Kwave::toUint(m_chunk_size);
+}
+
 //***************************************************************************
 int Kwave::PlayBackALSA::flush()
 {
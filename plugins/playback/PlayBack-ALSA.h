@@ -33,6 +33,7 @@
 #include <QList>
 #include <QMap>
 #include <QString>
+#include <QVector>
 
 #include "libkwave/PlayBackDevice.h"
 #include "libkwave/SampleArray.h"
@@ -66,6 +67,20 @@ namespace Kwave
          */
         int write(const Kwave::SampleArray &samples) override;
 
+        /**
+         * Writes a block of samples, encoded directly into the buffer
+         * of the device.
+         * @see PlayBackDevice::writeBlock
+         */
+        virtual int writeBlock(const QVector<Kwave::SampleArray> &channels,
+                               unsigned int length) override;
+
+        /**
+         * Returns the period size of the device
+         * @see PlayBackDevice::periodSize
+         */
+        unsigned int periodSize() const override;
+
         /**
          * Closes the output device.
          * @see PlayBackDevice::close
@@ -231,6 +246,12 @@ namespace Kwave
         /** encoder for conversion from samples to raw */
         Kwave::SampleEncoder *m_encoder;
 
+        /** interleaved samples of one block, up to one buffer */
+        Kwave::SampleArray m_interleaved;
+
+        /** pointers to the current position within each channel */
+        QVector<const sample_t *> m_block_src;
+
     };
 }
 
@@ -39,6 +39,7 @@
 #include "libkwave/ByteOrder.h"
 #include "libkwave/Compression.h"
 #include "libkwave/SampleEncoderLinear.h"
+#include "libkwave/SampleKernels.h"
 #include "libkwave/String.h"
 #include "libkwave/Utils.h"
 #include "libkwave/memcpy.h"
@@ -99,6 +100,7 @@ Kwave::PlayBackOSS::PlayBackOSS()
     m_buffer_size(0),
     m_buffer_used(0),
     m_encoder(nullptr),
+    m_block_src(),
     m_oss_version(-1)
 {
 }
@@ -254,6 +256,7 @@ QString Kwave::PlayBackOSS::open(const QString &device, double rate,
     m_buffer_size /= m_encoder->rawBytesPerSample();
     if (!m_buffer.resize(m_buffer_size))
         return i18n("Out of memory");
+    m_block_src.resize(m_channels);
 
     return QString();
 }
@@ -292,6 +295,43 @@ int Kwave::PlayBackOSS::write(const Kwave::SampleArray &samples)
     return 0;
 }
 
+//***************************************************************************
+int Kwave::PlayBackOSS::writeBlock(const QVector<Kwave::SampleArray> &channels,
+                                  unsigned int length)
+{
+    if (!m_encoder || !m_channels || (m_buffer_size < m_channels))
+        return -EIO;
+    Q_ASSERT(Kwave::toUint(channels.count()) >= m_channels);
+    if (Kwave::toUint(channels.count()) < m_channels) return -EINVAL;
+
+    unsigned int offset = 0;
+    while (offset < length) {
+        // as many frames as fit into the rest of the buffer
+        const unsigned int room = (m_buffer_size - m_buffer_used) / m_channels;
+        const unsigned int count = qMin(length - offset, room);
+        if (count) {
+            for (unsigned int c = 0; c < m_channels; ++c)
+                m_block_src[c] = channels[c].constData() + offset;
+            Kwave::SampleKernels::interleave(m_block_src.constData(),
+                m_channels, count, m_buffer.data() + m_buffer_used);
+            m_buffer_used += count * m_channels;
+            offset        += count;
+        }
+
+        // write buffer to device if no further frame fits into it
+        if (m_buffer_used + m_channels > m_buffer_size)
+            flush();
+    }
+
+    return 0;
+}
+
+//***************************************************************************
+unsigned int Kwave::PlayBackOSS::periodSize() const
+{
+    return (m_channels) ? (m_buffer_size / m_channels) : 0;
+}
+
 //***************************************************************************
 void Kwave::PlayBackOSS::flush()
 {
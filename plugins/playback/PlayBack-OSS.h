@@ -24,6 +24,7 @@
 #include <QByteArray>
 #include <QList>
 #include <QString>
+#include <QVector>
 
 #include "libkwave/PlayBackDevice.h"
 #include "libkwave/SampleArray.h"
@@ -58,6 +59,20 @@ namespace Kwave
          */
         int write(const Kwave::SampleArray &samples) override;
 
+        /**
+         * Writes a block of samples, interleaved directly into the
+         * buffer of the device.
+         * @see PlayBackDevice::writeBlock
+         */
+        virtual int writeBlock(const QVector<Kwave::SampleArray> &channels,
+                               unsigned int length) override;
+
+        /**
+         * Returns the fragment size of the device
+         * @see PlayBackDevice::periodSize
+         */
+        unsigned int periodSize() const override;
+
         /**
          * Closes the output device.
          * @see PlayBackDevice::close
@@ -156,6 +171,9 @@ namespace Kwave
         /** encoder for converting from samples to raw format */
         Kwave::SampleEncoder *m_encoder;
 
+        /** pointers to the current position within each channel */
+        QVector<const sample_t *> m_block_src;
+
         /** OSS driver version */
         int m_oss_version;
     };
@@ -37,6 +37,7 @@
 #include <KUser>
 
 #include "libkwave/FileInfo.h"
+#include "libkwave/SampleKernels.h"
 #include "libkwave/String.h"
 #include "libkwave/Utils.h"
 #include "libkwave/memcpy.h"
@@ -85,6 +86,7 @@ Kwave::PlayBackPulseAudio::PlayBackPulseAudio(const Kwave::FileInfo &info)
      m_buffer(nullptr),
      m_buffer_size(0),
      m_buffer_used(0),
+     m_block_src(),
      m_bufbase(10),
      m_pa_proplist(nullptr),
      m_pa_mainloop(nullptr),
@@ -596,19 +598,8 @@ int Kwave::PlayBackPulseAudio::write(const Kwave::SampleArray &samples)
     if (!m_bytes_per_sample || !m_pa_mainloop)
         return -EINVAL;
 
-    // check buffer existence and size changes
-    size_t current_buffer_size = (1 << m_bufbase) * m_bytes_per_sample;
-    if (!m_buffer || (m_buffer_size != current_buffer_size)) {
-
-        // get a buffer from heap (malloc once at the start is fast enough)
-        m_buffer      = (m_buffer) ? realloc(m_buffer, current_buffer_size) :
-                                     malloc(current_buffer_size);
-        m_buffer_size = current_buffer_size;
-    }
-
     // abort with out-of-memory if failed
-    Q_ASSERT(m_buffer);
-    if (!m_buffer || !m_buffer_size)
+    if (!allocateBuffer())
         return -ENOMEM;
 
     Q_ASSERT (m_buffer_used + bytes <= m_buffer_size);
@@ -630,6 +621,73 @@ int Kwave::PlayBackPulseAudio::write(const Kwave::SampleArray &samples)
     return 0;
 }
 
+//***************************************************************************
+int Kwave::PlayBackPulseAudio::writeBlock(
+    const QVector<Kwave::SampleArray> &channels, unsigned int length)
+{
+    Q_ASSERT(m_bytes_per_sample);
+    Q_ASSERT(m_pa_mainloop);
+    if (!m_bytes_per_sample || !m_pa_mainloop)
+        return -EINVAL;
+    if (!allocateBuffer())
+        return -ENOMEM;
+
+    // the stream is opened with native samples, no encoding is needed
+    const unsigned int tracks = m_bytes_per_sample / sizeof(sample_t);
+    Q_ASSERT(Kwave::toUint(channels.count()) >= tracks);
+    if (Kwave::toUint(channels.count()) < tracks) return -EINVAL;
+    if (Kwave::toUint(m_block_src.size()) != tracks)
+        m_block_src.resize(tracks);
+
+    unsigned int offset = 0;
+    while (offset < length) {
+        // as many frames as fit into the rest of the buffer
+        const unsigned int room = Kwave::toUint(
+            (m_buffer_size - m_buffer_used) / m_bytes_per_sample);
+        const unsigned int count = qMin(length - offset, room);
+        if (count) {
+            for (unsigned int c = 0; c < tracks; ++c)
+                m_block_src[c] = channels[c].constData() + offset;
+            Kwave::SampleKernels::interleave(m_block_src.constData(),
+                tracks, count, reinterpret_cast<sample_t *>(
+                reinterpret_cast<quint8 *>(m_buffer) + m_buffer_used));
+            m_buffer_used += count * m_bytes_per_sample;
+            offset        += count;
+        }
+
+        // write the buffer if it is full
+        if (m_buffer_used + m_bytes_per_sample > m_buffer_size) {
+            int result = flush();
+            if (result < 0) return result;
+        }
+    }
+
+    return 0;
+}
+
+//***************************************************************************
+unsigned int Kwave::PlayBackPulseAudio::periodSize() const
+{
+    return (1U << m_bufbase);
+}
+
+//***************************************************************************
+bool Kwave::PlayBackPulseAudio::allocateBuffer()
+{
+    // check buffer existence and size changes
+    size_t current_buffer_size = (1 << m_bufbase) * m_bytes_per_sample;
+    if (!m_buffer || (m_buffer_size != current_buffer_size)) {
+
+        // get a buffer from heap (malloc once at the start is fast enough)
+        m_buffer      = (m_buffer) ? realloc(m_buffer, current_buffer_size) :
+                                     malloc(current_buffer_size);
+        m_buffer_size = current_buffer_size;
+    }
+
+    Q_ASSERT(m_buffer);
+    return (m_buffer && m_buffer_size);
+}
+
 //***************************************************************************
 int Kwave::PlayBackPulseAudio::flush()
 {
@@ -35,6 +35,7 @@
 #include <QMap>
 #include <QMutex>
 #include <QString>
+#include <QVector>
 #include <QWaitCondition>
 
 #include "libkwave/FileInfo.h"
@@ -73,6 +74,20 @@ namespace Kwave
          */
         int write(const Kwave::SampleArray &samples) override;
 
+        /**
+         * Writes a block of samples, interleaved directly into the
+         * buffer of the stream.
+         * @see PlayBackDevice::writeBlock
+         */
+        virtual int writeBlock(const QVector<Kwave::SampleArray> &channels,
+                               unsigned int length) override;
+
+        /**
+         * Returns the number of frames in the buffer of the stream
+         * @see PlayBackDevice::periodSize
+         */
+        unsigned int periodSize() const override;
+
         /**
          * Closes the output device.
          * @see PlayBackDevice::close
@@ -121,6 +136,12 @@ namespace Kwave
         /** Writes the output buffer to the device */
         int flush();
 
+        /**
+         * Allocates the output buffer or adjusts its size
+         * @return true if succeeded, false if out of memory
+         */
+        bool allocateBuffer();
+
         /** re-implementation of the threaded mainloop of PulseAudio */
         void run_wrapper(const QVariant &params) override;
 
@@ -269,6 +290,9 @@ namespace Kwave
         /** number of bytes in the buffer */
         size_t m_buffer_used;
 
+        /** source pointers of the tracks, used by writeBlock() */
+        QVector<const sample_t *> m_block_src;
+
         /**
          * exponent of the buffer size,
          * buffer size should be (1 << m_bufbase)
@@ -35,8 +35,10 @@
 #include <KLocalizedString>
 
 #include "libkwave/SampleEncoderLinear.h"
+#include "libkwave/SampleKernels.h"
 #include "libkwave/String.h"
 #include "libkwave/Utils.h"
+#include "libkwave/memcpy.h"
 
 #include "PlayBack-Qt.h"
 
@@ -53,7 +55,12 @@ Kwave::PlayBackQt::PlayBackQt()
      m_buffer_size(0),
      m_encoder(nullptr),
      m_buffer(),
-     m_one_frame()
+     m_one_frame(),
+     m_block(),
+     m_block_raw(),
+     m_block_raw_size(0),
+     m_block_raw_written(0),
+     m_block_src()
 {
 }
 
@@ -233,6 +240,54 @@ int Kwave::PlayBackQt::write(const Kwave::SampleArray &samples)
     return (written == m_one_frame.size()) ? 0 : -EAGAIN;
 }
 
+//***************************************************************************
+int Kwave::PlayBackQt::writeBlock(const QVector<Kwave::SampleArray> &channels,
+                                  unsigned int length)
+{
+    {
+        QMutexLocker _lock(&m_lock); // context: worker thread
+
+        if (!m_encoder || !m_output) return -EIO;
+
+        // the rest of a block that has been written only partially
+        // is still pending, the caller repeats the call with that block
+        if (!m_block_raw_written) {
+            const unsigned int tracks =
+                Kwave::toUint(m_output->format().channelCount());
+            Q_ASSERT(Kwave::toUint(channels.count()) >= tracks);
+            if (Kwave::toUint(channels.count()) < tracks) return -EINVAL;
+
+            // interleave and encode the whole block at once
+            const unsigned int samples = length * tracks;
+            if ((m_block.size() < samples) && !m_block.resize(samples))
+                return -ENOMEM;
+            m_block_raw_size = samples * m_encoder->rawBytesPerSample();
+            if (m_block_raw.size() < m_block_raw_size)
+                m_block_raw.resize(m_block_raw_size);
+            if (Kwave::toUint(m_block_src.size()) != tracks)
+                m_block_src.resize(tracks);
+
+            for (unsigned int c = 0; c < tracks; ++c)
+                m_block_src[c] = channels[c].constData();
+            Kwave::SampleKernels::interleave(m_block_src.constData(), tracks,
+                                             length, m_block.data());
+            m_encoder->encode(m_block.constData(), samples,
+                reinterpret_cast<quint8 *>(m_block_raw.data()));
+        }
+    }
+
+    const qint64 remaining = m_block_raw_size - m_block_raw_written;
+    qint64 written = m_buffer.writeData(
+        m_block_raw.constData() + m_block_raw_written, remaining);
+    if (written < remaining) {
+        m_block_raw_written += written;
+        return -EAGAIN;
+    }
+
+    m_block_raw_written = 0;
+    return 0;
+}
+
 //***************************************************************************
 void Kwave::PlayBackQt::stateChanged(QAudio::State state)
 {
@@ -332,6 +387,9 @@ int Kwave::PlayBackQt::close()
     delete m_encoder;
     m_encoder = nullptr;
 
+    m_block_raw_size    = 0;
+    m_block_raw_written = 0;
+
     m_device_name_map.clear();
     m_available_devices.clear();
 
@@ -556,18 +614,30 @@ qint64 Kwave::PlayBackQt::Buffer::readData(char *data, qint64 len)
 qint64 Kwave::PlayBackQt::Buffer::writeData(const char *data, qint64 len)
 {
     const qsizetype maxlen = m_raw_buffer.size();
-    for (qint64 remaining = len; remaining; remaining--) {
-        if (Q_LIKELY(m_sem_free.tryAcquire(1, m_timeout))) {
-            m_raw_buffer[m_wp] = *(data++);
-            if (Q_UNLIKELY(++m_wp >= maxlen)) m_wp = 0;
-            m_sem_filled.release(1);
-        } else {
+    qint64 remaining = len;
+    while (remaining) {
+        // wait for some free space, then take all that is available
+        if (Q_UNLIKELY(!m_sem_free.tryAcquire(1, m_timeout))) {
             qDebug("PlayBackQt::Buffer::writeData() - TIMEOUT");
-            return 0;
+            break;
         }
+        qint64 count = qMin<qint64>(remaining, 1 + m_sem_free.available());
+        if (count > 1) m_sem_free.acquire(Kwave::toInt(count - 1));
+
+        // copy in at most two parts, with wrap-around at the end
+        for (qint64 left = count; left; ) {
+            const qint64 part = qMin<qint64>(left, maxlen - m_wp);
+            MEMCPY(m_raw_buffer.data() + m_wp, data, part);
+            data += part;
+            left -= part;
+            m_wp += part;
+            if (m_wp >= maxlen) m_wp = 0;
+        }
+        m_sem_filled.release(Kwave::toInt(count));
+        remaining -= count;
     }
     QThread::yieldCurrentThread();
-    return len;
+    return len - remaining;
 }
 
 //***************************************************************************
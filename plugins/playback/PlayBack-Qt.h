@@ -32,6 +32,7 @@
 #include <QRecursiveMutex>
 #include <QSemaphore>
 #include <QString>
+#include <QVector>
 
 #include "libkwave/PlayBackDevice.h"
 #include "libkwave/SampleArray.h"
@@ -69,6 +70,14 @@ namespace Kwave
          */
         int write(const Kwave::SampleArray &samples) override;
 
+        /**
+         * Writes a block of samples, encoded as a whole into the
+         * buffer of the Qt playback engine.
+         * @see PlayBackDevice::writeBlock
+         */
+        virtual int writeBlock(const QVector<Kwave::SampleArray> &channels,
+                               unsigned int length) override;
+
         /**
          * Closes the output device.
          * @see PlayBackDevice::close
@@ -248,6 +257,24 @@ namespace Kwave
 
         /** internal buffer for encoding one frame */
         QByteArray m_one_frame;
+
+        /** interleaved samples of a block, used by writeBlock() */
+        Kwave::SampleArray m_block;
+
+        /** internal buffer for encoding one block */
+        QByteArray m_block_raw;
+
+        /** number of bytes of m_block_raw that belong to the current block */
+        qsizetype m_block_raw_size;
+
+        /**
+         * number of bytes of the current block that already have been
+         * written, non-zero if the last writeBlock() was incomplete
+         */
+        qsizetype m_block_raw_written;
+
+        /** source pointers of the tracks, used by writeBlock() */
+        QVector<const sample_t *> m_block_src;
     };
 }
 
@@ -55,8 +55,7 @@ static const float F_PEAK_DECAY = (0.005f);
 //***************************************************************************
 Kwave::LevelMeter::LevelMeter(QWidget *parent)
     :QWidget(parent),
-    m_tracks(0), m_sample_rate(0), m_yf(), m_yp(),
-    m_fast_queue(), m_peak_queue(),
+    m_tracks(0), m_fast_queue(), m_peak_queue(),
     m_current_fast(), m_current_peak(), m_timer(),
     m_color_low(Qt::green),
     m_color_normal(Qt::yellow),
@@ -96,55 +95,56 @@ void Kwave::LevelMeter::setTracks(unsigned int tracks)
 }
 
 //***************************************************************************
-void Kwave::LevelMeter::setSampleRate(double rate)
+unsigned int Kwave::LevelMeter::updatesPerBlock(unsigned int samples,
+                                                float rate)
 {
-    if (qFuzzyCompare(static_cast<float>(rate), m_sample_rate)) return;
-    m_sample_rate = static_cast<float>(rate);
+    const unsigned int samples_per_update = qMax(1U, Kwave::toUint(
+        rintf(ceilf(rate / UPDATES_PER_SECOND))));
+    return qMax(1U, samples / samples_per_update);
 }
 
 //***************************************************************************
-void Kwave::LevelMeter::updateTrack(unsigned int track,
-                                    const Kwave::SampleArray &buffer)
+void Kwave::LevelMeter::analyze(const Kwave::SampleArray &buffer, float rate,
+                                float &yf, float &yp,
+                                float *fast, float *peak)
 {
-    Q_ASSERT(Kwave::toInt(track) < m_tracks);
-    if (Kwave::toInt(track) >= m_tracks) return;
-
-    // calculate the number of samples per update (approx)
+    // split the buffer into parts of equal size, the last one gets
+    // the fractional rest
     const unsigned int samples = buffer.size();
-    const unsigned int samples_per_update = Kwave::toUint(
-        rintf(ceilf(m_sample_rate / UPDATES_PER_SECOND)));
-    unsigned int next_fraction = samples_per_update;
-    const unsigned int queue_depth = ((samples / samples_per_update) + 2);
+    const unsigned int updates = updatesPerBlock(samples, rate);
+    const unsigned int samples_per_update = samples / updates;
+    unsigned int next_update = samples_per_update;
+    if (!samples) return;
 
     /* fast update: rise */
-    float Fg = F_FAST_RISE / m_sample_rate;
+    float Fg = F_FAST_RISE / rate;
     float n = 1.0f / tanf(float(M_PI) * Fg);
     const float a0_fr = 1.0f / (1.0f + n);
     const float b1_fr = (1.0f - n) / (1.0f + n);
 
     /* fast update: decay */
-    Fg = F_FAST_DECAY / m_sample_rate;
+    Fg = F_FAST_DECAY / rate;
     n = 1.0f / tanf(float(M_PI) * Fg);
     const float a0_fd = 1.0f / (1.0f + n);
     const float b1_fd = (1.0f - n) / (1.0f + n);
 
     /* peak value: rise */
-    Fg = F_PEAK_RISE / m_sample_rate;
+    Fg = F_PEAK_RISE / rate;
     n = 1.0f / tanf(float(M_PI) * Fg);
     const float a0_pr = 1.0f / (1.0f + n);
     const float b1_pr = (1.0f - n) / (1.0f + n);
 
     /* peak value: decay */
-    Fg = F_PEAK_DECAY / m_sample_rate;
+    Fg = F_PEAK_DECAY / rate;
     n = 1.0f / tanf(float(M_PI) * Fg);
     const float a0_pd = 1.0f / (1.0f + n);
     const float b1_pd = (1.0f - n) / (1.0f + n);
 
-    float yf = m_yf[track];
-    float yp = m_yp[track];
+    const sample_t *in = buffer.constData();
     float last_x = yf;
+    unsigned int update = 0;
     for (unsigned int t = 0; t < samples; ++t) {
-        float x = fabsf(sample2float(buffer[t])); /* rectifier */
+        float x = fabsf(sample2float(in[t])); /* rectifier */
 
         /* fast value */
         if (x > yf) yf = (a0_fr * x) + (a0_fr * last_x) - (b1_fr * yf); // rise
@@ -157,19 +157,33 @@ void Kwave::LevelMeter::updateTrack(unsigned int track,
         // remember x[t-1]
         last_x = x;
 
-        // enqueue new values if limit reached
-        if ((t > next_fraction) || (t == samples-1)) {
-            next_fraction += samples_per_update;
-
-            // merge the last fractional part to the last normal part
-            if ((next_fraction + samples_per_update) > samples)
-               next_fraction = samples-1;
+        // store new values if limit reached
+        if ((t + 1 == next_update) || (t == samples - 1)) {
+            if (update < updates) {
+                fast[update] = yf;
+                peak[update] = yp;
+                update++;
+            }
+            next_update += samples_per_update;
+            if (update == updates - 1) next_update = samples;
+        }
+    }
+}
 
-            enqueue(track, yf, yp, queue_depth);
+//***************************************************************************
+void Kwave::LevelMeter::updateLevels(const QVector<float> &fast,
+                                     const QVector<float> &peak)
+{
+    Q_ASSERT(fast.size() == peak.size());
+    if (!m_tracks || (fast.size() != peak.size())) return;
+
+    const unsigned int updates = Kwave::toUint(fast.size() / m_tracks);
+    for (int track = 0; track < m_tracks; ++track) {
+        for (unsigned int i = 0; i < updates; ++i) {
+            const unsigned int index = (track * updates) + i;
+            enqueue(track, fast[index], peak[index], updates + 2);
         }
     }
-    m_yf[track] = yf;
-    m_yp[track] = yp;
 }
 
 //***************************************************************************
@@ -177,14 +191,10 @@ void Kwave::LevelMeter::reset()
 {
     if (m_timer && m_timer->isActive()) m_timer->stop();
 
-    m_yf.resize(m_tracks);
-    m_yf.fill(0.0);
     m_fast_queue.resize(m_tracks);
     m_current_fast.resize(m_tracks);
     m_current_fast.fill(0.0);
 
-    m_yp.resize(m_tracks);
-    m_yp.fill(0.0);
     m_peak_queue.resize(m_tracks);
     m_current_peak.resize(m_tracks);
     m_current_peak.fill(0.0);
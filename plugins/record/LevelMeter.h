@@ -51,24 +51,40 @@ namespace Kwave
         /** @see QWidget::resizeEvent */
         void resizeEvent(QResizeEvent *) override;
 
+        /**
+         * Returns the number of level values that analyze() produces
+         * for a block of samples
+         * @param samples number of samples in the block
+         * @param rate sample rate
+         */
+        static unsigned int updatesPerBlock(unsigned int samples, float rate);
+
+        /**
+         * Passes a block of samples through the level filters, does not
+         * touch the display and may be called from any thread
+         * @param buffer array with samples
+         * @param rate sample rate
+         * @param yf last output value of the fast filter, will be updated
+         * @param yp last output value of the peak filter, will be updated
+         * @param fast receives the fast levels, one per display update
+         * @param peak receives the peak levels, one per display update
+         * @see updatesPerBlock
+         */
+        static void analyze(const Kwave::SampleArray &buffer, float rate,
+                            float &yf, float &yp, float *fast, float *peak);
+
     public slots:
 
         /** sets the number of tracks that the display should use */
         virtual void setTracks(unsigned int tracks);
 
         /**
-         * sets the sample rate for interpreting the samples used
-         * for updating the display.
+         * Updates all tracks with levels calculated by analyze()
+         * @param fast fast levels of all tracks, one track after the other
+         * @param peak peak levels of all tracks, in the same order
          */
-        virtual void setSampleRate(double rate);
-
-        /**
-         * Updates a apecific track
-         * @param track index of the track
-         * @param buffer array with samples
-         */
-        virtual void updateTrack(unsigned int track,
-                                 const Kwave::SampleArray &buffer);
+        virtual void updateLevels(const QVector<float> &fast,
+                                  const QVector<float> &peak);
 
         /**
          * Resets all meters to zero
@@ -124,15 +140,6 @@ namespace Kwave
         /** number of tracks */
         int m_tracks;
 
-        /** sample rate used for interpreting the received buffers */
-        float m_sample_rate;
-
-        /** last output value of the filter for fast updates */
-        QVector<float> m_yf;
-
-        /** last output value of the filter for peak updates */
-        QVector<float> m_yp;
-
         /** queues with fast update values for each track */
         QVector< QQueue<float> > m_fast_queue;
 
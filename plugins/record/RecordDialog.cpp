@@ -25,6 +25,7 @@
 #include <QIcon>
 #include <QLabel>
 #include <QLatin1Char>
+#include <QLineEdit>
 #include <QPixmap>
 #include <QPointer>
 #include <QProgressBar>
@@ -36,6 +37,7 @@
 #include <QTreeView>
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
+#include <QUrl>
 #include <QVector>
 
 #include <KComboBox>
@@ -136,6 +138,12 @@ Kwave::RecordDialog::RecordDialog(QWidget *parent, QStringList &params,
     // record time (duration)
     STD_SETUP(record_time_limited, record_time, RecordTime)
 
+    // record file
+    chkRecordFile->setChecked(m_params.record_file_enabled);
+    edRecordFile->setText(m_params.record_file);
+    edRecordFile->setEnabled(m_params.record_file_enabled);
+    btRecordFile->setEnabled(m_params.record_file_enabled);
+
     // start time (date & time)
     chkRecordStartTime->setChecked(m_params.start_time_enabled);
     startTime->setDateTime(m_params.start_time);
@@ -201,6 +209,13 @@ Kwave::RecordDialog::RecordDialog(QWidget *parent, QStringList &params,
     connect(sbRecordTime, SIGNAL(valueChanged(int)),
             this, SLOT(recordTimeChanged(int)));
 
+    connect(chkRecordFile, SIGNAL(toggled(bool)),
+            this, SLOT(recordFileChecked(bool)));
+    connect(edRecordFile, SIGNAL(textChanged(QString)),
+            this, SLOT(recordFileChanged(QString)));
+    connect(btRecordFile, SIGNAL(clicked()),
+            this, SLOT(selectRecordFile()));
+
     connect(chkRecordStartTime, SIGNAL(toggled(bool)),
             this, SLOT(startTimeChecked(bool)));
     connect(startTime, SIGNAL(dateTimeChanged(QDateTime)),
@@ -1118,6 +1133,11 @@ void Kwave::RecordDialog::setState(Kwave::RecordState state)
     chkRecordTime->setEnabled(enable_settings);
     sbRecordTime->setEnabled(enable_settings &&
                              chkRecordTime->isChecked());
+    chkRecordFile->setEnabled(enable_settings);
+    edRecordFile->setEnabled(enable_settings &&
+                             chkRecordFile->isChecked());
+    btRecordFile->setEnabled(enable_settings &&
+                             chkRecordFile->isChecked());
     chkRecordTrigger->setEnabled(enable_settings);
 
     // it is not really necessary to disable these ;-)
@@ -1257,6 +1277,36 @@ void Kwave::RecordDialog::recordTimeChanged(int limit)
     updateRecordButton();
 }
 
+//***************************************************************************
+void Kwave::RecordDialog::recordFileChecked(bool enabled)
+{
+    m_params.record_file_enabled = enabled;
+}
+
+//***************************************************************************
+void Kwave::RecordDialog::recordFileChanged(const QString &filename)
+{
+    m_params.record_file = filename;
+}
+
+//***************************************************************************
+void Kwave::RecordDialog::selectRecordFile()
+{
+    QPointer<Kwave::FileDialog> dlg = new(std::nothrow) Kwave::FileDialog(
+        _("kfiledialog:///kwave_record_file"),
+        Kwave::FileDialog::SaveFile,
+        _("*.wav|") + i18n("WAV audio"),
+        this, QUrl::fromLocalFile(edRecordFile->text()), _("*.wav")
+    );
+    if (!dlg) return;
+    dlg->setWindowTitle(i18n("Select the Record File"));
+    if (dlg->exec() == QDialog::Accepted) {
+        QString filename = dlg->selectedUrl().toLocalFile();
+        if (!filename.isEmpty()) edRecordFile->setText(filename);
+    }
+    delete dlg;
+}
+
 //***************************************************************************
 void Kwave::RecordDialog::startTimeChecked(bool enabled)
 {
@@ -1273,6 +1323,9 @@ void Kwave::RecordDialog::startTimeChanged(const QDateTime &datetime)
     QTime t = m_params.start_time.time();
     t.setHMS(t.hour(), t.minute(), 0, 0);
     m_params.start_time.setTime(t);
+
+    emit sigTriggerChanged(m_params.record_trigger_enabled ||
+                           m_params.start_time_enabled);
 }
 
 //***************************************************************************
@@ -1286,6 +1339,8 @@ void Kwave::RecordDialog::triggerChecked(bool enabled)
 void Kwave::RecordDialog::triggerChanged(int trigger)
 {
     m_params.record_trigger = trigger;
+    emit sigTriggerChanged(m_params.record_trigger_enabled ||
+                           m_params.start_time_enabled);
 }
 
 //***************************************************************************
@@ -1311,15 +1366,14 @@ void Kwave::RecordDialog::updateBufferProgressBar()
 }
 
 //***************************************************************************
-void Kwave::RecordDialog::updateEffects(unsigned int track,
-                                        Kwave::SampleArray &buffer)
+void Kwave::RecordDialog::updateEffects(const QVector<float> &fast,
+                                        const QVector<float> &peak)
 {
-    if (!buffer.size()) return;
+    if (fast.isEmpty()) return;
 
     if (level_meter) {
         level_meter->setTracks(m_params.tracks);
-        level_meter->setSampleRate(m_params.sample_rate);
-        level_meter->updateTrack(track, buffer);
+        level_meter->updateLevels(fast, peak);
     }
 
 }
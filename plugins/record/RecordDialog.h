@@ -25,6 +25,7 @@
 #include <QString>
 #include <QStringList>
 #include <QTimer>
+#include <QVector>
 
 #include "libkwave/Compression.h"
 #include "libkwave/Sample.h"
@@ -146,13 +147,6 @@ namespace Kwave
          */
         void updateBufferState(unsigned int count, unsigned int total);
 
-        /**
-         * updates all enabled visual effects
-         * @param track index of the track that is updated
-         * @param buffer array with Kwave sample data
-         */
-        void updateEffects(unsigned int track, Kwave::SampleArray &buffer);
-
         /**
          * Show the "source" device tab, usually if the setup was
          * not successful.
@@ -188,7 +182,7 @@ namespace Kwave
         /** emitted when the record time has been changed */
         void sigRecordTimeChanged(int limit);
 
-        /** emitted when the record trigger has been enabled/disabled */
+        /** emitted when the record trigger or start time has changed */
         void sigTriggerChanged(bool enabled);
 
         /** emitted when the prerecording has been enabled/disabled */
@@ -205,6 +199,15 @@ namespace Kwave
         /** updates the number of recorded samples */
         void setRecordedSamples(sample_index_t samples_recorded);
 
+        /**
+         * updates all enabled visual effects
+         * @param fast fast levels of all tracks
+         * @param peak peak levels of all tracks
+         * @see Kwave::LevelMeter::updateLevels
+         */
+        void updateEffects(const QVector<float> &fast,
+                           const QVector<float> &peak);
+
         /** show a message in the status bar */
         void message(const QString &message);
 
@@ -272,6 +275,15 @@ namespace Kwave
         /** record time has been changed */
         void recordTimeChanged(int record_time);
 
+        /** recording into a file has been enabled/disabled */
+        void recordFileChecked(bool enabled);
+
+        /** the name of the record file has been changed */
+        void recordFileChanged(const QString &filename);
+
+        /** show a file dialog for selecting the record file */
+        void selectRecordFile();
+
         /** start time has been enabled/disabled */
         void startTimeChecked(bool enabled);
 
@@ -0,0 +1,248 @@
+/*************************************************************************
+         RecordFile.cpp  -  streams recorded samples into a WAV file
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+#include "libkwave/RiffHeader.h"
+#include "libkwave/SampleKernels.h"
+#include "libkwave/String.h"
+#include "libkwave/Utils.h"
+
+#include "RecordFile.h"
+
+/** interval for updating the header and flushing the file [ms] */
+#define HEADER_UPDATE_INTERVAL 1000
+
+/** format tag of uncompressed PCM */
+#define WAVE_FORMAT_PCM 0x0001
+
+//***************************************************************************
+Kwave::RecordFile::RecordFile()
+    :QThread(), m_file(), m_lock(), m_queued(), m_queue(), m_block(),
+     m_tracks(0), m_bits(0), m_data_size_offset(0), m_length(0),
+     m_failed(false)
+{
+}
+
+//***************************************************************************
+Kwave::RecordFile::~RecordFile()
+{
+    close();
+}
+
+//***************************************************************************
+bool Kwave::RecordFile::open(const QString &filename, unsigned int tracks,
+                             unsigned int rate, unsigned int bits)
+{
+    close();
+    if (!tracks || !bits || (bits > 32)) return false;
+
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+        return false;
+
+    m_tracks = tracks;
+    m_bits   = bits;
+    m_length = 0;
+    m_failed = false;
+    m_block.clear();
+    m_block.resize(tracks);
+
+    const unsigned int frame_bytes = ((bits + 7) >> 3) * tracks;
+
+    QByteArray header;
+
+    // main chunk, sizes are set by updateHeader()
+    Kwave::RiffHeader::appendMainChunk(header);
+
+    header.append("fmt ", 4);
+    appendLE<quint32>(header, 16);
+    appendLE<quint16>(header, WAVE_FORMAT_PCM);
+    appendLE<quint16>(header, static_cast<quint16>(tracks));
+    appendLE<quint32>(header, rate);
+    appendLE<quint32>(header, rate * frame_bytes);
+    appendLE<quint16>(header, static_cast<quint16>(frame_bytes));
+    appendLE<quint16>(header, static_cast<quint16>(bits));
+
+    header.append("data", 4);
+    m_data_size_offset = header.size();
+    appendLE<quint32>(header, 0);
+
+    if ((m_file.write(header) != header.size()) || !updateHeader(0)) {
+        m_file.close();
+        return false;
+    }
+
+    start();
+    return true;
+}
+
+//***************************************************************************
+bool Kwave::RecordFile::close()
+{
+    if (!m_file.isOpen()) return true;
+
+    // let the thread write the rest and update the header
+    requestInterruption();
+    {
+        QMutexLocker lock(&m_lock);
+        m_queued.wakeAll();
+    }
+    wait();
+
+    m_file.close();
+    m_queue.clear();
+    m_block.clear();
+
+    return !failed();
+}
+
+//***************************************************************************
+bool Kwave::RecordFile::failed()
+{
+    QMutexLocker lock(&m_lock);
+    return m_failed;
+}
+
+//***************************************************************************
+void Kwave::RecordFile::write(unsigned int track,
+                              const Kwave::SampleArray &samples)
+{
+    Q_ASSERT(track < m_tracks);
+    if (!isRunning() || (track >= m_tracks)) return;
+
+    // collect the tracks, the last one completes the block
+    m_block[track] = samples;
+    if (track + 1 < m_tracks) return;
+
+    m_length += samples.size();
+    QMutexLocker lock(&m_lock);
+    m_queue.enqueue(m_block);
+    m_queued.wakeAll();
+}
+
+//***************************************************************************
+void Kwave::RecordFile::encode(const QVector<Kwave::SampleArray> &block,
+                               QByteArray &raw) const
+{
+    const unsigned int tracks = m_tracks;
+    const unsigned int bytes  = (m_bits + 7) >> 3;
+    const unsigned int count  = block.isEmpty() ? 0 : block[0].size();
+
+    // interleave, truncated to the resolution
+    QVector<sample_t> interleaved(count * tracks);
+    const sample_t mask = (m_bits < SAMPLE_BITS) ?
+        ~((1 << (SAMPLE_BITS - m_bits)) - 1) : ~0;
+    for (unsigned int track = 0; track < tracks; ++track) {
+        const Kwave::SampleArray &samples = block[track];
+        const unsigned int n = qMin(count, samples.size());
+        sample_t *out = interleaved.data() + track;
+        for (unsigned int i = 0; i < n; ++i, out += tracks)
+            *out = samples[i] & mask;
+        for (unsigned int i = n; i < count; ++i, out += tracks)
+            *out = 0;
+    }
+
+    raw.resize(count * tracks * bytes);
+    quint8 *dst = reinterpret_cast<quint8 *>(raw.data());
+    if (bytes == 1) {
+        // 8 bit WAV is unsigned
+        for (const sample_t s : interleaved)
+            *(dst++) = static_cast<quint8>((s >> 16) + 128);
+        return;
+    }
+
+    Kwave::SampleKernels::encoder_t encoder =
+        Kwave::SampleKernels::linearEncoder(8 * bytes, true, true);
+    Q_ASSERT(encoder);
+    if (encoder) encoder(interleaved.constData(), dst, count * tracks);
+}
+
+//***************************************************************************
+bool Kwave::RecordFile::updateHeader(quint64 data_size)
+{
+    const qint64  end    = m_file.pos();
+    const quint64 frames = data_size / (((m_bits + 7) >> 3) * m_tracks);
+    bool ok = Kwave::RiffHeader::update(m_file, data_size, frames,
+                                        m_data_size_offset);
+
+    ok &= m_file.seek(end);
+    ok &= m_file.flush();
+    return ok;
+}
+
+//***************************************************************************
+void Kwave::RecordFile::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QByteArray raw;
+    quint64 data_size = 0;
+    bool ok    = true;
+    bool dirty = false;
+
+    forever {
+        QVector<Kwave::SampleArray> block;
+        {
+            QMutexLocker lock(&m_lock);
+            if (m_queue.isEmpty()) {
+                if (isInterruptionRequested()) break;
+                m_queued.wait(&m_lock, HEADER_UPDATE_INTERVAL);
+            }
+            if (!m_queue.isEmpty()) block = m_queue.dequeue();
+        }
+
+        if (!block.isEmpty() && ok) {
+            encode(block, raw);
+            ok = (m_file.write(raw) == raw.size());
+            data_size += raw.size();
+            dirty = true;
+        }
+
+        // make the data written so far readable
+        if (ok && dirty && (timer.elapsed() >= HEADER_UPDATE_INTERVAL)) {
+            ok = updateHeader(data_size);
+            dirty = false;
+            timer.restart();
+        }
+
+        if (!ok) {
+            QMutexLocker lock(&m_lock);
+            if (!m_failed)
+                qWarning("RecordFile: writing to '%s' failed",
+                         DBG(m_file.fileName()));
+            m_failed = true;
+            m_queue.clear();
+        }
+    }
+
+    // pad the data chunk to an even length, set the final sizes
+    if (ok && (data_size & 1)) ok = (m_file.write("\000", 1) == 1);
+    if (ok) ok = updateHeader(data_size);
+    if (!ok) {
+        QMutexLocker lock(&m_lock);
+        m_failed = true;
+    }
+}
+
+//***************************************************************************
+//***************************************************************************
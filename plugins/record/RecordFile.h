@@ -0,0 +1,149 @@
+/*************************************************************************
+           RecordFile.h  -  streams recorded samples into a WAV file
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef RECORD_FILE_H
+#define RECORD_FILE_H
+
+#include "config.h"
+
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "libkwave/Sample.h"
+#include "libkwave/SampleArray.h"
+
+namespace Kwave
+{
+
+    /**
+     * Writes recorded samples directly into a WAV file on disk, from a
+     * thread of its own. The header is updated in regular intervals, so
+     * that the file stays readable if recording gets interrupted. If the
+     * file exceeds 4GB it is promoted to RF64.
+     */
+    class RecordFile: public QThread
+    {
+    public:
+
+        /** Constructor */
+        RecordFile();
+
+        /** Destructor */
+        ~RecordFile() override;
+
+        /**
+         * Creates the file, writes the header and starts the thread
+         * @param filename name of the file, will be overwritten
+         * @param tracks number of tracks
+         * @param rate sample rate
+         * @param bits number of bits per sample
+         * @return true if succeeded, false on errors
+         */
+        bool open(const QString &filename, unsigned int tracks,
+                  unsigned int rate, unsigned int bits);
+
+        /**
+         * Writes everything that is still queued, updates the header
+         * and closes the file
+         * @return true if succeeded, false if writing failed
+         */
+        bool close();
+
+        /** returns true if the file is open */
+        inline bool isOpen() const { return m_file.isOpen(); }
+
+        /** returns the name of the file */
+        inline QString fileName() const { return m_file.fileName(); }
+
+        /**
+         * Appends samples of one track. Once all tracks received their
+         * samples, they are queued for writing.
+         * @param track index of the track
+         * @param samples array with samples, all tracks must get the
+         *                same number of samples
+         */
+        void write(unsigned int track, const Kwave::SampleArray &samples);
+
+        /** returns the number of samples per track passed to write() */
+        inline sample_index_t length() const { return m_length; }
+
+        /** returns true if writing failed */
+        bool failed();
+
+        /** writes the queued blocks, until closed */
+        void run() override;
+
+    private:
+
+        /**
+         * Interleaves and encodes one block of all tracks
+         * @param block one array of samples per track
+         * @param raw receives the encoded data
+         */
+        void encode(const QVector<Kwave::SampleArray> &block,
+                    QByteArray &raw) const;
+
+        /**
+         * Writes the current sizes into the header
+         * @param data_size number of bytes in the data chunk
+         * @return true if succeeded
+         */
+        bool updateHeader(quint64 data_size);
+
+    private:
+
+        /** the file to write to */
+        QFile m_file;
+
+        /** lock for the queue */
+        QMutex m_lock;
+
+        /** signaled when a block has been queued */
+        QWaitCondition m_queued;
+
+        /** blocks that are waiting to be written */
+        QQueue<QVector<Kwave::SampleArray> > m_queue;
+
+        /** block that is currently being collected */
+        QVector<Kwave::SampleArray> m_block;
+
+        /** number of tracks */
+        unsigned int m_tracks;
+
+        /** number of bits per sample */
+        unsigned int m_bits;
+
+        /** offset of the size of the "data" chunk */
+        qint64 m_data_size_offset;
+
+        /** number of samples per track passed to write() */
+        sample_index_t m_length;
+
+        /** true if writing failed */
+        bool m_failed;
+    };
+}
+
+#endif /* RECORD_FILE_H */
+
+//***************************************************************************
+//***************************************************************************
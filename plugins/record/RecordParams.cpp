@@ -29,6 +29,7 @@ Kwave::RecordParams::RecordParams()
     record_time_limited(false),    record_time(5*60),
     start_time_enabled(false),     start_time(QDateTime::currentDateTime()),
     record_trigger_enabled(false), record_trigger(30),
+    record_file_enabled(false),    record_file(),
     amplification_enabled(false),  amplification(+3),
     agc_enabled(false),            agc_decay(50),
     fade_in_enabled(false),        fade_in_time(5),
@@ -60,8 +61,8 @@ int Kwave::RecordParams::fromList(const QStringList &list)
     bool ok;
     int index = 0;
 
-    // check number of elements
-    if (list.count() != 17) return -EINVAL;
+    // check number of elements, older settings have no record file
+    if ((list.count() != 17) && (list.count() != 19)) return -EINVAL;
 
     // recording method
     unsigned int method_index;
@@ -131,6 +132,15 @@ int Kwave::RecordParams::fromList(const QStringList &list)
     GET(buffer_count, toUInt)
     GET(buffer_size, toUInt)
 
+    // record file
+    if (index < list.count()) {
+        GET(record_file_enabled, toUInt)
+        record_file = list[index++];
+    } else {
+        record_file_enabled = false;
+        record_file         = QString();
+    }
+
     return 0;
 }
 
@@ -191,6 +201,10 @@ QStringList Kwave::RecordParams::toList() const
     PUT(buffer_count);
     PUT(buffer_size);
 
+    // record file
+    PUT(record_file_enabled);
+    list += record_file;
+
     return list;
 }
 
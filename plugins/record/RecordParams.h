@@ -86,6 +86,9 @@ namespace Kwave
         bool record_trigger_enabled;    /**< record trigger: feature enabled */
         unsigned int record_trigger;    /**< record trigger level in percent */
 
+        bool record_file_enabled;       /**< record directly into a file */
+        QString record_file;            /**< name of the file to record to */
+
         bool amplification_enabled;     /**< amplification: feature enabled */
         int amplification;              /**< amplification: value in decibel */
 
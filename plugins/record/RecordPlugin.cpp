@@ -26,6 +26,7 @@
 #include <QApplication>
 #include <QCursor>
 #include <QDateTime>
+#include <QFileInfo>
 #include <QList>
 #include <QStringList>
 #include <QVariant>
@@ -41,9 +42,9 @@
 #include "libkwave/FileInfo.h"
 #include "libkwave/InsertMode.h"
 #include "libkwave/MessageBox.h"
+#include "libkwave/Parser.h"
 #include "libkwave/PluginManager.h"
 #include "libkwave/Sample.h"
-#include "libkwave/SampleFIFO.h"
 #include "libkwave/SampleFormat.h"
 #include "libkwave/SignalManager.h"
 #include "libkwave/String.h"
@@ -56,7 +57,9 @@
 #include "Record-Qt.h"
 #include "RecordDevice.h"
 #include "RecordDialog.h"
+#include "RecordFile.h"
 #include "RecordPlugin.h"
+#include "RecordProcessor.h"
 #include "RecordThread.h"
 #include "SampleDecoderLinear.h"
 
@@ -74,12 +77,13 @@ Kwave::RecordPlugin::RecordPlugin(QObject *parent, const QVariantList &args)
      m_device(nullptr),
      m_dialog(nullptr),
      m_thread(nullptr),
+     m_processor(nullptr),
      m_decoder(nullptr),
-     m_prerecording_queue(),
      m_writers(nullptr),
+     m_file(nullptr),
+     m_recorded_file(),
      m_buffers_recorded(0),
      m_inhibit_count(0),
-     m_trigger_value(),
      m_retry_timer()
 {
     m_retry_timer.setSingleShot(true);
@@ -96,6 +100,10 @@ Kwave::RecordPlugin::~RecordPlugin()
     delete m_dialog;
     m_dialog = nullptr;
 
+    Q_ASSERT(!m_processor);
+    delete m_processor;
+    m_processor = nullptr;
+
     Q_ASSERT(!m_thread);
     delete m_thread;
     m_thread = nullptr;
@@ -104,6 +112,10 @@ Kwave::RecordPlugin::~RecordPlugin()
     delete m_decoder;
     m_decoder = nullptr;
 
+    Q_ASSERT(!m_file);
+    delete m_file;
+    m_file = nullptr;
+
     delete m_device;
     m_device = nullptr;
 }
@@ -149,6 +161,18 @@ QStringList *Kwave::RecordPlugin::setup(QStringList &previous_params)
         return nullptr;
     }
 
+    // create the thread for processing the recorded buffers
+    m_processor = new(std::nothrow) Kwave::RecordProcessor(*m_thread);
+    Q_ASSERT(m_processor);
+    if (!m_processor) {
+        delete m_thread;
+        m_thread = nullptr;
+        delete m_dialog;
+        m_dialog = nullptr;
+        return nullptr;
+    }
+    m_processor->setState(m_state);
+
     // connect some signals of the setup dialog
     connect(m_dialog, SIGNAL(sigMethodChanged(Kwave::record_method_t)),
             this,     SLOT(setMethod(Kwave::record_method_t)));
@@ -169,6 +193,10 @@ QStringList *Kwave::RecordPlugin::setup(QStringList &previous_params)
             SLOT(changeSampleFormat(Kwave::SampleFormat::Format)));
     connect(m_dialog, SIGNAL(sigBuffersChanged()),
             this,     SLOT(buffersChanged()));
+    connect(m_dialog, SIGNAL(sigRecordTimeChanged(int)),
+            this,     SLOT(recordParamsChanged()));
+    connect(m_dialog, SIGNAL(sigTriggerChanged(bool)),
+            this,     SLOT(recordParamsChanged()));
     connect(this,     SIGNAL(sigRecordedSamples(sample_index_t)),
             m_dialog, SLOT(setRecordedSamples(sample_index_t)));
 
@@ -202,9 +230,18 @@ QStringList *Kwave::RecordPlugin::setup(QStringList &previous_params)
     // connect us to the record thread
     connect(m_thread, SIGNAL(stopped(int)),
             this,     SLOT(recordStopped(int)));
-    connect(m_thread, SIGNAL(bufferFull()),
-            this,     SLOT(processBuffer()),
-            Qt::QueuedConnection);
+
+    // connect us and the dialog to the processing of the buffers
+    connect(m_processor, SIGNAL(sigBufferProcessed()),
+            this,        SLOT(bufferProcessed()));
+    connect(m_processor, SIGNAL(sigTriggerReached()),
+            this,        SLOT(triggerReached()));
+    connect(m_processor, SIGNAL(sigRecordedSamples(sample_index_t)),
+            this,        SLOT(samplesRecorded(sample_index_t)));
+    connect(m_processor, SIGNAL(sigRecordingDone()),
+            this,        SLOT(recordingDone()));
+    connect(m_processor,     &Kwave::RecordProcessor::sigLevels,
+            m_dialog.data(), &Kwave::RecordDialog::updateEffects);
 
     // dummy init -> disable format settings
     m_dialog->setSupportedTracks(0, 0);
@@ -227,14 +264,15 @@ QStringList *Kwave::RecordPlugin::setup(QStringList &previous_params)
         list = nullptr;
     }
 
-    /* de-queue all buffers that are pending and remove the record thread */
-    if (m_thread) {
-        m_thread->stop();
-        while (m_thread->queuedBuffers())
-            processBuffer();
-        delete m_thread;
-        m_thread = nullptr;
+    /* process all buffers that are pending and remove the threads */
+    if (m_thread) m_thread->stop();
+    if (m_processor) {
+        m_processor->stop();
+        delete m_processor;
+        m_processor = nullptr;
     }
+    delete m_thread;
+    m_thread = nullptr;
 
     delete m_decoder;
     m_decoder = nullptr;
@@ -242,8 +280,19 @@ QStringList *Kwave::RecordPlugin::setup(QStringList &previous_params)
     delete m_dialog;
     m_dialog = nullptr;
 
-    // flush away all prerecording buffers
-    m_prerecording_queue.clear();
+    // finish the record file, if still open
+    if (m_file) {
+        if (m_file->close() && m_file->length())
+            m_recorded_file = m_file->fileName();
+        delete m_file;
+        m_file = nullptr;
+    }
+
+    // open the file that has been recorded
+    if (!m_recorded_file.isEmpty()) {
+        emitCommand(_("open(%1)").arg(Kwave::Parser::escape(m_recorded_file)));
+        m_recorded_file = QString();
+    }
 
     // enable undo again if we recorded something
     if (!signalManager().isEmpty())
@@ -834,9 +883,8 @@ void Kwave::RecordPlugin::enterInhibit()
         m_thread->stop();
         Q_ASSERT(!m_thread->isRunning());
 
-        // de-queue all buffers that are still in the queue
-        while (m_thread->queuedBuffers())
-            processBuffer();
+        // process all buffers that are still in the queue
+        if (m_processor) m_processor->stop();
     }
 }
 
@@ -860,7 +908,8 @@ void Kwave::RecordPlugin::leaveInhibit()
         // set new parameters for the recorder
         setupRecordThread();
 
-        // and let the thread run (again)
+        // and let the threads run (again)
+        m_processor->start();
         m_thread->start();
         break;
     }
@@ -872,7 +921,7 @@ void Kwave::RecordPlugin::leaveInhibit()
 //***************************************************************************
 bool Kwave::RecordPlugin::paramsValid()
 {
-    if (!m_thread || !m_device || !m_dialog) return false;
+    if (!m_thread || !m_processor || !m_device || !m_dialog) return false;
 
     // check for a valid/usable record device
     if (m_device_name.isNull()) return false;
@@ -966,27 +1015,12 @@ void Kwave::RecordPlugin::setupRecordThread()
         return;
     }
 
-    // set up the prerecording queues
-    m_prerecording_queue.clear();
-    if (params.pre_record_enabled) {
-        // prepare a queue for each track
-        const unsigned int prerecording_samples = Kwave::toUint(
-            rint(params.pre_record_time * params.sample_rate));
-        m_prerecording_queue.resize(params.tracks);
-        for (int i=0; i < m_prerecording_queue.size(); i++)
-            m_prerecording_queue[i].setSize(prerecording_samples);
-
-        if (m_prerecording_queue.size() != Kwave::toInt(params.tracks)) {
-            m_prerecording_queue.clear();
-            Kwave::MessageBox::sorry(m_dialog, i18n("Out of memory"));
-            return;
-        }
+    // set up the processing of the buffers, with the prerecording queues
+    if (!m_processor->setup(m_decoder, params)) {
+        Kwave::MessageBox::sorry(m_dialog, i18n("Out of memory"));
+        return;
     }
 
-    // set up the recording trigger values
-    m_trigger_value.resize(params.tracks);
-    m_trigger_value.fill(0.0);
-
     // set up the record thread
     m_thread->setRecordDevice(m_device);
     unsigned int buf_count = params.buffer_count;
@@ -1001,12 +1035,16 @@ void Kwave::RecordPlugin::startRecording()
 {
     Q_ASSERT(m_dialog);
     Q_ASSERT(m_thread);
+    Q_ASSERT(m_processor);
     Q_ASSERT(m_device);
-    if (!m_dialog || !m_thread || !m_device) return;
+    if (!m_dialog || !m_thread || !m_processor || !m_device) return;
 
     InhibitRecordGuard _lock(*this); // don't record while settings change
 
     if ((m_state != Kwave::REC_PAUSED) || !m_decoder) {
+        // the sinks might get replaced
+        m_processor->setSinks(nullptr, nullptr);
+
         double rate = m_dialog->params().sample_rate;
         unsigned int tracks = m_dialog->params().tracks;
         unsigned int bits = m_dialog->params().bits_per_sample;
@@ -1054,34 +1092,79 @@ void Kwave::RecordPlugin::startRecording()
             // reuse the current signal and append to it
         }
 
-        // initialize the file information
-        Kwave::FileInfo fileInfo(signalManager().metaData());
-        fileInfo.setRate(rate);
-        fileInfo.setBits(bits);
-        fileInfo.setTracks(tracks);
-        fileInfo.set(Kwave::INF_MIMETYPE, _("audio/vnd.wave"));
-        fileInfo.set(Kwave::INF_SAMPLE_FORMAT,
-            Kwave::SampleFormat(m_dialog->params().sample_format).toInt());
-        fileInfo.set(Kwave::INF_COMPRESSION, m_dialog->params().compression);
-
-        // add our Kwave Software tag
-        const KAboutData about_data = KAboutData::applicationData();
-        QString software = about_data.componentName() + _("-") +
-                           about_data.version() + _(" ") +
-                           i18n("(built with KDE Frameworks %1)",
-                           _(KXMLGUI_VERSION_STRING));
-        fileInfo.set(Kwave::INF_SOFTWARE, software);
-
-        // add a date tag, ISO format
-        QString date(QDate::currentDate().toString(_("yyyy-MM-dd")));
-        fileInfo.set(Kwave::INF_CREATION_DATE, date);
-        signalManager().setFileInfo(fileInfo, false);
+        if (m_dialog->params().record_file_enabled) {
+            // record directly into a file, the signal stays empty
+            if (!openRecordFile(tracks, rate, bits)) return;
+        } else {
+            // initialize the file information
+            Kwave::FileInfo fileInfo(signalManager().metaData());
+            fileInfo.setRate(rate);
+            fileInfo.setBits(bits);
+            fileInfo.setTracks(tracks);
+            fileInfo.set(Kwave::INF_MIMETYPE, _("audio/vnd.wave"));
+            fileInfo.set(Kwave::INF_SAMPLE_FORMAT, Kwave::SampleFormat(
+                m_dialog->params().sample_format).toInt());
+            fileInfo.set(Kwave::INF_COMPRESSION,
+                m_dialog->params().compression);
+
+            // add our Kwave Software tag
+            const KAboutData about_data = KAboutData::applicationData();
+            QString software = about_data.componentName() + _("-") +
+                               about_data.version() + _(" ") +
+                               i18n("(built with KDE Frameworks %1)",
+                               _(KXMLGUI_VERSION_STRING));
+            fileInfo.set(Kwave::INF_SOFTWARE, software);
+
+            // add a date tag, ISO format
+            QString date(QDate::currentDate().toString(_("yyyy-MM-dd")));
+            fileInfo.set(Kwave::INF_CREATION_DATE, date);
+            signalManager().setFileInfo(fileInfo, false);
+        }
+        m_processor->setSinks(m_writers, m_file);
     }
 
     // now the recording can be considered to be started
     m_controller.deviceRecordStarted();
 }
 
+//***************************************************************************
+bool Kwave::RecordPlugin::openRecordFile(unsigned int tracks, double rate,
+                                         unsigned int bits)
+{
+    const QString filename = m_dialog->params().record_file;
+    if (filename.isEmpty()) {
+        Kwave::MessageBox::sorry(m_dialog,
+            i18n("Please select a file to record into."));
+        return false;
+    }
+
+    QFileInfo file(filename);
+    if (file.exists() && file.size() && (filename != m_recorded_file) &&
+        (Kwave::MessageBox::warningContinueCancel(m_dialog,
+            i18n("The file '%1' already exists. Do you really want to "
+                 "overwrite it?", filename)) != KMessageBox::Continue))
+        return false;
+
+    delete m_file;
+    m_file = new(std::nothrow) Kwave::RecordFile();
+    Q_ASSERT(m_file);
+    if (!m_file) {
+        Kwave::MessageBox::sorry(m_dialog, i18n("Out of memory"));
+        return false;
+    }
+
+    if (!m_file->open(filename, tracks, Kwave::toUint(rint(rate)), bits)) {
+        Kwave::MessageBox::sorry(m_dialog,
+            i18n("Opening the file '%1' for writing failed.", filename));
+        delete m_file;
+        m_file = nullptr;
+        return false;
+    }
+    m_recorded_file = QString();
+
+    return true;
+}
+
 //***************************************************************************
 void Kwave::RecordPlugin::recordStopped(int reason)
 {
@@ -1105,17 +1188,13 @@ void Kwave::RecordPlugin::recordStopped(int reason)
     }
     Kwave::MessageBox::error(m_dialog, err_msg);
 
-    if (m_writers) m_writers->flush();
-    qDebug("RecordPlugin::recordStopped(): last=%lu",
-           static_cast<unsigned long int>(
-           (m_writers) ? m_writers->last() : 0));
-
-    // flush away all prerecording buffers
-    m_prerecording_queue.clear();
+    const sample_index_t recorded = (m_processor) ? m_processor->flush() : 0;
+    qDebug("RecordPlugin::recordStopped(): recorded=%lu",
+           static_cast<unsigned long int>(recorded));
 
     // update the file info if we recorded something
     // NOTE: this implicitly sets the "modified" flag of the signal
-    if (m_writers && m_writers->last()) {
+    if (m_writers && !m_file && recorded) {
         Kwave::FileInfo info(signalManager().metaData());
         info.setLength(signalLength());
         info.setTracks(m_dialog->params().tracks);
@@ -1128,19 +1207,31 @@ void Kwave::RecordPlugin::recordStopped(int reason)
 void Kwave::RecordPlugin::stateChanged(Kwave::RecordState state)
 {
     m_state = state;
+    if (m_processor) m_processor->setState(state);
     switch (m_state) {
         case Kwave::REC_PAUSED:
-            if (m_writers) m_writers->flush();
+            if (m_processor) m_processor->flush();
             break;
         case Kwave::REC_UNINITIALIZED:
         case Kwave::REC_EMPTY:
         case Kwave::REC_DONE:
             // reset buffer status
+            if (m_processor) m_processor->setSinks(nullptr, nullptr);
             if (m_writers) {
                 m_writers->flush();
                 delete m_writers;
                 m_writers = nullptr;
             }
+            if (m_file) {
+                if (!m_file->close())
+                    Kwave::MessageBox::error(m_dialog, i18n(
+                        "Writing to the file '%1' failed.",
+                        m_file->fileName()));
+                if (m_file->length())
+                    m_recorded_file = m_file->fileName();
+                delete m_file;
+                m_file = nullptr;
+            }
             m_buffers_recorded = 0;
             m_dialog->updateBufferState(0, 0);
             break;
@@ -1183,432 +1274,47 @@ void Kwave::RecordPlugin::updateBufferProgressBar()
 }
 
 //***************************************************************************
-void Kwave::RecordPlugin::split(QByteArray &raw_data, QByteArray &dest,
-                                unsigned int bytes_per_sample,
-                                unsigned int track,
-                                unsigned int tracks)
+void Kwave::RecordPlugin::bufferProcessed()
 {
-    unsigned int raw_data_size = static_cast<unsigned int>(raw_data.size());
-    unsigned int samples = (raw_data_size / bytes_per_sample) / tracks;
-
-#if 0
-    // simple sawtooth generator, based on raw data
-    // works for up to 16 channels
-    static int saw[16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-    raw_data.fill(0x05);
-    for (unsigned int s = 0; s < samples; s++) {
-        int v = saw[track];
-        for (unsigned int byte = 0; byte < bytes_per_sample; byte++) {
-            quint8 x = (quint8)v;
-            raw_data[(((s * tracks) + track) * bytes_per_sample) + byte] = x;
-            v >>= 8;
-        }
+    if (!m_dialog || !m_thread) return;
 
-        const int max = (1 << ((bytes_per_sample * 8) - 1)) - 1;
-        saw[track] += max / 64;
-        if (saw[track] >= max) saw[track] = 0;
-    }
-#endif
+    // we received a buffer -> update the progress bar
+    updateBufferProgressBar();
 
-    if (tracks == 1) {
-        // this would give a 1:1 memcpy
-        dest = raw_data;
-    } else {
-        switch (bytes_per_sample) {
-            case 1: {
-                // 1...8 bits per sample, use 8 bit pointers
-                const quint8 *src =
-                    reinterpret_cast<const quint8 *>(raw_data.constData());
-                quint8 *dst =
-                    reinterpret_cast<quint8 *>(dest.data());
-                src += track;
-                while (samples) {
-                    *dst = *src;
-                    dst++;
-                    src += tracks;
-                    samples--;
-                }
-                break;
-            }
-            case 2: {
-                // 9...16 bits per sample, use 16 bit pointers
-                const quint16 *src =
-                    reinterpret_cast<const quint16 *>(raw_data.constData());
-                quint16 *dst =
-                    reinterpret_cast<quint16 *>(dest.data());
-                src += track;
-                while (samples) {
-                    *dst = *src;
-                    dst++;
-                    src += tracks;
-                    samples--;
-                }
-                break;
-            }
-            case 3: {
-                // 17...24 bits per sample, use 8 bit pointers, three times
-                const quint8 *src =
-                    reinterpret_cast<const quint8 *>(raw_data.constData());
-                quint8 *dst =
-                    reinterpret_cast<quint8 *>(dest.data());
-                src += track * 3;
-                while (samples) {
-                    *(dst++) = *(src++);
-                    *(dst++) = *(src++);
-                    *(dst++) = *(src++);
-                    src += (tracks - 1) * 3;
-                    samples--;
-                }
-                break;
-            }
-            case 4: {
-                // 24...32 bits per sample, use 32 bit pointers
-                const quint32 *src =
-                    reinterpret_cast<const quint32 *>(raw_data.constData());
-                quint32 *dst =
-                    reinterpret_cast<quint32 *>(dest.data());
-                src += track;
-                while (samples) {
-                    *dst = *src;
-                    dst++;
-                    src += tracks;
-                    samples--;
-                }
-                break;
-            }
-            case 8: {
-                // 64 bits per sample, use 64 bit pointers
-                const quint64 *src =
-                    reinterpret_cast<const quint64 *>(raw_data.constData());
-                quint64 *dst =
-                    reinterpret_cast<quint64 *>(dest.data());
-                src += track;
-                while (samples) {
-                    *dst = *src;
-                    dst++;
-                    src += tracks;
-                    samples--;
-                }
-                break;
-            }
-            default: {
-                // default: byte wise operation
-                const quint8 *src =
-                    reinterpret_cast<const quint8 *>(raw_data.constData());
-                quint8 *dst =
-                    reinterpret_cast<quint8 *>(dest.data());
-                src += (track * bytes_per_sample);
-                unsigned int increment = (tracks - 1) * bytes_per_sample;
-                while (samples) {
-                    for (unsigned int b = 0; b < bytes_per_sample; b++) {
-                        *dst = *src;
-                        dst++;
-                        src++;
-                        samples--;
-                    }
-                    src += increment;
-                }
-            }
-        }
-    }
+    // if the first buffer is full -> leave REC_BUFFERING
+    if ((m_state == Kwave::REC_BUFFERING) && (m_buffers_recorded > 1))
+        m_controller.deviceBufferFull();
 }
 
 //***************************************************************************
-bool Kwave::RecordPlugin::checkTrigger(unsigned int track,
-                                       const Kwave::SampleArray &buffer)
+void Kwave::RecordPlugin::triggerReached()
 {
-    Q_ASSERT(m_dialog);
-    if (!m_dialog) return false;
-
-    // check if the recording start time has been reached
-    if (m_dialog->params().start_time_enabled) {
-        if (QDateTime::currentDateTime() < m_dialog->params().start_time)
-            return false;
-    }
-
-    // shortcut if no trigger has been set
-    if (!m_dialog->params().record_trigger_enabled) return true;
-
-    // check the input parameters
-    if (!buffer.size()) return false;
-    if (!m_writers) return false;
-    if (m_trigger_value.size() != Kwave::toInt(m_writers->tracks()))
-        return false;
-
-    // pass the buffer through a rectifier and a lowpass with
-    // center frequency about 2Hz to get the amplitude
-    float trigger = static_cast<float>(
-        m_dialog->params().record_trigger / 100.0);
-    float rate = static_cast<float>(
-        m_dialog->params().sample_rate);
-
-    /*
-     * simple lowpass calculation:
-     *
-     *               1 + z
-     * H(z) = a0 * -----------   | z = e ^ (j*2*pi*f)
-     *               z + b1
-     *
-     *        1            1 - n
-     * a0 = -----    b1 = --------
-     *      1 + n          1 + n
-     *
-     * Fg = fg / fa
-     *
-     * n = cot(Pi * Fg)
-     *
-     * y[t] = a0 * x[t] + a1 * x[t-1] - b1 * y[t-1]
-     *
-     */
-
-    // rise coefficient: ~20Hz
-    const float f_rise = 20.0f;
-    float Fg = f_rise / rate;
-    float n = 1.0f / tanf(float(M_PI) * Fg);
-    const float a0_r = 1.0f / (1.0f + n);
-    const float b1_r = (1.0f - n) / (1.0f + n);
-
-    // fall coefficient: ~1.0Hz
-    const float f_fall = 1.0f;
-    Fg = f_fall / rate;
-    n = 1.0f / tanf(float(M_PI) * Fg);
-    const float a0_f = 1.0f / (1.0f + n);
-    const float b1_f = (1.0f - n) / (1.0f + n);
-
-    float y = m_trigger_value[track];
-    float last_x = y;
-    for (unsigned int t = 0; t < buffer.size(); ++t) {
-        float x = fabsf(sample2float(buffer[t])); /* rectifier */
-
-        if (x > y) { /* diode */
-            // rise if amplitude is above average (serial R)
-            y = (a0_r * x) + (a0_r * last_x) - (b1_r * y);
-        }
-
-        // fall (parallel R)
-        y = (a0_f * x) + (a0_f * last_x) - (b1_f * y);
-
-        // remember x[t-1]
-        last_x = x;
-
-// nice for debugging:
-//      buffer[t] = (int)((double)(1 << (SAMPLE_BITS-1)) * y);
-        if (y > trigger) return true;
-    }
-    m_trigger_value[track] = y;
-
-    qDebug(">> level=%5.3g, trigger=%5.3g", y, trigger);
-
-    return false;
+    // the processing already continues in the new state
+    if ((m_state == Kwave::REC_WAITING_FOR_TRIGGER) ||
+        (m_state == Kwave::REC_PRERECORDING))
+        m_controller.deviceTriggerReached();
 }
 
 //***************************************************************************
-void Kwave::RecordPlugin::enqueuePrerecording(unsigned int track,
-                                              const Kwave::SampleArray &decoded)
+void Kwave::RecordPlugin::samplesRecorded(sample_index_t samples)
 {
-    Q_ASSERT(m_dialog);
-    Q_ASSERT(Kwave::toInt(track) < m_prerecording_queue.size());
-    if (!m_dialog) return;
-    if (Kwave::toInt(track) >= m_prerecording_queue.size()) return;
-
-    // append the array with decoded sample to the prerecording buffer
-    m_prerecording_queue[track].put(decoded);
+    // we have transferred data to the sinks, we are no longer empty
+    if (samples) m_controller.setEmpty(false);
+    emit sigRecordedSamples(samples);
 }
 
 //***************************************************************************
-void Kwave::RecordPlugin::flushPrerecordingQueue()
+void Kwave::RecordPlugin::recordingDone()
 {
-    if (!m_prerecording_queue.size()) return;
-    Q_ASSERT(m_dialog);
-    Q_ASSERT(m_thread);
-    Q_ASSERT(m_decoder);
-    if (!m_dialog || !m_thread || !m_decoder) return;
-
-    const Kwave::RecordParams &params = m_dialog->params();
-    const unsigned int tracks = params.tracks;
-    Q_ASSERT(tracks);
-    if (!tracks) return;
-    Q_ASSERT(m_writers);
-    if (!m_writers) return;
-    Q_ASSERT(tracks == m_writers->tracks());
-    if (tracks != m_writers->tracks()) return;
-
-    for (unsigned int track=0; track < tracks; ++track) {
-        Kwave::SampleFIFO &fifo = m_prerecording_queue[track];
-        Q_ASSERT(fifo.length());
-        if (!fifo.length()) continue;
-        fifo.crop(); // enforce the correct size
-
-        // push all buffers to the writer, starting at the tail
-        Kwave::Writer *writer = (*m_writers)[track];
-        Q_ASSERT(writer);
-        if (writer) {
-            Kwave::SampleArray buffer(writer->blockSize());
-            unsigned int rest = fifo.length();
-            while (rest) {
-                unsigned int read = fifo.get(buffer);
-                if (read < 1) break;
-                writer->write(buffer, read);
-                rest -= read;
-            }
-        } else {
-            // fallback: discard the FIFO content
-            fifo.flush();
-        }
-        Q_ASSERT(fifo.length() == 0);
-    }
-
-    // the queues are no longer needed
-    m_prerecording_queue.clear();
-
-    // we have transferred data to the writers, we are no longer empty
-    m_controller.setEmpty(false);
+    // if this was the last received buffer, change state
+    if ((m_state != Kwave::REC_DONE) && (m_state != Kwave::REC_EMPTY))
+        m_controller.actionStop();
 }
 
 //***************************************************************************
-void Kwave::RecordPlugin::processBuffer()
+void Kwave::RecordPlugin::recordParamsChanged()
 {
-    bool recording_done = false;
-
-    // de-queue the buffer from the thread
-    if (!m_thread) return;
-    if (!m_thread->queuedBuffers()) return;
-    QByteArray buffer = m_thread->dequeue();
-
-    // abort here if we have no dialog or no decoder
-    if (!m_dialog || !m_decoder) return;
-
-    // we received a buffer -> update the progress bar
-    updateBufferProgressBar();
-
-    const Kwave::RecordParams &params = m_dialog->params();
-    const unsigned int tracks = params.tracks;
-    Q_ASSERT(tracks);
-    if (!tracks) return;
-
-    const unsigned int bytes_per_sample = m_decoder->rawBytesPerSample();
-    Q_ASSERT(bytes_per_sample);
-    if (!bytes_per_sample) return;
-
-    unsigned int buffer_size = static_cast<unsigned int>(buffer.size());
-    unsigned int samples = (buffer_size / bytes_per_sample) / tracks;
-    Q_ASSERT(samples);
-    if (!samples) return;
-
-    // check for reached recording time limit if enabled
-    if (params.record_time_limited && m_writers) {
-        sample_index_t last = m_writers->last();
-        sample_index_t already_recorded = (last) ? (last + 1) : 0;
-        sample_index_t limit = static_cast<sample_index_t>(rint(
-            params.record_time * params.sample_rate));
-        if (already_recorded + samples >= limit) {
-            // reached end of recording time, we are full
-            if (m_state == Kwave::REC_RECORDING) {
-                samples = Kwave::toUint(
-                    (limit > already_recorded) ?
-                    (limit - already_recorded) : 0);
-                buffer.resize(samples * tracks * bytes_per_sample);
-            }
-            recording_done = true;
-        }
-    }
-
-    QByteArray buf;
-    buf.resize(bytes_per_sample * samples);
-    Q_ASSERT(buf.size() == Kwave::toInt(bytes_per_sample * samples));
-    if (buf.size() != Kwave::toInt(bytes_per_sample * samples)) return;
-
-    Kwave::SampleArray decoded(samples);
-    Q_ASSERT(decoded.size() == samples);
-    if (decoded.size() != samples) return;
-
-    // check for trigger
-    // note: this might change the state, which affects the
-    //       processing of all tracks !
-    if ((m_state == Kwave::REC_WAITING_FOR_TRIGGER) ||
-        ((m_state == Kwave::REC_PRERECORDING) &&
-          params.record_trigger_enabled) ||
-        ((m_state == Kwave::REC_PRERECORDING) &&
-          params.start_time_enabled))
-    {
-        for (unsigned int track=0; track < tracks; ++track) {
-            // split off and decode buffer with current track
-            split(buffer, buf, bytes_per_sample, track, tracks);
-            m_decoder->decode(buf, decoded);
-            if (checkTrigger(track, decoded)) {
-                m_controller.deviceTriggerReached();
-                break;
-            }
-        }
-    }
-
-    if ((m_state == Kwave::REC_RECORDING) && !m_prerecording_queue.isEmpty()) {
-        // flush all prerecorded buffers to the output
-        flushPrerecordingQueue();
-    }
-
-    // use a copy of the state, in case it changes below ;-)
-    Kwave::RecordState state = m_state;
-    for (unsigned int track = 0; track < tracks; ++track) {
-        // decode and care for all special effects, meters and so on
-        // split off and decode buffer with current track
-        split(buffer, buf, bytes_per_sample, track, tracks);
-        m_decoder->decode(buf, decoded);
-
-        // update the level meter and other effects
-        m_dialog->updateEffects(track, decoded);
-
-        // if the first buffer is full -> leave REC_BUFFERING
-        // limit state transitions to a point before the first track is
-        // processed (avoid asymmetry)
-        if ((track == 0) && (m_state == Kwave::REC_BUFFERING) &&
-            (m_buffers_recorded > 1))
-        {
-            m_controller.deviceBufferFull();
-            state = m_state; // might have changed!
-        }
-
-        switch (state) {
-            case Kwave::REC_UNINITIALIZED:
-            case Kwave::REC_EMPTY:
-            case Kwave::REC_PAUSED:
-            case Kwave::REC_DONE:
-            case Kwave::REC_BUFFERING:
-            case Kwave::REC_WAITING_FOR_TRIGGER:
-                // already handled before or nothing to do...
-                break;
-            case Kwave::REC_PRERECORDING:
-                // enqueue the buffers into a FIFO
-                enqueuePrerecording(track, decoded);
-                break;
-            case Kwave::REC_RECORDING: {
-                // put the decoded track data into the buffer
-                if (!m_writers) break; // (could happen due to queued signal)
-                Q_ASSERT(tracks == m_writers->tracks());
-                if (!tracks || (tracks != m_writers->tracks())) break;
-
-                Kwave::Writer *writer = (*m_writers)[track];
-                Q_ASSERT(writer);
-                if (writer) (*writer) << decoded;
-                m_controller.setEmpty(false);
-
-                break;
-            }
-            DEFAULT_IMPOSSIBLE;
-        }
-    }
-
-    // update the number of recorded samples
-    if (m_writers) emit sigRecordedSamples(m_writers->last() + 1);
-
-    // if this was the last received buffer, change state
-    if (recording_done &&
-        (m_state != Kwave::REC_DONE) &&
-        (m_state != Kwave::REC_EMPTY))
-    {
-        m_controller.actionStop();
-    }
-
+    if (m_processor && m_dialog) m_processor->setParams(m_dialog->params());
 }
 
 //***************************************************************************
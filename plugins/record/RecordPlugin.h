@@ -20,19 +20,16 @@
 
 #include "config.h"
 
-#include <QByteArray>
 #include <QList>
 #include <QPointer>
 #include <QString>
 #include <QStringList>
 #include <QTimer>
-#include <QVector>
 
 #include "libkwave/MultiTrackWriter.h"
 #include "libkwave/Plugin.h"
 #include "libkwave/Sample.h"
 #include "libkwave/SampleArray.h"
-#include "libkwave/SampleFIFO.h"
 #include "libkwave/SampleFormat.h"
 
 #include "RecordController.h"
@@ -44,6 +41,8 @@ namespace Kwave
 
     class RecordDevice;
     class RecordDialog;
+    class RecordFile;
+    class RecordProcessor;
     class RecordThread;
     class SampleDecoder;
 
@@ -160,8 +159,20 @@ namespace Kwave
         /** select a new sample format */
         void changeSampleFormat(Kwave::SampleFormat::Format new_format);
 
-        /** process a raw audio buffer */
-        void processBuffer();
+        /** a raw audio buffer has been processed */
+        void bufferProcessed();
+
+        /** the record trigger has been reached */
+        void triggerReached();
+
+        /** updates the number of recorded samples */
+        void samplesRecorded(sample_index_t samples);
+
+        /** the record time limit has been reached */
+        void recordingDone();
+
+        /** passes changed record parameters to the processing */
+        void recordParamsChanged();
 
         /** restart recorder with new buffer settings */
         void buffersChanged();
@@ -191,42 +202,15 @@ namespace Kwave
         void updateBufferProgressBar();
 
         /**
-         * check if the trigger level has been reached
-         * @param track index of the track that is checked
-         * @param buffer array with Kwave sample data
-         * @return true if trigger reached or no trigger set
-         */
-        bool checkTrigger(unsigned int track, const Kwave::SampleArray &buffer);
-
-        /**
-         * Split off one track from a raw buffer with multiple tracks into
-         * a separate buffer
-         * @param raw_data the raw buffer with multiple tracks
-         * @param dest byte array that receives the data of the specified track
-         * @param bytes_per_sample number of bytes for each sample
-         * @param track index of the track to split off [1...n-1]
-         * @param tracks number of total tracks
-         */
-        void split(QByteArray &raw_data, QByteArray &dest,
-                   unsigned int bytes_per_sample,
-                   unsigned int track,
-                   unsigned int tracks);
-
-        /**
-         * Enqueue a buffer with decoded samples into a prerecording
-         * buffer of the corresponding track.
-         *
-         * @param track index of the track [0...tracks-1]
-         * @param decoded array with decoded samples, in Kwave's internal format
+         * Creates the record file and starts writing to it, if recording
+         * directly into a file is enabled
+         * @param tracks number of tracks
+         * @param rate sample rate
+         * @param bits number of bits per sample
+         * @return true if recording can be started, false if not
          */
-        void enqueuePrerecording(unsigned int track,
-                                 const Kwave::SampleArray &decoded);
-
-        /**
-         * Flush the content of the prerecording queue to the output
-         * @see m_writers
-         */
-        void flushPrerecordingQueue();
+        bool openRecordFile(unsigned int tracks, double rate,
+                            unsigned int bits);
 
         /**
          * Returns true if all parameters are valid and the recording
@@ -257,18 +241,21 @@ namespace Kwave
         /** the thread for recording */
         Kwave::RecordThread *m_thread;
 
+        /** the thread for processing the recorded buffers */
+        Kwave::RecordProcessor *m_processor;
+
         /** decoder for converting raw data to samples */
         Kwave::SampleDecoder *m_decoder;
 
-        /**
-         * set of queues for buffering prerecording data, one for each
-         * track
-         */
-        QVector<Kwave::SampleFIFO> m_prerecording_queue;
-
         /** sink for the audio data */
         Kwave::MultiTrackWriter *m_writers;
 
+        /** sink for the audio data if recording directly into a file */
+        Kwave::RecordFile *m_file;
+
+        /** name of the file that has been recorded, opened when done */
+        QString m_recorded_file;
+
         /**
          * number of recorded buffers since start or continue or the number of
          * buffers in the queue if recording stopped
@@ -278,9 +265,6 @@ namespace Kwave
         /** recursion level for inhibiting recording */
         unsigned int m_inhibit_count;
 
-        /** buffer for trigger values */
-        QVector<float> m_trigger_value;
-
         /** timer for retrying "open" */
         QTimer m_retry_timer;
 
@@ -0,0 +1,444 @@
+/*************************************************************************
+    RecordProcessor.cpp  -  decodes and dispatches recorded buffers
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <math.h>
+
+#include <QDateTime>
+#include <QMutexLocker>
+
+#include "libkwave/MultiTrackWriter.h"
+#include "libkwave/Utils.h"
+#include "libkwave/WorkerPool.h"
+#include "libkwave/Writer.h"
+
+#include "LevelMeter.h"
+#include "RecordFile.h"
+#include "RecordProcessor.h"
+#include "RecordThread.h"
+#include "SampleDecoder.h"
+
+/** time to wait for a buffer before checking for stop requests [ms] */
+#define WAIT_TIMEOUT 100
+
+/** number of samples per block when flushing the prerecording queues */
+#define FLUSH_BLOCK_SIZE (64 * 1024)
+
+//***************************************************************************
+Kwave::RecordProcessor::RecordProcessor(Kwave::RecordThread &source)
+    :QThread(),
+     m_source(source),
+     m_lock(),
+     m_decoder(nullptr),
+     m_params(),
+     m_state(Kwave::REC_UNINITIALIZED),
+     m_writers(nullptr),
+     m_file(nullptr),
+     m_prerecording_queue(),
+     m_trigger_value(),
+     m_level_fast(),
+     m_level_peak(),
+     m_interleaved()
+{
+}
+
+//***************************************************************************
+Kwave::RecordProcessor::~RecordProcessor()
+{
+    stop();
+}
+
+//***************************************************************************
+bool Kwave::RecordProcessor::setup(Kwave::SampleDecoder *decoder,
+                                   const Kwave::RecordParams &params)
+{
+    Q_ASSERT(!isRunning());
+    if (isRunning()) return false;
+
+    QMutexLocker lock(&m_lock);
+    m_decoder = decoder;
+    m_params  = params;
+
+    // set up the prerecording queues
+    m_prerecording_queue.clear();
+    if (params.pre_record_enabled) {
+        // prepare a queue for each track
+        const unsigned int prerecording_samples = Kwave::toUint(
+            rint(params.pre_record_time * params.sample_rate));
+        m_prerecording_queue.resize(params.tracks);
+        for (int i = 0; i < m_prerecording_queue.size(); i++)
+            m_prerecording_queue[i].setSize(prerecording_samples);
+
+        if (m_prerecording_queue.size() != Kwave::toInt(params.tracks)) {
+            m_prerecording_queue.clear();
+            return false;
+        }
+    }
+
+    // set up the filters of the trigger and the level meter
+    m_trigger_value.resize(params.tracks);
+    m_trigger_value.fill(0.0);
+    m_level_fast.resize(params.tracks);
+    m_level_fast.fill(0.0);
+    m_level_peak.resize(params.tracks);
+    m_level_peak.fill(0.0);
+
+    return true;
+}
+
+//***************************************************************************
+void Kwave::RecordProcessor::setParams(const Kwave::RecordParams &params)
+{
+    QMutexLocker lock(&m_lock);
+
+    // the number of tracks and the format only change through setup()
+    Q_ASSERT(params.tracks == m_params.tracks);
+    if (params.tracks != m_params.tracks) return;
+
+    m_params = params;
+}
+
+//***************************************************************************
+void Kwave::RecordProcessor::setState(Kwave::RecordState state)
+{
+    QMutexLocker lock(&m_lock);
+    m_state = state;
+}
+
+//***************************************************************************
+void Kwave::RecordProcessor::setSinks(Kwave::MultiTrackWriter *writers,
+                                      Kwave::RecordFile *file)
+{
+    QMutexLocker lock(&m_lock);
+    m_writers = writers;
+    m_file    = file;
+}
+
+//***************************************************************************
+sample_index_t Kwave::RecordProcessor::flush()
+{
+    QMutexLocker lock(&m_lock);
+    if (m_writers) m_writers->flush();
+    return recordedSamples();
+}
+
+//***************************************************************************
+void Kwave::RecordProcessor::stop()
+{
+    if (!isRunning()) return;
+    requestInterruption();
+    wait();
+}
+
+//***************************************************************************
+void Kwave::RecordProcessor::run()
+{
+    forever {
+        // after a stop request only the remaining buffers are processed
+        const QByteArray *raw = m_source.waitForBuffer(
+            isInterruptionRequested() ? 0 : WAIT_TIMEOUT);
+        if (!raw) {
+            if (isInterruptionRequested()) break;
+            continue;
+        }
+
+        process(*raw);
+        m_source.release();
+        emit sigBufferProcessed();
+    }
+}
+
+//***************************************************************************
+void Kwave::RecordProcessor::process(const QByteArray &raw)
+{
+    QMutexLocker lock(&m_lock);
+
+    const unsigned int tracks = m_params.tracks;
+    Q_ASSERT(tracks);
+    Q_ASSERT(m_decoder);
+    if (!tracks || !m_decoder) return;
+
+    const unsigned int bytes_per_sample = m_decoder->rawBytesPerSample();
+    Q_ASSERT(bytes_per_sample);
+    if (!bytes_per_sample) return;
+
+    const unsigned int raw_size = static_cast<unsigned int>(raw.size());
+    unsigned int samples = (raw_size / bytes_per_sample) / tracks;
+    Q_ASSERT(samples);
+    if (!samples) return;
+
+    // decode all tracks at once, then de-interleave the samples,
+    // each track into a new array as the sinks keep a reference
+    QVector<Kwave::SampleArray> decoded(tracks);
+    if (tracks == 1) {
+        decoded[0] = Kwave::SampleArray(samples);
+        m_decoder->decode(raw, decoded[0]);
+    } else {
+        const unsigned int count = raw_size / bytes_per_sample;
+        if ((m_interleaved.size() != count) &&
+            !m_interleaved.resize(count)) return;
+        m_decoder->decode(raw, m_interleaved);
+    }
+
+    // de-interleave and run the level meter filters, in parallel
+    const float rate = static_cast<float>(m_params.sample_rate);
+    const unsigned int updates =
+        Kwave::LevelMeter::updatesPerBlock(samples, rate);
+    QVector<float> fast(tracks * updates);
+    QVector<float> peak(tracks * updates);
+    {
+        Kwave::SampleArray *out  = decoded.data();
+        const sample_t     *in   = m_interleaved.constData();
+        float              *yf   = m_level_fast.data();
+        float              *yp   = m_level_peak.data();
+        float              *f    = fast.data();
+        float              *p    = peak.data();
+        Kwave::WorkerPool::instance().run(tracks,
+            [out, in, yf, yp, f, p, tracks, samples, updates, rate]
+            (unsigned int track) {
+                if (tracks > 1) {
+                    out[track] = Kwave::SampleArray(samples);
+                    const sample_t *src = in + track;
+                    sample_t       *dst = out[track].data();
+                    for (unsigned int i = 0; i < samples; ++i, src += tracks)
+                        dst[i] = *src;
+                }
+                Kwave::LevelMeter::analyze(out[track], rate,
+                    yf[track], yp[track],
+                    f + (track * updates), p + (track * updates));
+            }
+        );
+    }
+    emit sigLevels(fast, peak);
+
+    // check for trigger
+    if ((m_state == Kwave::REC_WAITING_FOR_TRIGGER) ||
+        ((m_state == Kwave::REC_PRERECORDING) &&
+          m_params.record_trigger_enabled) ||
+        ((m_state == Kwave::REC_PRERECORDING) &&
+          m_params.start_time_enabled))
+    {
+        for (unsigned int track = 0; track < tracks; ++track) {
+            if (!checkTrigger(track, decoded[track])) continue;
+
+            // same transition as in the record controller, which
+            // follows as soon as the GUI thread gets the signal
+            m_state = (m_params.pre_record_enabled &&
+                      (m_state == Kwave::REC_WAITING_FOR_TRIGGER)) ?
+                Kwave::REC_PRERECORDING : Kwave::REC_RECORDING;
+            emit sigTriggerReached();
+            break;
+        }
+    }
+
+    switch (m_state) {
+        case Kwave::REC_UNINITIALIZED:
+        case Kwave::REC_EMPTY:
+        case Kwave::REC_PAUSED:
+        case Kwave::REC_DONE:
+        case Kwave::REC_BUFFERING:
+        case Kwave::REC_WAITING_FOR_TRIGGER:
+            // already handled before or nothing to do...
+            break;
+        case Kwave::REC_PRERECORDING:
+            // enqueue the buffers into a FIFO
+            for (unsigned int track = 0; track < tracks; ++track) {
+                if (Kwave::toInt(track) < m_prerecording_queue.size())
+                    m_prerecording_queue[track].put(decoded[track]);
+            }
+            break;
+        case Kwave::REC_RECORDING: {
+            // flush all prerecorded buffers to the output
+            if (!m_prerecording_queue.isEmpty()) flushPrerecordingQueue();
+
+            // check for reached recording time limit if enabled
+            bool recording_done = false;
+            if (m_params.record_time_limited) {
+                const sample_index_t recorded = recordedSamples();
+                const sample_index_t limit =
+                    static_cast<sample_index_t>(rint(
+                    m_params.record_time * m_params.sample_rate));
+                if (recorded + samples >= limit) {
+                    // reached end of recording time, we are full
+                    samples = Kwave::toUint(
+                        (limit > recorded) ? (limit - recorded) : 0);
+                    for (unsigned int t = 0; t < tracks; ++t)
+                        decoded[t].resize(samples);
+                    recording_done = true;
+                }
+            }
+
+            // put the decoded track data into the sink
+            for (unsigned int track = 0; samples && (track < tracks);
+                 ++track)
+            {
+                if (m_file) {
+                    m_file->write(track, decoded[track]);
+                } else if (m_writers && (m_writers->tracks() == tracks)) {
+                    Kwave::Writer *writer = (*m_writers)[track];
+                    Q_ASSERT(writer);
+                    if (writer) (*writer) << decoded[track];
+                }
+            }
+
+            // update the number of recorded samples
+            emit sigRecordedSamples(recordedSamples());
+
+            // stop writing until the GUI thread changes the state
+            if (recording_done) {
+                m_state = Kwave::REC_DONE;
+                emit sigRecordingDone();
+            }
+            break;
+        }
+        DEFAULT_IMPOSSIBLE;
+    }
+}
+
+//***************************************************************************
+bool Kwave::RecordProcessor::checkTrigger(unsigned int track,
+                                          const Kwave::SampleArray &buffer)
+{
+    // check if the recording start time has been reached
+    if (m_params.start_time_enabled) {
+        if (QDateTime::currentDateTime() < m_params.start_time)
+            return false;
+    }
+
+    // shortcut if no trigger has been set
+    if (!m_params.record_trigger_enabled) return true;
+
+    // check the input parameters
+    if (!buffer.size()) return false;
+    if (Kwave::toInt(track) >= m_trigger_value.size()) return false;
+
+    // pass the buffer through a rectifier and a lowpass with
+    // center frequency about 2Hz to get the amplitude
+    float trigger = static_cast<float>(m_params.record_trigger / 100.0);
+    float rate = static_cast<float>(m_params.sample_rate);
+
+    /*
+     * simple lowpass calculation:
+     *
+     *               1 + z
+     * H(z) = a0 * -----------   | z = e ^ (j*2*pi*f)
+     *               z + b1
+     *
+     *        1            1 - n
+     * a0 = -----    b1 = --------
+     *      1 + n          1 + n
+     *
+     * Fg = fg / fa
+     *
+     * n = cot(Pi * Fg)
+     *
+     * y[t] = a0 * x[t] + a1 * x[t-1] - b1 * y[t-1]
+     *
+     */
+
+    // rise coefficient: ~20Hz
+    const float f_rise = 20.0f;
+    float Fg = f_rise / rate;
+    float n = 1.0f / tanf(float(M_PI) * Fg);
+    const float a0_r = 1.0f / (1.0f + n);
+    const float b1_r = (1.0f - n) / (1.0f + n);
+
+    // fall coefficient: ~1.0Hz
+    const float f_fall = 1.0f;
+    Fg = f_fall / rate;
+    n = 1.0f / tanf(float(M_PI) * Fg);
+    const float a0_f = 1.0f / (1.0f + n);
+    const float b1_f = (1.0f - n) / (1.0f + n);
+
+    float y = m_trigger_value[track];
+    float last_x = y;
+    for (unsigned int t = 0; t < buffer.size(); ++t) {
+        float x = fabsf(sample2float(buffer[t])); /* rectifier */
+
+        if (x > y) { /* diode */
+            // rise if amplitude is above average (serial R)
+            y = (a0_r * x) + (a0_r * last_x) - (b1_r * y);
+        }
+
+        // fall (parallel R)
+        y = (a0_f * x) + (a0_f * last_x) - (b1_f * y);
+
+        // remember x[t-1]
+        last_x = x;
+
+// nice for debugging:
+//      buffer[t] = (int)((double)(1 << (SAMPLE_BITS-1)) * y);
+        if (y > trigger) return true;
+    }
+    m_trigger_value[track] = y;
+
+    qDebug(">> level=%5.3g, trigger=%5.3g", y, trigger);
+
+    return false;
+}
+
+//***************************************************************************
+void Kwave::RecordProcessor::flushPrerecordingQueue()
+{
+    const unsigned int tracks = m_params.tracks;
+    if (m_prerecording_queue.size() != Kwave::toInt(tracks)) {
+        m_prerecording_queue.clear();
+        return;
+    }
+
+    // enforce the correct size
+    for (unsigned int track = 0; track < tracks; ++track)
+        m_prerecording_queue[track].crop();
+
+    // push all buffers to the sink, starting at the tail
+    forever {
+        unsigned int read = 0;
+        for (unsigned int track = 0; track < tracks; ++track) {
+            Kwave::SampleArray buffer(FLUSH_BLOCK_SIZE);
+            read = m_prerecording_queue[track].get(buffer);
+            if (read < 1) break;
+            if (read < buffer.size()) buffer.resize(read);
+
+            if (m_file) {
+                m_file->write(track, buffer);
+            } else if (m_writers && (m_writers->tracks() == tracks)) {
+                Kwave::Writer *writer = (*m_writers)[track];
+                Q_ASSERT(writer);
+                if (writer) writer->write(buffer, read);
+            }
+        }
+        if (read < 1) break;
+    }
+
+    // the queues are no longer needed
+    m_prerecording_queue.clear();
+}
+
+//***************************************************************************
+sample_index_t Kwave::RecordProcessor::recordedSamples() const
+{
+    if (m_file) return m_file->length();
+    if (!m_writers) return 0;
+    const sample_index_t last = m_writers->last();
+    return (last) ? (last + 1) : 0;
+}
+
+//***************************************************************************
+//***************************************************************************
+
+#include "moc_RecordProcessor.cpp"
@@ -0,0 +1,203 @@
+/*************************************************************************
+      RecordProcessor.h  -  decodes and dispatches recorded buffers
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef RECORD_PROCESSOR_H
+#define RECORD_PROCESSOR_H
+
+#include "config.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+
+#include "libkwave/Sample.h"
+#include "libkwave/SampleArray.h"
+#include "libkwave/SampleFIFO.h"
+
+#include "RecordParams.h"
+#include "RecordState.h"
+
+namespace Kwave
+{
+
+    class MultiTrackWriter;
+    class RecordFile;
+    class RecordThread;
+    class SampleDecoder;
+
+    /**
+     * Takes the raw buffers filled by the RecordThread and does all the
+     * work on them in a thread of its own: de-interleaving and decoding,
+     * the level meter filters, checking the trigger, prerecording and
+     * writing to the sinks. Only the decimated levels and some status
+     * information are passed to the GUI thread, through signals.
+     *
+     * The state of the recording is still controlled from the GUI thread,
+     * it is passed in with setState() and applies to the next buffer.
+     */
+    class RecordProcessor: public QThread
+    {
+        Q_OBJECT
+    public:
+
+        /**
+         * Constructor
+         * @param source the record thread that delivers raw buffers
+         */
+        explicit RecordProcessor(Kwave::RecordThread &source);
+
+        /** Destructor */
+        ~RecordProcessor() override;
+
+        /**
+         * Prepares for a new run of the record thread, must not be called
+         * while running
+         * @param decoder decoder for the raw data
+         * @param params record parameters
+         * @return true if succeeded, false if out of memory
+         */
+        bool setup(Kwave::SampleDecoder *decoder,
+                   const Kwave::RecordParams &params);
+
+        /**
+         * Updates the record parameters that may change while recording,
+         * like the trigger, start time and time limit
+         * @param params record parameters
+         */
+        void setParams(const Kwave::RecordParams &params);
+
+        /**
+         * Sets the state of the recording, takes effect with the next
+         * buffer
+         * @param state the new state
+         */
+        void setState(Kwave::RecordState state);
+
+        /**
+         * Sets the sinks for the recorded samples. When this returns,
+         * the previous sinks are no longer accessed.
+         * @param writers writers into the signal, or null
+         * @param file record file, or null
+         */
+        void setSinks(Kwave::MultiTrackWriter *writers,
+                      Kwave::RecordFile *file);
+
+        /**
+         * Flushes the sink that writes into the signal
+         * @return number of samples per track that have been recorded
+         */
+        sample_index_t flush();
+
+        /**
+         * Processes all buffers that are still queued and stops the
+         * thread, the record thread has to be stopped before
+         */
+        void stop();
+
+        /** processes the buffers of the record thread, until stopped */
+        void run() override;
+
+    signals:
+
+        /**
+         * emitted with the decimated levels of all tracks of a buffer
+         * @see Kwave::LevelMeter::updateLevels
+         */
+        void sigLevels(const QVector<float> &fast,
+                       const QVector<float> &peak);
+
+        /** emitted when a buffer has been processed */
+        void sigBufferProcessed();
+
+        /** emitted when the trigger has been reached */
+        void sigTriggerReached();
+
+        /** emitted with the number of recorded samples per track */
+        void sigRecordedSamples(sample_index_t samples);
+
+        /** emitted when the record time limit has been reached */
+        void sigRecordingDone();
+
+    private:
+
+        /**
+         * Processes one raw buffer with all tracks
+         * @param raw the raw buffer from the record thread
+         */
+        void process(const QByteArray &raw);
+
+        /**
+         * Checks whether the start time and trigger level have been
+         * reached
+         * @param track index of the track
+         * @param buffer array with decoded samples of the track
+         * @return true if recording can start
+         */
+        bool checkTrigger(unsigned int track,
+                          const Kwave::SampleArray &buffer);
+
+        /** writes the content of the prerecording queues to the sinks */
+        void flushPrerecordingQueue();
+
+        /** returns the number of samples per track written to the sinks */
+        sample_index_t recordedSamples() const;
+
+    private:
+
+        /** the record thread, source of the raw buffers */
+        Kwave::RecordThread &m_source;
+
+        /** lock for the state, parameters and sinks */
+        QMutex m_lock;
+
+        /** decoder for converting raw data to samples */
+        Kwave::SampleDecoder *m_decoder;
+
+        /** copy of the record parameters */
+        Kwave::RecordParams m_params;
+
+        /** state of the recording */
+        Kwave::RecordState m_state;
+
+        /** sink for the audio data */
+        Kwave::MultiTrackWriter *m_writers;
+
+        /** sink for the audio data if recording into a file */
+        Kwave::RecordFile *m_file;
+
+        /** queues for the prerecording data, one for each track */
+        QVector<Kwave::SampleFIFO> m_prerecording_queue;
+
+        /** state of the trigger filter of each track */
+        QVector<float> m_trigger_value;
+
+        /** state of the fast level filter of each track */
+        QVector<float> m_level_fast;
+
+        /** state of the peak level filter of each track */
+        QVector<float> m_level_peak;
+
+        /** buffer for decoding the interleaved raw data */
+        Kwave::SampleArray m_interleaved;
+    };
+}
+
+#endif /* RECORD_PROCESSOR_H */
+
+//***************************************************************************
+//***************************************************************************
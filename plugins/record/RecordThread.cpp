@@ -19,7 +19,6 @@
 
 #include <errno.h>
 
-#include <QMutexLocker>
 #include <QVariant>
 
 #include "RecordDevice.h"
@@ -28,10 +27,11 @@
 //***************************************************************************
 Kwave::RecordThread::RecordThread()
     :Kwave::WorkerThread(nullptr, QVariant()),
-     m_lock(),
      m_device(nullptr),
-     m_empty_queue(),
-     m_full_queue(),
+     m_ring(),
+     m_filled_count(0),
+     m_released_count(0),
+     m_filled(0),
      m_buffer_count(0),
      m_buffer_size(0)
 {
@@ -41,12 +41,7 @@ Kwave::RecordThread::RecordThread()
 Kwave::RecordThread::~RecordThread()
 {
     stop();
-
-    {
-        QMutexLocker lock(&m_lock);
-        m_full_queue.clear();
-        m_empty_queue.clear();
-    }
+    m_ring.clear();
 }
 
 //***************************************************************************
@@ -61,61 +56,55 @@ void Kwave::RecordThread::setRecordDevice(Kwave::RecordDevice *device)
 //***************************************************************************
 int Kwave::RecordThread::setBuffers(unsigned int count, unsigned int size)
 {
-    QMutexLocker lock(&m_lock);
-
     Q_ASSERT(!isRunning());
     if (isRunning()) return -EBUSY;
 
-    // flush all queues
-    m_full_queue.clear();
-    m_empty_queue.clear();
+    // flush the ring
+    m_ring.clear();
+    m_filled.acquire(m_filled.available());
+    m_filled_count.store(0);
+    m_released_count.store(0);
 
-    // fill the "empty" queue again
-    QByteArray buf(size, 0x00);
+    // fill it with empty buffers again, each one with its own storage
     for (unsigned int i = 0; i < count; i++)
-        m_empty_queue.enqueue(buf);
+        m_ring.append(QByteArray(size, 0x00));
 
     // take the new settings
     m_buffer_size  = size;
-    m_buffer_count = count;
+    m_buffer_count = static_cast<unsigned int>(m_ring.count());
 
     // return number of buffers or -ENOMEM if not even two allocated
-    return (m_empty_queue.count() >= 2) ?
-        static_cast<unsigned int>(m_empty_queue.count()) : -ENOMEM;
+    return (m_ring.count() >= 2) ?
+        static_cast<unsigned int>(m_ring.count()) : -ENOMEM;
 }
 
 //***************************************************************************
 unsigned int Kwave::RecordThread::remainingBuffers()
 {
-    QMutexLocker lock(&m_lock);
-    return static_cast<unsigned int>(m_empty_queue.count());
+    return m_buffer_count - queuedBuffers();
 }
 
 //***************************************************************************
 unsigned int Kwave::RecordThread::queuedBuffers()
 {
-    QMutexLocker lock(&m_lock);
-    return static_cast<unsigned int>(m_full_queue.count());
+    const unsigned int released = m_released_count.load();
+    return m_filled_count.load() - released;
 }
 
 //***************************************************************************
-QByteArray Kwave::RecordThread::dequeue()
+const QByteArray *Kwave::RecordThread::waitForBuffer(int timeout)
 {
-    QMutexLocker lock(&m_lock);
+    if (!m_filled.tryAcquire(1, timeout)) return nullptr;
 
-    if (m_full_queue.count()) {
-        // de-queue the buffer from the full list
-        QByteArray buf = m_full_queue.dequeue();
-
-        // put the buffer back to the empty list
-        m_empty_queue.enqueue(buf);
+    const unsigned int index =
+        m_released_count.load(std::memory_order_relaxed) % m_buffer_count;
+    return &(m_ring.at(index));
+}
 
-        // return the buffer
-        return buf;
-    } else {
-        // return an empty buffer
-        return QByteArray();
-    }
+//***************************************************************************
+void Kwave::RecordThread::release()
+{
+    m_released_count.fetch_add(1, std::memory_order_release);
 }
 
 //***************************************************************************
@@ -124,29 +113,33 @@ void Kwave::RecordThread::run()
     int  result      = 0;
     bool interrupted = false;
 
+    Q_ASSERT(m_buffer_count);
+    if (!m_buffer_count) {
+        emit stopped(-ENOBUFS);
+        return;
+    }
+    QByteArray *ring = m_ring.data();
+
     // read data until we receive a close signal
     while (!isInterruptionRequested() && !interrupted) {
-        // dequeue a buffer from the "empty" queue
-
-        QByteArray buffer;
-        qsizetype  len;
-        {
-            QMutexLocker lock(&m_lock);
-
-            if (m_empty_queue.isEmpty()) {
-                // we had a "buffer overflow"
-                qWarning("RecordThread::run() -> NO EMPTY BUFFER FOUND !!!");
-                result = -ENOBUFS;
-                break;
-            }
+        // take the next buffer from the ring, if it has been released
+        const unsigned int filled =
+            m_filled_count.load(std::memory_order_relaxed);
+        const unsigned int released =
+            m_released_count.load(std::memory_order_acquire);
+        if (filled - released >= m_buffer_count) {
+            // we had a "buffer overflow"
+            qWarning("RecordThread::run() -> NO EMPTY BUFFER FOUND !!!");
+            result = -ENOBUFS;
+            break;
+        }
 
-            buffer  = m_empty_queue.dequeue();
-            len     = buffer.size();
-            Q_ASSERT(buffer.size());
-            if (!len) {
-                result = -ENOBUFS;
-                break;
-            }
+        QByteArray &buffer = ring[filled % m_buffer_count];
+        qsizetype   len    = buffer.size();
+        Q_ASSERT(len);
+        if (!len) {
+            result = -ENOBUFS;
+            break;
         }
 
         // read into the current buffer
@@ -183,20 +176,12 @@ void Kwave::RecordThread::run()
             }
         }
 
-        // return buffer into the empty queue and abort on errors
-        // do not use it
-        if (interrupted && (result < 0)) {
-            QMutexLocker lock(&m_lock);
-            m_empty_queue.enqueue(buffer);
-            break;
-        }
+        // abort on errors, leave the buffer in the ring, do not use it
+        if (interrupted && (result < 0)) break;
 
-        // inform the application that there is something to dequeue
-        {
-            QMutexLocker lock(&m_lock);
-            m_full_queue.enqueue(buffer);
-        }
-        emit bufferFull();
+        // hand the buffer over to the consumer
+        m_filled_count.store(filled + 1, std::memory_order_release);
+        m_filled.release();
     }
 
     // do not evaluate the result of the last operation if there
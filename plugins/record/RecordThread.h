@@ -20,9 +20,11 @@
 
 #include "config.h"
 
+#include <atomic>
+
 #include <QByteArray>
-#include <QQueue>
-#include <QRecursiveMutex>
+#include <QSemaphore>
+#include <QVector>
 
 #include "libkwave/WorkerThread.h"
 
@@ -31,6 +33,12 @@ namespace Kwave
 
     class RecordDevice;
 
+    /**
+     * Reads raw data from the record device into a ring of buffers. The
+     * buffers are handed over to a single consumer without any locking,
+     * the consumer keeps the buffer it works on in the ring until it
+     * calls release().
+     */
     class RecordThread: public Kwave::WorkerThread
     {
         Q_OBJECT
@@ -67,16 +75,22 @@ namespace Kwave
         /** Returns the number of queued filled buffers */
         unsigned int queuedBuffers();
 
-        /** De-queues a buffer from the m_full_queue. */
-        QByteArray dequeue();
-
-    signals:
+        /**
+         * Waits for the oldest filled buffer, must only be called by one
+         * consumer thread.
+         * @param timeout maximum time to wait [ms]
+         * @return pointer to the buffer, or null if none was filled in time.
+         *         The buffer stays valid until release() is called.
+         */
+        const QByteArray *waitForBuffer(int timeout);
 
         /**
-         * emitted when a buffer was full and has been de-queued
-         * with dequeue()
+         * Gives the buffer returned by waitForBuffer() back to the
+         * recording, for getting filled again
          */
-        void bufferFull();
+        void release();
+
+    signals:
 
         /**
          * emitted when the recording stops or aborts
@@ -87,17 +101,20 @@ namespace Kwave
 
     private:
 
-        /** lock for protecting the queues */
-        QRecursiveMutex m_lock;
-
         /** the device used as source */
         Kwave::RecordDevice *m_device;
 
-        /** queue with empty buffers for raw input data */
-        QQueue<QByteArray>m_empty_queue;
+        /** ring of buffers for raw input data */
+        QVector<QByteArray> m_ring;
+
+        /** number of buffers that have been filled, wraps around */
+        std::atomic<unsigned int> m_filled_count;
+
+        /** number of buffers that have been released, wraps around */
+        std::atomic<unsigned int> m_released_count;
 
-        /** queue with filled buffers with raw input data */
-        QQueue<QByteArray>m_full_queue;
+        /** counts filled buffers, for waking up the consumer */
+        QSemaphore m_filled;
 
         /** number of buffers to allocate */
         unsigned int m_buffer_count;
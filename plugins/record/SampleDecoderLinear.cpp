@@ -21,6 +21,8 @@
 
 #include "libkwave/Sample.h"
 #include "libkwave/SampleFormat.h"
+#include "libkwave/SampleKernels.h"
+#include "libkwave/SampleLinear.h"
 #include "libkwave/Utils.h"
 
 #include "SampleDecoderLinear.h"
@@ -34,68 +36,6 @@ static void decode_NULL(const quint8 *src, sample_t *dst, unsigned int count)
     }
 }
 
-//***************************************************************************
-// this little function is provided as inline code to avaid a compiler
-// warning about negative shift value when included directly
-static inline quint32 shl(const quint32 v, const int s)
-{
-    if (!s)
-        return v;
-    else if (s > 0)
-        return (v << s);
-    else
-        return (v >> (-s));
-}
-
-//***************************************************************************
-/**
- * Template for decoding a buffer with linear samples. The tricky part is
- * done in the compiler which optimizes away all unused parts of current
- * variant and does nice loop optimizing!
- * @param src array with raw data
- * @param dst array that receives the samples in Kwave's format
- * @param count the number of samples to be decoded
- */
-template<const unsigned int bits, const bool is_signed,
-         const bool is_little_endian>
-void decode_linear(const quint8 *src, sample_t *dst, unsigned int count)
-{
-    const int shift = (SAMPLE_BITS - bits);
-    const quint32 sign = 1 << (SAMPLE_BITS-1);
-    const quint32 negative = ~(sign - 1);
-    const quint32 bytes = (bits+7) >> 3;
-
-    while (count) {
-        count--;
-
-        // read from source buffer
-        quint32 s = 0;
-        if (is_little_endian) {
-            // little endian
-            for (unsigned int byte = 0; byte < bytes; ++byte, ++src) {
-                s |= static_cast<quint8>(*src) << (byte << 3);
-            }
-        } else {
-            // big endian
-            for (int byte = bytes - 1; byte >= 0; --byte, ++src) {
-                s |= static_cast<quint8>(*src) << (byte << 3);
-            }
-        }
-
-        // convert to signed
-        if (!is_signed) s -= shl(1, bits-1)-1;
-
-        // shift up to Kwave's bit count
-        s = shl(s, shift);
-
-        // sign correcture for negative values
-        if (is_signed && (s & sign)) s |= negative;
-
-        // write to destination buffer
-        *(dst++) = static_cast<sample_t>(s);
-    }
-}
-
 //***************************************************************************
 #define MAKE_DECODER(bits)                             \
 if (sample_format != Kwave::SampleFormat::Unsigned) {  \
@@ -155,6 +95,15 @@ Kwave::SampleDecoderLinear::SampleDecoderLinear(
             break;
         DEFAULT_IMPOSSIBLE;
     }
+
+    // use a vectorized variant if the CPU supports it
+    if (Kwave::SampleKernels::level() != Kwave::SampleKernels::Scalar) {
+        Kwave::SampleKernels::decoder_t fast =
+            Kwave::SampleKernels::linearDecoder(m_bytes_per_sample * 8,
+                (sample_format == Kwave::SampleFormat::Signed),
+                (endianness != Kwave::BigEndian));
+        if (fast) m_decoder = fast;
+    }
 }
 
 //***************************************************************************
@@ -163,7 +112,7 @@ Kwave::SampleDecoderLinear::~SampleDecoderLinear()
 }
 
 //***************************************************************************
-void Kwave::SampleDecoderLinear::decode(QByteArray &raw_data,
+void Kwave::SampleDecoderLinear::decode(const QByteArray &raw_data,
                                         Kwave::SampleArray &decoded)
 {
     Q_ASSERT(m_decoder);
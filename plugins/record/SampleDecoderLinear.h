@@ -49,7 +49,7 @@ namespace Kwave
          * @param raw_data array with raw undecoded audio data
          * @param decoded array with decoded samples
          */
-        virtual void decode(QByteArray &raw_data,
+        virtual void decode(const QByteArray &raw_data,
                             Kwave::SampleArray &decoded) override;
 
         /** Returns the number of bytes per sample in raw (not encoded) form */
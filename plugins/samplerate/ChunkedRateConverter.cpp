@@ -0,0 +1,188 @@
+/*************************************************************************
+ ChunkedRateConverter.cpp  -  sample rate conversion in independent chunks
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "config.h"
+
+#include <math.h>
+#include <numeric>
+#include <vector>
+
+#include <samplerate.h>
+
+#include "libkwave/SampleReader.h"
+
+#include "ChunkedRateConverter.h"
+
+/** nominal length of a chunk [input samples] */
+#define CHUNK_LENGTH (1024 * 1024)
+
+/** largest common period of the rates that allows chunks [samples] */
+#define MAX_PERIOD (CHUNK_LENGTH / 16)
+
+/**
+ * input samples that are added before and after a chunk for the warm-up
+ * and settling of the filter, at ratios >= 1. This is much more than the
+ * half length of the sinc filter of the best libsamplerate converter.
+ */
+#define FILTER_MARGIN 1024
+
+//***************************************************************************
+Kwave::ChunkedRateConverter::ChunkedRateConverter(double old_rate,
+                                                  double new_rate,
+                                                  int converter_type,
+                                                  sample_index_t length)
+    :m_ratio(new_rate / old_rate), m_converter_type(converter_type),
+     m_input_length(length), m_output_length(0), m_period_in(0),
+     m_period_out(0), m_margin(0), m_starts()
+{
+    // find the common period of both rates, if they are integer numbers
+    const quint64 r_old = static_cast<quint64>(rint(old_rate));
+    const quint64 r_new = static_cast<quint64>(rint(new_rate));
+    if (r_old && r_new &&
+        qFuzzyCompare(old_rate, static_cast<double>(r_old)) &&
+        qFuzzyCompare(new_rate, static_cast<double>(r_new)))
+    {
+        const quint64 gcd = std::gcd(r_old, r_new);
+        if (r_old / gcd <= MAX_PERIOD) {
+            m_period_in  = r_old / gcd;
+            m_period_out = r_new / gcd;
+        }
+    }
+
+    m_starts.append(0);
+    if (m_period_in) {
+        // exact length, in units of the period plus the rest
+        m_output_length = ((length / m_period_in) * m_period_out) +
+            (((length % m_period_in) * m_period_out) / m_period_in);
+
+        // the filter spans more input samples when reducing the rate
+        const sample_index_t margin = static_cast<sample_index_t>(
+            ceil(FILTER_MARGIN * qMax(1.0, 1.0 / m_ratio)));
+        m_margin = ((margin + m_period_in - 1) / m_period_in) * m_period_in;
+
+        // all chunks start at a multiple of the period
+        const sample_index_t step =
+            qMax<sample_index_t>(CHUNK_LENGTH / m_period_in, 1) *
+            m_period_in;
+        for (sample_index_t pos = step; pos < length; pos += step)
+            m_starts.append(pos);
+    } else {
+        m_output_length = static_cast<sample_index_t>(
+            static_cast<double>(length) * m_ratio);
+    }
+    m_starts.append(length);
+}
+
+//***************************************************************************
+Kwave::ChunkedRateConverter::~ChunkedRateConverter()
+{
+}
+
+//***************************************************************************
+sample_index_t Kwave::ChunkedRateConverter::outputPos(sample_index_t pos)
+    const
+{
+    if (!m_period_in)
+        return static_cast<sample_index_t>(static_cast<double>(pos) *
+                                           m_ratio);
+
+    Q_ASSERT(!(pos % m_period_in));
+    return (pos / m_period_in) * m_period_out;
+}
+
+//***************************************************************************
+bool Kwave::ChunkedRateConverter::convert(const Kwave::Stripe::List &input,
+                                          unsigned int chunk,
+                                          Kwave::SampleArray &output) const
+{
+    Q_ASSERT(chunk < chunks());
+    if (chunk >= chunks()) return false;
+
+    // range of the output
+    const sample_index_t start     = m_starts[chunk];
+    const sample_index_t end       = m_starts[chunk + 1];
+    const sample_index_t out_start = outputPos(start);
+    const sample_index_t out_end   = (chunk + 1 < chunks()) ?
+        outputPos(end) : m_output_length;
+    const unsigned int   out_len   = Kwave::toUint(out_end - out_start);
+    if (!output.resize(out_len)) return false;
+    if (!out_len) return true;
+
+    // range of the input, including the margins for the filter
+    const sample_index_t in_first = (start > m_margin) ?
+        (start - m_margin) : 0;
+    const sample_index_t in_end   = qMin(end + m_margin, m_input_length);
+    const unsigned int   in_len   = Kwave::toUint(in_end - in_first);
+    const sample_index_t skip     = out_start - outputPos(in_first);
+
+    // read the input, out of a snapshot of the track
+    Kwave::SampleArray samples(in_len);
+    if (samples.size() != in_len) return false;
+    Kwave::SampleReader reader(Kwave::SinglePassForward, input);
+    reader.seek(input.left() + in_first);
+    unsigned int read = 0;
+    while (read < in_len) {
+        const unsigned int count = reader.read(samples, read, in_len - read);
+        if (!count) break;
+        read += count;
+    }
+    Q_ASSERT(read == in_len);
+
+    std::vector<float> f_in(in_len);
+    const sample_t *s_in = samples.constData();
+    for (unsigned int i = 0; i < read; ++i)
+        f_in[i] = sample2float(s_in[i]);
+    for (unsigned int i = read; i < in_len; ++i)
+        f_in[i] = 0.0f;
+    samples = Kwave::SampleArray();
+
+    // convert the whole chunk in one pass
+    const unsigned int gen_max = Kwave::toUint(
+        ceil(static_cast<double>(in_len) * m_ratio)) + 16;
+    std::vector<float> f_out(gen_max);
+
+    SRC_DATA src;
+    src.data_in           = f_in.data();
+    src.data_out          = f_out.data();
+    src.input_frames      = in_len;
+    src.output_frames     = gen_max;
+    src.input_frames_used = 0;
+    src.output_frames_gen = 0;
+    src.end_of_input      = 1;
+    src.src_ratio         = m_ratio;
+
+    int error = src_simple(&src, m_converter_type, 1);
+    if (error) {
+        qWarning("ChunkedRateConverter: SRC error: '%s'",
+                 src_strerror(error));
+        return false;
+    }
+
+    // take the part that belongs to the chunk, without the margins
+    const sample_index_t gen = static_cast<sample_index_t>(
+        src.output_frames_gen);
+    sample_t *s_out = output.data();
+    for (unsigned int i = 0; i < out_len; ++i) {
+        const sample_index_t index = skip + i;
+        s_out[i] = (index < gen) ? float2sample(f_out[index]) : 0;
+    }
+
+    return true;
+}
+
+//***************************************************************************
+//***************************************************************************
@@ -0,0 +1,125 @@
+/*************************************************************************
+ ChunkedRateConverter.h  -  sample rate conversion in independent chunks
+                             -------------------
+    begin                : Sun Oct 18 2026
+    copyright            : (C) 2026 by agent
+    email                : agent@local
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef CHUNKED_RATE_CONVERTER_H
+#define CHUNKED_RATE_CONVERTER_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QVector>
+
+#include "libkwave/Sample.h"
+#include "libkwave/SampleArray.h"
+#include "libkwave/Stripe.h"
+#include "libkwave/Utils.h"
+
+namespace Kwave
+{
+    /**
+     * Converts the sample rate of a range of samples in chunks that can
+     * be processed independently and in parallel. Each chunk starts at a
+     * position where a sample of the old and a sample of the new rate
+     * fall onto the same instant, so that the output of a chunk is on
+     * the same time grid as the output of one single pass. Before its
+     * start and after its end each chunk gets some extra input for the
+     * warm-up and the settling of the interpolation filter, which is
+     * discarded afterwards.
+     *
+     * This needs both rates to be integer numbers with a not too large
+     * common period, otherwise there is only one chunk.
+     */
+    class ChunkedRateConverter
+    {
+    public:
+        /**
+         * Constructor
+         * @param old_rate the sample rate of the input
+         * @param new_rate the sample rate of the output
+         * @param converter_type type of the libsamplerate converter
+         * @param length number of input samples
+         */
+        ChunkedRateConverter(double old_rate, double new_rate,
+                             int converter_type, sample_index_t length);
+
+        /** Destructor */
+        virtual ~ChunkedRateConverter();
+
+        /** Returns the number of output samples */
+        inline sample_index_t outputLength() const {
+            return m_output_length;
+        }
+
+        /** Returns the number of chunks */
+        inline unsigned int chunks() const {
+            return Kwave::toUint(m_starts.count() - 1);
+        }
+
+        /**
+         * Converts one chunk of one track. The input and output of the
+         * chunk are held in memory, so this is meant for the case that
+         * the range could be split into several chunks.
+         * @param input the input samples, as list of stripes
+         * @param chunk index of the chunk [0 ... chunks() - 1]
+         * @param output receives the converted samples
+         * @return true if succeeded, false if out of memory or if the
+         *         converter failed
+         */
+        bool convert(const Kwave::Stripe::List &input, unsigned int chunk,
+                     Kwave::SampleArray &output) const;
+
+    private:
+
+        /**
+         * Returns the output position of an input position
+         * @param pos index of an input sample, at the start of a chunk
+         * @return index of the corresponding output sample
+         */
+        sample_index_t outputPos(sample_index_t pos) const;
+
+    private:
+
+        /** conversion ratio, ((new rate) / (old rate)) */
+        double m_ratio;
+
+        /** type of the libsamplerate converter */
+        int m_converter_type;
+
+        /** number of input samples */
+        sample_index_t m_input_length;
+
+        /** number of output samples */
+        sample_index_t m_output_length;
+
+        /** common period of both rates, in input samples (0 = none) */
+        sample_index_t m_period_in;
+
+        /** common period of both rates, in output samples */
+        sample_index_t m_period_out;
+
+        /** input samples before and after a chunk for the filter */
+        sample_index_t m_margin;
+
+        /** first input sample of each chunk, plus the input length */
+        QVector<sample_index_t> m_starts;
+    };
+}
+
+#endif /* CHUNKED_RATE_CONVERTER_H */
+
+//***************************************************************************
+//***************************************************************************
@@ -18,11 +18,17 @@
 #include "config.h"
 #include <errno.h>
 
+#include <atomic>
+
+#include <samplerate.h>
+
 #include <KLocalizedString> // for the i18n macro
 
 #include <QList>
 #include <QListIterator>
 #include <QStringList>
+#include <QThread>
+#include <QVector>
 
 #include "libkwave/Connect.h"
 #include "libkwave/FileInfo.h"
@@ -32,12 +38,14 @@
 #include "libkwave/PluginManager.h"
 #include "libkwave/SignalManager.h"
 #include "libkwave/Utils.h"
+#include "libkwave/WorkerPool.h"
 #include "libkwave/Writer.h"
 #include "libkwave/modules/RateConverter.h"
 #include "libkwave/undo/UndoTransactionGuard.h"
 #include "libkwave/undo/UndoAddMetaDataAction.h"
 #include "libkwave/undo/UndoDeleteMetaDataAction.h"
 
+#include "ChunkedRateConverter.h"
 #include "SampleRatePlugin.h"
 
 KWAVE_PLUGIN(samplerate, SampleRatePlugin)
@@ -46,7 +54,7 @@ KWAVE_PLUGIN(samplerate, SampleRatePlugin)
 Kwave::SampleRatePlugin::SampleRatePlugin(QObject *parent,
                                           const QVariantList &args)
     :Kwave::Plugin(parent, args), m_params(), m_new_rate(0.0),
-     m_whole_signal(false)
+     m_whole_signal(false), m_quality(SRC_SINC_MEDIUM_QUALITY)
 {
 }
 
@@ -64,19 +72,31 @@ int Kwave::SampleRatePlugin::interpreteParameters(QStringList &params)
     // set defaults
     m_new_rate     = 44100.0;
     m_whole_signal = false;
+    m_quality      = SRC_SINC_MEDIUM_QUALITY;
 
     // evaluate the parameter list
-    if (params.count() < 1) return -EINVAL;
+    if ((params.count() < 1) || (params.count() > 3)) return -EINVAL;
 
     param = params[0];
     m_new_rate = param.toDouble(&ok);
     if (!ok) return -EINVAL;
 
-    // check whether we should change the whole signal (optional)
-    if (params.count() == 2) {
-        if (params[1] != _("all"))
+    // check whether we should change the whole signal and
+    // which quality should be used (both optional)
+    for (int i = 1; i < params.count(); ++i) {
+        param = params[i];
+        if (param == _("all"))
+            m_whole_signal = true;
+        else if (param == _("best"))
+            m_quality = SRC_SINC_BEST_QUALITY;
+        else if (param == _("medium"))
+            m_quality = SRC_SINC_MEDIUM_QUALITY;
+        else if (param == _("fast"))
+            m_quality = SRC_SINC_FASTEST;
+        else if (param == _("linear"))
+            m_quality = SRC_LINEAR;
+        else
             return -EINVAL;
-        m_whole_signal = true;
     }
 
     // all parameters accepted
@@ -126,8 +146,9 @@ void Kwave::SampleRatePlugin::run(QStringList params)
 
     // calculate the new length
     double ratio = m_new_rate / old_rate;
-    sample_index_t new_length =
-        static_cast<sample_index_t>(double(length) * ratio);
+    Kwave::ChunkedRateConverter engine(old_rate, m_new_rate, m_quality,
+                                       length);
+    sample_index_t new_length = engine.outputLength();
     if ((new_length == length) || !new_length) return;
 
     Kwave::MetaDataList meta = mgr.metaData().selectByRange(first, last);
@@ -150,41 +171,63 @@ void Kwave::SampleRatePlugin::run(QStringList params)
         mgr.insertSpace(last + 1, new_length - length + 1, tracks);
     }
 
-    Kwave::MultiTrackReader source(Kwave::SinglePassForward,
-        mgr, tracks, first, last);
-
-    // connect the progress dialog
-    connect(&source, SIGNAL(progress(qreal)),
-            this,  SLOT(updateProgress(qreal)),
-             Qt::BlockingQueuedConnection);
     emit setProgressText(
         i18n("Changing sample rate from %1 kHz to %2 kHz...",
              (old_rate   / 1E3), (m_new_rate / 1E3))
     );
 
-    // create the converter
-    Kwave::MultiTrackSource<Kwave::RateConverter, true> converter(
-        static_cast<unsigned int>(tracks.count()), this);
-    converter.setAttribute(SLOT(setRatio(QVariant)), QVariant(ratio));
+    // number of samples that have been written
+    sample_index_t written = 0;
 
-    // create the writer with the appropriate length
-    Kwave::MultiTrackWriter sink(mgr, tracks, Kwave::Overwrite,
-        first, first + new_length - 1);
+    if (engine.chunks() > 1) {
+        // take a snapshot of the input, the output overwrites it
+        const QList<Kwave::Stripe::List> input =
+            mgr.stripes(tracks, first, last);
 
-    // connect the objects
-    bool    ok = Kwave::connect(source,    converter);
-    if (ok) ok = Kwave::connect(converter, sink);
-    if (!ok) return;
+        // create the writer with the appropriate length
+        Kwave::MultiTrackWriter sink(mgr, tracks, Kwave::Overwrite,
+            first, first + new_length - 1);
 
-    while (!shouldStop() && !source.eof()) {
-        source.goOn();
-        converter.goOn();
-    }
+        if (!convertInChunks(engine, input, sink))
+            qWarning("SampleRatePlugin: conversion failed");
+        sink.flush();
+        written = sink[0]->position() - first;
+    } else {
+        // no suitable chunks: convert each track in one stream
+        Kwave::MultiTrackReader source(Kwave::SinglePassForward,
+            mgr, tracks, first, last);
+
+        // connect the progress dialog
+        connect(&source, SIGNAL(progress(qreal)),
+                this,  SLOT(updateProgress(qreal)),
+                 Qt::BlockingQueuedConnection);
+
+        // create the converter
+        Kwave::MultiTrackSource<Kwave::RateConverter, true> converter(
+            static_cast<unsigned int>(tracks.count()), this);
+        converter.setAttribute(SLOT(setRatio(QVariant)), QVariant(ratio));
+        converter.setAttribute(SLOT(setQuality(QVariant)),
+                               QVariant(m_quality));
+
+        // create the writer with the appropriate length
+        Kwave::MultiTrackWriter sink(mgr, tracks, Kwave::Overwrite,
+            first, first + new_length - 1);
+
+        // connect the objects
+        bool    ok = Kwave::connect(source,    converter);
+        if (ok) ok = Kwave::connect(converter, sink);
+        if (!ok) return;
+
+        while (!shouldStop() && !source.eof()) {
+            source.goOn();
+            converter.goOn();
+        }
 
-    sink.flush();
+        sink.flush();
+        written = sink[0]->position() - first;
+    }
 
-    // find out how many samples have been written and delete the leftovers
-    sample_index_t written = sink[0]->position() - first;
+    // delete the leftovers
 //     qDebug("SampleRatePlugin: old=%u, expected=%u, written=%u",
 //          length, new_length, written);
     if (written < length) {
@@ -235,6 +278,67 @@ void Kwave::SampleRatePlugin::run(QStringList params)
 
 }
 
+//***************************************************************************
+bool Kwave::SampleRatePlugin::convertInChunks(
+    const Kwave::ChunkedRateConverter &engine,
+    const QList<Kwave::Stripe::List> &input,
+    Kwave::MultiTrackWriter &sink)
+{
+    const unsigned int tracks  = Kwave::toUint(input.count());
+    const unsigned int chunks  = engine.chunks();
+    const unsigned int threads =
+        Kwave::toUint(qMax(QThread::idealThreadCount(), 1));
+    Q_ASSERT(tracks);
+    if (!tracks || !chunks) return false;
+
+    // enough chunks per pass to keep all CPUs busy
+    const unsigned int window = qMax(1U, (threads + tracks - 1) / tracks);
+
+    connect(this, SIGNAL(conversionProgress(qreal)),
+            this, SLOT(updateProgress(qreal)),
+            Qt::QueuedConnection);
+
+    bool ok = true;
+    for (unsigned int first = 0; (first < chunks) && !shouldStop();
+         first += window)
+    {
+        const unsigned int count = qMin(window, chunks - first);
+        const unsigned int jobs  = count * tracks;
+
+        // convert all tracks of some chunks in parallel
+        QVector<Kwave::SampleArray> blocks(jobs);
+        std::atomic<bool> failed(false);
+        Kwave::WorkerPool::instance().run(jobs,
+            [&](unsigned int index) {
+                if (failed) return;
+                const unsigned int chunk = first + (index / tracks);
+                const unsigned int track = index % tracks;
+                if (!engine.convert(input[Kwave::toInt(track)], chunk,
+                                    blocks[index]))
+                    failed = true;
+            }
+        );
+        if (failed) {
+            ok = false;
+            break;
+        }
+
+        // write the results in the order of the chunks
+        for (unsigned int index = 0; index < jobs; ++index) {
+            Kwave::Writer *writer = sink[index % tracks];
+            if (writer) (*writer) << blocks[index];
+            blocks[index] = Kwave::SampleArray();
+        }
+
+        emit conversionProgress(qreal(100.0) *
+            static_cast<qreal>(first + count) / static_cast<qreal>(chunks));
+    }
+
+    disconnect(this, SIGNAL(conversionProgress(qreal)),
+               this, SLOT(updateProgress(qreal)));
+    return ok;
+}
+
 //***************************************************************************
 #include "SampleRatePlugin.moc"
 //***************************************************************************
@@ -20,14 +20,19 @@
 
 #include "config.h"
 
+#include <QList>
 #include <QString>
 #include <QStringList>
 
 #include "libkwave/Plugin.h"
 #include "libkwave/Sample.h"
+#include "libkwave/Stripe.h"
 
 namespace Kwave
 {
+    class ChunkedRateConverter;
+    class MultiTrackWriter;
+
     /**
      * @class SampleRatePlugin
      * Change the sample rate of a signal
@@ -54,6 +59,14 @@ namespace Kwave
          */
         void run(QStringList params) override;
 
+    signals:
+
+        /**
+         * emitted from the conversion in chunks
+         * @param progress the current progress in percent [0...100]
+         */
+        void conversionProgress(qreal progress);
+
     protected:
 
         /**
@@ -63,6 +76,20 @@ namespace Kwave
          */
         int interpreteParameters(QStringList &params);
 
+    private:
+
+        /**
+         * Converts all chunks of all tracks, as many in parallel as
+         * there are CPUs, and writes the results in their order
+         * @param engine the converter, split into more than one chunk
+         * @param input snapshot of the input samples, one list per track
+         * @param sink writers for the output range
+         * @return true if succeeded, false if the conversion failed
+         */
+        bool convertInChunks(const Kwave::ChunkedRateConverter &engine,
+                             const QList<Kwave::Stripe::List> &input,
+                             Kwave::MultiTrackWriter &sink);
+
     private:
 
         /** list of parameters */
@@ -74,6 +101,9 @@ namespace Kwave
         /** if true, ignore selection and change whole signal */
         bool m_whole_signal;
 
+        /** type of the libsamplerate converter, quality vs. speed */
+        int m_quality;
+
     };
 }
 
@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: 2026 agent <agent@local>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <math.h>
+#include <vector>
+
+#include <samplerate.h>
+
+#include "ChunkedRateConverter.h"
+#include "libkwave/SampleArray.h"
+#include "libkwave/Stripe.h"
+#include <QTest>
+
+/** length of the input, enough for several chunks */
+static const unsigned int LENGTH = 5 * 512 * 1024;
+
+/** offset of the input within the track */
+static const sample_index_t OFFSET = 1000;
+
+/** largest allowed difference to a single pass, about -80dB */
+static const sample_t TOLERANCE = SAMPLE_MAX / 10000;
+
+class TestChunkedRateConverter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void sameAsSinglePass_data();
+    void sameAsSinglePass();
+
+private:
+    /** the input samples */
+    Kwave::SampleArray m_input;
+};
+
+void TestChunkedRateConverter::initTestCase()
+{
+    // two tones and some noise, without clipping
+    QVERIFY(m_input.resize(LENGTH));
+    quint32 random = 1;
+    for (unsigned int i = 0; i < LENGTH; ++i) {
+        random = (random * 0x0019660DU) + 0x3C6EF35FU;
+        const double noise = static_cast<double>(random >> 8) /
+            static_cast<double>(1 << 24) - 0.5;
+        const double value =
+            0.4 * sin(i * 0.0571) + 0.3 * sin(i * 0.9123) + 0.1 * noise;
+        m_input[i] = float2sample(static_cast<float>(value));
+    }
+}
+
+void TestChunkedRateConverter::sameAsSinglePass_data()
+{
+    QTest::addColumn<double>("old_rate");
+    QTest::addColumn<double>("new_rate");
+    QTest::addColumn<int>("type");
+
+    QTest::newRow("44.1k -> 48k") << 44100.0 << 48000.0
+                                  << int(SRC_SINC_MEDIUM_QUALITY);
+    QTest::newRow("96k -> 48k")   << 96000.0 << 48000.0
+                                  << int(SRC_SINC_MEDIUM_QUALITY);
+    // the margin has to grow with the length of the filter
+    QTest::newRow("44.1k -> 8k")  << 44100.0 << 8000.0
+                                  << int(SRC_SINC_BEST_QUALITY);
+}
+
+void TestChunkedRateConverter::sameAsSinglePass()
+{
+    QFETCH(double, old_rate);
+    QFETCH(double, new_rate);
+    QFETCH(int, type);
+
+    Kwave::ChunkedRateConverter converter(old_rate, new_rate, type, LENGTH);
+    QVERIFY(converter.chunks() > 1);
+    const sample_index_t length = converter.outputLength();
+    QVERIFY(length > 0);
+
+    // reference: one pass over all input
+    const double ratio = new_rate / old_rate;
+    std::vector<float> f_in(LENGTH);
+    for (unsigned int i = 0; i < LENGTH; ++i)
+        f_in[i] = sample2float(m_input[i]);
+    std::vector<float> f_out(static_cast<size_t>(
+        ceil(static_cast<double>(LENGTH) * ratio)) + 16);
+
+    SRC_DATA src;
+    src.data_in           = f_in.data();
+    src.data_out          = f_out.data();
+    src.input_frames      = LENGTH;
+    src.output_frames     = static_cast<long>(f_out.size());
+    src.input_frames_used = 0;
+    src.output_frames_gen = 0;
+    src.end_of_input      = 1;
+    src.src_ratio         = ratio;
+    QCOMPARE(src_simple(&src, type, 1), 0);
+    const sample_index_t gen =
+        static_cast<sample_index_t>(src.output_frames_gen);
+
+    // all chunks, out of a track with more than one stripe
+    Kwave::Stripe::List input(OFFSET, OFFSET + LENGTH - 1);
+    const unsigned int half = LENGTH / 2;
+    Kwave::SampleArray first(half);
+    Kwave::SampleArray second(LENGTH - half);
+    QCOMPARE(first.size(), half);
+    QCOMPARE(second.size(), LENGTH - half);
+    for (unsigned int i = 0; i < half; ++i)
+        first[i] = m_input[i];
+    for (unsigned int i = half; i < LENGTH; ++i)
+        second[i - half] = m_input[i];
+    input.append(Kwave::Stripe(OFFSET, first));
+    input.append(Kwave::Stripe(OFFSET + half, second));
+
+    sample_index_t pos = 0;
+    for (unsigned int chunk = 0; chunk < converter.chunks(); ++chunk) {
+        Kwave::SampleArray output;
+        QVERIFY(converter.convert(input, chunk, output));
+        for (unsigned int i = 0; i < output.size(); ++i, ++pos) {
+            const sample_t expected =
+                (pos < gen) ? float2sample(f_out[pos]) : 0;
+            if (qAbs(output[i] - expected) > TOLERANCE) {
+                qWarning("chunk %u, output %llu: %d instead of %d",
+                         chunk, static_cast<unsigned long long>(pos),
+                         output[i], expected);
+                QFAIL("output differs from a single pass");
+            }
+        }
+    }
+    QCOMPARE(pos, length);
+}
+
+QTEST_MAIN(TestChunkedRateConverter)
+#include "test_ChunkedRateConverter.moc"
@@ -20,6 +20,7 @@
 
 #include "config.h"
 
+#include <atomic>
 #include <errno.h>
 
 #include <QDir>
@@ -38,10 +39,12 @@
 #include "libkwave/LabelList.h"
 #include "libkwave/MessageBox.h"
 #include "libkwave/MetaDataList.h"
+#include "libkwave/MultiTrackReader.h"
 #include "libkwave/Parser.h"
 #include "libkwave/SignalManager.h"
 #include "libkwave/String.h"
 #include "libkwave/Utils.h"
+#include "libkwave/WorkerPool.h"
 
 #include "SaveBlocksDialog.h"
 #include "SaveBlocksPlugin.h"
@@ -219,22 +222,6 @@ int Kwave::SaveBlocksPlugin::start(QStringList &params)
 //     qDebug("indices          = %u...%u (count=%u)", first,
 //             first + count - 1, count);
 
-    // remember the original file info and determine the list of unsupported
-    // properties, we need that later to avoid that the signal manager
-    // complains on saving each and every block, again and again...
-    const Kwave::FileInfo orig_file_info(signalManager().metaData());
-    Kwave::FileInfo file_info(orig_file_info);
-    QList<Kwave::FileProperty> unsupported_properties;
-    {
-        QString mimetype = Kwave::CodecManager::mimeTypeOf(m_url);
-        Kwave::Encoder *encoder = Kwave::CodecManager::encoder(mimetype);
-        if (encoder) {
-            unsupported_properties = encoder->unsupportedProperties(
-                file_info.properties().keys());
-            delete encoder;
-        }
-    }
-
     // iterate over all blocks to check for overwritten files and missing dirs
     QStringList  overwritten_files;
     QStringList  missing_dirs;
@@ -308,18 +295,47 @@ int Kwave::SaveBlocksPlugin::start(QStringList &params)
         }
     }
 
-    // save the current selection, we have to restore it afterwards!
-    sample_index_t saved_selection_left  = 0;
-    sample_index_t saved_selection_right = 0;
-    selection(nullptr, &saved_selection_left, &saved_selection_right, false);
+    // the blocks are saved with the tracks of the current selection
+    const QVector<unsigned int> tracks = selectedTracks();
+    if (tracks.isEmpty()) {
+        Kwave::MessageBox::error(parentWidget(),
+            i18n("Signal is empty, nothing to save."));
+        return -1;
+    }
+
+    // this encoder is only used for preparing the meta data, each block
+    // gets an own instance when it is saved
+    m_mimetype = Kwave::CodecManager::mimeTypeOf(m_url);
+    Kwave::Encoder *encoder = Kwave::CodecManager::encoder(m_mimetype);
+    if (!encoder) {
+        Kwave::MessageBox::error(parentWidget(),
+            i18n("Sorry, the file type is not supported."));
+        return -EINVAL;
+    }
 
-    // now we can loop over all blocks and save them
+    // ask only once whether it is ok to lose some properties and remove
+    // them, so that saving the blocks does not complain again and again
+    const Kwave::FileInfo orig_file_info(signalManager().metaData());
+    Kwave::FileInfo file_info(orig_file_info);
+    file_info.set(Kwave::INF_MIMETYPE, m_mimetype);
+    if (!signalManager().acceptLostProperties(*encoder, file_info)) {
+        delete encoder;
+        return -1;
+    }
+    const QList<Kwave::FileProperty> unsupported_properties =
+        encoder->unsupportedProperties(file_info.properties().keys());
+    for (const Kwave::FileProperty &p : unsupported_properties)
+        file_info.set(p, QVariant());
+
+    // now we can loop over all blocks and prepare them, the selection
+    // and the meta data of the signal stay untouched
     sample_index_t block_start;
     sample_index_t block_end = 0;
     Kwave::LabelList labels(signalManager().metaData());
     Kwave::LabelListIterator it(labels);
     Kwave::Label label = it.hasNext() ? it.next() : Kwave::Label();
 
+    m_jobs.clear();
     for (unsigned int index = first;;) {
         block_start = block_end;
         block_end   = (label.isNull()) ? signalLength() : label.pos();
@@ -335,9 +351,6 @@ int Kwave::SaveBlocksPlugin::start(QStringList &params)
             Q_ASSERT(right > left);
             if (right <= left) break; // zero-length ?
 
-            // select the range of samples
-            selectRange(left, right - left + 1);
-
             // determine the filename
             QString name = createFileName(base, ext, m_pattern, index, count,
                                           first + count - 1);
@@ -348,6 +361,7 @@ int Kwave::SaveBlocksPlugin::start(QStringList &params)
             url.setPath(url.path(QUrl::FullyEncoded) + name, QUrl::StrictMode);
 
             // enter the title of the block into the meta data if supported
+            Kwave::FileInfo info(file_info);
             if (!unsupported_properties.contains(INF_NAME)) {
                 QString title = orig_file_info.get(INF_NAME).toString();
                 int idx = index - first;
@@ -356,30 +370,25 @@ int Kwave::SaveBlocksPlugin::start(QStringList &params)
                     if (block_title.length())
                         title = title + _(", ") + block_title;
                 }
-                file_info.set(INF_NAME, QVariant(title));
-                signalManager().metaData().replace(
-                    Kwave::MetaDataList(file_info));
-            }
-
-            qDebug("saving %9lu...%9lu -> '%s'",
-                   static_cast<unsigned long int>(left),
-                   static_cast<unsigned long int>(right),
-                   DBG(url.toDisplayString()));
-            if (signalManager().save(url, true) < 0)
-                break;
-
-            // if there were unsupported properties, the user might have been
-            // asked whether it is ok to continue or not. If he answered with
-            // "Cancel", we do not reach this point, otherwise we can continue
-            // and prevent any further annoying questions by removing all
-            // unsupported file info before the next run...
-            if ((index == first) && !unsupported_properties.isEmpty()) {
-                for (const Kwave::FileProperty &p : unsupported_properties) {
-                    file_info.set(p, QVariant());
-                }
-                signalManager().metaData().replace(
-                    Kwave::MetaDataList(file_info));
+                info.set(INF_NAME, QVariant(title));
             }
+            signalManager().prepareFileInfo(info, *encoder,
+                right - left + 1, Kwave::toUint(tracks.count()));
+
+            // adjust all position aware meta data in a copy
+            ExportJob job;
+            job.m_url    = url;
+            job.m_length = right - left + 1;
+            job.m_meta   = signalManager().metaData();
+            job.m_meta.replace(Kwave::MetaDataList(info));
+            job.m_meta.cropByRange(left, right);
+            Kwave::FileInfo block_info(job.m_meta);
+            block_info.set(Kwave::INF_FILENAME, url.path());
+            job.m_meta.replace(Kwave::MetaDataList(block_info));
+
+            // take a snapshot of the samples, the storage is shared
+            job.m_stripes = signalManager().stripes(tracks, left, right);
+            m_jobs.append(job);
 
             // increment the index for the next filename
             index++;
@@ -387,17 +396,84 @@ int Kwave::SaveBlocksPlugin::start(QStringList &params)
         if (label.isNull()) break;
         label = (it.hasNext()) ? it.next() : Kwave::Label();
     }
+    delete encoder;
 
-    // restore the original file info
-    signalManager().metaData().replace(
-        Kwave::MetaDataList(orig_file_info));
+    return Kwave::Plugin::start(params);
+}
+
+//***************************************************************************
+void Kwave::SaveBlocksPlugin::run(QStringList params)
+{
+    Q_UNUSED(params)
+
+    sample_index_t total = 0;
+    for (const ExportJob &job : m_jobs)
+        total += job.m_length;
+
+    connect(this, SIGNAL(exportProgress(qreal)),
+            this, SLOT(updateProgress(qreal)),
+            Qt::QueuedConnection);
+
+    // each block gets an own encoder and reader, the pool limits the
+    // number of blocks that are encoded at the same time
+    std::atomic<sample_index_t> done(0);
+    std::atomic<bool> failed(false);
+    Kwave::WorkerPool::instance().run(Kwave::toUint(m_jobs.count()),
+        [&](unsigned int index) {
+            if (failed || shouldStop()) return;
+            const ExportJob &job = m_jobs.at(index);
+            if (!exportBlock(job)) {
+                failed = true;
+                return;
+            }
+            const sample_index_t saved = (done += job.m_length);
+            emit exportProgress(100.0 * static_cast<qreal>(saved) /
+                                static_cast<qreal>(total));
+        }
+    );
+
+    disconnect(this, SIGNAL(exportProgress(qreal)),
+               this, SLOT(updateProgress(qreal)));
 
-    // restore the previous selection
-    selectRange(saved_selection_left,
-        (saved_selection_left != saved_selection_right) ?
-        (saved_selection_right - saved_selection_left + 1) : 0);
+    // release the snapshots of the samples
+    m_jobs.clear();
 
-    return result;
+    if (failed && !shouldStop())
+        Kwave::MessageBox::error(parentWidget(),
+            i18n("An error occurred while saving the file."));
+}
+
+//***************************************************************************
+bool Kwave::SaveBlocksPlugin::exportBlock(const ExportJob &job)
+{
+    Kwave::Encoder *encoder = Kwave::CodecManager::encoder(m_mimetype);
+    Q_ASSERT(encoder);
+    if (!encoder) return false;
+
+    qDebug("saving %9lu samples -> '%s'",
+           static_cast<unsigned long int>(job.m_length),
+           DBG(job.m_url.toDisplayString()));
+
+    QFile dst(job.m_url.path());
+    Kwave::MultiTrackReader src(Kwave::SinglePassForward, job.m_stripes);
+    connect(this, SIGNAL(sigCancel()), &src, SLOT(cancel()),
+            Qt::DirectConnection);
+
+    bool encoded = false;
+    if (src.tracks() == Kwave::toUint(job.m_stripes.count()))
+        encoded = encoder->encode(parentWidget(), src, dst, job.m_meta);
+    if (!encoded)
+        qWarning("SaveBlocksPlugin: saving '%s' failed",
+                 DBG(job.m_url.toDisplayString()));
+
+    delete encoder;
+    return encoded;
+}
+
+//***************************************************************************
+QString Kwave::SaveBlocksPlugin::progressText()
+{
+    return i18n("Saving blocks...");
 }
 
 //***************************************************************************
@@ -22,11 +22,14 @@
 
 #include "config.h"
 
+#include <QList>
 #include <QObject>
 #include <QString>
 #include <QUrl>
 
+#include "libkwave/MetaDataList.h"
 #include "libkwave/Plugin.h"
+#include "libkwave/Stripe.h"
 
 namespace Kwave
 {
@@ -55,11 +58,24 @@ namespace Kwave
             override;
 
         /**
-         * Saves the files, using the settings made in "setup()"
+         * Prepares saving the files, using the settings made in "setup()".
+         * Determines the range, file name and meta data of all blocks and
+         * takes a snapshot of their samples.
          * @see Kwave::Plugin::start()
          */
         int start(QStringList &params) override;
 
+        /**
+         * Saves all blocks prepared in start(), several of them in
+         * parallel. The selection and the meta data of the signal are
+         * not touched.
+         * @see Kwave::Plugin::run()
+         */
+        void run(QStringList params) override;
+
+        /** @see Kwave::Plugin::progressText() */
+        QString progressText() override;
+
         /** mode for numbering the output files */
         typedef enum {
             CONTINUE      = 0,
@@ -141,6 +157,12 @@ namespace Kwave
         /** emitted by updateExample to update the filename preview */
         void sigNewExample(const QString &example);
 
+        /**
+         * emitted from the worker threads whenever a block has been saved
+         * @param progress the overall progress [0...100]
+         */
+        void exportProgress(qreal progress);
+
     private slots:
 
         /**
@@ -166,6 +188,14 @@ namespace Kwave
             QString        m_title;  /**< title of the block */
         } BlockInfo;
 
+        /** everything needed for saving one block without the signal */
+        typedef struct {
+            QUrl                       m_url;     /**< destination */
+            sample_index_t             m_length;  /**< number of samples */
+            Kwave::MetaDataList        m_meta;    /**< meta data */
+            QList<Kwave::Stripe::List> m_stripes; /**< samples, one per track */
+        } ExportJob;
+
     private:
 
         /**
@@ -178,6 +208,13 @@ namespace Kwave
         QString createDisplayList(const QStringList &list,
                                   unsigned int max_entries) const;
 
+        /**
+         * Saves one block, can be called from any thread
+         * @param job description and samples of the block
+         * @return true if succeeded, false on errors
+         */
+        bool exportBlock(const ExportJob &job);
+
     private:
 
         /** the URL of the first file (user selection) */
@@ -195,6 +232,12 @@ namespace Kwave
         /** list of all blocks to save */
         QList<BlockInfo> m_block_info;
 
+        /** mime type of the files to save */
+        QString m_mimetype;
+
+        /** blocks to be saved in run(), prepared by start() */
+        QList<ExportJob> m_jobs;
+
     };
 }
 
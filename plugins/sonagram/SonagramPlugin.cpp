@@ -64,12 +64,12 @@ Kwave::SonagramPlugin::SonagramPlugin(QObject *parent,
     :Kwave::Plugin(parent, args),
      m_sonagram_window(nullptr),
      m_selection(nullptr),
-     m_slices(0), m_fft_points(0),
+     m_slices(0), m_stride(1), m_fft_points(0),
      m_window_type(Kwave::WINDOW_FUNC_NONE), m_color(true),
      m_track_changes(true), m_follow_selection(false), m_image(),
      m_overview_cache(nullptr), m_slice_pool(), m_valid(MAX_SLICES, false),
      m_pending_jobs(), m_lock_job_list(), m_future(),
-     m_repaint_timer()
+     m_repaint_timer(), m_fft_plans(), m_lock_fft_plans()
 {
     i18n("Sonagram");
 
@@ -93,6 +93,16 @@ Kwave::SonagramPlugin::~SonagramPlugin()
 
     delete m_selection;
     m_selection = nullptr;
+
+    // free the cached FFT plans
+    QMutexLocker _lock(&m_lock_fft_plans);
+    if (!m_fft_plans.isEmpty()) {
+        Kwave::GlobalLock _global_lock; // libfftw is not threadsafe!
+        QHash<unsigned int, fftw_plan>::const_iterator it;
+        for (it = m_fft_plans.constBegin(); it != m_fft_plans.constEnd(); ++it)
+            fftw_destroy_plan(it.value());
+        m_fft_plans.clear();
+    }
 }
 
 //***************************************************************************
@@ -192,18 +202,23 @@ int Kwave::SonagramPlugin::start(QStringList &params)
     if (!length || selected_channels.isEmpty())
         return -EINVAL;
 
-    // calculate the number of slices (width of image)
-    m_slices = Kwave::toUint(ceil(static_cast<double>(length) /
-                                  static_cast<double>(m_fft_points)));
-    if (m_slices > MAX_SLICES) m_slices = MAX_SLICES;
-
-    /* limit selection to INT_MAX samples (limitation of the cache index) */
-    if ((length / m_fft_points) >= SAMPLE_INDEX_MAX) {
+    /* limit selection to INT_MAX slices (limitation of the cache index) */
+    if ((length / m_fft_points) >= static_cast<sample_index_t>(
+        std::numeric_limits<int>::max()))
+    {
         Kwave::MessageBox::error(parentWidget(),
                                  i18n("File or selection too large"));
         return -EFBIG;
     }
 
+    // calculate the number of slices (width of image), if there are more
+    // FFT frames than fit into the image, combine several of them into
+    // one slice, so that the image size stays bounded
+    const sample_index_t frames = (length + m_fft_points - 1) / m_fft_points;
+    m_stride = Kwave::toUint((frames + MAX_SLICES - 1) / MAX_SLICES);
+    if (!m_stride) m_stride = 1;
+    m_slices = Kwave::toUint((frames + m_stride - 1) / m_stride);
+
     // create a selection tracker
     m_selection = new(std::nothrow) Kwave::SelectionTracker(
         &sig_mgr, offset, length, &selected_channels);
@@ -251,6 +266,7 @@ int Kwave::SonagramPlugin::start(QStringList &params)
     m_sonagram_window->setColorMode((m_color) ? 1 : 0);
     m_sonagram_window->setImage(m_image);
     m_sonagram_window->setPoints(m_fft_points);
+    m_sonagram_window->setStride(m_stride);
     m_sonagram_window->setRate(signalRate());
     m_sonagram_window->show();
 
@@ -272,6 +288,7 @@ void Kwave::SonagramPlugin::makeAllValid()
 {
     unsigned int             fft_points;
     unsigned int             slices;
+    unsigned int             stride;
     Kwave::window_function_t window_type;
     sample_index_t           first_sample;
     sample_index_t           last_sample;
@@ -286,6 +303,7 @@ void Kwave::SonagramPlugin::makeAllValid()
 
         fft_points   = m_fft_points;
         slices       = m_slices;
+        stride       = m_stride;
         window_type  = m_window_type;
         first_sample = m_selection->first();
         last_sample  = m_selection->last();
@@ -310,64 +328,96 @@ void Kwave::SonagramPlugin::makeAllValid()
 //     qDebug("SonagramPlugin[%p]::makeAllValid() [%llu .. %llu]",
 //      static_cast<void *>(this), first_sample, last_sample);
 
+    // if a slice covers more than one FFT frame, the first pass uses only
+    // one frame per slice and gives a quick preview of the whole range,
+    // the following passes refine it with further frames in between
+    const unsigned int passes = qMin<unsigned int>(stride,
+                                                   MAX_FRAMES_PER_SLICE);
+
     QFutureSynchronizer<void> synchronizer;
-    for (unsigned int slice_nr = 0; slice_nr < slices; slice_nr++) {
-//      qDebug("SonagramPlugin::run(): calculating slice %d of %d",
-//             slice_nr, m_slices);
-
-        if (valid[slice_nr]) continue;
-
-        // determine start of the stripe
-        sample_index_t pos = first_sample + (slice_nr * fft_points);
-
-        // get a new slice from the pool and initialize it
-        Kwave::SonagramPlugin::Slice *slice = m_slice_pool.allocate();
-        Q_ASSERT(slice);
-
-        slice->m_index = slice_nr;
-        memset(slice->m_input,  0x00, sizeof(slice->m_input));
-        memset(slice->m_output, 0x00, sizeof(slice->m_output));
-
-        if ((pos <= last_sample) && (tracks)) {
-            // initialize result with zeroes
-            memset(slice->m_result, 0x00, sizeof(slice->m_result));
-
-            // seek to the start of the slice
-            source.seek(pos);
-
-            // we have a new slice, now fill it's input buffer
-            double *in = slice->m_input;
-            for (unsigned int j = 0; j < fft_points; j++) {
-                double value = 0.0;
-                if (!(source.eof())) {
-                    for (unsigned int t = 0; t < tracks; t++) {
-                        sample_t s = 0;
-                        Kwave::SampleReader *reader = source[t];
-                        Q_ASSERT(reader);
-                        if (reader) *reader >> s;
-                        value += sample2double(s);
+    bool stop = false;
+    for (unsigned int pass = 0; (pass < passes) && !stop; pass++) {
+        const sample_index_t frame_offset =
+            (static_cast<sample_index_t>(pass) * stride) / passes;
+        for (unsigned int slice_nr = 0; slice_nr < slices; slice_nr++) {
+//          qDebug("SonagramPlugin::run(): calculating slice %d of %d",
+//                 slice_nr, m_slices);
+
+            if (valid[slice_nr]) continue;
+
+            // determine start of the stripe
+            sample_index_t pos = first_sample + ((
+                (static_cast<sample_index_t>(slice_nr) * stride) + frame_offset
+            ) * fft_points);
+
+            // refinement passes only for frames within the range
+            if (pass && (pos > last_sample)) continue;
+
+            // get a new slice from the pool and initialize it
+            Kwave::SonagramPlugin::Slice *slice = m_slice_pool.allocate();
+            Q_ASSERT(slice);
+
+            slice->m_index = slice_nr;
+            slice->m_pass  = pass;
+            memset(slice->m_input,  0x00, sizeof(slice->m_input));
+            memset(slice->m_output, 0x00, sizeof(slice->m_output));
+
+            if ((pos <= last_sample) && (tracks)) {
+                // initialize result with zeroes
+                memset(slice->m_result, 0x00, sizeof(slice->m_result));
+
+                // seek to the start of the slice
+                source.seek(pos);
+
+                // we have a new slice, now fill it's input buffer
+                double *in = slice->m_input;
+                for (unsigned int j = 0; j < fft_points; j++) {
+                    double value = 0.0;
+                    if (!(source.eof())) {
+                        for (unsigned int t = 0; t < tracks; t++) {
+                            sample_t s = 0;
+                            Kwave::SampleReader *reader = source[t];
+                            Q_ASSERT(reader);
+                            if (reader) *reader >> s;
+                            value += sample2double(s);
+                        }
+                        value /= tracks;
                     }
-                    value /= tracks;
+                    in[j] = value * windowfunction[j];
+                }
+
+                // get the plan, it is created only once per size
+                fftw_plan plan = fftPlan(fft_points, slice);
+                if (!plan) {
+                    m_slice_pool.release(slice);
+                    stop = true;
+                    break;
                 }
-                in[j] = value * windowfunction[j];
+
+                // a background job is running soon
+                // (for counterpart, see insertSlice(...) below [main thread])
+                m_pending_jobs.lockForRead();
+
+                // run the FFT in a background thread
+                synchronizer.addFuture(QtConcurrent::run(
+                    &Kwave::SonagramPlugin::calculateSlice, this, slice, plan)
+                );
+            } else {
+                // range has been deleted -> fill with "empty"
+                memset(slice->m_result, 0xFF, sizeof(slice->m_result));
+                m_pending_jobs.lockForRead();
+                emit sliceAvailable(slice);
             }
 
-            // a background job is running soon
-            // (for counterpart, see insertSlice(...) below [main thread])
-            m_pending_jobs.lockForRead();
-
-            // run the FFT in a background thread
-            synchronizer.addFuture(QtConcurrent::run(
-                &Kwave::SonagramPlugin::calculateSlice, this, slice)
-            );
-        } else {
-            // range has been deleted -> fill with "empty"
-            memset(slice->m_result, 0xFF, sizeof(slice->m_result));
-            m_pending_jobs.lockForRead();
-            emit sliceAvailable(slice);
+            if (shouldStop()) {
+                stop = true;
+                break;
+            }
         }
 
-        if (shouldStop()) break;
+        // the results of a pass must be queued before the refinements
+        // of the next pass, which are merged into them
+        synchronizer.waitForFinished();
     }
 
 //     qDebug("SonagramPlugin::makeAllValid(): waiting for background jobs...");
@@ -396,30 +446,45 @@ void Kwave::SonagramPlugin::run(QStringList params)
 }
 
 //***************************************************************************
-void Kwave::SonagramPlugin::calculateSlice(Kwave::SonagramPlugin::Slice *slice)
+fftw_plan Kwave::SonagramPlugin::fftPlan(unsigned int points,
+                                         Kwave::SonagramPlugin::Slice *slice)
 {
-    fftw_plan p;
+    QMutexLocker _lock(&m_lock_fft_plans);
+
+    fftw_plan plan = m_fft_plans.value(points, nullptr);
+    if (plan) return plan;
 
-    // prepare for a 1-dimensional real-to-complex DFT
+    // prepare for a 1-dimensional real-to-complex DFT. FFTW_ESTIMATE
+    // does not touch the arrays, FFTW_UNALIGNED allows executing the
+    // plan on the arrays of any other slice
     {
-        Kwave::GlobalLock _lock; // libfftw is not threadsafe!
-        p = fftw_plan_dft_r2c_1d(
-            m_fft_points,
+        Kwave::GlobalLock _global_lock; // libfftw is not threadsafe!
+        plan = fftw_plan_dft_r2c_1d(
+            points,
             &(slice->m_input[0]),
             &(slice->m_output[0]),
-            FFTW_ESTIMATE
+            FFTW_ESTIMATE | FFTW_UNALIGNED
         );
     }
-    Q_ASSERT(p);
-    if (!p) return;
+    Q_ASSERT(plan);
+    if (plan) m_fft_plans.insert(points, plan);
+    return plan;
+}
 
-    // calculate the fft (according to the specs, this is the one and only
-    // libfft function that is threadsafe!)
-    fftw_execute(p);
+//***************************************************************************
+void Kwave::SonagramPlugin::calculateSlice(Kwave::SonagramPlugin::Slice *slice,
+                                           fftw_plan plan)
+{
+    // calculate the fft (executing a plan on new arrays is threadsafe,
+    // no lock needed)
+    fftw_execute_dft_r2c(plan,
+                         &(slice->m_input[0]),
+                         &(slice->m_output[0]));
 
     // norm all values to [0...254] and use them as pixel value
-    const double scale = static_cast<double>(m_fft_points) / 254.0;
-    for (unsigned int j = 0; j < m_fft_points / 2; j++) {
+    const unsigned int fft_points = m_fft_points;
+    const double scale = static_cast<double>(fft_points) / 254.0;
+    for (unsigned int j = 0; j < fft_points / 2; j++) {
         // get signal energy and scale to [0 .. 254]
         double rea = slice->m_output[j][0];
         double ima = slice->m_output[j][1];
@@ -428,12 +493,6 @@ void Kwave::SonagramPlugin::calculateSlice(Kwave::SonagramPlugin::Slice *slice)
         slice->m_result[j] = static_cast<unsigned char>(qMin(a, double(254.0)));
     }
 
-    // free the allocated FFT resources
-    {
-        Kwave::GlobalLock _lock; // libfftw is not threadsafe!
-        fftw_destroy_plan(p);
-    }
-
     // emit the slice data to be synchronously inserted into
     // the current image in the context of the main thread
     // (Qt does the queuing for us)
@@ -455,8 +514,10 @@ void Kwave::SonagramPlugin::insertSlice(Kwave::SonagramPlugin::Slice *slice)
                       m_fft_points / 2);
     unsigned int nr = slice->m_index;
 
-    // forward the slice to the window to display it
-    if (m_sonagram_window) m_sonagram_window->insertSlice(nr, result);
+    // forward the slice to the window to display it, refinements are
+    // merged into the result of the previous passes
+    if (m_sonagram_window)
+        m_sonagram_window->insertSlice(nr, result, (slice->m_pass != 0));
 
     // return the slice into the pool
     m_slice_pool.release(slice);
@@ -481,7 +542,7 @@ void Kwave::SonagramPlugin::createNewImage(const unsigned int width,
     // also do not create if the image size is out of range
     Q_ASSERT(width <= 32767);
     Q_ASSERT(height <= 32767);
-    if ((width >= 32767) || (height >= 32767)) return;
+    if ((width > 32767) || (height > 32767)) return;
 
     // create the new image object
     m_image = QImage(width, height, QImage::Format_Indexed8);
@@ -588,13 +649,16 @@ void Kwave::SonagramPlugin::slotInvalidated(quint64 track_id,
     first -= offset;
     last  -= offset;
 
-    unsigned int first_idx = Kwave::toUint(first / m_fft_points);
+    const sample_index_t slice_length =
+        static_cast<sample_index_t>(m_fft_points) * m_stride;
+    unsigned int first_idx = Kwave::toUint(qMin(first / slice_length,
+        static_cast<sample_index_t>(m_slices - 1)));
     unsigned int last_idx;
-    if (last >= (SAMPLE_INDEX_MAX - (m_fft_points - 1)))
+    if (last >= (SAMPLE_INDEX_MAX - (slice_length - 1)))
         last_idx = m_slices - 1;
     else
         last_idx = Kwave::toUint(qMin(Kwave::round_up(last,
-            static_cast<sample_index_t>(m_fft_points)) / m_fft_points,
+            slice_length) / slice_length,
             static_cast<sample_index_t>(m_slices - 1))
         );
 
@@ -25,6 +25,7 @@
 #include <QBitArray>
 #include <QByteArray>
 #include <QFuture>
+#include <QHash>
 #include <QImage>
 #include <QList>
 #include <QMutex>
@@ -49,6 +50,12 @@ class QImage;
 /** maximum number of slices (width of the image) */
 #define MAX_SLICES 32767
 
+/**
+ * maximum number of FFT frames that are combined into one slice if the
+ * selection has more frames than fit into the image
+ */
+#define MAX_FRAMES_PER_SLICE 16
+
 namespace Kwave
 {
     class OverViewCache;
@@ -95,6 +102,9 @@ namespace Kwave
             /** index of the slice */
             unsigned int m_index;
 
+            /** refinement pass, zero for the first frame of a slice */
+            unsigned int m_pass;
+
             /** array with input samples */
             double m_input[MAX_FFT_POINTS];
 
@@ -187,11 +197,25 @@ namespace Kwave
          */
         void requestValidation();
 
+        /**
+         * Returns a FFT plan for a given number of points. Plans are
+         * created once per size and then shared by all worker threads,
+         * which use them through the thread safe new-array execute
+         * interface of libfftw.
+         * @param points number of FFT points
+         * @param slice a slice, used as template for the arrays
+         * @return a plan or null if failed
+         */
+        fftw_plan fftPlan(unsigned int points,
+                          Kwave::SonagramPlugin::Slice *slice);
+
         /**
          * do the FFT calculation on a slice
          * @param slice structure with the input data and output buffer
+         * @param plan the FFT plan to use, from fftPlan()
          */
-        void calculateSlice(Kwave::SonagramPlugin::Slice *slice);
+        void calculateSlice(Kwave::SonagramPlugin::Slice *slice,
+                            fftw_plan plan);
 
         /**
          * Creates a new image for the current processing.
@@ -217,6 +241,9 @@ namespace Kwave
         /** number of slices (= width of the image in pixels) */
         unsigned int m_slices;
 
+        /** number of FFT frames covered by one slice */
+        unsigned int m_stride;
+
         /** number of fft points */
         unsigned int m_fft_points;
 
@@ -255,6 +282,12 @@ namespace Kwave
 
         /** timer for refreshing the sonagram */
         QTimer m_repaint_timer;
+
+        /** cache with FFT plans, indexed by number of FFT points */
+        QHash<unsigned int, fftw_plan> m_fft_plans;
+
+        /** lock for protecting m_fft_plans */
+        QMutex m_lock_fft_plans;
     };
 }
 
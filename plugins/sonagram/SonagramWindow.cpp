@@ -91,6 +91,7 @@ Kwave::SonagramWindow::SonagramWindow(QWidget *parent, const QString &name)
      m_view(nullptr),
      m_overview(nullptr),
      m_points(0),
+     m_stride(1),
      m_rate(0),
      m_xscale(nullptr),
      m_yscale(nullptr),
@@ -307,7 +308,8 @@ void Kwave::SonagramWindow::setOverView(const QImage &overview)
 
 //****************************************************************************
 void Kwave::SonagramWindow::insertSlice(const unsigned int slice_nr,
-                                        const QByteArray &slice)
+                                        const QByteArray &slice,
+                                        bool merge)
 {
     Q_ASSERT(m_view);
     if (!m_view) return;
@@ -325,11 +327,15 @@ void Kwave::SonagramWindow::insertSlice(const unsigned int slice_nr,
         quint8 p;
 
         // remove the current pixel from the histogram
-        p = static_cast<quint8>(m_image.pixelIndex(slice_nr, y));
-        m_histogram[p]--;
+        const quint8 old = static_cast<quint8>(
+            m_image.pixelIndex(slice_nr, y));
+        m_histogram[old]--;
 
-        // set the new pixel value
+        // set the new pixel value, when merging keep the maximum
+        // (0xFF is "empty", 0xFE is a full scale value here, the blank
+        // fill is only used below the slice)
         p = slice[(size - 1) - y];
+        if (merge && (old != 0xFF) && (old > p)) p = old;
         m_image.setPixel(slice_nr, y, p);
 
         // insert the new pixel into the histogram
@@ -477,7 +483,8 @@ void Kwave::SonagramWindow::translatePixels2TF(const QPoint p,
         // get the time coordinate [0...(N_samples-1)* (1/f_sample) ]
         if (!qFuzzyIsNull(m_rate)) {
             *ms = static_cast<double>(p.x()) *
-                  static_cast<double>(m_points) * 1000.0 / m_rate;
+                  static_cast<double>(m_points) *
+                  static_cast<double>(m_stride) * 1000.0 / m_rate;
         } else {
             *ms = 0;
         }
@@ -572,6 +579,13 @@ void Kwave::SonagramWindow::setPoints(unsigned int points)
     updateScaleWidgets();
 }
 
+//****************************************************************************
+void Kwave::SonagramWindow::setStride(unsigned int stride)
+{
+    m_stride = (stride) ? stride : 1;
+    updateScaleWidgets();
+}
+
 //****************************************************************************
 void Kwave::SonagramWindow::setRate(double rate)
 {
@@ -76,8 +76,12 @@ namespace Kwave
          * content of the image slice will be cleared or updated in all cases.
          * @param slice_nr index of the slice (horizontal position) [0..n-1]
          * @param slice array with the byte data
+         * @param merge if true, keep the maximum of the new data and the
+         *        previous content, used for refining slices that cover
+         *        more than one FFT frame
          */
-        void insertSlice(const unsigned int slice_nr, const QByteArray &slice);
+        void insertSlice(const unsigned int slice_nr, const QByteArray &slice,
+                         bool merge = false);
 
     public slots:
 
@@ -119,6 +123,13 @@ namespace Kwave
          */
         void setPoints(unsigned int points);
 
+        /**
+         * sets information about the number of FFT frames per slice
+         * (needed for translating cursor coordinates into time)
+         * @param stride the number of FFT frames per slice [1...]
+         */
+        void setStride(unsigned int stride);
+
         /**
          * sets information about the sample rate (needed for
          * translating cursor coordinates into time
@@ -184,6 +195,9 @@ namespace Kwave
         /** number of fft points */
         unsigned int m_points;
 
+        /** number of FFT frames per slice (horizontal pixel) */
+        unsigned int m_stride;
+
         /** sample rate, needed for translating pixel coordinates */
         double m_rate;
 